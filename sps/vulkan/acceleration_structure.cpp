@@ -47,7 +47,7 @@ void AccelerationStructure::cleanup()
   }
   if (m_memory)
   {
-    dev.freeMemory(m_memory);
+    m_device->free_memory(m_memory);
     m_memory = VK_NULL_HANDLE;
   }
   if (m_scratch_buffer)
@@ -57,7 +57,7 @@ void AccelerationStructure::cleanup()
   }
   if (m_scratch_memory)
   {
-    dev.freeMemory(m_scratch_memory);
+    m_device->free_memory(m_scratch_memory);
     m_scratch_memory = VK_NULL_HANDLE;
   }
   if (m_instance_buffer)
@@ -67,7 +67,7 @@ void AccelerationStructure::cleanup()
   }
   if (m_instance_memory)
   {
-    dev.freeMemory(m_instance_memory);
+    m_device->free_memory(m_instance_memory);
     m_instance_memory = VK_NULL_HANDLE;
   }
 }
@@ -147,7 +147,7 @@ void AccelerationStructure::create_buffer(vk::DeviceSize size, vk::BufferUsageFl
   allocInfo.memoryTypeIndex = m_device->find_memory_type(
     memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_memory = dev.allocateMemory(allocInfo);
+  m_memory = m_device->allocate_memory(allocInfo, MemoryCategory::AccelerationStructure);
   dev.bindBufferMemory(m_buffer, m_memory, 0);
 }
 
@@ -233,7 +233,7 @@ void AccelerationStructure::build_blas(vk::CommandBuffer cmd, const Mesh& mesh)
   scratchAllocInfo.memoryTypeIndex = m_device->find_memory_type(
     scratchMemReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_scratch_memory = dev.allocateMemory(scratchAllocInfo);
+  m_scratch_memory = m_device->allocate_memory(scratchAllocInfo, MemoryCategory::AccelerationStructure);
   dev.bindBufferMemory(m_scratch_buffer, m_scratch_memory, 0);
 
   vk::DeviceAddress scratchAddress = get_buffer_device_address(dev, m_scratch_buffer);
@@ -311,7 +311,7 @@ void AccelerationStructure::build_tlas(vk::CommandBuffer cmd,
   }
   if (m_instance_memory)
   {
-    dev.freeMemory(m_instance_memory);
+    m_device->free_memory(m_instance_memory);
     m_instance_memory = VK_NULL_HANDLE;
   }
 
@@ -329,7 +329,7 @@ void AccelerationStructure::build_tlas(vk::CommandBuffer cmd,
     instanceMemReqs.memoryTypeBits,
     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
-  m_instance_memory = dev.allocateMemory(instanceAllocInfo);
+  m_instance_memory = m_device->allocate_memory(instanceAllocInfo, MemoryCategory::AccelerationStructure);
   dev.bindBufferMemory(m_instance_buffer, m_instance_memory, 0);
 
   // Copy instance data
@@ -399,7 +399,7 @@ void AccelerationStructure::build_tlas(vk::CommandBuffer cmd,
   scratchAllocInfo.memoryTypeIndex = m_device->find_memory_type(
     scratchMemReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_scratch_memory = dev.allocateMemory(scratchAllocInfo);
+  m_scratch_memory = m_device->allocate_memory(scratchAllocInfo, MemoryCategory::AccelerationStructure);
   dev.bindBufferMemory(m_scratch_buffer, m_scratch_memory, 0);
 
   vk::DeviceAddress scratchAddress = get_buffer_device_address(dev, m_scratch_buffer);
@@ -8,6 +8,7 @@
 #include <sps/vulkan/debug_constants.h>
 #include <sps/vulkan/meta.hpp>
 #include <sps/vulkan/screenshot.h>
+#include <sps/vulkan/shader_compiler.h>
 
 #include <fstream>
 #include <sps/vulkan/vertex.h>
@@ -18,11 +19,16 @@
 #include <sps/vulkan/pipeline.h>
 #include <sps/vulkan/shaders.h>
 
-#include <sps/vulkan/fence.h>
 #include <sps/vulkan/semaphore.h>
 
 #include <sps/vulkan/stages/composite_stage.h>
 #include <sps/vulkan/stages/debug_2d_stage.h>
+#include <sps/vulkan/stages/depth_prepass_stage.h>
+#include <sps/vulkan/stages/draw_cull_stage.h>
+#include <sps/vulkan/stages/hiz_cull_stage.h>
+#include <sps/vulkan/stages/occlusion_depth_stage.h>
+#include <sps/vulkan/stages/oit_accumulate_stage.h>
+#include <sps/vulkan/stages/oit_resolve_stage.h>
 #include <sps/vulkan/stages/sss_blur_stage.h>
 #include <sps/vulkan/stages/raster_blend_stage.h>
 #include <sps/vulkan/stages/raster_opaque_stage.h>
@@ -35,8 +41,10 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 
 namespace sps::vulkan
 {
@@ -59,7 +67,10 @@ RendererConfig Application::build_renderer_config(int argc, char** argv, AppConf
   config.window_height = app_config.window_height;
   config.window_mode = app_config.window_mode;
   config.preferred_gpu = app_config.preferred_gpu;
+  config.pipeline_cache_dir = app_config.pipeline_cache_dir;
   config.msaa_samples = app_config.msaa_samples;
+  config.frames_in_flight = app_config.frames_in_flight;
+  config.low_latency = app_config.low_latency;
 
   auto enable_renderdoc = cla_parser.arg<bool>("--renderdoc");
   if (enable_renderdoc)
@@ -91,6 +102,13 @@ RendererConfig Application::build_renderer_config(int argc, char** argv, AppConf
     config.vsync = false;
   }
 
+  const auto low_latency = cla_parser.arg<bool>("--low-latency");
+  if (low_latency.value_or(false))
+  {
+    spdlog::trace("Low-latency presentation enabled");
+    config.low_latency = true;
+  }
+
   const auto no_separate_queue = cla_parser.arg<bool>("--no-separate-data-queue");
   if (no_separate_queue.value_or(false))
   {
@@ -117,6 +135,8 @@ Application::Application(int argc, char** argv)
   // Build renderer config from TOML + CLI, then construct renderer
   AppConfig app_config;
   RendererConfig renderer_config = build_renderer_config(argc, argv, app_config);
+  if (app_config.runtime_shader_compilation)
+    enable_runtime_shader_compilation(app_config.shader_cache_dir);
   m_renderer = std::make_unique<VulkanRenderer>(renderer_config);
 
   // Apply app-specific config (geometry, lighting, etc.)
@@ -142,11 +162,15 @@ Application::Application(int argc, char** argv)
   // Create scene manager and load initial scene
   m_scene_manager = std::make_unique<SceneManager>(m_renderer->device());
   m_scene_manager->set_ibl_settings(m_ibl_settings);
+  m_scene_manager->set_host_visible_meshes(m_host_visible_meshes);
   m_scene_manager->create_defaults(m_hdr_file);
   auto load_result = m_scene_manager->load_initial_scene(m_geometry_source, m_gltf_file, m_ply_file);
 
-  // Create uniform buffer (descriptors allocated by graph in finalize_setup)
-  create_uniform_buffer();
+  // Create per-frame uniform buffers (descriptors allocated by graph in finalize_setup)
+  create_uniform_buffers();
+  m_frame_timer = std::make_unique<FrameTimer>(m_renderer->device(), m_renderer->frames_in_flight());
+  if (m_renderer->device().supports_present_wait())
+    m_present_waiter = std::make_unique<PresentWaiter>(m_renderer->device().device());
 
   // Create scene render pass (pipelines created by RasterOpaqueStage in finalize_setup)
   create_scene_renderpass();
@@ -161,6 +185,11 @@ Application::Application(int argc, char** argv)
 
   finalize_setup();
 
+  // Compare runs with and without a pipeline cache file (delete it for a cold start)
+  const auto cache_bytes = m_renderer->device().pipeline_cache_loaded_bytes();
+  spdlog::info("Startup took {:.1f} ms ({} pipeline cache)", (glfwGetTime() - m_lastTime) * 1000.0,
+    cache_bytes > 0 ? fmt::format("warm, {} KiB", cache_bytes / 1024) : std::string("cold"));
+
   // Setup resize and input callbacks
   glfwSetWindowUserPointer(m_renderer->window().get(), this);
   glfwSetFramebufferSizeCallback(m_renderer->window().get(),
@@ -179,6 +208,15 @@ void Application::apply_config(AppConfig config)
 {
   m_backfaceCulling = config.backface_culling;
   m_use_raytracing = config.use_raytracing;
+  m_bindless_materials = config.bindless_materials;
+  m_recording_threads = config.recording_threads;
+  m_async_compute = config.async_compute;
+  m_gpu_driven_draws = config.gpu_driven_draws;
+  m_occlusion_culling = config.occlusion_culling;
+  m_depth_prepass = config.depth_prepass;
+  m_oit = config.order_independent_transparency && oit_supported();
+  m_prewarm_shader_modes = config.prewarm_shader_modes;
+  m_host_visible_meshes = config.host_visible_meshes;
   m_geometry_source = std::move(config.geometry_source);
   m_ply_file = std::move(config.ply_file);
   m_gltf_file = std::move(config.gltf_file);
@@ -193,6 +231,15 @@ void Application::apply_config(AppConfig config)
   m_light = std::move(config.light);
 }
 
+bool Application::oit_supported() const
+{
+  if (m_renderer->device().supports_independent_blend())
+    return true;
+  spdlog::warn("Order independent transparency needs the independentBlend device feature, "
+               "using sorted blending");
+  return false;
+}
+
 void Application::setup_camera()
 {
   // Position camera to look at the triangle
@@ -207,11 +254,33 @@ void Application::setup_camera()
   m_camera.set_aspect_ratio(static_cast<float>(width) / static_cast<float>(height));
 }
 
-void Application::create_uniform_buffer()
+void Application::create_uniform_buffers()
 {
-  m_uniform_buffer =
-    std::make_unique<UniformBuffer<UniformBufferObject>>(m_renderer->device(), "camera uniform buffer");
-  spdlog::trace("Created uniform buffer");
+  const uint32_t count = m_renderer->frames_in_flight();
+  m_uniform_buffers.clear();
+  for (uint32_t i = 0; i < count; i++)
+  {
+    m_uniform_buffers.push_back(std::make_unique<UniformBuffer<UniformBufferObject>>(
+      m_renderer->device(), "camera uniform buffer " + std::to_string(i)));
+    m_uniform_buffers.back()->update(m_ubo_data);
+  }
+  spdlog::trace("Created {} uniform buffers", count);
+}
+
+std::vector<vk::DescriptorBufferInfo> Application::uniform_buffer_infos() const
+{
+  std::vector<vk::DescriptorBufferInfo> infos;
+  for (const auto& ubo : m_uniform_buffers)
+    infos.push_back(ubo->descriptor_info());
+  return infos;
+}
+
+std::vector<vk::Buffer> Application::uniform_buffer_handles() const
+{
+  std::vector<vk::Buffer> buffers;
+  for (const auto& ubo : m_uniform_buffers)
+    buffers.push_back(ubo->buffer());
+  return buffers;
 }
 
 void Application::update_uniform_buffer()
@@ -281,7 +350,8 @@ void Application::update_uniform_buffer()
 
   ubo.clear_color = glm::vec4(m_clear_color, 0.0f);
 
-  m_uniform_buffer->update(ubo);
+  // Uploaded in render() once the target frame's buffer is no longer in use
+  m_ubo_data = ubo;
 }
 
 void Application::process_input()
@@ -326,6 +396,7 @@ void Application::process_input()
 void Application::key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
   auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+  app->m_input_event = true;
   if (key >= 0 && key < 512)
   {
     if (action == GLFW_PRESS)
@@ -375,6 +446,7 @@ void Application::key_callback(GLFWwindow* window, int key, int scancode, int ac
 void Application::mouse_callback(GLFWwindow* window, double xpos, double ypos)
 {
   auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+  app->m_input_event = true;
 
   if (app->m_firstMouse)
   {
@@ -422,6 +494,7 @@ void Application::mouse_callback(GLFWwindow* window, double xpos, double ypos)
 void Application::scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 {
   auto* app = static_cast<Application*>(glfwGetWindowUserPointer(window));
+  app->m_input_event = true;
 
   // 2D mode: scroll to zoom
   if (app->m_debug_2d_mode)
@@ -450,7 +523,7 @@ void Application::run()
 
   while (!m_renderer->window().should_close())
   {
-    m_renderer->window().poll();
+    poll_events();
     process_input();
     update_uniform_buffer();
     render();
@@ -458,7 +531,7 @@ void Application::run()
   }
 }
 
-void Application::record_draw_commands(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
+bool Application::record_draw_commands(vk::CommandBuffer commandBuffer, uint32_t imageIndex)
 {
   vk::CommandBufferBeginInfo beginInfo = {};
 
@@ -478,17 +551,73 @@ void Application::record_draw_commands(vk::CommandBuffer commandBuffer, uint32_t
   FrameContext ctx{};
   ctx.command_buffer = commandBuffer;
   ctx.image_index = imageIndex;
+  ctx.frame_index = m_frame_index;
   ctx.extent = m_renderer->swapchain().extent();
   ctx.mesh = m_scene_manager->mesh();
   ctx.scene = m_scene_manager->scene();
   ctx.camera = &m_camera;
   ctx.clear_color = m_clear_color;
 
-  m_render_graph.record(ctx);
+  // Visibility for the raster stages (main thread: stages may record in parallel)
+  m_frustum_culled = m_frustum_culling && ctx.scene && !m_use_raytracing;
+  if (m_frustum_culled)
+  {
+    m_frustum_culler.cull(*ctx.scene, m_camera.view_projection_matrix());
+    ctx.culler = &m_frustum_culler;
+  }
+
+  // Draw order of the CPU-recorded opaque pass (GPU-driven draws need none)
+  m_opaque_draws_sorted = m_draw_sorting && ctx.scene && !m_use_raytracing
+    && !m_raster_opaque_stage->gpu_driven();
+  if (m_opaque_draws_sorted)
+  {
+    m_opaque_draw_list.build(*ctx.scene, ctx.culler, m_camera.view_matrix());
+    ctx.opaque_draws = &m_opaque_draw_list;
+  }
+  // Back-to-front BLEND order (order-independent transparency needs none)
+  if (ctx.scene && !m_use_raytracing && !m_oit_accumulate_stage->is_enabled())
+  {
+    m_blend_draw_list.build(*ctx.scene, ctx.culler, m_camera.view_matrix());
+    ctx.blend_draws = &m_blend_draw_list;
+  }
+
+  // Async compute: the graph decides per plan whether these are used
+  if (m_render_graph.async_compute())
+  {
+    ctx.compute_command_buffer = m_renderer->frame_compute_command_buffer(m_frame_index);
+    ctx.resume_command_buffer = m_renderer->frame_resume_command_buffer(m_frame_index);
+    for (vk::CommandBuffer extra : { ctx.compute_command_buffer, ctx.resume_command_buffer })
+    {
+      extra.reset();
+      extra.begin(beginInfo);
+    }
+  }
+
+  m_frame_timer->begin(commandBuffer, m_frame_index);
+  if (ctx.compute_command_buffer)
+  {
+    m_frame_timer->begin_split(ctx.compute_command_buffer, ctx.resume_command_buffer, m_frame_index);
+  }
+
+  const bool split = m_render_graph.record(ctx);
+  if (split)
+  {
+    m_frame_timer->end_split(commandBuffer, ctx.compute_command_buffer, m_frame_index);
+    m_frame_timer->end(ctx.resume_command_buffer, m_frame_index);
+  }
+  else
+  {
+    m_frame_timer->end(commandBuffer, m_frame_index);
+  }
 
   try
   {
     commandBuffer.end();
+    if (ctx.compute_command_buffer)
+    {
+      ctx.compute_command_buffer.end();
+      ctx.resume_command_buffer.end();
+    }
   }
   catch (vk::SystemError err)
   {
@@ -498,6 +627,7 @@ void Application::record_draw_commands(vk::CommandBuffer commandBuffer, uint32_t
       std::cout << "failed to record command buffer!" << std::endl;
     }
   }
+  return split;
 }
 
 void Application::calculateFrameRate()
@@ -520,6 +650,19 @@ void Application::calculateFrameRate()
 
 void Application::recreate_swapchain()
 {
+  const double start = glfwGetTime();
+
+  // Present ids of the old swapchain can no longer be waited for (nor the
+  // swapchain used once it is retired below)
+  if (m_present_waiter)
+    m_present_waiter->flush();
+
+  if (!m_resize_present_pending)
+  {
+    const Window& window = m_renderer->window();
+    m_resize_requested = window.has_pending_resize() ? window.resize_pending_since() : start;
+  }
+
   // 1. Wait for valid size (not 0×0)
   std::uint32_t width, height;
   m_renderer->window().get_framebuffer_size(width, height);
@@ -529,36 +672,43 @@ void Application::recreate_swapchain()
     m_renderer->window().get_framebuffer_size(width, height);
   }
 
-  // 2. Wait for GPU to finish using old resources
-  m_renderer->device().wait_idle();
+  // 2. No device idle: frames in flight keep the old resources. Everything
+  // replaced below (depth, HDR, transient images, framebuffers, descriptor
+  // pools) is retired through Device::defer_release() and destroyed once the
+  // work submitted so far has completed. The old swapchain, its views and the
+  // render-finished semaphores also wait for frames in flight + 1 presents of
+  // the new swapchain (Swapchain::defer_until_presented()), since queued
+  // presents may still use them. Peak memory briefly holds both sizes.
 
-  // 3. Scene framebuffers destroyed by RenderGraph::recreate_scene_framebuffers()
-  // Composite framebuffers destroyed by CompositeStage::on_swapchain_resize()
-  // SSS blur ping image + descriptors destroyed by SSSBlurStage::on_swapchain_resize()
+  // 3. Scene framebuffers retired by RenderGraph::recreate_scene_framebuffers()
+  // Composite framebuffers retired by CompositeStage::on_swapchain_resize()
+  // Transient images (SSS ping, RT storage, MSAA) recreated by realize_transient_images()
 
-  // 4. Recreate swapchain (handles its own image views internally)
+  // 4. Recreate swapchain (the old one is handed over as oldSwapchain)
   m_renderer->swapchain().recreate(width, height);
 
   // 6. Recreate per-swapchain-image semaphores
   m_renderer->recreate_sync_objects();
 
-  // 7. Recreate renderer-owned resources (depth-stencil) and graph-owned resources (HDR, MSAA)
+  // 7. Recreate renderer-owned resources (depth-stencil) and graph-owned resources (HDR)
   m_renderer->recreate_depth_resources();
   m_render_graph.recreate_hdr_resources();
 
-  // RT storage image handled by RayTracingStage::on_swapchain_resize()
-
   // Update shared image registry before recreating framebuffers and notifying stages
   // (HDR registry updated by recreate_hdr_resources above)
   m_render_graph.image_registry().set("depth_stencil",
     { m_renderer->depth_stencil().image(), m_renderer->depth_stencil().stencil_view(),
       {}, m_renderer->depth_format() });
 
+  // Recreate transient images; stages refresh their descriptors from the registry
+  m_render_graph.realize_transient_images();
+
   // Recreate scene framebuffers (uses registry images + scene render pass)
   m_render_graph.recreate_scene_framebuffers();
 
   // Composite framebuffers + descriptor handled by CompositeStage::on_swapchain_resize()
-  // SSS blur ping + descriptors handled by SSSBlurStage::on_swapchain_resize()
+  // SSS blur descriptors refreshed by on_transient_images_realized() above; the
+  // per-frame RT sets are rewritten lazily, per slot, in RayTracingStage::begin_frame()
 
   // Update camera aspect ratio
   m_camera.set_aspect_ratio(static_cast<float>(width) / static_cast<float>(height));
@@ -573,41 +723,100 @@ void Application::recreate_swapchain()
   // Notify render stages of resize
   m_render_graph.on_swapchain_resize(m_renderer->device(), m_renderer->swapchain().extent());
 
+  m_resize_recreate_ms = (glfwGetTime() - start) * 1000.0;
+  m_resize_present_pending = true;
+
   spdlog::trace(
     "Swapchain recreated: {}x{}", m_renderer->swapchain().extent().width, m_renderer->swapchain().extent().height);
 }
 
 void Application::render()
 {
-  // Wait for previous frame to complete
-  m_renderer->in_flight().block();
+  // Wait until the GPU has finished the frame that last used this slot
+  // (frames_in_flight frames ago); newer frames may still be executing.
+  Semaphore& image_available = m_renderer->image_available(m_frame_index);
+  const double wait_start = glfwGetTime();
+  m_renderer->wait_frame(m_frame_index);
+  const double timeline_wait_ms = (glfwGetTime() - wait_start) * 1000.0;
+  m_frame_timer->resolve(m_frame_index, timeline_wait_ms);
+
+  // Release resources retired by earlier submissions (staging buffers etc.)
+  m_renderer->device().collect_releases();
+
+  // Globally disabled features are compiled out of the shader variants
+  uint32_t global_features = MATERIAL_FEATURE_ALL;
+  if (!m_use_normal_mapping)
+    global_features &= ~MATERIAL_FEATURE_NORMAL_MAP;
+  if (!m_use_emissive)
+    global_features &= ~MATERIAL_FEATURE_EMISSIVE;
+  if (!m_use_ao)
+    global_features &= ~MATERIAL_FEATURE_AO;
+  if (!m_use_ibl)
+    global_features &= ~MATERIAL_FEATURE_IBL;
+  m_raster_opaque_stage->set_global_features(global_features);
+
+  // Swap in shader pipelines compiled in the background (the old ones are
+  // released once the frames already submitted have completed)
+  m_raster_opaque_stage->poll_pipelines();
 
   // Acquire next image
   uint32_t imageIndex;
+  const double acquire_start = glfwGetTime();
   try
   {
     imageIndex = m_renderer->device().device()
                    .acquireNextImageKHR(
-                     *m_renderer->swapchain().swapchain(), UINT64_MAX, *m_renderer->image_available().semaphore(), nullptr)
+                     *m_renderer->swapchain().swapchain(), UINT64_MAX, *image_available.semaphore(), nullptr)
                    .value;
   }
   catch (const vk::OutOfDateKHRError&)
   {
     // Swapchain out of date - recreate and skip this frame
-    // Don't reset fence - it's still signaled, next frame can proceed
+    // (the slot's timeline value is unchanged, next frame can proceed)
     recreate_swapchain();
     return;
   }
+  // Blocks while every image is queued for display (FIFO)
+  const double acquire_ms = (glfwGetTime() - acquire_start) * 1000.0;
 
-  // Reset fence only after successful acquire, before submit
-  m_renderer->in_flight().reset();
+  // This frame's UBO is no longer read by the GPU
+  m_uniform_buffers[m_frame_index]->update(m_ubo_data);
 
-  vk::CommandBuffer commandBuffer = m_renderer->command_buffers()[imageIndex];
+  vk::CommandBuffer commandBuffer = m_renderer->frame_command_buffer(m_frame_index);
   commandBuffer.reset();
-  record_draw_commands(commandBuffer, imageIndex);
+  const bool split = record_draw_commands(commandBuffer, imageIndex);
+
+  // The previous frame's async compute work may still read depth, which this
+  // frame overwrites; the graph narrows the wait to the stages touching it
+  const auto& device = m_renderer->device();
+  const std::uint64_t previous_compute = device.supports_async_compute()
+    ? device.submitted_compute_value()
+    : 0;
+  const vk::PipelineStageFlags previous_compute_stages = m_render_graph.compute_wait_stages();
+
+  std::uint64_t final_wait = previous_compute;
+  vk::PipelineStageFlags final_wait_stages = previous_compute_stages;
+  if (split)
+  {
+    // Graphics (up to the blur) -> compute (blur) -> graphics (composite)
+    vk::SubmitInfo sceneSubmit = {};
+    sceneSubmit.commandBufferCount = 1;
+    sceneSubmit.pCommandBuffers = &commandBuffer;
+    const std::uint64_t scene_done =
+      device.submit_graphics(sceneSubmit, previous_compute, previous_compute_stages);
+
+    vk::CommandBuffer computeBuffer = m_renderer->frame_compute_command_buffer(m_frame_index);
+    vk::SubmitInfo computeSubmit = {};
+    computeSubmit.commandBufferCount = 1;
+    computeSubmit.pCommandBuffers = &computeBuffer;
+    final_wait = device.submit_compute(computeSubmit, scene_done);
+    final_wait_stages = m_render_graph.resume_wait_stages();
+
+    commandBuffer = m_renderer->frame_resume_command_buffer(m_frame_index);
+  }
 
   vk::SubmitInfo submitInfo = {};
-  vk::Semaphore waitSemaphores[] = { *m_renderer->image_available().semaphore() };
+  vk::Semaphore waitSemaphores[] = { *image_available.semaphore() };
   vk::PipelineStageFlags waitStages[] = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
   submitInfo.waitSemaphoreCount = 1;
   submitInfo.pWaitSemaphores = waitSemaphores;
@@ -619,7 +828,17 @@ void Application::render()
   submitInfo.signalSemaphoreCount = 1;
   submitInfo.pSignalSemaphores = signalSemaphores;
 
-  m_renderer->device().graphics_queue().submit(submitInfo, m_renderer->in_flight().get());
+  // When split, retiring the slot on this value also covers its compute work
+  m_renderer->set_frame_timeline_value(
+    m_frame_index, device.submit_graphics(submitInfo, final_wait, final_wait_stages));
+  m_frame_index = (m_frame_index + 1) % m_renderer->frames_in_flight();
+
+  // CPU work only: time blocked on the timeline or the acquire would feed back
+  // into wait_for_frame_start() and start the next frame earlier still
+  m_last_submit_time = glfwGetTime();
+  const double cpu_ms = std::max(
+    (m_last_submit_time - m_frame_start_time) * 1000.0 - timeline_wait_ms - acquire_ms, 0.0);
+  m_cpu_frame_ms = m_cpu_frame_ms == 0.0 ? cpu_ms : 0.9 * m_cpu_frame_ms + 0.1 * cpu_ms;
 
   // Present
   vk::PresentInfoKHR presentInfo = {};
@@ -630,6 +849,16 @@ void Application::render()
   presentInfo.pSwapchains = swapChains;
   presentInfo.pImageIndices = &imageIndex;
 
+  // Tag the present so its display time can be waited for
+  vk::PresentIdKHR presentId{};
+  const uint64_t present_id = ++m_present_id;
+  if (m_present_waiter)
+  {
+    presentId.swapchainCount = 1;
+    presentId.pPresentIds = &present_id;
+    presentInfo.pNext = &presentId;
+  }
+
   vk::Result presentResult;
   try
   {
@@ -640,6 +869,35 @@ void Application::render()
     presentResult = vk::Result::eErrorOutOfDateKHR;
   }
 
+  if (presentResult != vk::Result::eErrorOutOfDateKHR)
+    m_renderer->swapchain().on_presented();
+
+  if (m_frame_input_time >= 0.0 && presentResult != vk::Result::eErrorOutOfDateKHR)
+  {
+    if (m_present_waiter)
+    {
+      // Timed on the waiter thread when the image reaches the display
+      m_present_waiter->push(
+        *m_renderer->swapchain().swapchain(), present_id, m_frame_input_time);
+    }
+    else
+    {
+      // Estimate: the GPU work just submitted, then the image is queued for display
+      record_input_latency(
+        m_frame_input_time, glfwGetTime() + m_frame_timer->average().gpu_busy_ms / 1000.0, false);
+    }
+  }
+  m_frame_input_time = -1.0;
+  collect_present_latencies();
+
+  if (m_resize_present_pending && presentResult != vk::Result::eErrorOutOfDateKHR)
+  {
+    m_resize_present_pending = false;
+    m_resize_last_ms = (glfwGetTime() - m_resize_requested) * 1000.0;
+    m_resize_max_ms = std::max(m_resize_max_ms, m_resize_last_ms);
+    ++m_resize_count;
+  }
+
   // Check if we need to recreate (out of date, suboptimal, or resize requested)
   if (presentResult == vk::Result::eErrorOutOfDateKHR ||
     presentResult == vk::Result::eSuboptimalKHR || m_renderer->window().has_pending_resize())
@@ -661,15 +919,30 @@ void Application::create_scene_renderpass()
 /// RasterOpaqueStage owns the pipeline layout, the opaque pipeline, and the blend
 /// pipeline. RasterBlendStage holds a const reference to the opaque stage and
 /// queries blend_pipeline() / pipeline_layout() each frame — so shader hot-reload
-/// is transparent (no stale handles).
+/// is transparent (no stale handles). DrawCullStage follows the opaque stage's
+/// gpu_driven() state the same way, and so do the occlusion culling stages
+/// (OcclusionDepthStage, HiZCullStage), which run after it in the PrePass.
+/// DepthPrepassStage records the opaque stage's depth pre-pass, so it is
+/// registered in front of it.
 void Application::create_raster_stages()
 {
   m_raster_opaque_stage = m_render_graph.add<RasterOpaqueStage>(
     *m_renderer, m_scene_renderpass, m_render_graph,
     std::string(SHADER_DIR "vertex.spv"), std::string(SHADER_DIR "fragment.spv"),
-    &m_use_raytracing, &m_debug_2d_mode);
+    &m_use_raytracing, &m_debug_2d_mode, &m_gpu_driven_draws, &m_depth_prepass);
+  if (m_prewarm_shader_modes)
+    m_raster_opaque_stage->prewarm_shader_modes();
+  m_depth_prepass_stage =
+    m_render_graph.add_before<DepthPrepassStage>(m_raster_opaque_stage, *m_raster_opaque_stage);
   m_raster_blend_stage = m_render_graph.add<RasterBlendStage>(
     *m_raster_opaque_stage, m_render_graph, &m_use_raytracing, &m_debug_2d_mode);
+  m_draw_cull_stage =
+    m_render_graph.add<DrawCullStage>(*m_renderer, m_render_graph, *m_raster_opaque_stage);
+  m_occlusion_depth_stage = m_render_graph.add<OcclusionDepthStage>(
+    *m_renderer, m_render_graph, *m_raster_opaque_stage, &m_occlusion_culling);
+  m_hiz_cull_stage =
+    m_render_graph.add<HiZCullStage>(*m_renderer, m_render_graph, *m_occlusion_depth_stage);
+  m_draw_cull_stage->set_occlusion_stage(m_hiz_cull_stage);
 }
 
 
@@ -751,13 +1024,12 @@ int Application::current_shader_mode() const
 void Application::reload_shaders(
   const std::string& vertex_shader, const std::string& fragment_shader)
 {
-  m_renderer->device().wait_idle();
+  // Compiles in the background; render() swaps the pipelines in
   m_raster_opaque_stage->reload_shaders(vertex_shader, fragment_shader);
 }
 
 void Application::apply_shader_mode(int mode)
 {
-  m_renderer->device().wait_idle();
   m_raster_opaque_stage->apply_shader_mode(mode);
 }
 
@@ -829,6 +1101,153 @@ void Application::tick_screenshot_all()
   }
 }
 
+void Application::begin_frames_in_flight_bench(uint32_t frames_per_setting)
+{
+  if (m_fif_bench_count > 0)
+  {
+    spdlog::warn("Frames-in-flight benchmark already running");
+    return;
+  }
+  if (m_renderer->vsync_enabled())
+    spdlog::warn("VSync is on: frame times are capped by the display refresh rate");
+
+  m_fif_bench_restore = m_renderer->frames_in_flight();
+  m_fif_bench_frames = std::max(frames_per_setting, 1u);
+  m_fif_bench_results.clear();
+  m_fif_bench_count = 1;
+  m_fif_bench_frame = -16; // warm-up frames so the queue fills to the new depth
+  set_frames_in_flight(1);
+  spdlog::info("Frames-in-flight benchmark: {} frames per setting", m_fif_bench_frames);
+}
+
+void Application::tick_frames_in_flight_bench()
+{
+  if (m_fif_bench_count < 0)
+    return; // not active
+
+  if (m_fif_bench_frame < 0)
+  {
+    if (++m_fif_bench_frame == 0)
+    {
+      m_fif_bench_start = glfwGetTime();
+      m_fif_bench_sum = {};
+    }
+    return;
+  }
+
+  const FrameTimings& last = m_frame_timer->last();
+  m_fif_bench_sum.cpu_wait_ms += last.cpu_wait_ms;
+  m_fif_bench_sum.gpu_busy_ms += last.gpu_busy_ms;
+  m_fif_bench_sum.gpu_idle_ms += last.gpu_idle_ms;
+  if (++m_fif_bench_frame < static_cast<int>(m_fif_bench_frames))
+    return;
+
+  // Record the current setting (may be clamped below the requested count)
+  const double frame_ms = (glfwGetTime() - m_fif_bench_start) * 1000.0 / m_fif_bench_frames;
+  m_fif_bench_results.push_back(fmt::format(
+    "  N={} (active {}): {:.3f} ms/frame ({:.1f} fps), CPU wait {:.3f} ms, "
+    "GPU busy {:.3f} ms, GPU idle {:.3f} ms",
+    m_fif_bench_count, m_renderer->frames_in_flight(), frame_ms, 1000.0 / frame_ms,
+    m_fif_bench_sum.cpu_wait_ms / m_fif_bench_frames,
+    m_fif_bench_sum.gpu_busy_ms / m_fif_bench_frames,
+    m_fif_bench_sum.gpu_idle_ms / m_fif_bench_frames));
+  spdlog::info("Frames-in-flight benchmark:{}", m_fif_bench_results.back());
+
+  // Advance to next setting
+  if (++m_fif_bench_count <= static_cast<int>(VulkanRenderer::MAX_FRAMES_IN_FLIGHT))
+  {
+    m_fif_bench_frame = -16;
+    set_frames_in_flight(static_cast<uint32_t>(m_fif_bench_count));
+    return;
+  }
+
+  // Done — report and restore original setting
+  std::string report = "Frames-in-flight benchmark complete:";
+  for (const auto& line : m_fif_bench_results)
+    report += "\n" + line;
+  spdlog::info("{}", report);
+  m_fif_bench_count = -1;
+  set_frames_in_flight(m_fif_bench_restore);
+}
+
+void Application::begin_mesh_memory_bench(uint32_t frames_per_mode)
+{
+  if (m_mesh_bench_mode >= 0)
+  {
+    spdlog::warn("Mesh memory benchmark already running");
+    return;
+  }
+
+  // Both modes reload the current glTF scene
+  m_mesh_bench_path = m_current_model_index >= 0
+    ? m_gltf_models[m_current_model_index]
+    : (m_geometry_source == "gltf" ? m_gltf_file : std::string());
+  if (m_mesh_bench_path.empty())
+  {
+    spdlog::warn("Mesh memory benchmark needs a glTF scene");
+    return;
+  }
+  if (m_renderer->vsync_enabled())
+    spdlog::warn("VSync is on: frame times are capped by the display refresh rate");
+
+  m_mesh_bench_frames = std::max(frames_per_mode, 1u);
+  m_mesh_bench_results.clear();
+  m_mesh_bench_mode = 0;
+  m_mesh_bench_frame = -16; // warm-up frames after the reload
+  m_scene_manager->set_host_visible_meshes(false);
+  reload_scene(m_mesh_bench_path);
+  spdlog::info("Mesh memory benchmark: {} frames per mode", m_mesh_bench_frames);
+}
+
+void Application::tick_mesh_memory_bench()
+{
+  if (m_mesh_bench_mode < 0)
+    return; // not active
+
+  if (m_mesh_bench_frame < 0)
+  {
+    if (++m_mesh_bench_frame == 0)
+    {
+      m_mesh_bench_start = glfwGetTime();
+      m_mesh_bench_sum = {};
+    }
+    return;
+  }
+
+  const FrameTimings& last = m_frame_timer->last();
+  m_mesh_bench_sum.cpu_wait_ms += last.cpu_wait_ms;
+  m_mesh_bench_sum.gpu_busy_ms += last.gpu_busy_ms;
+  if (++m_mesh_bench_frame < static_cast<int>(m_mesh_bench_frames))
+    return;
+
+  const double frame_ms = (glfwGetTime() - m_mesh_bench_start) * 1000.0 / m_mesh_bench_frames;
+  m_mesh_bench_results.push_back(fmt::format(
+    "  {}: {:.3f} ms/frame ({:.1f} fps), CPU wait {:.3f} ms, GPU busy {:.3f} ms",
+    m_mesh_bench_mode == 0 ? "device-local" : "host-visible", frame_ms, 1000.0 / frame_ms,
+    m_mesh_bench_sum.cpu_wait_ms / m_mesh_bench_frames,
+    m_mesh_bench_sum.gpu_busy_ms / m_mesh_bench_frames));
+  spdlog::info("Mesh memory benchmark:{}", m_mesh_bench_results.back());
+
+  // Advance to the host-visible mode
+  if (++m_mesh_bench_mode == 1)
+  {
+    m_mesh_bench_frame = -16;
+    m_scene_manager->set_host_visible_meshes(true);
+    reload_scene(m_mesh_bench_path);
+    return;
+  }
+
+  // Done — report and restore the configured mode
+  std::string report = "Mesh memory benchmark complete:";
+  for (const auto& line : m_mesh_bench_results)
+    report += "\n" + line;
+  spdlog::info("{}", report);
+  m_mesh_bench_mode = -1;
+  m_scene_manager->set_host_visible_meshes(m_host_visible_meshes);
+  if (!m_host_visible_meshes)
+    reload_scene(m_mesh_bench_path);
+}
+
 void Application::poll_commands()
 {
   // Initialize command registry on first call
@@ -865,6 +1284,18 @@ void Application::poll_commands()
           m_debug_channel_mode = static_cast<int>(value);
         else if (name == "2d")
           m_debug_2d_mode = value > 0.5f;
+        else if (name == "gpu_driven")
+          m_gpu_driven_draws = value > 0.5f;
+        else if (name == "occlusion_culling")
+          m_occlusion_culling = value > 0.5f;
+        else if (name == "depth_prepass")
+          m_depth_prepass = value > 0.5f;
+        else if (name == "oit")
+          m_oit = value > 0.5f && oit_supported();
+        else if (name == "frustum_culling")
+          m_frustum_culling = value > 0.5f;
+        else if (name == "draw_sorting")
+          m_draw_sorting = value > 0.5f;
         else
           spdlog::warn("Unknown variable: {}", name);
       });
@@ -932,6 +1363,114 @@ void Application::poll_commands()
         m_debug_2d_mode = (args[0] == "2d");
       });
 
+    // Register "lowlatency" command (mailbox + just-in-time frame start)
+    m_command_registry->add("lowlatency", "Toggle low-latency presentation", "<on|off>",
+      [this](const std::vector<std::string>& args)
+      {
+        if (args.empty())
+          return;
+        set_low_latency(args[0] == "on");
+      });
+
+    // Register "stats" command for runtime telemetry
+    m_command_registry->add("stats", "Print runtime statistics", "<memory|frame|barriers|graph>",
+      [this](const std::vector<std::string>& args)
+      {
+        if (!args.empty() && args[0] == "frame")
+        {
+          const FrameTimings& t = m_frame_timer->average();
+          spdlog::info("Frame timing ({} in flight, timeline {}/{}): CPU wait {:.3f} ms, "
+                       "GPU busy {:.3f} ms, GPU idle {:.3f} ms{}{}",
+            m_renderer->frames_in_flight(), m_renderer->device().completed_graphics_value(),
+            m_renderer->device().submitted_graphics_value(), t.cpu_wait_ms, t.gpu_busy_ms,
+            t.gpu_idle_ms,
+            m_render_graph.async_compute()
+              ? fmt::format(", async compute {:.3f} ms ({:.3f} ms overlapped)", t.compute_ms,
+                  t.compute_overlap_ms)
+              : "",
+            m_frame_timer->gpu_timestamps_supported() ? "" : " (no GPU timestamps)");
+          if (m_input_latency.samples > 0)
+          {
+            spdlog::info("Input to photon: last {:.2f} ms, average {:.2f} ms ({}, {}{})",
+              m_input_latency.last_ms, m_input_latency.average_ms,
+              m_input_latency.measured ? "present wait" : "estimated",
+              vk::to_string(m_renderer->swapchain().present_mode()),
+              m_renderer->low_latency_enabled() ? ", low latency" : "");
+          }
+          if (m_resize_count > 0)
+          {
+            spdlog::info("Swapchain resize to present: last {:.2f} ms (recreate {:.2f} ms), "
+                         "max {:.2f} ms over {} resizes",
+              m_resize_last_ms, m_resize_recreate_ms, m_resize_max_ms, m_resize_count);
+          }
+          if (const FrustumCuller* culler = frustum_culler())
+          {
+            spdlog::info("Frustum culling: {} visible, {} culled of {} primitives{}",
+              culler->visible_count(), culler->culled_count(), culler->tested_count(),
+              m_raster_opaque_stage->gpu_driven() ? " (opaque draws culled on the GPU)" : "");
+          }
+          if (m_opaque_draws_sorted)
+          {
+            const DrawStateChanges& s = m_opaque_draw_list.sorted_changes();
+            const DrawStateChanges& l = m_opaque_draw_list.loader_order_changes();
+            spdlog::info("Opaque draw state changes for {} draws (sorted / loader order): "
+                         "pipeline {}/{}, cull mode {}/{}, stencil reference {}/{}, material {}/{}",
+              s.draws, s.pipelines, l.pipelines, s.cull_modes, l.cull_modes,
+              s.stencil_references, l.stencil_references, s.materials, l.materials);
+          }
+        }
+        else if (!args.empty() && args[0] == "barriers")
+        {
+          spdlog::info("{}{}", m_render_graph.barrier_plan().report(),
+            m_renderer->device().supports_synchronization2()
+              ? ""
+              : "\n(VK_KHR_synchronization2 unavailable: each batch is one vkCmdPipelineBarrier)");
+        }
+        else if (!args.empty() && args[0] == "graph")
+        {
+          spdlog::info("{}", m_render_graph.plan_report());
+        }
+        else if (args.empty() || args[0] == "memory")
+        {
+          const auto& device = m_renderer->device();
+          spdlog::info("{}{}", device.memory_stats().report(device.query_memory_budgets()),
+            device.supports_memory_budget() ? "" : "(VK_EXT_memory_budget unavailable: "
+                                                   "heap usage is app-tracked only)");
+        }
+        else
+        {
+          spdlog::warn("Unknown stats category: {}", args[0]);
+        }
+      });
+
+    // Register "bench" command for frame pacing comparisons
+    m_command_registry->add("bench", "Run a benchmark",
+      "<frames_in_flight [frames] | mesh_memory [frames] | blend_sort [primitives]>",
+      [this](const std::vector<std::string>& args)
+      {
+        if (args.empty() || args[0] == "frames_in_flight")
+        {
+          uint32_t frames = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : 300;
+          begin_frames_in_flight_bench(frames);
+        }
+        else if (args[0] == "mesh_memory")
+        {
+          // Current glTF scene with device-local, then host-visible vertex/index buffers
+          uint32_t frames = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : 300;
+          begin_mesh_memory_bench(frames);
+        }
+        else if (args[0] == "blend_sort")
+        {
+          // CPU only: synthetic scene, 100 frames of camera motion
+          uint32_t count = args.size() > 1 ? static_cast<uint32_t>(std::stoul(args[1])) : 10000;
+          spdlog::info("{}", benchmark_blend_sort(count, 100));
+        }
+        else
+        {
+          spdlog::warn("Unknown benchmark: {}", args[0]);
+        }
+      });
+
     spdlog::info("Command file: {}", std::filesystem::absolute(m_command_file_path).string());
   }
 
@@ -993,16 +1532,30 @@ void Application::load_model(int index)
   if (index == m_current_model_index)
     return;
 
-  m_renderer->device().wait_idle();
-  auto result = m_scene_manager->load_model(m_gltf_models[index]);
+  if (reload_scene(m_gltf_models[index]))
+    m_current_model_index = index;
+}
+
+bool Application::reload_scene(const std::string& path)
+{
+  m_renderer->device().wait_graphics_idle();
+  auto result = m_scene_manager->load_model(path);
   if (!result.success)
-    return;
+    return false;
+  m_opaque_draw_list.invalidate();
+  m_blend_draw_list.invalidate();
 
   // Reallocate material descriptors in graph for new materials
   m_render_graph.allocate_material_descriptors(
     m_scene_manager->default_texture_set(),
     m_scene_manager->material_texture_sets(),
-    { m_uniform_buffer->descriptor_info() });
+    m_scene_manager->material_params(),
+    m_scene_manager->instance_params(),
+    m_scene_manager->draw_params(),
+    uniform_buffer_infos());
+
+  // Shader variants for the new materials (compiled in the background)
+  m_raster_opaque_stage->set_material_features(m_scene_manager->material_features());
 
   // Camera + light reset
   if (result.bounds.valid())
@@ -1024,7 +1577,7 @@ void Application::load_model(int index)
   if (m_ray_tracing_stage && m_scene_manager->mesh())
     m_ray_tracing_stage->on_mesh_changed(*m_scene_manager->mesh(), m_scene_manager->scene(), m_scene_manager->ibl());
 
-  m_current_model_index = index;
+  return true;
 }
 
 void Application::load_hdr(int index)
@@ -1037,14 +1590,17 @@ void Application::load_hdr(int index)
   if (index == m_current_hdr_index)
     return;
 
-  m_renderer->device().wait_idle();
+  m_renderer->device().wait_graphics_idle();
   m_scene_manager->load_hdr(m_hdr_files[index]);
 
   // Reallocate material descriptors in graph (IBL textures changed)
   m_render_graph.allocate_material_descriptors(
     m_scene_manager->default_texture_set(),
     m_scene_manager->material_texture_sets(),
-    { m_uniform_buffer->descriptor_info() });
+    m_scene_manager->material_params(),
+    m_scene_manager->instance_params(),
+    m_scene_manager->draw_params(),
+    uniform_buffer_infos());
 
   m_current_hdr_index = index;
 
@@ -1109,11 +1665,14 @@ Application::~Application()
 {
   spdlog::trace("Destroying Application");
 
+  // Stop waiting on the swapchain before it is destroyed
+  m_present_waiter.reset();
+
   m_renderer->device().wait_idle();
 
   // Destroy resources before device
   m_scene_manager.reset();
-  m_uniform_buffer.reset();
+  m_uniform_buffers.clear();
 
   // Scene pipelines + layout destroyed by RasterOpaqueStage (via RenderGraph)
   m_renderer->device().device().destroyRenderPass(m_scene_renderpass);
@@ -1123,10 +1682,9 @@ Application::~Application()
   // Scene framebuffers destroyed by RenderGraph destructor
   m_renderer->device().device().destroyRenderPass(m_composite_renderpass);
 
-  // HDR + MSAA destroyed by RenderGraph destructor
+  // HDR + transient images (MSAA, SSS ping, RT storage) destroyed by RenderGraph destructor
   // Depth-stencil destroyed by renderer
-  // SSS blur resources destroyed by SSSBlurStage (via RenderGraph)
-  // RT resources destroyed by RayTracingStage (via RenderGraph)
+  // SSS blur and RT stage resources destroyed by their stages (via RenderGraph)
 
   // Swapchain destroyed in renderer
   // Surface ..
@@ -1144,26 +1702,28 @@ void Application::finalize_setup()
 
   // Populate shared image registry (before framebuffer and stage construction)
   m_render_graph.set_renderer(*m_renderer);
+  m_render_graph.set_bindless_requested(m_bindless_materials);
   m_render_graph.create_material_descriptor_layout();
   m_render_graph.create_hdr_resources();
   m_render_graph.image_registry().set("depth_stencil",
     { m_renderer->depth_stencil().image(), m_renderer->depth_stencil().stencil_view(),
       {}, m_renderer->depth_format() });
 
-  // Create scene framebuffers (uses registry images + scene render pass)
-  m_render_graph.create_scene_framebuffers();
-
   // Register render stages
   // Order within each phase doesn't matter — the render graph groups by phase.
   m_ray_tracing_stage = m_render_graph.add<RayTracingStage>(
-    *m_renderer, m_render_graph, &m_use_raytracing, m_uniform_buffer->buffer());
-  if (m_renderer->device().supports_ray_tracing() && m_scene_manager->mesh())
-    m_ray_tracing_stage->on_mesh_changed(*m_scene_manager->mesh(), m_scene_manager->scene(), m_scene_manager->ibl());
+    *m_renderer, m_render_graph, &m_use_raytracing, uniform_buffer_handles());
   create_raster_stages();
   m_sss_blur_stage = m_render_graph.add<SSSBlurStage>(
     *m_renderer, m_render_graph,
     &m_use_sss_blur, &m_use_raytracing,
     &m_sss_blur_width_r, &m_sss_blur_width_g, &m_sss_blur_width_b);
+  // Transparency is resolved over the blurred opaque scene
+  m_oit_accumulate_stage = m_render_graph.add<OitAccumulateStage>(*m_renderer, m_render_graph,
+    *m_raster_opaque_stage, &m_oit, &m_use_raytracing, &m_debug_2d_mode);
+  m_oit_resolve_stage =
+    m_render_graph.add<OitResolveStage>(*m_renderer, m_render_graph, *m_oit_accumulate_stage);
+  m_raster_blend_stage->set_oit_stage(m_oit_accumulate_stage);
   m_composite_stage = m_render_graph.add<CompositeStage>(
     *m_renderer, m_render_graph, m_composite_renderpass, &m_exposure, &m_tonemap_mode);
   m_render_graph.set_composite_stage(m_composite_stage);
@@ -1172,11 +1732,41 @@ void Application::finalize_setup()
     &m_debug_2d_mode, &m_debug_material_index);
   m_ui_stage = m_render_graph.add<UIStage>(&m_ui_render_callback);
 
+  // Intermediate phase on the compute queue when every stage in it allows it
+  // (before realizing transient images: their aliasing depends on it)
+  if (m_async_compute)
+    m_render_graph.set_async_compute(true);
+
+  // All transient images are declared now — create (and alias) them
+  m_render_graph.realize_transient_images();
+
+  // Create scene framebuffers (uses registry images, incl. transient MSAA target)
+  m_render_graph.create_scene_framebuffers();
+
+  // Worker threads for parallel command recording (the main thread records too)
+  if (m_recording_threads != 1)
+  {
+    m_worker_pool = std::make_unique<WorkerPool>(m_recording_threads == 0
+        ? WorkerPool::default_worker_count()
+        : m_recording_threads - 1);
+    m_render_graph.set_parallel_recording(m_worker_pool.get(), m_renderer->frames_in_flight());
+  }
+
+  // RT descriptors reference the transient storage image
+  if (m_renderer->device().supports_ray_tracing() && m_scene_manager->mesh())
+    m_ray_tracing_stage->on_mesh_changed(*m_scene_manager->mesh(), m_scene_manager->scene(), m_scene_manager->ibl());
+
   // Allocate material descriptors in graph (graph owns the pool and sets)
   m_render_graph.allocate_material_descriptors(
     m_scene_manager->default_texture_set(),
     m_scene_manager->material_texture_sets(),
-    { m_uniform_buffer->descriptor_info() });
+    m_scene_manager->material_params(),
+    m_scene_manager->instance_params(),
+    m_scene_manager->draw_params(),
+    uniform_buffer_infos());
+
+  // One PBR pipeline variant per material feature set
+  m_raster_opaque_stage->set_material_features(m_scene_manager->material_features());
 }
 
 VkInstance Application::vk_instance() const
@@ -1221,7 +1811,59 @@ bool Application::should_close() const
 
 void Application::poll_events()
 {
+  wait_for_frame_start();
+
+  m_frame_start_time = glfwGetTime();
+  m_input_event = false;
   m_renderer->window().poll();
+
+  // GLFW reports no event timestamps. Events queued up since the previous
+  // poll, so on average they arrived halfway between the two. The first poll
+  // has no previous one to bound them: no sample.
+  const bool bounded = m_input_event && m_last_poll_time > 0.0;
+  m_frame_input_time = bounded ? 0.5 * (m_last_poll_time + m_frame_start_time) : -1.0;
+  m_last_poll_time = glfwGetTime();
+}
+
+void Application::wait_for_frame_start()
+{
+  if (!m_renderer->low_latency_enabled())
+    return;
+
+  // The previous frame started on the GPU at submit (its queue was empty) and
+  // takes gpu_busy_ms. Start this frame so that its CPU part (input, update,
+  // record) ends just as the GPU frees up: input sampled any earlier would
+  // only wait in the queue. Without GPU timestamps there is nothing to go by.
+  constexpr double margin_ms = 0.5;
+  const double gpu_ms = m_frame_timer->average().gpu_busy_ms;
+  const double start =
+    m_last_submit_time + std::min(gpu_ms - m_cpu_frame_ms - margin_ms, 50.0) / 1000.0;
+
+  for (double now = glfwGetTime(); now < start; now = glfwGetTime())
+  {
+    const double remaining = start - now;
+    if (remaining > 0.002)
+      std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.001));
+    else
+      std::this_thread::yield();
+  }
+}
+
+void Application::collect_present_latencies()
+{
+  if (!m_present_waiter)
+    return;
+  for (const auto& displayed : m_present_waiter->take_displayed())
+    record_input_latency(displayed.input_time, displayed.display_time, true);
+}
+
+void Application::record_input_latency(double input_time, double photon_time, bool measured)
+{
+  auto& l = m_input_latency;
+  l.last_ms = (photon_time - input_time) * 1000.0;
+  l.average_ms = l.samples == 0 ? l.last_ms : 0.9 * l.average_ms + 0.1 * l.last_ms;
+  l.measured = measured;
+  ++l.samples;
 }
 
 void Application::wait_idle()
@@ -1235,6 +1877,36 @@ void Application::update_frame()
   update_uniform_buffer();
 }
 
+void Application::set_frames_in_flight(uint32_t count)
+{
+  // Renderer waits for the graphics timeline before rebuilding its ring
+  m_renderer->set_frames_in_flight(count);
+  m_frame_index = 0;
+  m_frame_timer = std::make_unique<FrameTimer>(m_renderer->device(), m_renderer->frames_in_flight());
+  m_render_graph.set_parallel_recording(m_worker_pool.get(), m_renderer->frames_in_flight());
+  if (m_uniform_buffers.size() == m_renderer->frames_in_flight())
+    return;
+
+  create_uniform_buffers();
+
+  // Per-frame descriptor sets reference the UBOs
+  m_render_graph.allocate_material_descriptors(
+    m_scene_manager->default_texture_set(),
+    m_scene_manager->material_texture_sets(),
+    m_scene_manager->material_params(),
+    m_scene_manager->instance_params(),
+    m_scene_manager->draw_params(),
+    uniform_buffer_infos());
+
+  if (m_ray_tracing_stage)
+  {
+    m_ray_tracing_stage->set_uniform_buffers(uniform_buffer_handles());
+    if (m_renderer->device().supports_ray_tracing() && m_scene_manager->mesh())
+      m_ray_tracing_stage->on_mesh_changed(
+        *m_scene_manager->mesh(), m_scene_manager->scene(), m_scene_manager->ibl());
+  }
+}
+
 void Application::set_vsync(bool enabled)
 {
   if (m_renderer->vsync_enabled() != enabled)
@@ -1244,4 +1916,17 @@ void Application::set_vsync(bool enabled)
     recreate_swapchain();
   }
 }
+
+void Application::set_low_latency(bool enabled)
+{
+  if (m_renderer->low_latency_enabled() != enabled)
+  {
+    m_renderer->low_latency_enabled() = enabled;
+    m_renderer->swapchain().set_low_latency(enabled);
+    recreate_swapchain();
+    m_input_latency = {};
+    spdlog::info("Low latency {}: present mode {}", enabled ? "on" : "off",
+      vk::to_string(m_renderer->swapchain().present_mode()));
+  }
+}
 }
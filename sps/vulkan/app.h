@@ -7,16 +7,22 @@
 #include <string>
 
 #include <sps/vulkan/app_config.h>
+#include <sps/vulkan/blend_draw_list.h>
 #include <sps/vulkan/camera.h>
 #include <sps/vulkan/command_registry.h>
+#include <sps/vulkan/frame_timer.h>
+#include <sps/vulkan/frustum_culler.h>
 #include <sps/vulkan/gltf_loader.h>
 #include <sps/vulkan/light.h>
 #include <sps/vulkan/mesh.h>
+#include <sps/vulkan/opaque_draw_list.h>
+#include <sps/vulkan/present_waiter.h>
 #include <sps/vulkan/render_graph.h>
 #include <sps/vulkan/renderer.h>
 #include <sps/vulkan/scene_manager.h>
 #include <sps/vulkan/texture.h>
 #include <sps/vulkan/uniform_buffer.h>
+#include <sps/vulkan/worker_pool.h>
 #include <vulkan/vulkan_handles.hpp>
 
 #include <glm/glm.hpp>
@@ -26,12 +32,27 @@ namespace sps::vulkan
 class CommandRegistry;
 class CompositeStage;
 class Debug2DStage;
+class DepthPrepassStage;
+class DrawCullStage;
+class HiZCullStage;
+class OcclusionDepthStage;
+class OitAccumulateStage;
+class OitResolveStage;
 class SSSBlurStage;
 class RasterOpaqueStage;
 class RasterBlendStage;
 class RayTracingStage;
 class UIStage;
 
+/// Input-to-photon latency of the frames that sampled new input events.
+struct InputLatency
+{
+  double last_ms{ 0.0 };
+  double average_ms{ 0.0 }; // exponential moving average
+  uint32_t samples{ 0 };
+  bool measured{ false }; // display time from VK_KHR_present_wait, else estimated
+};
+
 /// Uniform buffer object layout (must match shader std140 layout)
 /// Used for both rasterization and ray tracing
 struct UniformBufferObject
@@ -74,7 +95,9 @@ public:
   void run();
   void finalize_setup();
   void recreate_swapchain();
-  void record_draw_commands(vk::CommandBuffer, uint32_t imageIndex);
+  /// Record the frame; returns whether it was split for async compute
+  /// (the slot's compute and resume command buffers were recorded too).
+  bool record_draw_commands(vk::CommandBuffer, uint32_t imageIndex);
 
   void calculateFrameRate();
 
@@ -93,7 +116,7 @@ public:
   [[nodiscard]] uint32_t swapchain_image_count() const;
   [[nodiscard]] GLFWwindow* glfw_window() const;
   [[nodiscard]] bool should_close() const;
-  void poll_events();
+  void poll_events(); // Waits first in low-latency mode (see wait_for_frame_start())
   void wait_idle();
   void update_frame(); // Call process_input + update_uniform_buffer
 
@@ -129,6 +152,20 @@ public:
   Camera& camera() { return m_camera; }
   bool vsync_enabled() const { return m_renderer->vsync_enabled(); }
   void set_vsync(bool enabled);
+  // Low latency: MAILBOX when available, frame start delayed to just before the GPU frees up
+  bool low_latency_enabled() const { return m_renderer->low_latency_enabled(); }
+  void set_low_latency(bool enabled);
+  const InputLatency& input_latency() const { return m_input_latency; }
+
+  // Frames in flight (per-frame command buffers, semaphores, UBOs; paced by the graphics timeline)
+  uint32_t frames_in_flight() const { return m_renderer->frames_in_flight(); }
+  void set_frames_in_flight(uint32_t count); // Waits idle, rebuilds per-frame rings
+  void begin_frames_in_flight_bench(uint32_t frames_per_setting); // Time N=1,2,3 in turn
+  void tick_frames_in_flight_bench();                             // Called each frame
+
+  // Mesh memory: DEVICE_LOCAL (staged upload) or HOST_VISIBLE vertex/index buffers
+  void begin_mesh_memory_bench(uint32_t frames_per_mode); // Time both modes in turn
+  void tick_mesh_memory_bench();                          // Called each frame
 
   // Model switching
   const std::vector<std::string>& gltf_models() const { return m_gltf_models; }
@@ -177,6 +214,17 @@ public:
   // Call after ImGui to sync uniforms before render
   void sync_uniforms() { update_uniform_buffer(); }
 
+  // Frame pacing telemetry (CPU wait on the GPU, GPU busy/idle per frame)
+  const FrameTimings& frame_timings() const { return m_frame_timer->average(); }
+
+  // CPU frustum culling of the last frame (nullptr when it did not run)
+  const FrustumCuller* frustum_culler() const { return m_frustum_culled ? &m_frustum_culler : nullptr; }
+
+  // GPU memory telemetry
+  MemoryStats& memory_stats() const { return m_renderer->device().memory_stats(); }
+  std::vector<HeapBudget> memory_budgets() const { return m_renderer->device().query_memory_budgets(); }
+  bool memory_budget_supported() const { return m_renderer->device().supports_memory_budget(); }
+
   // Command file for remote control
   void poll_commands();
 
@@ -189,7 +237,13 @@ public:
 
 private:
   void setup_camera();
-  void create_uniform_buffer();
+  /// Whether OIT can be enabled; warns that sorted blending is used otherwise.
+  [[nodiscard]] bool oit_supported() const;
+  /// Load a glTF scene and rebuild everything that depends on it (waits idle).
+  bool reload_scene(const std::string& path);
+  void create_uniform_buffers();
+  std::vector<vk::DescriptorBufferInfo> uniform_buffer_infos() const;
+  std::vector<vk::Buffer> uniform_buffer_handles() const;
   void create_scene_renderpass();
   void create_raster_stages();
   void create_light_indicator();
@@ -197,6 +251,10 @@ private:
   void update_uniform_buffer();
   void process_input();
 
+  void wait_for_frame_start();
+  void collect_present_latencies();
+  void record_input_latency(double input_time, double photon_time, bool measured);
+
   static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
   static void mouse_callback(GLFWwindow* window, double xpos, double ypos);
   static void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
@@ -237,8 +295,32 @@ private:
   std::unique_ptr<Mesh> m_light_indicator_mesh;
   bool m_show_light_indicator{ true };
 
-  // Uniform buffer (using wrapper)
-  std::unique_ptr<UniformBuffer<UniformBufferObject>> m_uniform_buffer;
+  // Uniform buffers, one per frame in flight. update_uniform_buffer() fills
+  // m_ubo_data; render() copies it into the current frame's buffer once the
+  // graphics timeline has passed that frame's previous submission.
+  std::vector<std::unique_ptr<UniformBuffer<UniformBufferObject>>> m_uniform_buffers;
+  UniformBufferObject m_ubo_data{};
+  uint32_t m_frame_index{ 0 }; // 0..frames_in_flight-1
+  std::unique_ptr<FrameTimer> m_frame_timer;
+
+  // Resize latency: resize request -> first present on the new swapchain
+  double m_resize_requested{ 0.0 };   // glfwGetTime()
+  double m_resize_recreate_ms{ 0.0 }; // CPU time in recreate_swapchain()
+  bool m_resize_present_pending{ false };
+  uint32_t m_resize_count{ 0 };
+  double m_resize_last_ms{ 0.0 };
+  double m_resize_max_ms{ 0.0 };
+
+  // Low-latency pacing and input-to-photon latency (glfwGetTime() seconds)
+  bool m_input_event{ false };       // set by the input callbacks during poll_events()
+  double m_last_poll_time{ 0.0 };    // end of the previous poll_events() (0: none yet)
+  double m_frame_input_time{ -1.0 }; // estimated input time of this frame, -1 = none
+  double m_frame_start_time{ 0.0 };
+  double m_last_submit_time{ 0.0 };
+  double m_cpu_frame_ms{ 0.0 }; // frame start -> submit minus blocking waits (moving average)
+  uint64_t m_present_id{ 0 };
+  std::unique_ptr<PresentWaiter> m_present_waiter; // with VK_KHR_present_wait
+  InputLatency m_input_latency;
 
   // Lighting
   bool m_light_enabled{ true };
@@ -259,6 +341,22 @@ private:
 
   // Rendering mode toggles
   bool m_use_raytracing = false;    // Start with rasterization (R key to switch)
+  bool m_bindless_materials = true; // Bindless PBR materials when descriptor indexing is supported
+  uint32_t m_recording_threads = 0; // Command recording threads (0 = auto, 1 = serial)
+  bool m_async_compute = false;     // SSS blur on the async compute queue when available
+  bool m_gpu_driven_draws = true;   // Opaque draws from the GPU cull pass when supported
+  bool m_occlusion_culling = false; // Two-phase Hi-Z occlusion culling of GPU-driven draws
+  bool m_depth_prepass = false;     // Depth-only pre-pass, then opaque shading with EQUAL depth
+  bool m_oit = false;               // Weighted blended OIT instead of sorted BLEND draws
+  bool m_prewarm_shader_modes = false; // Build all shader modes' pipelines in the background
+  bool m_host_visible_meshes = false;  // Meshes in HOST_VISIBLE instead of DEVICE_LOCAL memory
+  bool m_frustum_culling = true;    // CPU frustum culling of raster scene draws
+  FrustumCuller m_frustum_culler;
+  bool m_frustum_culled = false;    // m_frustum_culler holds this frame's result
+  bool m_draw_sorting = true;       // State-sorted CPU-recorded opaque draws
+  OpaqueDrawList m_opaque_draw_list;
+  bool m_opaque_draws_sorted = false; // m_opaque_draw_list holds this frame's order
+  BlendDrawList m_blend_draw_list;  // Back-to-front BLEND draws, rebuilt each frame
   bool m_use_normal_mapping = true; // Normal mapping enabled by default
   bool m_use_emissive = true;       // Emissive texture enabled by default
   bool m_use_ao = true;             // Ambient occlusion enabled by default
@@ -273,6 +371,24 @@ private:
   int m_screenshot_all_restore = -1;     // model index to restore after completion
   int m_screenshot_all_frames_wait = 0;  // frames to wait after model load before capture
 
+  // Frames-in-flight benchmark state machine
+  int m_fif_bench_count = -1;        // -1 = not active, else frames in flight being measured
+  uint32_t m_fif_bench_restore = 0;  // frames in flight to restore after completion
+  uint32_t m_fif_bench_frames = 0;   // measured frames per setting
+  int m_fif_bench_frame = 0;         // <0 = warm-up, else measured frames so far
+  double m_fif_bench_start = 0.0;    // glfwGetTime() at the first measured frame
+  FrameTimings m_fif_bench_sum;      // accumulated timings over measured frames
+  std::vector<std::string> m_fif_bench_results;
+
+  // Mesh memory benchmark state machine
+  int m_mesh_bench_mode = -1;        // -1 = not active, 0 = device-local, 1 = host-visible
+  uint32_t m_mesh_bench_frames = 0;  // measured frames per mode
+  int m_mesh_bench_frame = 0;        // <0 = warm-up, else measured frames so far
+  double m_mesh_bench_start = 0.0;   // glfwGetTime() at the first measured frame
+  FrameTimings m_mesh_bench_sum;     // accumulated timings over measured frames
+  std::string m_mesh_bench_path;     // glTF scene reloaded in each mode
+  std::vector<std::string> m_mesh_bench_results;
+
   // 2D Debug mode
   bool m_debug_2d_mode = false;
   int m_debug_texture_index = 0;              // Which texture to display
@@ -290,13 +406,20 @@ private:
   std::filesystem::file_time_type m_command_file_mtime = std::filesystem::file_time_type::min();
 
 
-  // Render graph (stage-based command recording)
+  // Render graph (stage-based command recording); the worker pool outlives it
+  std::unique_ptr<WorkerPool> m_worker_pool;
   RenderGraph m_render_graph;
   CompositeStage* m_composite_stage{ nullptr };
   SSSBlurStage* m_sss_blur_stage{ nullptr };
   Debug2DStage* m_debug_2d_stage{ nullptr };
   RasterOpaqueStage* m_raster_opaque_stage{ nullptr };
   RasterBlendStage* m_raster_blend_stage{ nullptr };
+  DepthPrepassStage* m_depth_prepass_stage{ nullptr };
+  DrawCullStage* m_draw_cull_stage{ nullptr };
+  OcclusionDepthStage* m_occlusion_depth_stage{ nullptr };
+  HiZCullStage* m_hiz_cull_stage{ nullptr };
+  OitAccumulateStage* m_oit_accumulate_stage{ nullptr };
+  OitResolveStage* m_oit_resolve_stage{ nullptr };
   RayTracingStage* m_ray_tracing_stage{ nullptr };
   UIStage* m_ui_stage{ nullptr };
 };
@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 #include <toml.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 
@@ -52,6 +53,12 @@ AppConfig parse_toml(const std::string& file_name)
   {
     spdlog::info("Preferred GPU from config: {}", c.preferred_gpu);
   }
+  c.pipeline_cache_dir =
+    toml::find_or<std::string>(cfg, "vulkan", "pipeline_cache_dir", c.pipeline_cache_dir);
+  c.runtime_shader_compilation =
+    toml::find_or<bool>(cfg, "vulkan", "runtime_shader_compilation", false);
+  c.shader_cache_dir =
+    toml::find_or<std::string>(cfg, "vulkan", "shader_cache_dir", c.shader_cache_dir);
 
   // [application.window]
   const auto& wmodestr =
@@ -103,6 +110,48 @@ AppConfig parse_toml(const std::string& file_name)
   c.use_raytracing = (render_mode == "raytracing");
   spdlog::trace("Rendering mode: {}", render_mode);
 
+  c.bindless_materials = toml::find_or<bool>(
+    cfg, "application", "rendering", "bindless_materials", true);
+  spdlog::trace("Bindless materials: {}", c.bindless_materials);
+
+  c.frames_in_flight = static_cast<uint32_t>(std::max(1,
+    toml::find_or<int>(cfg, "application", "rendering", "frames_in_flight", 2)));
+  spdlog::trace("Frames in flight (config): {}", c.frames_in_flight);
+
+  c.recording_threads = static_cast<uint32_t>(std::max(0,
+    toml::find_or<int>(cfg, "application", "rendering", "recording_threads", 0)));
+  spdlog::trace("Recording threads (config): {}", c.recording_threads);
+
+  c.async_compute = toml::find_or<bool>(cfg, "application", "rendering", "async_compute", false);
+  spdlog::trace("Async compute (config): {}", c.async_compute);
+
+  c.gpu_driven_draws =
+    toml::find_or<bool>(cfg, "application", "rendering", "gpu_driven_draws", true);
+  spdlog::trace("GPU-driven draws (config): {}", c.gpu_driven_draws);
+
+  c.occlusion_culling =
+    toml::find_or<bool>(cfg, "application", "rendering", "occlusion_culling", false);
+  spdlog::trace("Occlusion culling (config): {}", c.occlusion_culling);
+
+  c.depth_prepass = toml::find_or<bool>(cfg, "application", "rendering", "depth_prepass", false);
+  spdlog::trace("Depth pre-pass (config): {}", c.depth_prepass);
+
+  c.order_independent_transparency = toml::find_or<bool>(
+    cfg, "application", "rendering", "order_independent_transparency", false);
+  spdlog::trace(
+    "Order-independent transparency (config): {}", c.order_independent_transparency);
+
+  c.prewarm_shader_modes = toml::find_or<bool>(
+    cfg, "application", "rendering", "prewarm_shader_modes", false);
+  spdlog::trace("Prewarm shader modes (config): {}", c.prewarm_shader_modes);
+
+  c.low_latency = toml::find_or<bool>(cfg, "application", "rendering", "low_latency", false);
+  spdlog::trace("Low latency (config): {}", c.low_latency);
+
+  c.host_visible_meshes =
+    toml::find_or<bool>(cfg, "application", "rendering", "host_visible_meshes", false);
+  spdlog::trace("Host-visible meshes (config): {}", c.host_visible_meshes);
+
   // [application.geometry]
   c.geometry_source = toml::find_or<std::string>(
     cfg, "application", "geometry", "source", "triangle");
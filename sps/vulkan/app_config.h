@@ -19,6 +19,9 @@ struct AppConfig
 {
   // [vulkan]
   std::string preferred_gpu;
+  std::string pipeline_cache_dir{ "pipeline_cache" };
+  bool runtime_shader_compilation{ false };
+  std::string shader_cache_dir{ "shader_cache" };
 
   // [application.window]
   Window::Mode window_mode{ Window::Mode::WINDOWED };
@@ -30,6 +33,17 @@ struct AppConfig
   bool backface_culling{ true };
   vk::SampleCountFlagBits msaa_samples{ vk::SampleCountFlagBits::e1 };
   bool use_raytracing{ false };
+  bool bindless_materials{ true };
+  uint32_t frames_in_flight{ 2 };
+  uint32_t recording_threads{ 0 }; // 0 = auto, 1 = serial recording
+  bool async_compute{ false };     // SSS blur on a dedicated compute queue
+  bool gpu_driven_draws{ true };   // opaque draws generated by a compute pass
+  bool occlusion_culling{ false }; // Hi-Z occlusion culling of GPU-driven draws
+  bool depth_prepass{ false };     // depth-only pre-pass before opaque shading
+  bool order_independent_transparency{ false }; // weighted blended OIT instead of sorting
+  bool prewarm_shader_modes{ false }; // build every shader mode's pipelines at startup
+  bool low_latency{ false };          // mailbox present + just-in-time frame starts
+  bool host_visible_meshes{ false };  // vertex/index buffers in HOST_VISIBLE memory
 
   // [application.geometry]
   std::string geometry_source{ "triangle" };
@@ -0,0 +1,538 @@
+#include <sps/vulkan/barrier_plan.h>
+
+#include <spdlog/spdlog.h>
+
+#include <sstream>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+constexpr vk::AccessFlags2 WRITE_ACCESS = vk::AccessFlagBits2::eShaderWrite
+  | vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+  | vk::AccessFlagBits2::eTransferWrite;
+
+struct UsageInfo
+{
+  vk::PipelineStageFlags2 stages;
+  vk::AccessFlags2 read;
+  vk::AccessFlags2 write;
+  vk::ImageLayout layout;
+};
+
+UsageInfo usage_info(ImageUsage usage)
+{
+  using S = vk::PipelineStageFlagBits2;
+  using A = vk::AccessFlagBits2;
+  using L = vk::ImageLayout;
+
+  switch (usage)
+  {
+    case ImageUsage::ColorAttachment:
+      return { S::eColorAttachmentOutput, A::eColorAttachmentRead, A::eColorAttachmentWrite,
+        L::eColorAttachmentOptimal };
+    case ImageUsage::DepthStencilAttachment:
+      return { S::eEarlyFragmentTests | S::eLateFragmentTests, A::eDepthStencilAttachmentRead,
+        A::eDepthStencilAttachmentWrite, L::eDepthStencilAttachmentOptimal };
+    case ImageUsage::DepthStencilReadOnly:
+      return { S::eEarlyFragmentTests | S::eLateFragmentTests, A::eDepthStencilAttachmentRead, {},
+        L::eDepthStencilReadOnlyOptimal };
+    case ImageUsage::DepthStencilSampled:
+      return { S::eComputeShader, A::eShaderRead, {}, L::eDepthStencilReadOnlyOptimal };
+    case ImageUsage::SampledFragment:
+      return { S::eFragmentShader, A::eShaderRead, {}, L::eShaderReadOnlyOptimal };
+    case ImageUsage::SampledCompute:
+      return { S::eComputeShader, A::eShaderRead, {}, L::eShaderReadOnlyOptimal };
+    case ImageUsage::StorageCompute:
+      return { S::eComputeShader, A::eShaderRead, A::eShaderWrite, L::eGeneral };
+    case ImageUsage::StorageRayTracing:
+      return { S::eRayTracingShaderKHR, A::eShaderRead, A::eShaderWrite, L::eGeneral };
+    case ImageUsage::TransferSrc:
+      return { S::eTransfer, A::eTransferRead, {}, L::eTransferSrcOptimal };
+    case ImageUsage::TransferDst:
+      return { S::eTransfer, {}, A::eTransferWrite, L::eTransferDstOptimal };
+  }
+  return {};
+}
+
+vk::ImageAspectFlags aspect_for(vk::Format format)
+{
+  switch (format)
+  {
+    case vk::Format::eD16UnormS8Uint:
+    case vk::Format::eD24UnormS8Uint:
+    case vk::Format::eD32SfloatS8Uint:
+      return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+    case vk::Format::eD16Unorm:
+    case vk::Format::eX8D24UnormPack32:
+    case vk::Format::eD32Sfloat:
+      return vk::ImageAspectFlagBits::eDepth;
+    case vk::Format::eS8Uint:
+      return vk::ImageAspectFlagBits::eStencil;
+    default:
+      return vk::ImageAspectFlagBits::eColor;
+  }
+}
+
+const char* phase_name(Phase phase)
+{
+  switch (phase)
+  {
+    case Phase::PrePass:
+      return "PrePass";
+    case Phase::ScenePass:
+      return "ScenePass";
+    case Phase::Intermediate:
+      return "Intermediate";
+    case Phase::CompositePass:
+      return "CompositePass";
+  }
+  return "?";
+}
+
+// Legacy masks: every stage and access bit the plan uses has the same value
+// in the synchronization2 enums
+vk::PipelineStageFlags legacy_stages(vk::PipelineStageFlags2 stages)
+{
+  return vk::PipelineStageFlags(
+    static_cast<VkPipelineStageFlags>(static_cast<VkPipelineStageFlags2>(stages)));
+}
+
+vk::AccessFlags legacy_access(vk::AccessFlags2 access)
+{
+  return vk::AccessFlags(static_cast<VkAccessFlags>(static_cast<VkAccessFlags2>(access)));
+}
+
+/// Declarations of the active stages merged for one phase.
+struct PhaseUse
+{
+  Phase phase;
+  ImageState entry;  // what the phase needs
+  ImageState exit;   // what the phase leaves behind
+  bool reads{ false }; // any stage needs the previous contents
+};
+
+/// Hazard tracking for one image while walking its phases.
+struct Tracker
+{
+  vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+  vk::PipelineStageFlags2 write_stages{}; // last write
+  vk::AccessFlags2 write_access{};
+  vk::PipelineStageFlags2 read_stages{};    // reads since the last write
+  vk::PipelineStageFlags2 visible_stages{}; // stages the last write is visible to
+  uint32_t queue_family{ VK_QUEUE_FAMILY_IGNORED }; // owner of the contents
+
+  void add_previous_use(const ImageState& state)
+  {
+    if (state.access & WRITE_ACCESS)
+    {
+      write_stages |= state.stages;
+      write_access |= state.access & WRITE_ACCESS;
+    }
+    read_stages |= state.stages;
+  }
+
+  [[nodiscard]] ImageState state() const
+  {
+    return { write_stages | read_stages, write_access, layout };
+  }
+};
+
+void record_batch(vk::CommandBuffer cmd, const std::vector<PlannedBarrier>& batch, bool synchronization2)
+{
+  if (batch.empty())
+    return;
+
+  if (synchronization2)
+  {
+    std::vector<vk::ImageMemoryBarrier2> barriers;
+    barriers.reserve(batch.size());
+    for (const auto& planned : batch)
+    {
+      vk::ImageMemoryBarrier2 barrier{};
+      barrier.srcStageMask = planned.src.stages;
+      barrier.srcAccessMask = planned.src.access;
+      barrier.dstStageMask = planned.dst.stages;
+      barrier.dstAccessMask = planned.dst.access;
+      barrier.oldLayout = planned.src.layout;
+      barrier.newLayout = planned.dst.layout;
+      barrier.srcQueueFamilyIndex = planned.src_queue_family;
+      barrier.dstQueueFamilyIndex = planned.dst_queue_family;
+      barrier.image = planned.image;
+      barrier.subresourceRange = vk::ImageSubresourceRange{ planned.aspect, 0, 1, 0, 1 };
+      barriers.push_back(barrier);
+    }
+
+    vk::DependencyInfo dependency{};
+    dependency.imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+    dependency.pImageMemoryBarriers = barriers.data();
+    cmd.pipelineBarrier2KHR(dependency);
+    return;
+  }
+
+  // One legacy barrier: per-image masks are unioned
+  vk::PipelineStageFlags srcStages{};
+  vk::PipelineStageFlags dstStages{};
+  std::vector<vk::ImageMemoryBarrier> barriers;
+  barriers.reserve(batch.size());
+  for (const auto& planned : batch)
+  {
+    srcStages |= legacy_stages(planned.src.stages);
+    dstStages |= legacy_stages(planned.dst.stages);
+
+    vk::ImageMemoryBarrier barrier{};
+    barrier.srcAccessMask = legacy_access(planned.src.access);
+    barrier.dstAccessMask = legacy_access(planned.dst.access);
+    barrier.oldLayout = planned.src.layout;
+    barrier.newLayout = planned.dst.layout;
+    barrier.srcQueueFamilyIndex = planned.src_queue_family;
+    barrier.dstQueueFamilyIndex = planned.dst_queue_family;
+    barrier.image = planned.image;
+    barrier.subresourceRange = vk::ImageSubresourceRange{ planned.aspect, 0, 1, 0, 1 };
+    barriers.push_back(barrier);
+  }
+  // Releases have no destination stages
+  if (!srcStages)
+    srcStages = vk::PipelineStageFlagBits::eTopOfPipe;
+  if (!dstStages)
+    dstStages = vk::PipelineStageFlagBits::eBottomOfPipe;
+
+  cmd.pipelineBarrier(srcStages, dstStages, {}, {}, {}, barriers);
+}
+
+} // anonymous namespace
+
+ImageState image_usage_state(ImageUsage usage, AccessIntent intent)
+{
+  const UsageInfo info = usage_info(usage);
+  ImageState state{ info.stages, info.read, info.layout };
+  if (intent != AccessIntent::Read)
+    state.access |= info.write;
+  return state;
+}
+
+BarrierPlan BarrierPlan::compile(const SharedImageRegistry& registry,
+  const ActivePredicate& is_active,
+  const std::map<std::string, ImageState>& entry_states,
+  const std::map<std::string, int>& alias_slots,
+  const PhaseQueueFamilies& queue_families)
+{
+  BarrierPlan plan;
+  const uint32_t home_family = queue_families[static_cast<size_t>(Phase::ScenePass)];
+  plan.m_final_states = entry_states;
+
+  // Merge the active declarations of each image per phase (sorted by name
+  // so the plan and its dump are deterministic)
+  std::map<std::string, std::vector<PhaseUse>> uses;
+  for (const auto& [name, records] : registry.all_access_records())
+  {
+    const auto* entry = registry.get(name);
+    if (!entry || !entry->image)
+      continue;
+
+    std::vector<PhaseUse> image_uses;
+    for (int p = 0; p < 4; ++p)
+    {
+      const auto phase = static_cast<Phase>(p);
+      PhaseUse* use = nullptr;
+      for (const auto& record : records)
+      {
+        if (record.phase != phase || !is_active(record))
+          continue;
+
+        const ImageState entry_state = image_usage_state(record.usage, record.intent);
+        const ImageState exit_state = record.final_usage
+          ? image_usage_state(*record.final_usage, record.intent)
+          : entry_state;
+
+        if (!use)
+        {
+          use = &image_uses.emplace_back(PhaseUse{ phase, entry_state, exit_state });
+        }
+        else
+        {
+          // Stages of a phase hand the image on in the layout the previous one left it in
+          if (use->exit.layout != entry_state.layout)
+          {
+            spdlog::warn("Barrier plan: '{}' is used in conflicting layouts within {} ({} gets {})",
+              name, phase_name(phase), record.stage_name, vk::to_string(use->exit.layout));
+          }
+          use->entry.stages |= entry_state.stages;
+          use->entry.access |= entry_state.access;
+          use->exit.stages |= exit_state.stages;
+          use->exit.access |= exit_state.access;
+          use->exit.layout = exit_state.layout;
+        }
+        use->reads = use->reads || record.intent != AccessIntent::Write;
+      }
+    }
+
+    if (!image_uses.empty())
+      uses[name] = std::move(image_uses);
+  }
+
+  auto entry_state_of = [&](const std::string& name)
+  {
+    auto it = entry_states.find(name);
+    return it != entry_states.end() ? it->second : ImageState{};
+  };
+
+  for (const auto& [name, image_uses] : uses)
+  {
+    const auto* entry = registry.get(name);
+
+    Tracker tracker;
+    tracker.add_previous_use(entry_state_of(name));
+    tracker.layout = entry_state_of(name).layout;
+    tracker.queue_family = home_family;
+    const PhaseUse* previous = nullptr; // last use this frame
+
+    // Queue family of the image's last use, in the previous frame as well
+    // when it ran this plan
+    const uint32_t last_family = queue_families[static_cast<size_t>(image_uses.back().phase)];
+
+    // First use of the frame: a pure write discards the previous contents
+    const PhaseUse& first = image_uses.front();
+    if (!first.reads)
+      tracker.layout = vk::ImageLayout::eUndefined;
+
+    // Aliased memory: also wait for the most recent use of every other image
+    // in the slot (earlier this frame, or else in the previous frame)
+    bool aliased = false;
+    if (auto slot = alias_slots.find(name); slot != alias_slots.end())
+    {
+      for (const auto& [other, other_slot] : alias_slots)
+      {
+        if (other == name || other_slot != slot->second)
+          continue;
+
+        ImageState last = entry_state_of(other);
+        if (auto other_uses = uses.find(other); other_uses != uses.end())
+        {
+          for (const auto& use : other_uses->second)
+          {
+            if (static_cast<int>(use.phase) < static_cast<int>(first.phase))
+              last = use.exit;
+          }
+        }
+        tracker.add_previous_use(last);
+        aliased = true;
+      }
+      if (aliased)
+        tracker.layout = vk::ImageLayout::eUndefined;
+    }
+
+    for (const auto& use : image_uses)
+    {
+      const uint32_t family = queue_families[static_cast<size_t>(use.phase)];
+      const bool queue_change = family != tracker.queue_family;
+      if (queue_change && !previous && tracker.layout != vk::ImageLayout::eUndefined)
+      {
+        // The release would belong to the previous frame
+        spdlog::warn("Barrier plan: '{}' is first used on queue family {} in {}; "
+                     "its previous contents are discarded",
+          name, family, phase_name(use.phase));
+        tracker.layout = vk::ImageLayout::eUndefined;
+      }
+      const bool transfer = queue_change && tracker.layout != vk::ImageLayout::eUndefined;
+
+      const bool transition = tracker.layout != use.entry.layout;
+      const bool writes = static_cast<bool>(use.entry.access & WRITE_ACCESS);
+      const bool pending_write = static_cast<bool>(tracker.write_access)
+        && static_cast<bool>(use.entry.stages & ~tracker.visible_stages);
+      const bool write_after_write = writes && static_cast<bool>(tracker.write_access);
+      const bool write_after_read = writes && static_cast<bool>(tracker.read_stages);
+
+      if (transfer || transition || pending_write || write_after_write || write_after_read)
+      {
+        const bool memory = transfer || transition || pending_write || write_after_write;
+
+        PlannedBarrier barrier{};
+        barrier.image_name = name;
+        barrier.image = entry->image;
+        barrier.aspect = aspect_for(entry->format);
+        barrier.aliased = aliased && &use == &first;
+        barrier.src.layout = tracker.layout;
+        barrier.src.stages = transition || transfer
+          ? tracker.write_stages | tracker.read_stages
+          : (memory ? tracker.write_stages : vk::PipelineStageFlags2{})
+            | (write_after_read ? tracker.read_stages : vk::PipelineStageFlags2{});
+        barrier.src.access = memory ? tracker.write_access : vk::AccessFlags2{};
+        barrier.dst = use.entry;
+        if (!memory)
+          barrier.dst.access = {}; // write-after-read: execution dependency only
+
+        if (transfer)
+        {
+          // Release on the old queue (source half), acquire on the new one
+          // (destination half); both carry the same layout transition
+          barrier.src_queue_family = tracker.queue_family;
+          barrier.dst_queue_family = family;
+
+          PlannedBarrier release = barrier;
+          release.dst.stages = {};
+          release.dst.access = {};
+          plan.m_releases[static_cast<size_t>(previous->phase)].push_back(std::move(release));
+
+          // The semaphore wait covers the acquire's stages, which chains it
+          barrier.src.stages = barrier.dst.stages;
+          barrier.src.access = {};
+          plan.m_wait_stages[static_cast<size_t>(use.phase)] |= barrier.dst.stages;
+          plan.m_batches[static_cast<size_t>(use.phase)].push_back(std::move(barrier));
+        }
+        else
+        {
+          // Work on the other queue is ordered by the semaphore between them,
+          // waited for in the stages of this barrier. When the previous frame
+          // left the image there, the source scope stays too in case that
+          // frame ran a different plan.
+          const bool from_previous_frame = !previous && last_family != family;
+          if (queue_change)
+          {
+            barrier.src.stages = barrier.dst.stages;
+            barrier.src.access = {};
+          }
+          else if (from_previous_frame)
+          {
+            barrier.src.stages |= barrier.dst.stages;
+          }
+          if (queue_change || from_previous_frame)
+            plan.m_wait_stages[static_cast<size_t>(use.phase)] |= barrier.dst.stages;
+
+          // Nothing earlier to wait for and nothing to transition
+          if (transition || barrier.src.stages)
+            plan.m_batches[static_cast<size_t>(use.phase)].push_back(std::move(barrier));
+        }
+
+        tracker.visible_stages = transition || transfer
+          ? use.entry.stages
+          : tracker.visible_stages | use.entry.stages;
+      }
+
+      // The phase's own accesses become the next phase's hazards
+      tracker.layout = use.exit.layout;
+      tracker.queue_family = family;
+      previous = &use;
+      if (use.exit.access & WRITE_ACCESS)
+      {
+        tracker.write_stages = use.exit.stages;
+        tracker.write_access = use.exit.access & WRITE_ACCESS;
+        tracker.read_stages = {};
+        tracker.visible_stages = {};
+      }
+      else
+      {
+        tracker.read_stages |= use.exit.stages;
+      }
+    }
+
+    // Only the home family carries contents into the next frame
+    if (tracker.queue_family != home_family && first.reads && !aliased)
+    {
+      spdlog::warn("Barrier plan: '{}' ends the frame on queue family {}; "
+                   "the next frame discards its contents",
+        name, tracker.queue_family);
+      tracker.layout = vk::ImageLayout::eUndefined;
+    }
+
+    plan.m_final_states[name] = tracker.state();
+  }
+
+  return plan;
+}
+
+void BarrierPlan::record(vk::CommandBuffer cmd, Phase phase, bool synchronization2) const
+{
+  record_batch(cmd, m_batches[static_cast<size_t>(phase)], synchronization2);
+}
+
+void BarrierPlan::record_releases(vk::CommandBuffer cmd, Phase phase, bool synchronization2) const
+{
+  record_batch(cmd, m_releases[static_cast<size_t>(phase)], synchronization2);
+}
+
+vk::PipelineStageFlags BarrierPlan::queue_wait_stages(Phase phase) const
+{
+  return legacy_stages(m_wait_stages[static_cast<size_t>(phase)]);
+}
+
+bool BarrierPlan::same_barriers(const BarrierPlan& other) const
+{
+  auto same_batch = [](const std::vector<PlannedBarrier>& a, const std::vector<PlannedBarrier>& b)
+  {
+    if (a.size() != b.size())
+      return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+      if (a[i].image != b[i].image || a[i].src.stages != b[i].src.stages
+        || a[i].src.access != b[i].src.access || a[i].src.layout != b[i].src.layout
+        || a[i].dst.stages != b[i].dst.stages || a[i].dst.access != b[i].dst.access
+        || a[i].dst.layout != b[i].dst.layout || a[i].src_queue_family != b[i].src_queue_family
+        || a[i].dst_queue_family != b[i].dst_queue_family)
+        return false;
+    }
+    return true;
+  };
+
+  for (size_t p = 0; p < m_batches.size(); ++p)
+  {
+    if (!same_batch(m_batches[p], other.m_batches[p])
+      || !same_batch(m_releases[p], other.m_releases[p])
+      || m_wait_stages[p] != other.m_wait_stages[p])
+      return false;
+  }
+  return true;
+}
+
+std::string BarrierPlan::report() const
+{
+  std::ostringstream out;
+  auto write_barrier = [&](const PlannedBarrier& b, const char* transfer)
+  {
+    out << "\n    " << b.image_name << (b.aliased ? " (aliased)" : "") << ": "
+        << vk::to_string(b.src.layout) << " -> " << vk::to_string(b.dst.layout);
+    if (b.src_queue_family != b.dst_queue_family)
+    {
+      out << " (" << transfer << ", queue family " << b.src_queue_family << " -> "
+          << b.dst_queue_family << ")";
+    }
+    out << "\n      src " << vk::to_string(b.src.stages) << " " << vk::to_string(b.src.access)
+        << "\n      dst " << vk::to_string(b.dst.stages) << " " << vk::to_string(b.dst.access);
+  };
+
+  out << "Barrier plan:";
+  for (size_t p = 0; p < m_batches.size(); ++p)
+  {
+    const auto& batch = m_batches[p];
+    out << "\n  before " << phase_name(static_cast<Phase>(p)) << ": ";
+    if (batch.empty())
+    {
+      out << "none";
+      continue;
+    }
+    out << batch.size() << (batch.size() == 1 ? " barrier" : " barriers");
+    for (const auto& b : batch)
+    {
+      write_barrier(b, "acquire");
+    }
+    if (m_wait_stages[p])
+      out << "\n    waits for the other queue in " << vk::to_string(m_wait_stages[p]);
+  }
+  for (size_t p = 0; p < m_releases.size(); ++p)
+  {
+    const auto& batch = m_releases[p];
+    if (batch.empty())
+      continue;
+    out << "\n  after " << phase_name(static_cast<Phase>(p)) << ": " << batch.size()
+        << (batch.size() == 1 ? " release" : " releases");
+    for (const auto& b : batch)
+    {
+      write_barrier(b, "release");
+    }
+  }
+  return out.str();
+}
+
+} // namespace sps::vulkan
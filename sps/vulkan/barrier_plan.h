@@ -0,0 +1,138 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+#include <sps/vulkan/shared_image_registry.h>
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+/// Synchronization state of an image: the pipeline stages and access types
+/// of its most recent use, and its current layout.
+struct ImageState
+{
+  vk::PipelineStageFlags2 stages{};
+  vk::AccessFlags2 access{};
+  vk::ImageLayout layout{ vk::ImageLayout::eUndefined };
+};
+
+/// State an image must be in for a given usage and intent.
+/// Read intents get only the usage's read access types.
+[[nodiscard]] ImageState image_usage_state(ImageUsage usage, AccessIntent intent);
+
+/// One image layout transition and/or memory dependency.
+struct PlannedBarrier
+{
+  std::string image_name;
+  vk::Image image;
+  vk::ImageAspectFlags aspect;
+  ImageState src;
+  ImageState dst;
+  bool aliased{ false }; // src covers images sharing this image's memory
+  // Queue family ownership transfer (VK_QUEUE_FAMILY_IGNORED when none)
+  uint32_t src_queue_family{ VK_QUEUE_FAMILY_IGNORED };
+  uint32_t dst_queue_family{ VK_QUEUE_FAMILY_IGNORED };
+};
+
+/// Queue family that executes each phase, indexed by Phase.
+using PhaseQueueFamilies = std::array<uint32_t, 4>;
+
+/// Inter-phase image barriers for one frame, compiled from the access
+/// declarations in a SharedImageRegistry.
+///
+/// For every image, the declarations of the active stages are merged per
+/// phase, in declaration order: a stage that transitions the image itself
+/// (AccessRecord::final_usage) hands it to the next stage of the phase in that
+/// layout, and the phase exits in the last one. Before each phase that uses an
+/// image, the plan inserts a barrier from the image's previous use (earlier
+/// phase, or the previous frame) when the layout changes, the previous use
+/// wrote, or this use writes.
+/// Read-after-read in the same layout needs nothing. Only write access types
+/// are made available; a write-after-read gets an execution dependency only.
+///
+/// An image whose first use in the frame is a pure Write is transitioned from
+/// eUndefined (contents discarded). For transient images that share memory,
+/// that first barrier also waits for the last use of every alias.
+///
+/// Phases may run on different queue families (e.g. Intermediate on an async
+/// compute queue). When an image whose contents are still needed changes
+/// family, the plan splits its barrier into a release, recorded after the
+/// phase that last used it, and an acquire before the phase that uses it next;
+/// the caller orders the two with a semaphore. Discarded contents need no
+/// transfer. The ScenePass family is the home family: images whose contents
+/// the next frame reads must end the frame there.
+/// A barrier that follows work on the other queue (this frame's, or the
+/// previous frame's for an image left there) includes its own stages in its
+/// source scope, so a semaphore wait in those stages chains into it;
+/// queue_wait_stages() reports them per phase.
+///
+/// All barriers before a phase are recorded as one batched
+/// vkCmdPipelineBarrier2 (VK_KHR_synchronization2), or one vkCmdPipelineBarrier
+/// with the union of the stage masks when the extension is unavailable.
+class BarrierPlan
+{
+public:
+  /// Decides whether an access declaration takes part in this frame.
+  using ActivePredicate = std::function<bool(const AccessRecord&)>;
+
+  /// Compile the plan.
+  /// @param registry Image handles and access declarations.
+  /// @param is_active Filters declarations of stages that do not run this frame.
+  /// @param entry_states State each image was left in by the previous frame
+  ///   (missing images are assumed eUndefined and unused).
+  /// @param alias_slots Transient image name -> shared memory slot.
+  /// @param queue_families Queue family of each phase.
+  [[nodiscard]] static BarrierPlan compile(const SharedImageRegistry& registry,
+    const ActivePredicate& is_active,
+    const std::map<std::string, ImageState>& entry_states,
+    const std::map<std::string, int>& alias_slots,
+    const PhaseQueueFamilies& queue_families);
+
+  /// Record the barriers that precede a phase (no-op when there are none).
+  /// @param synchronization2 Use vkCmdPipelineBarrier2KHR.
+  void record(vk::CommandBuffer cmd, Phase phase, bool synchronization2) const;
+
+  /// Record the ownership releases that follow a phase (no-op when there are none).
+  void record_releases(vk::CommandBuffer cmd, Phase phase, bool synchronization2) const;
+
+  /// Stages in which a phase's barriers depend on work submitted to the other
+  /// queue; the phase's submission waits for that work there (legacy mask,
+  /// empty when the phase has no such dependency).
+  [[nodiscard]] vk::PipelineStageFlags queue_wait_stages(Phase phase) const;
+
+  /// Barriers that precede a phase.
+  [[nodiscard]] const std::vector<PlannedBarrier>& barriers(Phase phase) const
+  {
+    return m_batches[static_cast<size_t>(phase)];
+  }
+
+  /// Ownership releases that follow a phase.
+  [[nodiscard]] const std::vector<PlannedBarrier>& releases(Phase phase) const
+  {
+    return m_releases[static_cast<size_t>(phase)];
+  }
+
+  /// State each image is left in at the end of the frame (entry states for the next one).
+  [[nodiscard]] const std::map<std::string, ImageState>& final_states() const { return m_final_states; }
+
+  /// Whether two plans record the same barriers.
+  [[nodiscard]] bool same_barriers(const BarrierPlan& other) const;
+
+  /// Multi-line dump of every batch, for logs and the command console.
+  [[nodiscard]] std::string report() const;
+
+private:
+  std::array<std::vector<PlannedBarrier>, 4> m_batches;  // [phase], recorded before it
+  std::array<std::vector<PlannedBarrier>, 4> m_releases; // [phase], recorded after it
+  std::array<vk::PipelineStageFlags2, 4> m_wait_stages{}; // [phase], see queue_wait_stages()
+  std::map<std::string, ImageState> m_final_states;
+};
+
+} // namespace sps::vulkan
@@ -0,0 +1,225 @@
+#include <sps/vulkan/blend_draw_list.h>
+
+#include <sps/vulkan/frustum_culler.h>
+#include <sps/vulkan/gltf_loader.h>
+#include <sps/vulkan/mesh.h>
+#include <sps/vulkan/radix_sort.h>
+
+#include <spdlog/spdlog.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+/// Unsigned key that orders like the float (negative values included).
+uint32_t sortable_key(float value)
+{
+  const auto bits = std::bit_cast<uint32_t>(value);
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/// Insertion sort of (key, value) pairs by ascending key, giving up after
+/// max_moves element moves. The pairs stay a permutation either way.
+/// @return Whether the pairs are sorted.
+bool insertion_sort(std::vector<uint32_t>& keys, std::vector<uint32_t>& values, uint64_t max_moves)
+{
+  uint64_t moves = 0;
+  for (size_t i = 1; i < keys.size(); ++i)
+  {
+    const uint32_t key = keys[i];
+    const uint32_t value = values[i];
+    size_t j = i;
+    for (; j > 0 && keys[j - 1] > key; --j)
+    {
+      keys[j] = keys[j - 1];
+      values[j] = values[j - 1];
+      if (++moves > max_moves)
+      {
+        keys[j - 1] = key;
+        values[j - 1] = value;
+        return false;
+      }
+    }
+    keys[j] = key;
+    values[j] = value;
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+void BlendDrawList::build_centroids(const GltfScene& scene)
+{
+  m_blend.clear();
+  m_centroids.clear();
+  for (uint32_t i = 0; i < scene.primitives.size(); ++i)
+  {
+    const auto& prim = scene.primitives[i];
+    if (scene.materials[prim.materialIndex].alphaMode != AlphaMode::Blend)
+      continue;
+    m_blend.push_back(i);
+    m_centroids.push_back(prim.modelMatrix * glm::vec4(prim.centroid, 1.0f));
+  }
+
+  m_scene = &scene;
+  m_primitive_count = scene.primitives.size();
+  m_prev_visible.clear();
+  m_entries.clear();
+}
+
+void BlendDrawList::build(
+  const GltfScene& scene, const FrustumCuller* culler, const glm::mat4& view, bool reuse_order)
+{
+  if (m_scene != &scene || m_primitive_count != scene.primitives.size())
+    build_centroids(scene);
+
+  // View-space z: only the third row of the view matrix. Ascending z is
+  // back to front (more negative z = farther).
+  const glm::vec4 z_row(view[0][2], view[1][2], view[2][2], view[3][2]);
+
+  const size_t count = m_blend.size();
+  m_visible.resize(count);
+  m_key_of.resize(count);
+  for (size_t e = 0; e < count; ++e)
+  {
+    m_visible[e] = (!culler || culler->visible(m_blend[e])) ? 1 : 0;
+    m_key_of[e] = sortable_key(glm::dot(z_row, m_centroids[e]));
+  }
+
+  // Same visible set as last frame: the previous order is nearly sorted
+  m_incremental = reuse_order && !m_entries.empty() && m_visible == m_prev_visible;
+  if (m_incremental)
+  {
+    m_keys.resize(m_entries.size());
+    for (size_t k = 0; k < m_entries.size(); ++k)
+      m_keys[k] = m_key_of[m_entries[k]];
+    m_incremental = insertion_sort(m_keys, m_entries, uint64_t{ MAX_MOVES_PER_DRAW } * m_keys.size());
+  }
+  else
+  {
+    m_entries.clear();
+    m_keys.clear();
+    for (uint32_t e = 0; e < count; ++e)
+    {
+      if (!m_visible[e])
+        continue;
+      m_entries.push_back(e);
+      m_keys.push_back(m_key_of[e]);
+    }
+  }
+  if (!m_incremental)
+    radix_sort(m_keys, m_entries, m_key_scratch, m_draw_scratch);
+  m_prev_visible.swap(m_visible);
+
+  m_draws.resize(m_entries.size());
+  for (size_t k = 0; k < m_entries.size(); ++k)
+    m_draws[k] = m_blend[m_entries[k]];
+}
+
+std::string benchmark_blend_sort(uint32_t primitive_count, uint32_t frames)
+{
+  using Clock = std::chrono::steady_clock;
+  frames = std::max(frames, 1u);
+
+  // Synthetic scene: BLEND primitives scattered through a 100^3 box
+  GltfScene scene;
+  scene.materials.resize(1);
+  scene.materials[0].alphaMode = AlphaMode::Blend;
+  scene.primitives.resize(primitive_count);
+  uint32_t seed = 12345u;
+  auto random = [&seed]()
+  {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 100.0f - 50.0f;
+  };
+  for (auto& prim : scene.primitives)
+  {
+    prim = ScenePrimitive{};
+    prim.modelMatrix = glm::mat4(1.0f);
+    prim.centroid = glm::vec3(random(), random(), random());
+  }
+
+  // Orbit camera: degrees per frame
+  auto view_at = [](float degrees)
+  {
+    const float angle = glm::radians(degrees);
+    const glm::vec3 eye(150.0f * std::cos(angle), 30.0f, 150.0f * std::sin(angle));
+    return glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  };
+  auto ms_per_frame = [frames](Clock::duration d)
+  { return std::chrono::duration<double, std::milli>(d).count() / frames; };
+
+  // Baseline: the comparator sort with a transform per comparison
+  std::vector<const ScenePrimitive*> prims;
+  auto start = Clock::now();
+  for (uint32_t f = 0; f < frames; ++f)
+  {
+    const glm::mat4 view = view_at(0.25f * f);
+    prims.clear();
+    for (const auto& prim : scene.primitives)
+      prims.push_back(&prim);
+    std::sort(prims.begin(), prims.end(),
+      [&view](const ScenePrimitive* a, const ScenePrimitive* b)
+      {
+        glm::vec4 aView = view * a->modelMatrix * glm::vec4(a->centroid, 1.0f);
+        glm::vec4 bView = view * b->modelMatrix * glm::vec4(b->centroid, 1.0f);
+        return aView.z < bView.z;
+      });
+  }
+  const double comparator_ms = ms_per_frame(Clock::now() - start);
+
+  // Coherent motion: insertion sort of last frame's order
+  BlendDrawList list;
+  list.build(scene, nullptr, view_at(0.0f));
+  uint32_t incremental_frames = 0;
+  start = Clock::now();
+  for (uint32_t f = 0; f < frames; ++f)
+  {
+    list.build(scene, nullptr, view_at(0.25f * (f + 1)));
+    incremental_frames += list.incremental() ? 1 : 0;
+  }
+  const double coherent_ms = ms_per_frame(Clock::now() - start);
+
+  // Radix sort alone: the previous order is not tried
+  start = Clock::now();
+  for (uint32_t f = 0; f < frames; ++f)
+    list.build(scene, nullptr, view_at(97.0f * (f + 1)), false);
+  const double radix_ms = ms_per_frame(Clock::now() - start);
+
+  // Jumping camera as rendered: the insertion sort gives up, then radix sort
+  uint32_t aborted_frames = 0;
+  start = Clock::now();
+  for (uint32_t f = 0; f < frames; ++f)
+  {
+    list.build(scene, nullptr, view_at(97.0f * (f + 1)));
+    aborted_frames += list.incremental() ? 0 : 1;
+  }
+  const double jumping_ms = ms_per_frame(Clock::now() - start);
+
+  // The last order must be back to front
+  const glm::mat4 last_view = view_at(97.0f * frames);
+  bool sorted = true;
+  for (size_t k = 1; k < list.draws().size(); ++k)
+  {
+    const auto& a = scene.primitives[list.draws()[k - 1]];
+    const auto& b = scene.primitives[list.draws()[k]];
+    sorted = sorted
+      && (last_view * glm::vec4(a.centroid, 1.0f)).z <= (last_view * glm::vec4(b.centroid, 1.0f)).z;
+  }
+
+  return fmt::format("Blend sort, {} primitives x {} frames: comparator sort {:.3f} ms, "
+                     "radix sort {:.3f} ms, coherent camera {:.3f} ms ({}/{} frames incremental), "
+                     "jumping camera {:.3f} ms (insertion abort {:+.3f} ms, {}/{} frames){}",
+    primitive_count, frames, comparator_ms, radix_ms, coherent_ms, incremental_frames, frames,
+    jumping_ms, jumping_ms - radix_ms, aborted_frames, frames, sorted ? "" : " [ORDER MISMATCH]");
+}
+
+} // namespace sps::vulkan
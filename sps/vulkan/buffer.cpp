@@ -10,7 +10,7 @@ namespace sps::vulkan
 {
 
 Buffer::Buffer(const Device& device, const std::string& name, vk::DeviceSize size,
-  vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties)
+  vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, MemoryCategory category)
   : m_device(&device)
   , m_name(name)
   , m_size(size)
@@ -41,7 +41,7 @@ Buffer::Buffer(const Device& device, const std::string& name, vk::DeviceSize siz
     alloc_info.pNext = &alloc_flags_info;
   }
 
-  m_memory = m_device->device().allocateMemory(alloc_info);
+  m_memory = m_device->allocate_memory(alloc_info, category);
 
   // Bind memory to buffer
   m_device->device().bindBufferMemory(m_buffer, m_memory, 0);
@@ -80,7 +80,7 @@ Buffer::~Buffer()
 
   if (m_memory)
   {
-    m_device->device().freeMemory(m_memory);
+    m_device->free_memory(m_memory);
     m_memory = VK_NULL_HANDLE;
   }
 
@@ -121,7 +121,7 @@ Buffer& Buffer::operator=(Buffer&& other) noexcept
       }
       if (m_memory)
       {
-        m_device->device().freeMemory(m_memory);
+        m_device->free_memory(m_memory);
       }
     }
 
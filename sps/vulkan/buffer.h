@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sps/vulkan/memory_stats.h>
+
 #include <vulkan/vulkan.hpp>
 
 #include <string>
@@ -22,8 +24,10 @@ public:
   /// @param size Size in bytes.
   /// @param usage Vulkan buffer usage flags.
   /// @param properties Memory property flags (e.g., HOST_VISIBLE | HOST_COHERENT).
+  /// @param category Memory telemetry category.
   Buffer(const Device& device, const std::string& name, vk::DeviceSize size,
-    vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
+    vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties,
+    MemoryCategory category = MemoryCategory::Other);
 
   virtual ~Buffer();
 
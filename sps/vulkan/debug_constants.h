@@ -121,4 +121,7 @@ inline const char* fragment_shaders[] = {
   SHADER_DIR "debug_texture2d.spv"
 };
 
+// Bindless variant of fragment_shaders[SHADER_PBR] (fragment.frag built with -DBINDLESS)
+inline const char* bindless_fragment_shader = SHADER_DIR "fragment_bindless.spv";
+
 } // namespace sps::vulkan::debug
@@ -3,6 +3,7 @@
 
 #include <spdlog/spdlog.h>
 
+#include <optional>
 #include <utility>
 
 namespace sps::vulkan
@@ -18,8 +19,9 @@ static bool format_has_stencil(vk::Format fmt)
 
 DepthStencilAttachment::DepthStencilAttachment(const Device& device, vk::Format format,
   vk::Extent2D extent, vk::SampleCountFlagBits samples,
-  vk::ImageUsageFlags extraUsage)
-  : m_vkDevice(device.device()), m_format(format), m_extent(extent)
+  vk::ImageUsageFlags extraUsage, bool transient)
+  : m_device(&device), m_vkDevice(device.device()), m_format(format), m_extent(extent)
+  , m_transient(transient)
 {
   const bool stencil = format_has_stencil(format);
 
@@ -40,7 +42,8 @@ DepthStencilAttachment::DepthStencilAttachment(const Device& device, vk::Format
   imageInfo.tiling = vk::ImageTiling::eOptimal;
   imageInfo.initialLayout = vk::ImageLayout::eUndefined;
   imageInfo.usage = vk::ImageUsageFlagBits::eDepthStencilAttachment
-                  | vk::ImageUsageFlagBits::eSampled
+                  | (transient ? vk::ImageUsageFlagBits::eTransientAttachment
+                               : vk::ImageUsageFlagBits::eSampled)
                   | extraUsage;
   imageInfo.samples = samples;
   imageInfo.sharingMode = vk::SharingMode::eExclusive;
@@ -49,12 +52,22 @@ DepthStencilAttachment::DepthStencilAttachment(const Device& device, vk::Format
 
   // Allocate and bind memory
   vk::MemoryRequirements memReqs = m_vkDevice.getImageMemoryRequirements(m_image);
+  std::optional<uint32_t> lazyType;
+  if (transient)
+  {
+    lazyType = device.try_find_memory_type(memReqs.memoryTypeBits,
+      vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated);
+  }
+  m_lazily_allocated = lazyType.has_value();
+
   vk::MemoryAllocateInfo allocInfo{};
   allocInfo.allocationSize = memReqs.size;
-  allocInfo.memoryTypeIndex = device.find_memory_type(
-    memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+  allocInfo.memoryTypeIndex = lazyType
+    ? *lazyType
+    : device.find_memory_type(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_memory = m_vkDevice.allocateMemory(allocInfo);
+  m_memory = device.allocate_memory(allocInfo,
+    m_lazily_allocated ? MemoryCategory::Transient : MemoryCategory::RenderTarget);
   m_vkDevice.bindImageMemory(m_image, m_memory, 0);
 
   // Combined view (depth + stencil aspects)
@@ -103,8 +116,8 @@ DepthStencilAttachment::DepthStencilAttachment(const Device& device, vk::Format
     m_stencilView = m_vkDevice.createImageView(viewInfo);
   }
 
-  spdlog::trace("Created DepthStencilAttachment {}x{} format={} stencil={}",
-    extent.width, extent.height, vk::to_string(format), stencil);
+  spdlog::trace("Created DepthStencilAttachment {}x{} format={} stencil={} transient={} lazy={}",
+    extent.width, extent.height, vk::to_string(format), stencil, transient, m_lazily_allocated);
 }
 
 DepthStencilAttachment::~DepthStencilAttachment()
@@ -113,14 +126,17 @@ DepthStencilAttachment::~DepthStencilAttachment()
 }
 
 DepthStencilAttachment::DepthStencilAttachment(DepthStencilAttachment&& other) noexcept
-  : m_vkDevice(other.m_vkDevice),
+  : m_device(other.m_device),
+    m_vkDevice(other.m_vkDevice),
     m_image(std::exchange(other.m_image, VK_NULL_HANDLE)),
     m_memory(std::exchange(other.m_memory, VK_NULL_HANDLE)),
     m_combinedView(std::exchange(other.m_combinedView, VK_NULL_HANDLE)),
     m_depthView(std::exchange(other.m_depthView, VK_NULL_HANDLE)),
     m_stencilView(std::exchange(other.m_stencilView, VK_NULL_HANDLE)),
     m_format(other.m_format),
-    m_extent(other.m_extent)
+    m_extent(other.m_extent),
+    m_transient(other.m_transient),
+    m_lazily_allocated(other.m_lazily_allocated)
 {
 }
 
@@ -129,6 +145,7 @@ DepthStencilAttachment& DepthStencilAttachment::operator=(DepthStencilAttachment
   if (this != &other)
   {
     destroy();
+    m_device = other.m_device;
     m_vkDevice = other.m_vkDevice;
     m_image = std::exchange(other.m_image, VK_NULL_HANDLE);
     m_memory = std::exchange(other.m_memory, VK_NULL_HANDLE);
@@ -137,6 +154,8 @@ DepthStencilAttachment& DepthStencilAttachment::operator=(DepthStencilAttachment
     m_stencilView = std::exchange(other.m_stencilView, VK_NULL_HANDLE);
     m_format = other.m_format;
     m_extent = other.m_extent;
+    m_transient = other.m_transient;
+    m_lazily_allocated = other.m_lazily_allocated;
   }
   return *this;
 }
@@ -160,7 +179,7 @@ void DepthStencilAttachment::destroy()
   if (m_image)
     m_vkDevice.destroyImage(m_image);
   if (m_memory)
-    m_vkDevice.freeMemory(m_memory);
+    m_device->free_memory(m_memory);
 
   m_stencilView = VK_NULL_HANDLE;
   m_depthView = VK_NULL_HANDLE;
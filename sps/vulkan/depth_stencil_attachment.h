@@ -17,12 +17,18 @@ class Device;
 ///
 /// The stencil view is only created when the format actually has a stencil
 /// component (e.g. D32SfloatS8Uint, D24UnormS8Uint).
+///
+/// A transient attachment is only valid inside a render pass (both storeOps
+/// DontCare, never sampled). It is created with TRANSIENT_ATTACHMENT usage
+/// and LAZILY_ALLOCATED memory when the device offers it, so on tile-based
+/// GPUs it never occupies physical memory. extraUsage must then be limited
+/// to attachment usages.
 class DepthStencilAttachment
 {
 public:
   DepthStencilAttachment(const Device& device, vk::Format format,
     vk::Extent2D extent, vk::SampleCountFlagBits samples,
-    vk::ImageUsageFlags extraUsage = {});
+    vk::ImageUsageFlags extraUsage = {}, bool transient = false);
   ~DepthStencilAttachment();
 
   DepthStencilAttachment(const DepthStencilAttachment&) = delete;
@@ -34,6 +40,8 @@ public:
   [[nodiscard]] vk::Format format() const { return m_format; }
   [[nodiscard]] vk::Extent2D extent() const { return m_extent; }
   [[nodiscard]] bool has_stencil() const;
+  [[nodiscard]] bool is_transient() const { return m_transient; }
+  [[nodiscard]] bool is_lazily_allocated() const { return m_lazily_allocated; }
 
   [[nodiscard]] vk::ImageView combined_view() const { return m_combinedView; }
   [[nodiscard]] vk::ImageView depth_view() const { return m_depthView; }
@@ -42,6 +50,7 @@ public:
 private:
   void destroy();
 
+  const Device* m_device{ nullptr };
   vk::Device m_vkDevice;
   vk::Image m_image;
   vk::DeviceMemory m_memory;
@@ -50,6 +59,8 @@ private:
   vk::ImageView m_stencilView;
   vk::Format m_format;
   vk::Extent2D m_extent;
+  bool m_transient{ false };
+  bool m_lazily_allocated{ false };
 };
 
 } // namespace sps::vulkan
@@ -5,9 +5,13 @@
 #include <sps/vulkan/instance.h>
 #include <sps/vulkan/representation.h>
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <optional>
 #include <span>
 #include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 #include <vulkan/vulkan.hpp>
@@ -402,12 +406,29 @@ Device::Device(const Instance& inst, vk::SurfaceKHR surface, bool prefer_distinc
     m_transfer_queue_family_index = m_graphics_queue_family_index;
   }
 
-  // TODO(Use C++)
+  // Dedicated compute family for async compute (optional)
+  queue_candidate = find_queue_family_index_if(
+    [&](const std::uint32_t, const vk::QueueFamilyProperties& queue_family)
+    {
+      return (queue_family.queueFlags & vk::QueueFlagBits::eCompute) &&
+        !(queue_family.queueFlags & vk::QueueFlagBits::eGraphics);
+    });
+
+  m_compute_queue_family_index = m_graphics_queue_family_index;
+  if (queue_candidate)
+  {
+    spdlog::trace("A separate queue will be used for async compute.");
+    m_compute_queue_family_index = *queue_candidate;
 
-  //  VkPhysicalDeviceFeatures available_features{};
-  //  vkGetPhysicalDeviceFeatures(physical_device, &available_features);
+    // The transfer family may be the same one: share its queue create info
+    if (!use_distinct_data_transfer_queue || m_transfer_queue_family_index != *queue_candidate)
+    {
+      queues_to_create.push_back(vk::DeviceQueueCreateInfo(vk::DeviceQueueCreateFlags(),
+        m_compute_queue_family_index, 1, &sps::vulkan::DEFAULT_QUEUE_PRIORITY));
+    }
+  }
 
-  vk::PhysicalDeviceFeatures available_features = vk::PhysicalDeviceFeatures();
+  const vk::PhysicalDeviceFeatures available_features = m_physical_device.getFeatures();
 
   const auto comparable_required_features = get_device_features_as_vector(required_features);
   const auto comparable_optional_features = get_device_features_as_vector(optional_features);
@@ -458,6 +479,75 @@ Device::Device(const Instance& inst, vk::SurfaceKHR surface, bool prefer_distinc
   // Extended dynamic state (for per-draw cull mode)
   extensions_to_enable.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
 
+  // Heap budget/usage queries for memory telemetry (optional)
+  if (is_extension_supported(
+        m_physical_device.enumerateDeviceExtensionProperties(), VK_EXT_MEMORY_BUDGET_EXTENSION_NAME))
+  {
+    extensions_to_enable.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    m_memory_budget_supported = true;
+  }
+
+  // Synchronization2: per-barrier stage masks for the render graph's batched
+  // barriers (optional, the graph falls back to vkCmdPipelineBarrier)
+  vk::PhysicalDeviceSynchronization2FeaturesKHR availableSync2{};
+  vk::PhysicalDeviceFeatures2 sync2Query{};
+  sync2Query.pNext = &availableSync2;
+  if (is_extension_supported(
+        m_physical_device.enumerateDeviceExtensionProperties(), VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+  {
+    m_physical_device.getFeatures2(&sync2Query);
+    m_synchronization2_supported = availableSync2.synchronization2 == VK_TRUE;
+  }
+  if (m_synchronization2_supported)
+  {
+    extensions_to_enable.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+  }
+
+  // Indirect count draws (core in Vulkan 1.2 behind a Vulkan12Features bit,
+  // which cannot be chained next to the individual feature structs used here)
+  if (is_extension_supported(
+        m_physical_device.enumerateDeviceExtensionProperties(), VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+  {
+    extensions_to_enable.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+    m_indirect_count_supported =
+      m_enabled_features.multiDrawIndirect && m_enabled_features.drawIndirectFirstInstance;
+  }
+
+  // Compiler statistics of pipeline executables, for shader variant reports (optional)
+  vk::PhysicalDevicePipelineExecutablePropertiesFeaturesKHR availableExecutable{};
+  vk::PhysicalDeviceFeatures2 executableQuery{};
+  executableQuery.pNext = &availableExecutable;
+  if (is_extension_supported(m_physical_device.enumerateDeviceExtensionProperties(),
+        VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME))
+  {
+    m_physical_device.getFeatures2(&executableQuery);
+    m_pipeline_statistics_supported = availableExecutable.pipelineExecutableInfo == VK_TRUE;
+  }
+  if (m_pipeline_statistics_supported)
+  {
+    extensions_to_enable.push_back(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+  }
+
+  // Present ids + waiting for them, for input-to-photon latency (optional)
+  vk::PhysicalDevicePresentIdFeaturesKHR availablePresentId{};
+  vk::PhysicalDevicePresentWaitFeaturesKHR availablePresentWait{};
+  availablePresentId.pNext = &availablePresentWait;
+  vk::PhysicalDeviceFeatures2 presentQuery{};
+  presentQuery.pNext = &availablePresentId;
+  const auto device_extensions = m_physical_device.enumerateDeviceExtensionProperties();
+  if (is_extension_supported(device_extensions, VK_KHR_PRESENT_ID_EXTENSION_NAME)
+    && is_extension_supported(device_extensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME))
+  {
+    m_physical_device.getFeatures2(&presentQuery);
+    m_present_wait_supported =
+      availablePresentId.presentId == VK_TRUE && availablePresentWait.presentWait == VK_TRUE;
+  }
+  if (m_present_wait_supported)
+  {
+    extensions_to_enable.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+    extensions_to_enable.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+  }
+
   // Add ray tracing extensions if supported and requested
   if (enable_ray_tracing && m_ray_tracing_capabilities.supported)
   {
@@ -477,14 +567,39 @@ Device::Device(const Instance& inst, vk::SurfaceKHR surface, bool prefer_distinc
   vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures{};
   extendedDynamicStateFeatures.extendedDynamicState = VK_TRUE;
 
-  // Create device with extended features for ray tracing
+  // Descriptor indexing: bindless material textures (raster) and the RT
+  // closest-hit texture array both index sampled image arrays non-uniformly
+  vk::PhysicalDeviceDescriptorIndexingFeatures availableIndexing{};
+  vk::PhysicalDeviceFeatures2 features2{};
+  features2.pNext = &availableIndexing;
+  m_physical_device.getFeatures2(&features2);
+
+  m_bindless_supported = availableIndexing.runtimeDescriptorArray
+    && availableIndexing.shaderSampledImageArrayNonUniformIndexing
+    && availableIndexing.descriptorBindingPartiallyBound
+    && availableIndexing.descriptorBindingVariableDescriptorCount;
+  if (!m_bindless_supported)
+  {
+    spdlog::warn("Descriptor indexing not fully supported, bindless materials disabled");
+  }
+
   vk::PhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
-  descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
-  descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+  descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing =
+    availableIndexing.shaderSampledImageArrayNonUniformIndexing;
+  descriptorIndexingFeatures.runtimeDescriptorArray = availableIndexing.runtimeDescriptorArray;
+  descriptorIndexingFeatures.descriptorBindingPartiallyBound = m_bindless_supported;
+  descriptorIndexingFeatures.descriptorBindingVariableDescriptorCount = m_bindless_supported;
+
+  // Timeline semaphores (core in Vulkan 1.2, always supported): frame pacing,
+  // upload completion, and deferred resource release
+  vk::PhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+  timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
+  vk::PhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+  synchronization2Features.synchronization2 = VK_TRUE;
 
   vk::PhysicalDeviceBufferDeviceAddressFeatures bufferDeviceAddressFeatures{};
   bufferDeviceAddressFeatures.bufferDeviceAddress = VK_TRUE;
-  bufferDeviceAddressFeatures.pNext = &descriptorIndexingFeatures;
 
   vk::PhysicalDeviceAccelerationStructureFeaturesKHR asFeatures{};
   asFeatures.accelerationStructure = VK_TRUE;
@@ -500,13 +615,39 @@ Device::Device(const Instance& inst, vk::SurfaceKHR surface, bool prefer_distinc
     extensions_to_enable.size(), extensions_to_enable.data(),                     //
     &m_enabled_features);
 
-  // Always chain extended dynamic state features
+  // Always chain extended dynamic state + timeline semaphore + descriptor indexing features
   deviceInfo.pNext = &extendedDynamicStateFeatures;
+  extendedDynamicStateFeatures.pNext = &timelineSemaphoreFeatures;
+  timelineSemaphoreFeatures.pNext = &descriptorIndexingFeatures;
+  if (m_synchronization2_supported)
+  {
+    timelineSemaphoreFeatures.pNext = &synchronization2Features;
+    synchronization2Features.pNext = &descriptorIndexingFeatures;
+  }
 
   // Chain ray tracing features if enabled
   if (enable_ray_tracing && m_ray_tracing_capabilities.supported)
   {
-    extendedDynamicStateFeatures.pNext = &rtPipelineFeatures;
+    descriptorIndexingFeatures.pNext = &rtPipelineFeatures;
+  }
+
+  vk::PhysicalDevicePipelineExecutablePropertiesFeaturesKHR executableFeatures{};
+  executableFeatures.pipelineExecutableInfo = VK_TRUE;
+  if (m_pipeline_statistics_supported)
+  {
+    executableFeatures.pNext = const_cast<void*>(deviceInfo.pNext);
+    deviceInfo.pNext = &executableFeatures;
+  }
+
+  vk::PhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+  presentIdFeatures.presentId = VK_TRUE;
+  vk::PhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+  presentWaitFeatures.presentWait = VK_TRUE;
+  if (m_present_wait_supported)
+  {
+    presentWaitFeatures.pNext = const_cast<void*>(deviceInfo.pNext);
+    presentIdFeatures.pNext = &presentWaitFeatures;
+    deviceInfo.pNext = &presentIdFeatures;
   }
 
   try
@@ -531,11 +672,20 @@ Device::Device(const Instance& inst, vk::SurfaceKHR surface, bool prefer_distinc
   spdlog::trace("   - Graphics: {}", m_graphics_queue_family_index);
   spdlog::trace("   - Present: {}", m_present_queue_family_index);
   spdlog::trace("   - Transfer: {}", m_transfer_queue_family_index);
+  spdlog::trace("   - Compute: {}", m_compute_queue_family_index);
 
   // Setup the queues for presentation and graphics.
   // Since we only have one queue per queue family, we acquire index 0.
   m_present_queue = m_device.getQueue(m_present_queue_family_index, 0);
   m_graphics_queue = m_device.getQueue(m_graphics_queue_family_index, 0);
+
+  m_graphics_timeline = std::make_unique<TimelineSemaphore>(*this, "graphics timeline");
+
+  if (m_compute_queue_family_index != m_graphics_queue_family_index)
+  {
+    m_compute_queue = m_device.getQueue(m_compute_queue_family_index, 0);
+    m_compute_timeline = std::make_unique<TimelineSemaphore>(*this, "compute timeline");
+  }
 }
 
 RayTracingCapabilities Device::query_ray_tracing_capabilities(vk::PhysicalDevice physical_device)
@@ -617,6 +767,17 @@ vk::SampleCountFlagBits Device::max_usable_sample_count() const
 
 uint32_t Device::find_memory_type(
   uint32_t type_filter, vk::MemoryPropertyFlags properties) const
+{
+  if (auto index = try_find_memory_type(type_filter, properties))
+  {
+    return *index;
+  }
+
+  throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+std::optional<uint32_t> Device::try_find_memory_type(
+  uint32_t type_filter, vk::MemoryPropertyFlags properties) const
 {
   vk::PhysicalDeviceMemoryProperties mem_properties = m_physical_device.getMemoryProperties();
 
@@ -629,11 +790,87 @@ uint32_t Device::find_memory_type(
     }
   }
 
-  throw std::runtime_error("Failed to find suitable memory type!");
+  return std::nullopt;
+}
+
+vk::DeviceMemory Device::allocate_memory(
+  const vk::MemoryAllocateInfo& alloc_info, MemoryCategory category) const
+{
+  vk::DeviceMemory memory = m_device.allocateMemory(alloc_info);
+
+  uint32_t heap_index =
+    m_physical_device.getMemoryProperties().memoryTypes[alloc_info.memoryTypeIndex].heapIndex;
+  m_memory_stats.record_allocation(memory, category, alloc_info.allocationSize, heap_index);
+  m_memory_stats.check_budgets(query_memory_budgets());
+
+  return memory;
+}
+
+void Device::free_memory(vk::DeviceMemory memory) const
+{
+  if (!memory)
+    return;
+
+  m_memory_stats.record_free(memory);
+  m_device.freeMemory(memory);
+}
+
+void Device::retire_memory(vk::DeviceMemory memory) const
+{
+  if (memory)
+    defer_release([this, memory]() { free_memory(memory); });
+}
+
+std::vector<HeapBudget> Device::query_memory_budgets() const
+{
+  vk::PhysicalDeviceMemoryBudgetPropertiesEXT budget_props{};
+  vk::PhysicalDeviceMemoryProperties2 props2{};
+  if (m_memory_budget_supported)
+  {
+    props2.pNext = &budget_props;
+  }
+  m_physical_device.getMemoryProperties2(&props2);
+
+  const auto& mem_props = props2.memoryProperties;
+  std::vector<HeapBudget> heaps(mem_props.memoryHeapCount);
+  for (uint32_t i = 0; i < mem_props.memoryHeapCount; i++)
+  {
+    heaps[i].heap_index = i;
+    heaps[i].flags = mem_props.memoryHeaps[i].flags;
+    heaps[i].size = mem_props.memoryHeaps[i].size;
+    if (m_memory_budget_supported)
+    {
+      heaps[i].budget = budget_props.heapBudget[i];
+      heaps[i].usage = budget_props.heapUsage[i];
+    }
+    else
+    {
+      heaps[i].budget = heaps[i].size;
+      heaps[i].usage = m_memory_stats.heap_bytes(i);
+    }
+  }
+  return heaps;
 }
 
 Device::~Device()
 {
+  // Owners have destroyed their resources by now; flush what was deferred
+  if (m_graphics_timeline)
+  {
+    wait_idle();
+    for (auto& pending : m_pending_releases)
+      pending.release();
+    m_pending_releases.clear();
+    m_graphics_timeline.reset();
+    m_compute_timeline.reset();
+  }
+
+  if (m_pipeline_cache)
+  {
+    save_pipeline_cache();
+    m_device.destroyPipelineCache(m_pipeline_cache);
+  }
+
   std::scoped_lock locker(m_mutex);
 
   // Because the device handle must be valid for the destruction of the command pools in the
@@ -646,6 +883,103 @@ Device::~Device()
   vkDestroyDevice(m_device, nullptr);
 }
 
+void Device::load_pipeline_cache(const std::string& directory)
+{
+  const auto props = m_physical_device.getProperties();
+
+  std::vector<std::uint8_t> data;
+  if (!directory.empty())
+  {
+    // One file per vendor/device/driver: a driver update starts a fresh cache
+    std::string uuid;
+    for (auto byte : props.pipelineCacheUUID)
+      uuid += fmt::format("{:02x}", byte);
+    const auto file_name = fmt::format("{:04x}_{:04x}_{:08x}_{}.bin", props.vendorID,
+      props.deviceID, props.driverVersion, uuid);
+    m_pipeline_cache_file = (std::filesystem::path(directory) / file_name).string();
+
+    std::ifstream file(m_pipeline_cache_file, std::ios::binary | std::ios::ate);
+    if (file)
+    {
+      data.resize(static_cast<std::size_t>(file.tellg()));
+      file.seekg(0);
+      file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+  }
+
+  // The driver also validates the data, but a stale or foreign file is
+  // dropped here so it is reported (VkPipelineCacheHeaderVersionOne)
+  if (!data.empty())
+  {
+    VkPipelineCacheHeaderVersionOne header{};
+    bool valid = data.size() >= sizeof(header);
+    if (valid)
+    {
+      std::memcpy(&header, data.data(), sizeof(header));
+      valid = header.headerSize >= sizeof(header) &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == props.vendorID && header.deviceID == props.deviceID &&
+        std::memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+    }
+    if (!valid)
+    {
+      spdlog::warn("Ignoring pipeline cache {}: header does not match this device",
+        m_pipeline_cache_file);
+      data.clear();
+    }
+  }
+
+  vk::PipelineCacheCreateInfo cache_ci{};
+  cache_ci.initialDataSize = data.size();
+  cache_ci.pInitialData = data.empty() ? nullptr : data.data();
+  m_pipeline_cache = m_device.createPipelineCache(cache_ci);
+  m_pipeline_cache_loaded_bytes = data.size();
+  set_debug_name(reinterpret_cast<uint64_t>(static_cast<VkPipelineCache>(m_pipeline_cache)),
+    vk::ObjectType::ePipelineCache, "pipeline cache");
+
+  if (m_pipeline_cache_file.empty())
+    spdlog::info("Pipeline cache: in-memory only (no directory configured)");
+  else if (data.empty())
+    spdlog::info("Pipeline cache: cold start, will be written to {}", m_pipeline_cache_file);
+  else
+  {
+    spdlog::info(
+      "Pipeline cache: loaded {} KiB from {}", data.size() / 1024, m_pipeline_cache_file);
+  }
+}
+
+void Device::save_pipeline_cache() const
+{
+  if (!m_pipeline_cache || m_pipeline_cache_file.empty())
+    return;
+
+  try
+  {
+    const auto data = m_device.getPipelineCacheData(m_pipeline_cache);
+
+    // Write a temporary file first so an interrupted save never leaves a torn cache
+    const std::filesystem::path path(m_pipeline_cache_file);
+    std::filesystem::create_directories(path.parent_path());
+    const auto tmp_path = std::filesystem::path(path).concat(".tmp");
+    {
+      std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+      file.write(
+        reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+      if (!file)
+      {
+        spdlog::warn("Failed to write pipeline cache {}", tmp_path.string());
+        return;
+      }
+    }
+    std::filesystem::rename(tmp_path, path);
+    spdlog::info("Pipeline cache: saved {} KiB to {}", data.size() / 1024, m_pipeline_cache_file);
+  }
+  catch (const std::exception& e)
+  {
+    spdlog::warn("Failed to save pipeline cache {}: {}", m_pipeline_cache_file, e.what());
+  }
+}
+
 vk::SurfaceCapabilitiesKHR Device::surfaceCapabilities(const vk::SurfaceKHR& surface) const
 {
   // TODO: May throw
@@ -664,6 +998,134 @@ void Device::wait_idle() const
     throw;
   }
 }
+std::uint64_t Device::submit_graphics(const vk::SubmitInfo& submit_info,
+  std::uint64_t compute_wait_value, vk::PipelineStageFlags compute_wait_stages) const
+{
+  std::scoped_lock locker(m_submit_mutex);
+  const std::uint64_t value = ++m_graphics_timeline_value;
+
+  // Append the timeline to the signal list. Binary semaphores ignore their
+  // entry in the value arrays, but the arrays must match the semaphore counts.
+  std::vector<vk::Semaphore> signal_semaphores(
+    submit_info.pSignalSemaphores, submit_info.pSignalSemaphores + submit_info.signalSemaphoreCount);
+  signal_semaphores.push_back(m_graphics_timeline->get());
+  std::vector<std::uint64_t> signal_values(signal_semaphores.size(), 0);
+  signal_values.back() = value;
+
+  std::vector<vk::Semaphore> wait_semaphores(
+    submit_info.pWaitSemaphores, submit_info.pWaitSemaphores + submit_info.waitSemaphoreCount);
+  std::vector<vk::PipelineStageFlags> wait_stages(
+    submit_info.pWaitDstStageMask, submit_info.pWaitDstStageMask + submit_info.waitSemaphoreCount);
+  std::vector<std::uint64_t> wait_values(submit_info.waitSemaphoreCount, 0);
+  if (compute_wait_value != 0 && compute_wait_stages && m_compute_timeline)
+  {
+    wait_semaphores.push_back(m_compute_timeline->get());
+    wait_stages.push_back(compute_wait_stages);
+    wait_values.push_back(compute_wait_value);
+  }
+
+  vk::TimelineSemaphoreSubmitInfo timeline_info{};
+  timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+  timeline_info.pWaitSemaphoreValues = wait_values.data();
+  timeline_info.signalSemaphoreValueCount = static_cast<uint32_t>(signal_values.size());
+  timeline_info.pSignalSemaphoreValues = signal_values.data();
+
+  vk::SubmitInfo info = submit_info;
+  info.pNext = &timeline_info;
+  info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+  info.pWaitSemaphores = wait_semaphores.data();
+  info.pWaitDstStageMask = wait_stages.data();
+  info.signalSemaphoreCount = static_cast<uint32_t>(signal_semaphores.size());
+  info.pSignalSemaphores = signal_semaphores.data();
+
+  m_graphics_queue.submit(info);
+  return value;
+}
+
+std::uint64_t Device::submit_compute(
+  const vk::SubmitInfo& submit_info, std::uint64_t graphics_wait_value) const
+{
+  if (!m_compute_timeline)
+  {
+    throw std::runtime_error("Device::submit_compute: no async compute queue");
+  }
+
+  std::scoped_lock locker(m_submit_mutex);
+  const std::uint64_t value = ++m_compute_timeline_value;
+
+  const vk::Semaphore wait_semaphore = m_graphics_timeline->get();
+  const vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eComputeShader;
+  const vk::Semaphore signal_semaphore = m_compute_timeline->get();
+
+  vk::TimelineSemaphoreSubmitInfo timeline_info{};
+  timeline_info.waitSemaphoreValueCount = 1;
+  timeline_info.pWaitSemaphoreValues = &graphics_wait_value;
+  timeline_info.signalSemaphoreValueCount = 1;
+  timeline_info.pSignalSemaphoreValues = &value;
+
+  vk::SubmitInfo info = submit_info;
+  info.pNext = &timeline_info;
+  info.waitSemaphoreCount = 1;
+  info.pWaitSemaphores = &wait_semaphore;
+  info.pWaitDstStageMask = &wait_stage;
+  info.signalSemaphoreCount = 1;
+  info.pSignalSemaphores = &signal_semaphore;
+
+  m_compute_queue.submit(info);
+  return value;
+}
+
+std::uint64_t Device::submitted_compute_value() const
+{
+  std::scoped_lock locker(m_submit_mutex);
+  return m_compute_timeline_value;
+}
+
+void Device::wait_graphics(std::uint64_t value) const
+{
+  m_graphics_timeline->wait(value);
+}
+
+std::uint64_t Device::submitted_graphics_value() const
+{
+  std::scoped_lock locker(m_submit_mutex);
+  return m_graphics_timeline_value;
+}
+
+std::uint64_t Device::completed_graphics_value() const
+{
+  return m_graphics_timeline->value();
+}
+
+void Device::defer_release(std::function<void()> release) const
+{
+  // Opportunistic collection bounds the backlog during bulk uploads
+  collect_releases();
+
+  const std::uint64_t value = submitted_graphics_value();
+  std::scoped_lock locker(m_release_mutex);
+  m_pending_releases.push_back({ value, std::move(release) });
+}
+
+void Device::collect_releases() const
+{
+  std::deque<PendingRelease> ready;
+  {
+    std::scoped_lock locker(m_release_mutex);
+    if (m_pending_releases.empty())
+      return;
+    // Values are pushed in submission order, so completed entries form a prefix
+    const std::uint64_t completed = completed_graphics_value();
+    while (!m_pending_releases.empty() && m_pending_releases.front().value <= completed)
+    {
+      ready.push_back(std::move(m_pending_releases.front()));
+      m_pending_releases.pop_front();
+    }
+  }
+  for (auto& pending : ready)
+    pending.release();
+}
+
 void Device::create_fence(
   const vk::FenceCreateInfo& fenceCreateInfo, vk::Fence* pFence, const std::string& name) const
 {
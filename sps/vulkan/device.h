@@ -1,12 +1,18 @@
 #pragma once
 
+#include <sps/vulkan/memory_stats.h>
+#include <sps/vulkan/timeline_semaphore.h>
+
 #include <vulkan/vulkan.hpp>
 
 #include <array>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <string>
 #include <vulkan/vulkan_handles.hpp>
 #include <vulkan/vulkan_structs.hpp>
 
@@ -109,8 +115,70 @@ public:
 
   [[nodiscard]] vk::Queue transfer_queue() const { return m_transfer_queue; }
 
+  /// Queue of a dedicated compute family (no graphics bit), or VK_NULL_HANDLE.
+  [[nodiscard]] vk::Queue compute_queue() const { return m_compute_queue; }
+
+  /// Check if a dedicated compute queue exists (async compute)
+  [[nodiscard]] bool supports_async_compute() const { return m_compute_queue != VK_NULL_HANDLE; }
+
   void wait_idle() const;
 
+  /// Submit a batch to the graphics queue and signal the graphics timeline.
+  ///
+  /// The timeline semaphore is appended to the batch's signal semaphores;
+  /// any binary wait/signal semaphores in submit_info are kept. Every
+  /// graphics submission (frames, uploads, AS builds) goes through here, so
+  /// timeline values are monotonic in submission order.
+  /// @param compute_wait_value When nonzero, the batch also waits until the
+  ///   compute timeline reaches this value...
+  /// @param compute_wait_stages ...in these stages only (no wait when empty),
+  ///   so that work of the batch not touching compute results can overlap it.
+  /// @return The timeline value reached when this batch has completed.
+  std::uint64_t submit_graphics(const vk::SubmitInfo& submit_info,
+    std::uint64_t compute_wait_value = 0, vk::PipelineStageFlags compute_wait_stages = {}) const;
+
+  /// Submit a batch to the async compute queue and signal the compute timeline.
+  /// The batch waits in the compute shader stage until the graphics timeline
+  /// reaches graphics_wait_value. Requires supports_async_compute().
+  /// @return The compute timeline value reached when this batch has completed.
+  std::uint64_t submit_compute(const vk::SubmitInfo& submit_info, std::uint64_t graphics_wait_value) const;
+
+  /// Last value signaled by a submit_compute() batch (0 before the first).
+  [[nodiscard]] std::uint64_t submitted_compute_value() const;
+
+  /// Block until the graphics timeline reaches value.
+  void wait_graphics(std::uint64_t value) const;
+
+  /// Block until everything submitted to the graphics queue so far has
+  /// completed. Unlike wait_idle(), other queues (present) keep running.
+  void wait_graphics_idle() const { wait_graphics(submitted_graphics_value()); }
+
+  /// Last value signaled by a submit_graphics() batch.
+  [[nodiscard]] std::uint64_t submitted_graphics_value() const;
+
+  /// Value the GPU has reached (all batches up to it have completed).
+  [[nodiscard]] std::uint64_t completed_graphics_value() const;
+
+  /// Run release once all graphics work submitted so far has completed,
+  /// instead of idling the device before destroying a resource.
+  void defer_release(std::function<void()> release) const;
+
+  /// Destroy a Vulkan handle (image, view, framebuffer, descriptor pool, ...)
+  /// through defer_release(). Null handles are ignored.
+  template <typename Handle>
+  void retire(Handle handle) const
+  {
+    if (handle)
+      defer_release([dev = m_device, handle]() { dev.destroy(handle); });
+  }
+
+  /// Free memory from allocate_memory() through defer_release().
+  void retire_memory(vk::DeviceMemory memory) const;
+
+  /// Run deferred releases whose timeline value has been reached.
+  /// Called once per frame; cheap when nothing is pending.
+  void collect_releases() const;
+
   vk::SurfaceCapabilitiesKHR surfaceCapabilities(const vk::SurfaceKHR& surface) const;
 
   void create_semaphore(const vk::SemaphoreCreateInfo& semaphoreCreateInfo,
@@ -131,6 +199,62 @@ public:
   [[nodiscard]] uint32_t find_memory_type(
     uint32_t type_filter, vk::MemoryPropertyFlags properties) const;
 
+  /// Find a suitable memory type for allocation, without throwing
+  /// @param type_filter Bitmask of acceptable memory types
+  /// @param properties Required memory properties
+  /// @return Index of suitable memory type, ``std::nullopt`` if none matches
+  [[nodiscard]] std::optional<uint32_t> try_find_memory_type(
+    uint32_t type_filter, vk::MemoryPropertyFlags properties) const;
+
+  /// Allocate device memory and record it in the memory telemetry.
+  /// @param alloc_info Allocation parameters (size, memory type, pNext chain).
+  /// @param category What the allocation is used for.
+  /// @return The allocated memory handle.
+  [[nodiscard]] vk::DeviceMemory allocate_memory(
+    const vk::MemoryAllocateInfo& alloc_info, MemoryCategory category) const;
+
+  /// Free device memory allocated through allocate_memory().
+  void free_memory(vk::DeviceMemory memory) const;
+
+  /// Memory telemetry (per-category counters, budget warning hook).
+  [[nodiscard]] MemoryStats& memory_stats() const { return m_memory_stats; }
+
+  /// Check if VK_EXT_memory_budget is enabled on this device
+  [[nodiscard]] bool supports_memory_budget() const { return m_memory_budget_supported; }
+
+  /// Check if the descriptor indexing features for bindless material textures
+  /// (runtime arrays, partially bound, variable count, non-uniform indexing) are enabled
+  [[nodiscard]] bool supports_bindless() const { return m_bindless_supported; }
+
+  /// Check if VK_KHR_synchronization2 is enabled (vkCmdPipelineBarrier2KHR)
+  [[nodiscard]] bool supports_synchronization2() const { return m_synchronization2_supported; }
+
+  /// Check if GPU-driven draws are possible: VK_KHR_draw_indirect_count plus
+  /// the multiDrawIndirect and drawIndirectFirstInstance features
+  [[nodiscard]] bool supports_indirect_count() const { return m_indirect_count_supported; }
+
+  /// Check if the independentBlend feature is enabled (per-attachment blend
+  /// states, needed by order independent transparency)
+  [[nodiscard]] bool supports_independent_blend() const
+  {
+    return m_enabled_features.independentBlend == VK_TRUE;
+  }
+
+  /// Check if VK_KHR_pipeline_executable_properties is enabled (per-stage
+  /// compiler statistics such as register and instruction counts)
+  [[nodiscard]] bool supports_pipeline_statistics() const
+  {
+    return m_pipeline_statistics_supported;
+  }
+
+  /// Check if VK_KHR_present_id and VK_KHR_present_wait are enabled (presents
+  /// carry an id the CPU can wait on, i.e. when the image reached the display)
+  [[nodiscard]] bool supports_present_wait() const { return m_present_wait_supported; }
+
+  /// Query per-heap budget and usage.
+  /// Uses VK_EXT_memory_budget when available, otherwise heap size and tracked usage.
+  [[nodiscard]] std::vector<HeapBudget> query_memory_budgets() const;
+
   /// Check if ray tracing is supported and query capabilities
   static RayTracingCapabilities query_ray_tracing_capabilities(vk::PhysicalDevice physical_device);
 
@@ -143,6 +267,26 @@ public:
   /// Check if ray tracing is available on this device
   [[nodiscard]] bool supports_ray_tracing() const { return m_ray_tracing_capabilities.supported; }
 
+  /// Create the device-wide pipeline cache, seeded from a file in directory
+  /// named after the vendor, device, driver version and pipelineCacheUUID.
+  /// A missing file or one whose header does not match this device starts
+  /// an empty cache. With an empty directory the cache is not persisted.
+  /// Call before creating any pipeline.
+  void load_pipeline_cache(const std::string& directory);
+
+  /// Write the pipeline cache back to its file (no-op without a directory).
+  /// Called by the destructor.
+  void save_pipeline_cache() const;
+
+  /// Cache passed to every pipeline creation (VK_NULL_HANDLE before load_pipeline_cache())
+  [[nodiscard]] vk::PipelineCache pipeline_cache() const { return m_pipeline_cache; }
+
+  /// Bytes of cache data loaded from disk (0 on a cold start)
+  [[nodiscard]] std::size_t pipeline_cache_loaded_bytes() const
+  {
+    return m_pipeline_cache_loaded_bytes;
+  }
+
   /// Query the maximum usable MSAA sample count (intersection of color and depth)
   [[nodiscard]] vk::SampleCountFlagBits max_usable_sample_count() const;
 
@@ -161,21 +305,51 @@ private:
 
   vk::PhysicalDeviceFeatures m_enabled_features{};
   RayTracingCapabilities m_ray_tracing_capabilities{};
+  bool m_memory_budget_supported{ false };
+  bool m_bindless_supported{ false };
+  bool m_synchronization2_supported{ false };
+  bool m_indirect_count_supported{ false };
+  bool m_pipeline_statistics_supported{ false };
+  bool m_present_wait_supported{ false };
+  mutable MemoryStats m_memory_stats;
+
+  vk::PipelineCache m_pipeline_cache{ VK_NULL_HANDLE };
+  std::string m_pipeline_cache_file; // empty = not persisted
+  std::size_t m_pipeline_cache_loaded_bytes{ 0 };
 
   vk::Queue m_graphics_queue{ VK_NULL_HANDLE };
   vk::Queue m_present_queue{ VK_NULL_HANDLE };
   vk::Queue m_transfer_queue{ VK_NULL_HANDLE };
+  vk::Queue m_compute_queue{ VK_NULL_HANDLE };
 
 public:
   // Find other way to expose to swapchain
   std::uint32_t m_present_queue_family_index{ 0 };
   std::uint32_t m_graphics_queue_family_index{ 0 };
   std::uint32_t m_transfer_queue_family_index{ 0 };
+  std::uint32_t m_compute_queue_family_index{ 0 }; // graphics family without async compute
 
 private:
   mutable std::vector<std::unique_ptr<vk::CommandPool>> m_cmd_pools;
   mutable std::mutex m_mutex;
 
   vk::detail::DispatchLoaderDynamic m_dldi;
+
+  // Graphics queue timeline (frames, uploads, AS builds)
+  std::unique_ptr<TimelineSemaphore> m_graphics_timeline;
+  mutable std::uint64_t m_graphics_timeline_value{ 0 };
+
+  // Async compute queue timeline (frame handoffs to and from graphics)
+  std::unique_ptr<TimelineSemaphore> m_compute_timeline;
+  mutable std::uint64_t m_compute_timeline_value{ 0 };
+  mutable std::mutex m_submit_mutex;
+
+  struct PendingRelease
+  {
+    std::uint64_t value;
+    std::function<void()> release;
+  };
+  mutable std::deque<PendingRelease> m_pending_releases;
+  mutable std::mutex m_release_mutex;
 };
 }
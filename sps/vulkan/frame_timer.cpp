@@ -0,0 +1,172 @@
+#include <sps/vulkan/frame_timer.h>
+
+#include <sps/vulkan/device.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+// Per frame slot: frame begin/end, first graphics buffer end, resume buffer
+// begin, compute begin/end
+constexpr uint32_t QUERIES_PER_FRAME = 6;
+constexpr uint32_t FRAME_BEGIN = 0;
+constexpr uint32_t FRAME_END = 1;
+constexpr uint32_t SPLIT_END = 2;
+constexpr uint32_t RESUME_BEGIN = 3;
+constexpr uint32_t COMPUTE_BEGIN = 4;
+constexpr uint32_t COMPUTE_END = 5;
+
+double overlap(uint64_t a0, uint64_t a1, uint64_t b0, uint64_t b1)
+{
+  const uint64_t lo = std::max(a0, b0);
+  const uint64_t hi = std::min(a1, b1);
+  return hi > lo ? static_cast<double>(hi - lo) : 0.0;
+}
+
+} // anonymous namespace
+
+FrameTimer::FrameTimer(const Device& device, uint32_t frames_in_flight)
+  : m_device(device)
+  , m_pending(frames_in_flight, false)
+  , m_split(frames_in_flight, false)
+{
+  const auto props = device.physicalDevice().getProperties();
+  const auto families = device.physicalDevice().getQueueFamilyProperties();
+  const uint32_t valid_bits =
+    families[device.m_graphics_queue_family_index].timestampValidBits;
+
+  if (!props.limits.timestampComputeAndGraphics || valid_bits == 0)
+  {
+    spdlog::warn("GPU timestamps unsupported, frame timing reports CPU wait only");
+    return;
+  }
+
+  m_timestamp_period_ns = props.limits.timestampPeriod;
+  m_timestamp_mask = valid_bits >= 64 ? ~0ull : ((1ull << valid_bits) - 1);
+  m_compute_timestamps = device.supports_async_compute()
+    && families[device.m_compute_queue_family_index].timestampValidBits == valid_bits;
+
+  vk::QueryPoolCreateInfo info{};
+  info.queryType = vk::QueryType::eTimestamp;
+  info.queryCount = QUERIES_PER_FRAME * frames_in_flight;
+  m_query_pool = device.device().createQueryPool(info);
+}
+
+FrameTimer::~FrameTimer()
+{
+  if (m_query_pool)
+    m_device.device().destroyQueryPool(m_query_pool);
+}
+
+void FrameTimer::begin(vk::CommandBuffer cmd, uint32_t frame)
+{
+  if (!m_query_pool)
+    return;
+  cmd.resetQueryPool(m_query_pool, QUERIES_PER_FRAME * frame, QUERIES_PER_FRAME);
+  cmd.writeTimestamp(
+    vk::PipelineStageFlagBits::eTopOfPipe, m_query_pool, QUERIES_PER_FRAME * frame + FRAME_BEGIN);
+  m_split[frame] = false;
+}
+
+void FrameTimer::end(vk::CommandBuffer cmd, uint32_t frame)
+{
+  if (!m_query_pool)
+    return;
+  cmd.writeTimestamp(
+    vk::PipelineStageFlagBits::eBottomOfPipe, m_query_pool, QUERIES_PER_FRAME * frame + FRAME_END);
+  m_pending[frame] = true;
+}
+
+void FrameTimer::begin_split(vk::CommandBuffer compute_cmd, vk::CommandBuffer resume_cmd, uint32_t frame)
+{
+  if (!m_query_pool || !m_compute_timestamps)
+    return;
+  // Reset by begin(), which the first graphics buffer executes before these
+  compute_cmd.writeTimestamp(
+    vk::PipelineStageFlagBits::eTopOfPipe, m_query_pool, QUERIES_PER_FRAME * frame + COMPUTE_BEGIN);
+  resume_cmd.writeTimestamp(
+    vk::PipelineStageFlagBits::eTopOfPipe, m_query_pool, QUERIES_PER_FRAME * frame + RESUME_BEGIN);
+}
+
+void FrameTimer::end_split(vk::CommandBuffer cmd, vk::CommandBuffer compute_cmd, uint32_t frame)
+{
+  if (!m_query_pool || !m_compute_timestamps)
+    return;
+  cmd.writeTimestamp(
+    vk::PipelineStageFlagBits::eBottomOfPipe, m_query_pool, QUERIES_PER_FRAME * frame + SPLIT_END);
+  compute_cmd.writeTimestamp(
+    vk::PipelineStageFlagBits::eBottomOfPipe, m_query_pool, QUERIES_PER_FRAME * frame + COMPUTE_END);
+  m_split[frame] = true;
+}
+
+void FrameTimer::resolve(uint32_t frame, double cpu_wait_ms)
+{
+  m_last.cpu_wait_ms = cpu_wait_ms;
+
+  if (m_query_pool && m_pending[frame])
+  {
+    m_pending[frame] = false;
+
+    // Split frames wrote all six queries, others only the first two
+    std::array<uint64_t, QUERIES_PER_FRAME> ticks{};
+    const uint32_t count = m_split[frame] ? QUERIES_PER_FRAME : 2;
+    const vk::Result result = m_device.device().getQueryPoolResults(m_query_pool,
+      QUERIES_PER_FRAME * frame, count, count * sizeof(uint64_t), ticks.data(), sizeof(uint64_t),
+      vk::QueryResultFlagBits::e64);
+    if (result == vk::Result::eSuccess)
+    {
+      for (auto& tick : ticks)
+        tick &= m_timestamp_mask;
+      const uint64_t begin = ticks[FRAME_BEGIN];
+      const uint64_t end = ticks[FRAME_END];
+      const double to_ms = m_timestamp_period_ns * 1e-6;
+
+      m_last.gpu_busy_ms = end >= begin ? static_cast<double>(end - begin) * to_ms : 0.0;
+      m_last.gpu_idle_ms = m_has_prev_end && begin >= m_prev_end
+        ? static_cast<double>(begin - m_prev_end) * to_ms
+        : 0.0;
+      m_prev_end = end;
+      m_has_prev_end = true;
+
+      m_last.compute_ms = 0.0;
+      m_last.compute_overlap_ms = 0.0;
+
+      // The previous frame's compute work against this frame's first graphics
+      // buffer, which only waits for it in the stages touching its images
+      const uint64_t first_end = m_split[frame] ? ticks[SPLIT_END] : end;
+      if (m_has_prev_compute)
+      {
+        m_last.compute_overlap_ms +=
+          overlap(m_prev_compute_begin, m_prev_compute_end, begin, first_end) * to_ms;
+      }
+
+      m_has_prev_compute = m_split[frame];
+      if (m_split[frame])
+      {
+        const uint64_t c0 = ticks[COMPUTE_BEGIN];
+        const uint64_t c1 = ticks[COMPUTE_END];
+        m_last.compute_ms = c1 >= c0 ? static_cast<double>(c1 - c0) * to_ms : 0.0;
+        m_last.compute_overlap_ms += (overlap(c0, c1, begin, first_end)
+          + overlap(c0, c1, ticks[RESUME_BEGIN], end)) * to_ms;
+        m_prev_compute_begin = c0;
+        m_prev_compute_end = c1;
+      }
+    }
+  }
+
+  constexpr double alpha = 0.05;
+  m_average.cpu_wait_ms += alpha * (m_last.cpu_wait_ms - m_average.cpu_wait_ms);
+  m_average.gpu_busy_ms += alpha * (m_last.gpu_busy_ms - m_average.gpu_busy_ms);
+  m_average.gpu_idle_ms += alpha * (m_last.gpu_idle_ms - m_average.gpu_idle_ms);
+  m_average.compute_ms += alpha * (m_last.compute_ms - m_average.compute_ms);
+  m_average.compute_overlap_ms += alpha * (m_last.compute_overlap_ms - m_average.compute_overlap_ms);
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+class Device;
+
+/// CPU/GPU overlap for one frame, in milliseconds.
+struct FrameTimings
+{
+  double cpu_wait_ms{ 0.0 }; // CPU blocked on the graphics timeline (waiting for the GPU)
+  double gpu_busy_ms{ 0.0 }; // GPU executing the frame's command buffer
+  double gpu_idle_ms{ 0.0 }; // GPU gap before the frame started (waiting for the CPU)
+  double compute_ms{ 0.0 };         // async compute work of the frame
+  double compute_overlap_ms{ 0.0 }; // part of it that ran while the graphics queue was busy
+};
+
+/// Frame pacing instrumentation.
+///
+/// Two timestamps bracket each frame's command buffer, one query pair per
+/// frame slot. When a slot comes round again (after its timeline wait) the
+/// pair from its previous use is read back. Slots are resolved in
+/// submission order, so the gap to the previously resolved frame's end
+/// timestamp is the time the GPU sat idle waiting for the CPU.
+///
+/// Frames split for async compute (see RenderGraph) also timestamp the
+/// compute command buffer and both ends of the split graphics work. The
+/// overlap is the part of the compute interval that falls inside the graphics
+/// intervals, including the next frame's first graphics buffer; that part is
+/// counted when the next frame resolves, the first time both are known. This
+/// assumes both queues share one timestamp time domain, which holds on common
+/// desktop drivers.
+///
+/// Without timestamp support only the CPU wait is reported.
+class FrameTimer
+{
+public:
+  FrameTimer(const Device& device, uint32_t frames_in_flight);
+  ~FrameTimer();
+
+  FrameTimer(const FrameTimer&) = delete;
+  FrameTimer& operator=(const FrameTimer&) = delete;
+
+  /// Reset the slot's queries and write the start timestamp.
+  void begin(vk::CommandBuffer cmd, uint32_t frame);
+
+  /// Write the end timestamp (into the resume buffer for split frames).
+  void end(vk::CommandBuffer cmd, uint32_t frame);
+
+  /// Write the start timestamps of a possibly split frame's compute and
+  /// resume command buffers, before anything is recorded into them.
+  void begin_split(vk::CommandBuffer compute_cmd, vk::CommandBuffer resume_cmd, uint32_t frame);
+
+  /// Mark the frame as split: write the end timestamps of the first graphics
+  /// buffer and the compute buffer.
+  void end_split(vk::CommandBuffer cmd, vk::CommandBuffer compute_cmd, uint32_t frame);
+
+  /// Read back the slot's previous frame. Call after the slot's timeline wait.
+  /// @param cpu_wait_ms Time the CPU just spent blocked on that wait.
+  void resolve(uint32_t frame, double cpu_wait_ms);
+
+  /// Most recently resolved frame.
+  [[nodiscard]] const FrameTimings& last() const { return m_last; }
+
+  /// Exponential moving average over recent frames (for display).
+  [[nodiscard]] const FrameTimings& average() const { return m_average; }
+
+  [[nodiscard]] bool gpu_timestamps_supported() const { return m_query_pool != VK_NULL_HANDLE; }
+
+private:
+  const Device& m_device;
+  vk::QueryPool m_query_pool{ VK_NULL_HANDLE };
+  double m_timestamp_period_ns{ 1.0 };
+  uint64_t m_timestamp_mask{ ~0ull };
+  bool m_compute_timestamps{ false }; // compute family has valid timestamp bits
+  std::vector<bool> m_pending; // [frame] queries written and not yet resolved
+  std::vector<bool> m_split;   // [frame] the pending frame used async compute
+  uint64_t m_prev_end{ 0 };    // end timestamp of the previously resolved frame
+  bool m_has_prev_end{ false };
+  uint64_t m_prev_compute_begin{ 0 }; // compute interval of the previously resolved frame
+  uint64_t m_prev_compute_end{ 0 };
+  bool m_has_prev_compute{ false };
+
+  FrameTimings m_last;
+  FrameTimings m_average;
+};
+
+} // namespace sps::vulkan
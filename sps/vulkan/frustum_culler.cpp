@@ -0,0 +1,100 @@
+#include <sps/vulkan/frustum_culler.h>
+
+#include <sps/vulkan/gltf_loader.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SPS_FRUSTUM_CULLER_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace sps::vulkan
+{
+
+std::array<glm::vec4, 6> frustum_planes(const glm::mat4& view_proj)
+{
+  const glm::vec4 row0(view_proj[0][0], view_proj[1][0], view_proj[2][0], view_proj[3][0]);
+  const glm::vec4 row1(view_proj[0][1], view_proj[1][1], view_proj[2][1], view_proj[3][1]);
+  const glm::vec4 row2(view_proj[0][2], view_proj[1][2], view_proj[2][2], view_proj[3][2]);
+  const glm::vec4 row3(view_proj[0][3], view_proj[1][3], view_proj[2][3], view_proj[3][3]);
+
+  return {
+    row3 + row0, // left
+    row3 - row0, // right
+    row3 + row1, // bottom
+    row3 - row1, // top
+    row3 + row2, // near
+    row3 - row2  // far
+  };
+}
+
+void FrustumCuller::cull(const GltfScene& scene, const glm::mat4& view_proj)
+{
+  const PrimitiveBounds& bounds = scene.primitive_bounds;
+  if (bounds.size() != scene.primitives.size())
+  {
+    // No bounds for this scene: keep everything
+    m_visible.assign(scene.primitives.size(), 1);
+    m_tested = m_visible_count = static_cast<uint32_t>(scene.primitives.size());
+    return;
+  }
+  const size_t padded = bounds.padded_size();
+  const auto planes = frustum_planes(view_proj);
+
+  // Per plane, the corner furthest along the normal: max on positive axes
+  struct PlaneCorner
+  {
+    const float* x;
+    const float* y;
+    const float* z;
+  };
+  std::array<PlaneCorner, 6> corners{};
+  for (size_t p = 0; p < planes.size(); ++p)
+  {
+    corners[p].x = planes[p].x >= 0.0f ? bounds.max_x.data() : bounds.min_x.data();
+    corners[p].y = planes[p].y >= 0.0f ? bounds.max_y.data() : bounds.min_y.data();
+    corners[p].z = planes[p].z >= 0.0f ? bounds.max_z.data() : bounds.min_z.data();
+  }
+
+  m_visible.resize(padded);
+
+#ifdef SPS_FRUSTUM_CULLER_SSE
+  static_assert(PrimitiveBounds::LANES == 4, "SSE path tests four boxes per iteration");
+  const __m128 zero = _mm_setzero_ps();
+  for (size_t i = 0; i < padded; i += 4)
+  {
+    __m128 inside = _mm_cmpeq_ps(zero, zero); // all lanes set
+    for (size_t p = 0; p < planes.size(); ++p)
+    {
+      __m128 d = _mm_add_ps(
+        _mm_mul_ps(_mm_set1_ps(planes[p].x), _mm_loadu_ps(corners[p].x + i)),
+        _mm_mul_ps(_mm_set1_ps(planes[p].y), _mm_loadu_ps(corners[p].y + i)));
+      d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes[p].z), _mm_loadu_ps(corners[p].z + i)));
+      d = _mm_add_ps(d, _mm_set1_ps(planes[p].w));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+    }
+    const int mask = _mm_movemask_ps(inside);
+    m_visible[i + 0] = static_cast<uint8_t>(mask & 1);
+    m_visible[i + 1] = static_cast<uint8_t>((mask >> 1) & 1);
+    m_visible[i + 2] = static_cast<uint8_t>((mask >> 2) & 1);
+    m_visible[i + 3] = static_cast<uint8_t>((mask >> 3) & 1);
+  }
+#else
+  for (size_t i = 0; i < padded; ++i)
+  {
+    bool inside = true;
+    for (size_t p = 0; p < planes.size() && inside; ++p)
+    {
+      inside = planes[p].x * corners[p].x[i] + planes[p].y * corners[p].y[i] +
+          planes[p].z * corners[p].z[i] + planes[p].w >= 0.0f;
+    }
+    m_visible[i] = inside ? 1 : 0;
+  }
+#endif
+
+  m_tested = static_cast<uint32_t>(bounds.size());
+  m_visible_count = 0;
+  for (uint32_t i = 0; i < m_tested; ++i)
+    m_visible_count += m_visible[i];
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+struct GltfScene;
+
+/// World-space frustum planes of a view-projection matrix (Gribb/Hartmann),
+/// ordered left, right, bottom, top, near, far. A point p is inside when
+/// dot(plane.xyz, p) + plane.w >= 0 for every plane. The near plane uses the
+/// OpenGL clip range (-w <= z), which contains the Vulkan one, so tests stay
+/// conservative under either depth convention. Planes are not normalized.
+[[nodiscard]] std::array<glm::vec4, 6> frustum_planes(const glm::mat4& view_proj);
+
+/// Per-frame visibility of scene primitives against the camera frustum.
+///
+/// Tests the scene's SoA primitive bounds (GltfScene::primitive_bounds), four
+/// boxes per iteration with SSE where available (scalar otherwise). For each
+/// plane only the box corner furthest along its normal is tested, so a box is
+/// culled only when it is entirely outside one plane.
+///
+/// Runs on the main thread before recording; stages then only read it.
+class FrustumCuller
+{
+public:
+  /// Classify every primitive of the scene.
+  void cull(const GltfScene& scene, const glm::mat4& view_proj);
+
+  /// Whether primitive i intersects the frustum (valid after cull()).
+  [[nodiscard]] bool visible(uint32_t primitive) const { return m_visible[primitive] != 0; }
+
+  /// Primitives tested by the last cull().
+  [[nodiscard]] uint32_t tested_count() const { return m_tested; }
+
+  /// Primitives found inside the frustum by the last cull().
+  [[nodiscard]] uint32_t visible_count() const { return m_visible_count; }
+
+  /// Primitives found outside the frustum by the last cull().
+  [[nodiscard]] uint32_t culled_count() const { return m_tested - m_visible_count; }
+
+private:
+  std::vector<uint8_t> m_visible; // [primitive] (padded), 1 = inside
+  uint32_t m_tested{ 0 };
+  uint32_t m_visible_count{ 0 };
+};
+
+} // namespace sps::vulkan
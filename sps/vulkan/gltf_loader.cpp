@@ -1207,6 +1207,7 @@ void traverse_nodes(
       // Record vertex offset for this primitive
       int32_t vertex_offset = static_cast<int32_t>(all_vertices.size());
       size_t num_verts = position_accessor->count;
+      AABB prim_bounds;
 
       for (size_t i = 0; i < num_verts; ++i)
       {
@@ -1216,6 +1217,7 @@ void traverse_nodes(
         // Expand world-space bounding box
         glm::vec3 world_pos = glm::vec3(model_matrix * glm::vec4(v.position, 1.0f));
         bounds.expand(world_pos);
+        prim_bounds.expand(world_pos);
 
         if (!normals.empty())
           v.normal = glm::vec3(normals[i * 3 + 0], normals[i * 3 + 1], normals[i * 3 + 2]);
@@ -1282,6 +1284,7 @@ void traverse_nodes(
       scene_prim.materialIndex = mat_index;
       scene_prim.modelMatrix = model_matrix;
       scene_prim.centroid = centroid;
+      scene_prim.bounds = prim_bounds;
       primitives.push_back(scene_prim);
     }
   }
@@ -1296,7 +1299,28 @@ void traverse_nodes(
 
 } // anonymous namespace
 
-GltfScene load_gltf_scene(const Device& device, const std::string& filepath)
+void PrimitiveBounds::assign(const std::vector<ScenePrimitive>& primitives)
+{
+  m_count = primitives.size();
+  const size_t padded = (m_count + LANES - 1) / LANES * LANES;
+  for (auto* v : { &min_x, &min_y, &min_z, &max_x, &max_y, &max_z })
+    v->assign(padded, 0.0f);
+
+  for (size_t i = 0; i < m_count; ++i)
+  {
+    const AABB& box = primitives[i].bounds;
+    if (!box.valid())
+      continue; // no vertices: a point at the origin, never drawn anyway
+    min_x[i] = box.min.x;
+    min_y[i] = box.min.y;
+    min_z[i] = box.min.z;
+    max_x[i] = box.max.x;
+    max_y[i] = box.max.y;
+    max_z[i] = box.max.z;
+  }
+}
+
+GltfScene load_gltf_scene(const Device& device, const std::string& filepath, bool host_visible_mesh)
 {
   GltfScene scene;
 
@@ -1351,15 +1375,18 @@ GltfScene load_gltf_scene(const Device& device, const std::string& filepath)
     return scene;
   }
 
+  scene.primitive_bounds.assign(scene.primitives);
+
   std::string mesh_name = file_path.stem().string();
 
   if (all_indices.empty())
   {
-    scene.mesh = std::make_unique<Mesh>(device, mesh_name, all_vertices);
+    scene.mesh = std::make_unique<Mesh>(device, mesh_name, all_vertices, host_visible_mesh);
   }
   else
   {
-    scene.mesh = std::make_unique<Mesh>(device, mesh_name, all_vertices, all_indices);
+    scene.mesh =
+      std::make_unique<Mesh>(device, mesh_name, all_vertices, all_indices, host_visible_mesh);
   }
 
   spdlog::info("Loaded glTF scene '{}': {} vertices, {} indices, {} primitives, {} materials",
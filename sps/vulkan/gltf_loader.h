@@ -88,6 +88,28 @@ struct ScenePrimitive
   uint32_t materialIndex;
   glm::mat4 modelMatrix;  // pre-computed world transform from node hierarchy
   glm::vec3 centroid{0.0f};  // object-space centroid for depth sorting
+  AABB bounds;               // world-space bounding box (for culling)
+};
+
+/// @brief World-space primitive bounds in SoA form, for SIMD culling.
+///
+/// Entry i is ScenePrimitive i. The arrays are padded to a multiple of
+/// LANES with empty boxes at the origin; size() is the unpadded count.
+struct PrimitiveBounds
+{
+  static constexpr size_t LANES = 4;
+
+  std::vector<float> min_x, min_y, min_z;
+  std::vector<float> max_x, max_y, max_z;
+
+  [[nodiscard]] size_t size() const { return m_count; }
+  [[nodiscard]] size_t padded_size() const { return min_x.size(); }
+
+  /// Rebuild from the primitives' AABBs.
+  void assign(const std::vector<ScenePrimitive>& primitives);
+
+private:
+  size_t m_count{ 0 };
 };
 
 /// @brief Material data for a scene primitive.
@@ -132,6 +154,7 @@ struct GltfScene
   std::unique_ptr<Mesh> mesh;              // merged vertex/index buffer
   std::vector<SceneMaterial> materials;    // one per glTF material
   std::vector<ScenePrimitive> primitives;  // one per draw call
+  PrimitiveBounds primitive_bounds;        // primitives[i].bounds, SoA
   AABB bounds;                             // world-space bounding box
 };
 
@@ -142,7 +165,9 @@ struct GltfScene
 ///
 /// @param device The Vulkan device wrapper.
 /// @param filepath Path to the glTF file.
+/// @param host_visible_mesh Keep the merged mesh in HOST_VISIBLE memory (see Mesh).
 /// @return GltfScene with mesh, materials, and primitives.
-GltfScene load_gltf_scene(const Device& device, const std::string& filepath);
+GltfScene load_gltf_scene(
+  const Device& device, const std::string& filepath, bool host_visible_mesh = false);
 
 } // namespace sps::vulkan
@@ -0,0 +1,84 @@
+#include <sps/vulkan/gpu_material.h>
+
+#include <sps/vulkan/gltf_loader.h>
+
+namespace sps::vulkan
+{
+
+GpuMaterial make_gpu_material(const SceneMaterial& material)
+{
+  GpuMaterial gpu{};
+  gpu.baseColorFactor = material.baseColorFactor;
+  gpu.metallicFactor = material.metallicFactor;
+  gpu.roughnessFactor = material.roughnessFactor;
+  gpu.alphaCutoff = material.alphaCutoff;
+  gpu.alphaMode = static_cast<uint32_t>(material.alphaMode) | (material.doubleSided ? 4u : 0u)
+    | (material.deriveTransmissionFromThickness ? 8u : 0u);
+  gpu.iridescenceFactor = material.iridescenceFactor;
+  gpu.iridescenceIor = material.iridescenceIor;
+  gpu.iridescenceThicknessMin = material.iridescenceThicknessMin;
+  gpu.iridescenceThicknessMax = material.iridescenceThicknessMax;
+  gpu.transmissionFactor = material.transmissionFactor;
+  gpu.thicknessFactor = material.thicknessFactor;
+  gpu.attenuationColorPacked =
+    (uint32_t(glm::clamp(material.attenuationColor.r, 0.0f, 1.0f) * 255.0f) << 0) |
+    (uint32_t(glm::clamp(material.attenuationColor.g, 0.0f, 1.0f) * 255.0f) << 8) |
+    (uint32_t(glm::clamp(material.attenuationColor.b, 0.0f, 1.0f) * 255.0f) << 16);
+  gpu.attenuationDistance = material.attenuationDistance;
+  return gpu;
+}
+
+uint32_t material_features(const SceneMaterial& material)
+{
+  uint32_t features = MATERIAL_FEATURE_IBL; // depends on the environment only
+  if (material.normalTexture)
+    features |= MATERIAL_FEATURE_NORMAL_MAP;
+  if (material.emissiveTexture)
+    features |= MATERIAL_FEATURE_EMISSIVE;
+  if (material.aoTexture)
+    features |= MATERIAL_FEATURE_AO;
+  if (material.iridescenceFactor > 0.0f)
+    features |= MATERIAL_FEATURE_IRIDESCENCE;
+  if (material.transmissionFactor > 0.0f)
+    features |= MATERIAL_FEATURE_SSS;
+  return features;
+}
+
+GpuInstance make_gpu_instance(const ScenePrimitive& primitive)
+{
+  GpuInstance gpu{};
+  gpu.model = primitive.modelMatrix;
+  gpu.materialIndex = primitive.materialIndex;
+  return gpu;
+}
+
+GpuDraw make_gpu_draw(const ScenePrimitive& primitive, const SceneMaterial& material)
+{
+  GpuDraw gpu{};
+  gpu.boundsMin = glm::vec4(primitive.bounds.min, 0.0f);
+  gpu.boundsMax = glm::vec4(primitive.bounds.max, 0.0f);
+  gpu.indexCount = primitive.indexCount;
+  gpu.firstIndex = primitive.firstIndex;
+  gpu.vertexOffset = primitive.vertexOffset;
+  if (!primitive.bounds.valid())
+    return gpu;
+
+  if (material.alphaMode == AlphaMode::Blend)
+  {
+    // Order-independent transparency needs no sort: cull mode is the only state
+    gpu.bucket = DRAW_BUCKET_BLEND | (material.doubleSided ? DRAW_BUCKET_DOUBLE_SIDED : 0u);
+  }
+  else
+  {
+    // Same state selection as the CPU-recorded opaque draws
+    gpu.bucket = (material.doubleSided ? DRAW_BUCKET_DOUBLE_SIDED : 0u)
+      | (material.transmissionFactor > 0.0f ? DRAW_BUCKET_SSS : 0u)
+      | (material.alphaMode == AlphaMode::Mask ? DRAW_BUCKET_ALPHA_MASK : 0u);
+    // Alpha-tested coverage has holes: it must not hide what is behind it
+    if (material.alphaMode == AlphaMode::Opaque)
+      gpu.flags |= DRAW_FLAG_OCCLUDER;
+  }
+  return gpu;
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+namespace sps::vulkan
+{
+
+struct SceneMaterial;
+struct ScenePrimitive;
+
+/// Per-material shader data, one entry per material in the material SSBO.
+///
+/// std430 layout, 96 bytes. Must match `struct Material` in scene_data.glsl.
+struct GpuMaterial
+{
+  glm::vec4 baseColorFactor{ 1.0f };
+  float metallicFactor{ 1.0f };
+  float roughnessFactor{ 1.0f };
+  float alphaCutoff{ 0.5f };
+  uint32_t alphaMode{ 0 }; // bits[1:0] AlphaMode, bit 2 doubleSided, bit 3 derive transmission
+  float iridescenceFactor{ 0.0f };
+  float iridescenceIor{ 1.3f };
+  float iridescenceThicknessMin{ 100.0f };
+  float iridescenceThicknessMax{ 400.0f };
+  float transmissionFactor{ 0.0f };
+  float thicknessFactor{ 0.0f };
+  uint32_t attenuationColorPacked{ 0x00FFFFFF }; // R8G8B8 unorm
+  float attenuationDistance{ 0.0f };
+
+  // Indices into the bindless texture table (filled in by RenderGraph)
+  uint32_t baseColorTextureIndex{ 0 };
+  uint32_t normalTextureIndex{ 0 };
+  uint32_t metallicRoughnessTextureIndex{ 0 };
+  uint32_t emissiveTextureIndex{ 0 };
+  uint32_t aoTextureIndex{ 0 };
+  uint32_t iridescenceTextureIndex{ 0 };
+  uint32_t iridescenceThicknessTextureIndex{ 0 };
+  uint32_t thicknessTextureIndex{ 0 };
+};
+
+static_assert(sizeof(GpuMaterial) == 96, "GpuMaterial must match the std430 shader layout");
+
+/// Per-draw shader data, one entry per scene primitive in the instance SSBO.
+///
+/// std430 layout, 80 bytes. Must match `struct Instance` in scene_data.glsl.
+/// Draws pass the entry index as firstInstance; the vertex shader reads it
+/// back through gl_InstanceIndex.
+struct GpuInstance
+{
+  glm::mat4 model{ 1.0f };
+  uint32_t materialIndex{ 0 };
+  uint32_t pad[3]{};
+};
+
+static_assert(sizeof(GpuInstance) == 80, "GpuInstance must match the std430 shader layout");
+
+/// Draw buckets of the GPU-driven opaque path: one per combination of the
+/// per-material dynamic state (cull mode, stencil reference) and of the
+/// depth pre-pass pipeline (position-only, or alpha-tested).
+inline constexpr uint32_t DRAW_BUCKET_DOUBLE_SIDED = 1; // cull mode none
+inline constexpr uint32_t DRAW_BUCKET_SSS = 2;          // stencil reference 1
+inline constexpr uint32_t DRAW_BUCKET_ALPHA_MASK = 4;   // MASK material (discards)
+inline constexpr uint32_t DRAW_BUCKET_COUNT = 8;        // opaque buckets
+
+/// BLEND primitives follow the opaque buckets, for the order-independent
+/// transparency pass (OitAccumulateStage): one bucket per cull mode.
+inline constexpr uint32_t DRAW_BUCKET_BLEND = DRAW_BUCKET_COUNT; // | DRAW_BUCKET_DOUBLE_SIDED
+inline constexpr uint32_t DRAW_BUCKET_TOTAL = DRAW_BUCKET_BLEND + 2;
+inline constexpr uint32_t DRAW_BUCKET_NONE = ~0u; // not drawn indirectly
+
+/// GpuDraw::flags bits.
+inline constexpr uint32_t DRAW_FLAG_OCCLUDER = 1; // fully opaque: may seed the Hi-Z pyramid
+
+/// Per-primitive draw source, one entry per scene primitive in the draw SSBO.
+///
+/// std430 layout, 64 bytes. Must match `struct Draw` in draw_cull.comp and
+/// hiz_cull.comp. The cull shaders turn visible entries into
+/// VkDrawIndexedIndirectCommands with the entry index as firstInstance (the
+/// primitive's GpuInstance).
+struct GpuDraw
+{
+  glm::vec4 boundsMin{ 0.0f }; // world-space AABB (w unused)
+  glm::vec4 boundsMax{ 0.0f };
+  uint32_t indexCount{ 0 };
+  uint32_t firstIndex{ 0 };
+  int32_t vertexOffset{ 0 };
+  uint32_t bucket{ DRAW_BUCKET_NONE };
+  uint32_t flags{ 0 }; // DRAW_FLAG_* bits
+  uint32_t pad0{ 0 };
+  uint32_t pad1{ 0 };
+  uint32_t pad2{ 0 };
+};
+
+static_assert(sizeof(GpuDraw) == 64, "GpuDraw must match the std430 shader layout");
+
+/// Shading features of a material, one bit each. A fragment shader variant
+/// (specialization constant MATERIAL_FEATURES in fragment.frag, which must
+/// match these bits) compiles out the code of every feature whose bit is clear.
+inline constexpr uint32_t MATERIAL_FEATURE_NORMAL_MAP = 1;  // normal texture: TBN path
+inline constexpr uint32_t MATERIAL_FEATURE_EMISSIVE = 2;    // emissive texture
+inline constexpr uint32_t MATERIAL_FEATURE_AO = 4;          // occlusion texture
+inline constexpr uint32_t MATERIAL_FEATURE_IRIDESCENCE = 8; // thin-film Fresnel
+inline constexpr uint32_t MATERIAL_FEATURE_SSS = 16;        // subsurface translucency and blur mask
+inline constexpr uint32_t MATERIAL_FEATURE_IBL = 32;        // image-based ambient lighting
+inline constexpr uint32_t MATERIAL_FEATURE_ALL = 63;        // the uber shader
+
+/// Features a material needs. A missing texture binds a default that is
+/// neutral for its feature (flat normal, black emissive, white occlusion),
+/// so its code can be skipped without changing the result.
+[[nodiscard]] uint32_t material_features(const SceneMaterial& material);
+
+/// Pack a scene material's factors. Texture indices are left at 0.
+[[nodiscard]] GpuMaterial make_gpu_material(const SceneMaterial& material);
+
+/// Pack a scene primitive's transform and material index.
+[[nodiscard]] GpuInstance make_gpu_instance(const ScenePrimitive& primitive);
+
+/// Pack a scene primitive's bounds, index range and draw bucket.
+[[nodiscard]] GpuDraw make_gpu_draw(const ScenePrimitive& primitive, const SceneMaterial& material);
+
+} // namespace sps::vulkan
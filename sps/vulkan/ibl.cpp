@@ -82,7 +82,8 @@ vk::CommandBuffer begin_single_time_commands(const Device& device, vk::CommandPo
   return cmd;
 }
 
-// End recording, submit and wait
+// End recording, submit and wait for this batch on the graphics timeline
+// (callers destroy intermediate images and buffers right after)
 void end_single_time_commands(
   const Device& device, vk::CommandPool pool, vk::CommandBuffer cmd)
 {
@@ -92,8 +93,7 @@ void end_single_time_commands(
   submit_info.commandBufferCount = 1;
   submit_info.pCommandBuffers = &cmd;
 
-  device.graphics_queue().submit(submit_info, nullptr);
-  device.graphics_queue().waitIdle();
+  device.wait_graphics(device.submit_graphics(submit_info));
 
   device.device().freeCommandBuffers(pool, cmd);
 }
@@ -126,7 +126,7 @@ void create_image(const Device& device, vk::Image& image, vk::DeviceMemory& memo
   alloc.memoryTypeIndex =
     device.find_memory_type(mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  memory = dev.allocateMemory(alloc);
+  memory = device.allocate_memory(alloc, MemoryCategory::Environment);
   dev.bindImageMemory(image, memory, 0);
 }
 
@@ -138,9 +138,10 @@ struct ComputePipeline
   vk::DescriptorSetLayout desc_layout;
 };
 
-ComputePipeline create_compute_pipeline(vk::Device dev, const std::string& spv_path,
+ComputePipeline create_compute_pipeline(const Device& device, const std::string& spv_path,
   std::vector<vk::DescriptorSetLayoutBinding> bindings, uint32_t push_constant_size)
 {
+  auto dev = device.device();
   ComputePipeline result{};
 
   // Descriptor set layout
@@ -174,7 +175,7 @@ ComputePipeline create_compute_pipeline(vk::Device dev, const std::string& spv_p
   ci.stage = stage;
   ci.layout = result.layout;
 
-  result.pipeline = dev.createComputePipeline(nullptr, ci).value;
+  result.pipeline = dev.createComputePipeline(device.pipeline_cache(), ci).value;
 
   dev.destroyShaderModule(module);
 
@@ -226,7 +227,7 @@ IBL::IBL(const Device& device, const std::string& hdr_path, const IBLSettings& s
   if (m_hdr_image)
     dev.destroyImage(m_hdr_image);
   if (m_hdr_memory)
-    dev.freeMemory(m_hdr_memory);
+    m_device.free_memory(m_hdr_memory);
   m_hdr_sampler = VK_NULL_HANDLE;
   m_hdr_view = VK_NULL_HANDLE;
   m_hdr_image = VK_NULL_HANDLE;
@@ -245,7 +246,7 @@ IBL::~IBL()
   if (m_brdf_lut_image)
     dev.destroyImage(m_brdf_lut_image);
   if (m_brdf_lut_memory)
-    dev.freeMemory(m_brdf_lut_memory);
+    m_device.free_memory(m_brdf_lut_memory);
 
   // Irradiance cleanup
   if (m_irradiance_sampler)
@@ -255,7 +256,7 @@ IBL::~IBL()
   if (m_irradiance_image)
     dev.destroyImage(m_irradiance_image);
   if (m_irradiance_memory)
-    dev.freeMemory(m_irradiance_memory);
+    m_device.free_memory(m_irradiance_memory);
 
   // Pre-filtered cleanup
   if (m_prefiltered_sampler)
@@ -265,7 +266,7 @@ IBL::~IBL()
   if (m_prefiltered_image)
     dev.destroyImage(m_prefiltered_image);
   if (m_prefiltered_memory)
-    dev.freeMemory(m_prefiltered_memory);
+    m_device.free_memory(m_prefiltered_memory);
 
   // HDR source cleanup (may already be freed)
   if (m_hdr_sampler)
@@ -275,7 +276,7 @@ IBL::~IBL()
   if (m_hdr_image)
     dev.destroyImage(m_hdr_image);
   if (m_hdr_memory)
-    dev.freeMemory(m_hdr_memory);
+    m_device.free_memory(m_hdr_memory);
 
   spdlog::trace("IBL resources destroyed");
 }
@@ -313,7 +314,8 @@ void IBL::upload_hdr_to_gpu()
   // Upload via staging buffer
   vk::DeviceSize data_size = m_hdr_width * m_hdr_height * 4 * sizeof(float);
   Buffer staging(m_device, "HDR staging", data_size, vk::BufferUsageFlagBits::eTransferSrc,
-    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    MemoryCategory::Staging);
   staging.update(m_hdr_data.data(), data_size);
 
   vk::CommandPoolCreateInfo pool_info{};
@@ -488,7 +490,7 @@ void IBL::run_compute_generation()
   // --- Create compute pipelines ---
 
   // 1. Equirect to cubemap: sampler2D + imageCube
-  auto equirect_pipeline = create_compute_pipeline(dev, SHADER_DIR "equirect_to_cubemap.spv",
+  auto equirect_pipeline = create_compute_pipeline(m_device, SHADER_DIR "equirect_to_cubemap.spv",
     {
       { 0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute },
       { 1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute }
@@ -496,7 +498,7 @@ void IBL::run_compute_generation()
     8); // face(4) + resolution(4)
 
   // 2. Irradiance: samplerCube + imageCube
-  auto irradiance_pipeline = create_compute_pipeline(dev, SHADER_DIR "irradiance.spv",
+  auto irradiance_pipeline = create_compute_pipeline(m_device, SHADER_DIR "irradiance.spv",
     {
       { 0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute },
       { 1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute }
@@ -504,7 +506,7 @@ void IBL::run_compute_generation()
     16); // face(4) + resolution(4) + sampleCount(4) + envResolution(4)
 
   // 3. Prefilter: samplerCube + imageCube
-  auto prefilter_pipeline = create_compute_pipeline(dev, SHADER_DIR "prefilter_env.spv",
+  auto prefilter_pipeline = create_compute_pipeline(m_device, SHADER_DIR "prefilter_env.spv",
     {
       { 0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute },
       { 1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute }
@@ -512,7 +514,7 @@ void IBL::run_compute_generation()
     20); // face(4) + resolution(4) + roughness(4) + sampleCount(4) + envResolution(4)
 
   // 4. BRDF LUT: image2D only
-  auto brdf_pipeline = create_compute_pipeline(dev, SHADER_DIR "brdf_lut.spv",
+  auto brdf_pipeline = create_compute_pipeline(m_device, SHADER_DIR "brdf_lut.spv",
     {
       { 0, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute }
     },
@@ -903,7 +905,7 @@ void IBL::create_default_environment()
   irr_alloc.allocationSize = irr_mem_reqs.size;
   irr_alloc.memoryTypeIndex =
     m_device.find_memory_type(irr_mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-  m_irradiance_memory = dev.allocateMemory(irr_alloc);
+  m_irradiance_memory = m_device.allocate_memory(irr_alloc, MemoryCategory::Environment);
   dev.bindImageMemory(m_irradiance_image, m_irradiance_memory, 0);
 
   // Allocate memory for prefiltered
@@ -912,7 +914,7 @@ void IBL::create_default_environment()
   pf_alloc.allocationSize = pf_mem_reqs.size;
   pf_alloc.memoryTypeIndex =
     m_device.find_memory_type(pf_mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-  m_prefiltered_memory = dev.allocateMemory(pf_alloc);
+  m_prefiltered_memory = m_device.allocate_memory(pf_alloc, MemoryCategory::Environment);
   dev.bindImageMemory(m_prefiltered_image, m_prefiltered_memory, 0);
 
   // Create neutral gray pixel data for all 6 faces
@@ -927,7 +929,8 @@ void IBL::create_default_environment()
 
   Buffer staging(m_device, "Cubemap staging", gray_data.size(),
     vk::BufferUsageFlagBits::eTransferSrc,
-    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    MemoryCategory::Staging);
   staging.update(gray_data.data(), gray_data.size());
 
   std::vector<vk::BufferImageCopy> regions(6);
@@ -1023,7 +1026,7 @@ void IBL::create_default_environment()
   m_brdf_lut_sampler = dev.createSampler(sampler_info);
 
   // Generate BRDF LUT via compute shader
-  auto brdf_pipeline = create_compute_pipeline(dev, SHADER_DIR "brdf_lut.spv",
+  auto brdf_pipeline = create_compute_pipeline(m_device, SHADER_DIR "brdf_lut.spv",
     { { 0, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute } },
     8);
 
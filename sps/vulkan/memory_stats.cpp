@@ -0,0 +1,195 @@
+#include <sps/vulkan/memory_stats.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+std::string format_bytes(vk::DeviceSize bytes)
+{
+  std::ostringstream oss;
+  oss.precision(1);
+  oss << std::fixed;
+  if (bytes >= (1ull << 30))
+    oss << static_cast<double>(bytes) / (1ull << 30) << " GiB";
+  else if (bytes >= (1ull << 20))
+    oss << static_cast<double>(bytes) / (1ull << 20) << " MiB";
+  else if (bytes >= (1ull << 10))
+    oss << static_cast<double>(bytes) / (1ull << 10) << " KiB";
+  else
+    oss << bytes << " B";
+  return oss.str();
+}
+
+} // namespace
+
+const char* to_string(MemoryCategory category)
+{
+  switch (category)
+  {
+    case MemoryCategory::Mesh:
+      return "Mesh";
+    case MemoryCategory::Texture:
+      return "Texture";
+    case MemoryCategory::Environment:
+      return "Environment";
+    case MemoryCategory::AccelerationStructure:
+      return "Acceleration structure";
+    case MemoryCategory::RenderTarget:
+      return "Render target";
+    case MemoryCategory::Transient:
+      return "Transient attachment";
+    case MemoryCategory::Uniform:
+      return "Uniform";
+    case MemoryCategory::Staging:
+      return "Staging";
+    case MemoryCategory::Other:
+    case MemoryCategory::Count:
+      break;
+  }
+  return "Other";
+}
+
+void MemoryStats::record_allocation(
+  vk::DeviceMemory memory, MemoryCategory category, vk::DeviceSize size, uint32_t heap_index)
+{
+  std::scoped_lock lock(m_mutex);
+
+  m_allocations[static_cast<VkDeviceMemory>(memory)] = { category, size, heap_index };
+
+  auto& stats = m_categories[static_cast<size_t>(category)];
+  stats.bytes += size;
+  stats.allocations++;
+  stats.peak_bytes = std::max(stats.peak_bytes, stats.bytes);
+
+  if (heap_index < VK_MAX_MEMORY_HEAPS)
+    m_heap_bytes[heap_index] += size;
+}
+
+void MemoryStats::record_free(vk::DeviceMemory memory)
+{
+  std::scoped_lock lock(m_mutex);
+
+  auto it = m_allocations.find(static_cast<VkDeviceMemory>(memory));
+  if (it == m_allocations.end())
+    return;
+
+  const Allocation& alloc = it->second;
+  auto& stats = m_categories[static_cast<size_t>(alloc.category)];
+  stats.bytes -= alloc.size;
+  stats.allocations--;
+
+  if (alloc.heap_index < VK_MAX_MEMORY_HEAPS)
+    m_heap_bytes[alloc.heap_index] -= alloc.size;
+
+  m_allocations.erase(it);
+}
+
+MemoryCategoryStats MemoryStats::category(MemoryCategory category) const
+{
+  std::scoped_lock lock(m_mutex);
+  return m_categories[static_cast<size_t>(category)];
+}
+
+vk::DeviceSize MemoryStats::total_bytes() const
+{
+  std::scoped_lock lock(m_mutex);
+  vk::DeviceSize total = 0;
+  for (const auto& c : m_categories)
+    total += c.bytes;
+  return total;
+}
+
+uint32_t MemoryStats::total_allocations() const
+{
+  std::scoped_lock lock(m_mutex);
+  return static_cast<uint32_t>(m_allocations.size());
+}
+
+vk::DeviceSize MemoryStats::heap_bytes(uint32_t heap_index) const
+{
+  std::scoped_lock lock(m_mutex);
+  return heap_index < VK_MAX_MEMORY_HEAPS ? m_heap_bytes[heap_index] : 0;
+}
+
+void MemoryStats::set_budget_warning(float threshold, BudgetWarningCallback callback)
+{
+  std::scoped_lock lock(m_mutex);
+  m_warning_threshold = threshold;
+  m_warning_callback = std::move(callback);
+  m_warned.fill(false);
+}
+
+void MemoryStats::check_budgets(const std::vector<HeapBudget>& heaps)
+{
+  std::vector<HeapBudget> crossed;
+  BudgetWarningCallback callback;
+  {
+    std::scoped_lock lock(m_mutex);
+    for (const auto& heap : heaps)
+    {
+      if (heap.heap_index >= VK_MAX_MEMORY_HEAPS || heap.budget == 0)
+        continue;
+
+      bool over = static_cast<double>(heap.usage) >=
+        static_cast<double>(heap.budget) * m_warning_threshold;
+      if (over && !m_warned[heap.heap_index])
+        crossed.push_back(heap);
+      m_warned[heap.heap_index] = over;
+    }
+    callback = m_warning_callback;
+  }
+
+  // Invoke outside the lock so the hook may query the stats
+  for (const auto& heap : crossed)
+  {
+    if (callback)
+    {
+      callback(heap);
+    }
+    else
+    {
+      spdlog::warn("GPU memory heap {} near budget: {} / {}", heap.heap_index,
+        format_bytes(heap.usage), format_bytes(heap.budget));
+    }
+  }
+}
+
+std::string MemoryStats::report(const std::vector<HeapBudget>& heaps) const
+{
+  std::scoped_lock lock(m_mutex);
+
+  std::ostringstream oss;
+  oss << "GPU memory by category:\n";
+  vk::DeviceSize total = 0;
+  for (size_t i = 0; i < m_categories.size(); i++)
+  {
+    const auto& c = m_categories[i];
+    total += c.bytes;
+    if (c.allocations == 0 && c.peak_bytes == 0)
+      continue;
+    oss << "  " << to_string(static_cast<MemoryCategory>(i)) << ": " << format_bytes(c.bytes)
+        << " in " << c.allocations << " allocations (peak " << format_bytes(c.peak_bytes) << ")\n";
+  }
+  oss << "  Total: " << format_bytes(total) << " in " << m_allocations.size() << " allocations\n";
+
+  oss << "Heaps:\n";
+  for (const auto& heap : heaps)
+  {
+    oss << "  [" << heap.heap_index << "]"
+        << ((heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) ? " device-local" : " host")
+        << ": usage " << format_bytes(heap.usage) << " / budget " << format_bytes(heap.budget)
+        << " (size " << format_bytes(heap.size) << ", app "
+        << format_bytes(heap.heap_index < VK_MAX_MEMORY_HEAPS ? m_heap_bytes[heap.heap_index] : 0)
+        << ")\n";
+  }
+  return oss.str();
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+/// What a device memory allocation is used for.
+enum class MemoryCategory : uint8_t
+{
+  Mesh = 0,              // vertex + index buffers
+  Texture,               // material textures
+  Environment,           // IBL cubemaps, BRDF LUT, source HDR
+  AccelerationStructure, // BLAS/TLAS storage, scratch, instance buffers
+  RenderTarget,          // HDR, MSAA, depth-stencil, stage-owned images
+  Transient,             // lazily-allocated attachments (may never be backed)
+  Uniform,               // uniform buffers, material + instance SSBOs
+  Staging,               // upload / readback buffers
+  Other,
+  Count
+};
+
+/// Human-readable category name.
+[[nodiscard]] const char* to_string(MemoryCategory category);
+
+/// Live counters for one category.
+struct MemoryCategoryStats
+{
+  vk::DeviceSize bytes{ 0 };      // currently allocated
+  vk::DeviceSize peak_bytes{ 0 }; // high-water mark
+  uint32_t allocations{ 0 };      // currently live allocations
+};
+
+/// Budget and usage for one memory heap (from VK_EXT_memory_budget).
+///
+/// When the extension is unavailable, budget is the heap size and usage is
+/// the sum of the application's own tracked allocations on that heap.
+struct HeapBudget
+{
+  uint32_t heap_index{ 0 };
+  vk::MemoryHeapFlags flags{};
+  vk::DeviceSize size{ 0 };
+  vk::DeviceSize budget{ 0 };
+  vk::DeviceSize usage{ 0 };
+};
+
+/// Device memory telemetry.
+///
+/// Tracks every vkAllocateMemory / vkFreeMemory made through
+/// Device::allocate_memory() and Device::free_memory(), bucketed by
+/// MemoryCategory and by memory heap. Thread-safe.
+///
+/// A budget warning hook fires once when a heap's usage crosses the
+/// configured fraction of its budget, and re-arms when usage drops below it.
+class MemoryStats
+{
+public:
+  using BudgetWarningCallback = std::function<void(const HeapBudget&)>;
+
+  /// Record a new allocation.
+  /// @param memory The allocated handle (used as key for the matching free).
+  /// @param category What the allocation is used for.
+  /// @param size Allocation size in bytes.
+  /// @param heap_index Heap backing the allocation's memory type.
+  void record_allocation(
+    vk::DeviceMemory memory, MemoryCategory category, vk::DeviceSize size, uint32_t heap_index);
+
+  /// Record a free. Unknown handles are ignored.
+  void record_free(vk::DeviceMemory memory);
+
+  /// Snapshot of the counters for one category.
+  [[nodiscard]] MemoryCategoryStats category(MemoryCategory category) const;
+
+  /// Total bytes currently allocated across all categories.
+  [[nodiscard]] vk::DeviceSize total_bytes() const;
+
+  /// Total live allocations across all categories.
+  [[nodiscard]] uint32_t total_allocations() const;
+
+  /// Bytes currently allocated by the application on a given heap.
+  [[nodiscard]] vk::DeviceSize heap_bytes(uint32_t heap_index) const;
+
+  /// Install the budget warning hook.
+  /// @param threshold Fraction of the heap budget (0..1) at which to warn.
+  /// @param callback Called with the offending heap. Null restores the default (spdlog::warn).
+  void set_budget_warning(float threshold, BudgetWarningCallback callback);
+
+  /// Compare heap usage against the threshold and fire the hook if crossed.
+  void check_budgets(const std::vector<HeapBudget>& heaps);
+
+  /// Multi-line report (categories + heaps) for logs and the command console.
+  [[nodiscard]] std::string report(const std::vector<HeapBudget>& heaps) const;
+
+private:
+  struct Allocation
+  {
+    MemoryCategory category;
+    vk::DeviceSize size;
+    uint32_t heap_index;
+  };
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<VkDeviceMemory, Allocation> m_allocations;
+  std::array<MemoryCategoryStats, static_cast<size_t>(MemoryCategory::Count)> m_categories{};
+  std::array<vk::DeviceSize, VK_MAX_MEMORY_HEAPS> m_heap_bytes{};
+
+  float m_warning_threshold{ 0.9f };
+  BudgetWarningCallback m_warning_callback;
+  std::array<bool, VK_MAX_MEMORY_HEAPS> m_warned{};
+};
+
+} // namespace sps::vulkan
@@ -6,56 +6,140 @@
 namespace sps::vulkan
 {
 
-Mesh::Mesh(const Device& device, const std::string& name, const std::vector<Vertex>& vertices)
+namespace
+{
+
+/// Create a mesh buffer and fill it with data.
+///
+/// Device-local buffers are filled through a temporary staging buffer and a
+/// one-time transfer submission (same pattern as Texture::upload_pixels).
+/// The CPU does not wait for the copy: the staging buffer is released once
+/// the graphics timeline passes the upload. Host-visible buffers are written
+/// directly through their persistent mapping.
+std::unique_ptr<Buffer> create_mesh_buffer(const Device& device, const std::string& name,
+  const void* data, vk::DeviceSize size, vk::BufferUsageFlags usage, bool host_visible)
+{
+  if (host_visible)
+  {
+    auto buffer = std::make_unique<Buffer>(device, name, size, usage,
+      vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+      MemoryCategory::Mesh);
+    buffer->update(data, size);
+    return buffer;
+  }
+
+  auto buffer = std::make_unique<Buffer>(device, name, size,
+    usage | vk::BufferUsageFlagBits::eTransferDst, vk::MemoryPropertyFlagBits::eDeviceLocal,
+    MemoryCategory::Mesh);
+
+  auto staging = std::make_shared<Buffer>(device, name + " staging", size,
+    vk::BufferUsageFlagBits::eTransferSrc,
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    MemoryCategory::Staging);
+  staging->update(data, size);
+
+  auto dev = device.device();
+
+  vk::CommandPoolCreateInfo pool_info{};
+  pool_info.queueFamilyIndex = device.m_graphics_queue_family_index;
+  pool_info.flags = vk::CommandPoolCreateFlagBits::eTransient;
+
+  vk::CommandPool cmd_pool = dev.createCommandPool(pool_info);
+
+  vk::CommandBufferAllocateInfo alloc_info{};
+  alloc_info.commandPool = cmd_pool;
+  alloc_info.level = vk::CommandBufferLevel::ePrimary;
+  alloc_info.commandBufferCount = 1;
+
+  vk::CommandBuffer cmd = dev.allocateCommandBuffers(alloc_info)[0];
+
+  vk::CommandBufferBeginInfo begin_info{};
+  begin_info.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  cmd.begin(begin_info);
+
+  vk::BufferCopy region{};
+  region.size = size;
+  cmd.copyBuffer(staging->buffer(), buffer->buffer(), region);
+
+  // Make the copy visible to every consumer (vertex input, storage reads in
+  // shaders, acceleration structure builds). Later submissions on the
+  // graphics queue are ordered after this barrier, so no CPU wait is needed.
+  vk::MemoryBarrier barrier{};
+  barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+  barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead;
+  cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+    vk::PipelineStageFlagBits::eAllCommands, {}, barrier, {}, {});
+
+  cmd.end();
+
+  vk::SubmitInfo submit_info{};
+  submit_info.commandBufferCount = 1;
+  submit_info.pCommandBuffers = &cmd;
+
+  device.submit_graphics(submit_info);
+
+  // Destroying the pool frees its command buffer
+  device.defer_release([staging, dev, cmd_pool]() mutable
+    {
+      staging.reset();
+      dev.destroyCommandPool(cmd_pool);
+    });
+
+  return buffer;
+}
+
+} // namespace
+
+Mesh::Mesh(const Device& device, const std::string& name, const std::vector<Vertex>& vertices,
+  bool host_visible)
   : m_name(name)
   , m_vertex_count(static_cast<uint32_t>(vertices.size()))
+  , m_host_visible(host_visible)
 {
   vk::DeviceSize buffer_size = sizeof(Vertex) * vertices.size();
 
   // Create vertex buffer
-  // Using HOST_VISIBLE for simplicity. For better performance, use staging buffer
-  // to copy to DEVICE_LOCAL memory.
   // Include ray tracing usage flags for acceleration structure building
-  m_vertex_buffer = std::make_unique<Buffer>(device, name + " vertex buffer", buffer_size,
+  m_vertex_buffer = create_mesh_buffer(device, name + " vertex buffer", vertices.data(),
+    buffer_size,
     vk::BufferUsageFlagBits::eVertexBuffer |
     vk::BufferUsageFlagBits::eShaderDeviceAddress |
     vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR,
-    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-  // Upload vertex data
-  m_vertex_buffer->update(vertices.data(), buffer_size);
+    host_visible);
 
-  spdlog::trace("Created mesh '{}' with {} vertices", name, m_vertex_count);
+  spdlog::trace("Created mesh '{}' with {} vertices ({})", name, m_vertex_count,
+    host_visible ? "host-visible" : "device-local");
 }
 
 Mesh::Mesh(const Device& device, const std::string& name, const std::vector<Vertex>& vertices,
-  const std::vector<uint32_t>& indices)
+  const std::vector<uint32_t>& indices, bool host_visible)
   : m_name(name)
   , m_vertex_count(static_cast<uint32_t>(vertices.size()))
   , m_index_count(static_cast<uint32_t>(indices.size()))
+  , m_host_visible(host_visible)
 {
   // Create vertex buffer with ray tracing usage flags
   vk::DeviceSize vertex_buffer_size = sizeof(Vertex) * vertices.size();
-  m_vertex_buffer = std::make_unique<Buffer>(device, name + " vertex buffer", vertex_buffer_size,
+  m_vertex_buffer = create_mesh_buffer(device, name + " vertex buffer", vertices.data(),
+    vertex_buffer_size,
     vk::BufferUsageFlagBits::eVertexBuffer |
     vk::BufferUsageFlagBits::eStorageBuffer |
     vk::BufferUsageFlagBits::eShaderDeviceAddress |
     vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR,
-    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-  m_vertex_buffer->update(vertices.data(), vertex_buffer_size);
+    host_visible);
 
   // Create index buffer with ray tracing usage flags
   vk::DeviceSize index_buffer_size = sizeof(uint32_t) * indices.size();
-  m_index_buffer = std::make_unique<Buffer>(device, name + " index buffer", index_buffer_size,
+  m_index_buffer = create_mesh_buffer(device, name + " index buffer", indices.data(),
+    index_buffer_size,
     vk::BufferUsageFlagBits::eIndexBuffer |
     vk::BufferUsageFlagBits::eStorageBuffer |
     vk::BufferUsageFlagBits::eShaderDeviceAddress |
     vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR,
-    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-  m_index_buffer->update(indices.data(), index_buffer_size);
+    host_visible);
 
-  spdlog::trace(
-    "Created mesh '{}' with {} vertices, {} indices", name, m_vertex_count, m_index_count);
+  spdlog::trace("Created mesh '{}' with {} vertices, {} indices ({})", name, m_vertex_count,
+    m_index_count, host_visible ? "host-visible" : "device-local");
 }
 
 void Mesh::bind(vk::CommandBuffer cmd) const
@@ -70,15 +154,15 @@ void Mesh::bind(vk::CommandBuffer cmd) const
   }
 }
 
-void Mesh::draw(vk::CommandBuffer cmd) const
+void Mesh::draw(vk::CommandBuffer cmd, uint32_t first_instance) const
 {
   if (m_index_buffer)
   {
-    cmd.drawIndexed(m_index_count, 1, 0, 0, 0);
+    cmd.drawIndexed(m_index_count, 1, 0, 0, first_instance);
   }
   else
   {
-    cmd.draw(m_vertex_count, 1, 0, 0);
+    cmd.draw(m_vertex_count, 1, 0, first_instance);
   }
 }
 
@@ -15,6 +15,11 @@ class Device;
 ///
 /// Holds vertex and optional index buffers for GPU rendering.
 /// Supports both indexed and non-indexed drawing.
+///
+/// By default the buffers live in DEVICE_LOCAL memory and are filled once via
+/// a staging buffer. Meshes whose data changes every frame can opt into
+/// HOST_VISIBLE memory instead, which avoids the staging copy but makes every
+/// vertex fetch cross the bus on discrete GPUs.
 class Mesh
 {
 public:
@@ -22,15 +27,18 @@ public:
   /// @param device The Vulkan device wrapper.
   /// @param name Debug name for the mesh.
   /// @param vertices Vertex data.
-  Mesh(const Device& device, const std::string& name, const std::vector<Vertex>& vertices);
+  /// @param host_visible Keep the buffer in HOST_VISIBLE memory (for dynamic meshes).
+  Mesh(const Device& device, const std::string& name, const std::vector<Vertex>& vertices,
+    bool host_visible = false);
 
   /// @brief Create a mesh from vertex and index data (indexed).
   /// @param device The Vulkan device wrapper.
   /// @param name Debug name for the mesh.
   /// @param vertices Vertex data.
   /// @param indices Index data.
+  /// @param host_visible Keep the buffers in HOST_VISIBLE memory (for dynamic meshes).
   Mesh(const Device& device, const std::string& name, const std::vector<Vertex>& vertices,
-    const std::vector<uint32_t>& indices);
+    const std::vector<uint32_t>& indices, bool host_visible = false);
 
   ~Mesh() = default;
 
@@ -48,7 +56,8 @@ public:
 
   /// @brief Record draw command.
   /// @param cmd The command buffer to record to.
-  void draw(vk::CommandBuffer cmd) const;
+  /// @param first_instance Instance index passed to the shaders (gl_InstanceIndex).
+  void draw(vk::CommandBuffer cmd, uint32_t first_instance = 0) const;
 
   /// @brief Get the number of vertices.
   [[nodiscard]] uint32_t vertex_count() const { return m_vertex_count; }
@@ -59,6 +68,9 @@ public:
   /// @brief Check if mesh uses indexed drawing.
   [[nodiscard]] bool is_indexed() const { return m_index_count > 0; }
 
+  /// @brief Check if the buffers live in HOST_VISIBLE memory.
+  [[nodiscard]] bool is_host_visible() const { return m_host_visible; }
+
   /// @brief Get the mesh name.
   [[nodiscard]] const std::string& name() const { return m_name; }
 
@@ -76,6 +88,7 @@ private:
 
   uint32_t m_vertex_count{ 0 };
   uint32_t m_index_count{ 0 };
+  bool m_host_visible{ false };
 };
 
 } // namespace sps::vulkan
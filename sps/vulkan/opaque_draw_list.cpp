@@ -0,0 +1,111 @@
+#include <sps/vulkan/opaque_draw_list.h>
+
+#include <sps/vulkan/frustum_culler.h>
+#include <sps/vulkan/gltf_loader.h>
+#include <sps/vulkan/radix_sort.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+constexpr uint64_t KEY_ALPHA_MASK = uint64_t{ 1 } << 63;
+constexpr uint64_t KEY_DOUBLE_SIDED = uint64_t{ 1 } << 62;
+constexpr uint64_t KEY_SSS = uint64_t{ 1 } << 61;
+constexpr uint32_t KEY_MATERIAL_SHIFT = 16;
+constexpr uint64_t NOT_DRAWN = ~uint64_t{ 0 }; // BLEND: drawn by RasterBlendStage
+
+/// Count the state commands of a draw order, the way RasterOpaqueStage
+/// records it (one command per state that differs from the previous draw).
+template <typename Order>
+DrawStateChanges count_changes(const GltfScene& scene, const Order& order)
+{
+  DrawStateChanges changes{};
+  bool first = true;
+  bool mask = false;
+  bool double_sided = false;
+  bool sss = false;
+  uint32_t material_index = 0;
+  for (const uint32_t i : order)
+  {
+    const uint32_t m = scene.primitives[i].materialIndex;
+    const auto& mat = scene.materials[m];
+    const bool draw_mask = mat.alphaMode == AlphaMode::Mask;
+    const bool draw_sss = mat.transmissionFactor > 0.0f;
+
+    changes.pipelines += (first || draw_mask != mask) ? 1u : 0u;
+    changes.cull_modes += (first || mat.doubleSided != double_sided) ? 1u : 0u;
+    changes.stencil_references += (first || draw_sss != sss) ? 1u : 0u;
+    changes.materials += (first || m != material_index) ? 1u : 0u;
+    ++changes.draws;
+
+    first = false;
+    mask = draw_mask;
+    double_sided = mat.doubleSided;
+    sss = draw_sss;
+    material_index = m;
+  }
+  return changes;
+}
+
+} // anonymous namespace
+
+void OpaqueDrawList::build_state_keys(const GltfScene& scene)
+{
+  m_state_keys.resize(scene.primitives.size());
+  for (size_t i = 0; i < scene.primitives.size(); ++i)
+  {
+    const uint32_t m = scene.primitives[i].materialIndex;
+    const auto& mat = scene.materials[m];
+    if (mat.alphaMode == AlphaMode::Blend)
+    {
+      m_state_keys[i] = NOT_DRAWN;
+      continue;
+    }
+    m_state_keys[i] = (mat.alphaMode == AlphaMode::Mask ? KEY_ALPHA_MASK : 0)
+      | (mat.doubleSided ? KEY_DOUBLE_SIDED : 0) | (mat.transmissionFactor > 0.0f ? KEY_SSS : 0)
+      | (uint64_t{ m } << KEY_MATERIAL_SHIFT);
+  }
+  m_scene = &scene;
+  m_primitive_count = scene.primitives.size();
+}
+
+void OpaqueDrawList::build(const GltfScene& scene, const FrustumCuller* culler, const glm::mat4& view)
+{
+  if (m_scene != &scene || m_primitive_count != scene.primitives.size())
+    build_state_keys(scene);
+
+  // View depth = -(view * p).z: only the third row of the view matrix
+  const glm::vec4 depth_row(-view[0][2], -view[1][2], -view[2][2], -view[3][2]);
+
+  m_keys.clear();
+  m_draws.clear();
+  for (uint32_t i = 0; i < m_primitive_count; ++i)
+  {
+    if (m_state_keys[i] == NOT_DRAWN || (culler && !culler->visible(i)))
+      continue;
+
+    const auto& prim = scene.primitives[i];
+    const glm::vec3 center = prim.bounds.valid()
+      ? (prim.bounds.min + prim.bounds.max) * 0.5f
+      : glm::vec3(prim.modelMatrix * glm::vec4(prim.centroid, 1.0f));
+    // Non-negative floats order like their bit patterns; the top 16 bits
+    // keep the exponent and 7 mantissa bits
+    const float depth = std::max(glm::dot(depth_row, glm::vec4(center, 1.0f)), 0.0f);
+    const auto bucket = static_cast<uint64_t>(std::bit_cast<uint32_t>(depth) >> 16);
+
+    m_keys.push_back(m_state_keys[i] | bucket);
+    m_draws.push_back(i);
+  }
+
+  // Loader order is the order before sorting
+  m_loader_changes = count_changes(scene, m_draws);
+  radix_sort(m_keys, m_draws, m_key_scratch, m_draw_scratch);
+  m_sorted_changes = count_changes(scene, m_draws);
+}
+
+} // namespace sps::vulkan
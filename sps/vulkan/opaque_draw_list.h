@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+class FrustumCuller;
+struct GltfScene;
+
+/// State commands an opaque draw order costs, counting a command whenever
+/// the state differs from the previous draw (the first draw sets everything).
+struct DrawStateChanges
+{
+  uint32_t draws{ 0 };
+  uint32_t pipelines{ 0 };          // opaque <-> alpha-tested (depth pre-pass)
+  uint32_t cull_modes{ 0 };
+  uint32_t stencil_references{ 0 };
+  uint32_t materials{ 0 };          // set 0 binds with classic (non-bindless) descriptors
+};
+
+/// Per-frame draw order of the CPU-recorded opaque pass (OPAQUE + MASK).
+///
+/// Every visible primitive gets a 64-bit key, most significant first:
+///   bit 63      pipeline (alpha-tested MASK materials last)
+///   bit 62      double-sided (cull mode)
+///   bit 61      SSS (stencil reference)
+///   bits 16-60  material index
+///   bits 0-15   view depth bucket, front to back
+/// and the keys are radix-sorted, so primitives sharing state are adjacent
+/// and RasterOpaqueStage skips the state commands between them. The state
+/// part of each key is computed when the scene changes; only the depth
+/// bucket (the top 16 bits of the float view depth: logarithmic buckets)
+/// is recomputed per frame.
+///
+/// Runs on the main thread before recording; stages then only read it.
+class OpaqueDrawList
+{
+public:
+  /// Sort the scene's visible OPAQUE + MASK primitives.
+  /// @param culler Frustum visibility (null: every primitive is visible).
+  /// @param view Camera view matrix, for the depth buckets.
+  void build(const GltfScene& scene, const FrustumCuller* culler, const glm::mat4& view);
+
+  /// Drop the cached state keys: call when the scene (or its materials) changes.
+  void invalidate() { m_scene = nullptr; }
+
+  /// Primitive indices in draw order (valid after build()).
+  [[nodiscard]] const std::vector<uint32_t>& draws() const { return m_draws; }
+
+  /// State changes of the sorted order.
+  [[nodiscard]] const DrawStateChanges& sorted_changes() const { return m_sorted_changes; }
+
+  /// State changes the same draws would cost in loader order.
+  [[nodiscard]] const DrawStateChanges& loader_order_changes() const { return m_loader_changes; }
+
+private:
+  const GltfScene* m_scene{ nullptr };
+  size_t m_primitive_count{ 0 };
+  std::vector<uint64_t> m_state_keys; // [primitive], state bits; NOT_DRAWN for BLEND
+
+  std::vector<uint64_t> m_keys;
+  std::vector<uint64_t> m_key_scratch;
+  std::vector<uint32_t> m_draws;
+  std::vector<uint32_t> m_draw_scratch;
+
+  DrawStateChanges m_sorted_changes;
+  DrawStateChanges m_loader_changes;
+
+  void build_state_keys(const GltfScene& scene);
+};
+
+} // namespace sps::vulkan
@@ -2,12 +2,13 @@
 
 #include <sps/vulkan/shaders.h>
 
+#include <array>
 #include <iostream>
 
 namespace sps::vulkan
 {
 vk::PipelineLayout make_pipeline_layout(
-  vk::Device device, vk::DescriptorSetLayout descriptorSetLayout,
+  vk::Device device, const std::vector<vk::DescriptorSetLayout>& descriptorSetLayouts,
   const std::vector<vk::PushConstantRange>& pushConstantRanges, bool debug)
 {
   vk::PipelineLayoutCreateInfo layoutInfo;
@@ -23,10 +24,10 @@ vk::PipelineLayout make_pipeline_layout(
     layoutInfo.pushConstantRangeCount = 0;
   }
 
-  if (descriptorSetLayout)
+  if (!descriptorSetLayouts.empty())
   {
-    layoutInfo.setLayoutCount = 1;
-    layoutInfo.pSetLayouts = &descriptorSetLayout;
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+    layoutInfo.pSetLayouts = descriptorSetLayouts.data();
   }
   else
   {
@@ -54,6 +55,10 @@ vk::RenderPass make_renderpass(vk::Device device, vk::Format swapchainImageForma
   const bool msaa = msaaSamples != vk::SampleCountFlagBits::e1;
   std::vector<vk::AttachmentDescription> attachments;
 
+  // No layout transitions inside the pass: the render graph's barrier plan
+  // moves every attachment into its subpass layout before the pass begins
+  // (and out of it afterwards), so initial = final = subpass layout.
+
   // Attachment 0: Color attachment
   vk::AttachmentDescription colorAttachment = {};
   colorAttachment.flags = vk::AttachmentDescriptionFlags();
@@ -180,10 +185,8 @@ vk::RenderPass make_scene_renderpass(vk::Device device, vk::Format hdrFormat,
   colorAttachment.storeOp = msaa ? vk::AttachmentStoreOp::eDontCare : vk::AttachmentStoreOp::eStore;
   colorAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
   colorAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-  colorAttachment.initialLayout = vk::ImageLayout::eUndefined;
-  colorAttachment.finalLayout = msaa
-    ? vk::ImageLayout::eColorAttachmentOptimal
-    : vk::ImageLayout::eShaderReadOnlyOptimal;
+  colorAttachment.initialLayout = vk::ImageLayout::eColorAttachmentOptimal;
+  colorAttachment.finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
   attachments.push_back(colorAttachment);
 
   // Attachment 1: Depth-stencil
@@ -191,10 +194,10 @@ vk::RenderPass make_scene_renderpass(vk::Device device, vk::Format hdrFormat,
   depthAttachment.format = depthFormat;
   depthAttachment.samples = msaaSamples;
   depthAttachment.loadOp = vk::AttachmentLoadOp::eClear;
-  depthAttachment.storeOp = vk::AttachmentStoreOp::eDontCare;
+  depthAttachment.storeOp = vk::AttachmentStoreOp::eStore; // OIT pass depth-tests against it
   depthAttachment.stencilLoadOp = vk::AttachmentLoadOp::eClear;
   depthAttachment.stencilStoreOp = vk::AttachmentStoreOp::eStore;
-  depthAttachment.initialLayout = vk::ImageLayout::eUndefined;
+  depthAttachment.initialLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
   depthAttachment.finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
   attachments.push_back(depthAttachment);
 
@@ -208,8 +211,8 @@ vk::RenderPass make_scene_renderpass(vk::Device device, vk::Format hdrFormat,
     resolveAttachment.storeOp = vk::AttachmentStoreOp::eStore;
     resolveAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
     resolveAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-    resolveAttachment.initialLayout = vk::ImageLayout::eUndefined;
-    resolveAttachment.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    resolveAttachment.initialLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    resolveAttachment.finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
     attachments.push_back(resolveAttachment);
   }
 
@@ -227,24 +230,15 @@ vk::RenderPass make_scene_renderpass(vk::Device device, vk::Format hdrFormat,
     subpass.pResolveAttachments = &resolveRef;
   }
 
-  vk::SubpassDependency dependency{};
-  dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-  dependency.dstSubpass = 0;
-  dependency.srcStageMask =
-    vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests;
-  dependency.srcAccessMask = vk::AccessFlagBits::eNone;
-  dependency.dstStageMask =
-    vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests;
-  dependency.dstAccessMask =
-    vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+  // No external dependencies: hazards against earlier work (this frame's
+  // PrePass, previous frames, aliased transient images) are covered by the
+  // barriers the render graph records before beginRenderPass.
 
   vk::RenderPassCreateInfo rpInfo{};
   rpInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
   rpInfo.pAttachments = attachments.data();
   rpInfo.subpassCount = 1;
   rpInfo.pSubpasses = &subpass;
-  rpInfo.dependencyCount = 1;
-  rpInfo.pDependencies = &dependency;
 
   try
   {
@@ -258,6 +252,106 @@ vk::RenderPass make_scene_renderpass(vk::Device device, vk::Format hdrFormat,
   return nullptr;
 }
 
+vk::RenderPass make_depth_renderpass(vk::Device device, vk::Format depthFormat, bool debug,
+  vk::SampleCountFlagBits msaaSamples)
+{
+  vk::AttachmentDescription depthAttachment{};
+  depthAttachment.format = depthFormat;
+  depthAttachment.samples = msaaSamples;
+  depthAttachment.loadOp = vk::AttachmentLoadOp::eClear;
+  depthAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+  depthAttachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+  depthAttachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+  depthAttachment.initialLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+  depthAttachment.finalLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+
+  vk::AttachmentReference depthRef{ 0, vk::ImageLayout::eDepthStencilAttachmentOptimal };
+
+  vk::SubpassDescription subpass{};
+  subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+  subpass.colorAttachmentCount = 0;
+  subpass.pDepthStencilAttachment = &depthRef;
+
+  vk::RenderPassCreateInfo rpInfo{};
+  rpInfo.attachmentCount = 1;
+  rpInfo.pAttachments = &depthAttachment;
+  rpInfo.subpassCount = 1;
+  rpInfo.pSubpasses = &subpass;
+
+  try
+  {
+    return device.createRenderPass(rpInfo);
+  }
+  catch (vk::SystemError err)
+  {
+    if (debug)
+      std::cout << "Failed to create depth renderpass!" << std::endl;
+  }
+  return nullptr;
+}
+
+vk::RenderPass make_oit_renderpass(vk::Device device, vk::Format accumFormat,
+  vk::Format revealageFormat, vk::Format depthFormat, bool debug,
+  vk::SampleCountFlagBits msaaSamples)
+{
+  std::array<vk::AttachmentDescription, 3> attachments{};
+
+  // 0: accumulation (sum of weighted premultiplied colors), cleared to 0
+  // 1: revealage (product of 1 - alpha), cleared to 1
+  attachments[0].format = accumFormat;
+  attachments[1].format = revealageFormat;
+  for (uint32_t i = 0; i < 2; ++i)
+  {
+    attachments[i].samples = msaaSamples;
+    attachments[i].loadOp = vk::AttachmentLoadOp::eClear;
+    attachments[i].storeOp = vk::AttachmentStoreOp::eStore;
+    attachments[i].stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+    attachments[i].stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+    attachments[i].initialLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    attachments[i].finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
+  }
+
+  // 2: scene depth-stencil, depth tested but never written. Stencil is
+  // loaded and stored as well: a don't-care load would be a write.
+  attachments[2].format = depthFormat;
+  attachments[2].samples = msaaSamples;
+  attachments[2].loadOp = vk::AttachmentLoadOp::eLoad;
+  attachments[2].storeOp = vk::AttachmentStoreOp::eStore;
+  attachments[2].stencilLoadOp = vk::AttachmentLoadOp::eLoad;
+  attachments[2].stencilStoreOp = vk::AttachmentStoreOp::eStore;
+  attachments[2].initialLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+  attachments[2].finalLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+
+  std::array<vk::AttachmentReference, 2> colorRefs{ {
+    { 0, vk::ImageLayout::eColorAttachmentOptimal },
+    { 1, vk::ImageLayout::eColorAttachmentOptimal },
+  } };
+  vk::AttachmentReference depthRef{ 2, vk::ImageLayout::eDepthStencilReadOnlyOptimal };
+
+  vk::SubpassDescription subpass{};
+  subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+  subpass.colorAttachmentCount = static_cast<uint32_t>(colorRefs.size());
+  subpass.pColorAttachments = colorRefs.data();
+  subpass.pDepthStencilAttachment = &depthRef;
+
+  vk::RenderPassCreateInfo rpInfo{};
+  rpInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+  rpInfo.pAttachments = attachments.data();
+  rpInfo.subpassCount = 1;
+  rpInfo.pSubpasses = &subpass;
+
+  try
+  {
+    return device.createRenderPass(rpInfo);
+  }
+  catch (vk::SystemError err)
+  {
+    if (debug)
+      std::cout << "Failed to create OIT renderpass!" << std::endl;
+  }
+  return nullptr;
+}
+
 vk::RenderPass make_composite_renderpass(vk::Device device, vk::Format swapchainFormat, bool debug)
 {
   // Single color attachment (swapchain image), no depth, no MSAA
@@ -322,7 +416,7 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
 
   // The info for the graphics pipeline
   vk::GraphicsPipelineCreateInfo pipelineInfo = {};
-  pipelineInfo.flags = vk::PipelineCreateFlags();
+  pipelineInfo.flags = specification.flags;
 
   // Shader stages, to be populated later
   std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
@@ -380,19 +474,25 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
   rasterizer.depthBiasEnable = VK_FALSE; // Depth bias can be useful in shadow maps.
   pipelineInfo.pRasterizationState = &rasterizer;
 
-  // Fragment Shader
-  if (debug)
+  // Fragment Shader (none for depth-only pipelines)
+  const bool depthOnly = specification.fragmentFilepath.empty();
+  vk::ShaderModule fragmentShader;
+  if (!depthOnly)
   {
-    std::cout << "Create fragment shader module" << std::endl;
+    if (debug)
+    {
+      std::cout << "Create fragment shader module" << std::endl;
+    }
+    fragmentShader =
+      sps::vulkan::createModule(specification.fragmentFilepath, specification.device, debug);
+    vk::PipelineShaderStageCreateInfo fragmentShaderInfo = {};
+    fragmentShaderInfo.flags = vk::PipelineShaderStageCreateFlags();
+    fragmentShaderInfo.stage = vk::ShaderStageFlagBits::eFragment;
+    fragmentShaderInfo.module = fragmentShader;
+    fragmentShaderInfo.pName = "main";
+    fragmentShaderInfo.pSpecializationInfo = specification.fragmentSpecialization;
+    shaderStages.push_back(fragmentShaderInfo);
   }
-  vk::ShaderModule fragmentShader =
-    sps::vulkan::createModule(specification.fragmentFilepath, specification.device, debug);
-  vk::PipelineShaderStageCreateInfo fragmentShaderInfo = {};
-  fragmentShaderInfo.flags = vk::PipelineShaderStageCreateFlags();
-  fragmentShaderInfo.stage = vk::ShaderStageFlagBits::eFragment;
-  fragmentShaderInfo.module = fragmentShader;
-  fragmentShaderInfo.pName = "main";
-  shaderStages.push_back(fragmentShaderInfo);
   // Now both shaders have been made, we can declare them to the pipeline info
   pipelineInfo.stageCount = shaderStages.size();
   pipelineInfo.pStages = shaderStages.data();
@@ -408,7 +508,7 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
   vk::PipelineDepthStencilStateCreateInfo depthStencil = {};
   depthStencil.depthTestEnable = specification.depthTestEnabled ? VK_TRUE : VK_FALSE;
   depthStencil.depthWriteEnable = (specification.depthTestEnabled && specification.depthWriteEnabled) ? VK_TRUE : VK_FALSE;
-  depthStencil.depthCompareOp = vk::CompareOp::eLess;
+  depthStencil.depthCompareOp = specification.depthCompareOp;
   depthStencil.depthBoundsTestEnable = VK_FALSE;
   depthStencil.stencilTestEnable = VK_FALSE;
 
@@ -430,9 +530,10 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
 
   // Color Blend
   vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
-  colorBlendAttachment.colorWriteMask = vk::ColorComponentFlagBits::eR |
-    vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB |
-    vk::ColorComponentFlagBits::eA;
+  colorBlendAttachment.colorWriteMask = (depthOnly || !specification.colorWriteEnabled)
+    ? vk::ColorComponentFlags{}
+    : vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
+      | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
   if (specification.blendEnabled)
   {
     colorBlendAttachment.blendEnable = VK_TRUE;
@@ -453,8 +554,17 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
   colorBlending.flags = vk::PipelineColorBlendStateCreateFlags();
   colorBlending.logicOpEnable = VK_FALSE;
   colorBlending.logicOp = vk::LogicOp::eCopy;
-  colorBlending.attachmentCount = 1;
-  colorBlending.pAttachments = &colorBlendAttachment;
+  if (specification.colorBlendAttachments.empty())
+  {
+    colorBlending.attachmentCount = specification.colorAttachmentCount;
+    colorBlending.pAttachments = &colorBlendAttachment;
+  }
+  else
+  {
+    colorBlending.attachmentCount =
+      static_cast<uint32_t>(specification.colorBlendAttachments.size());
+    colorBlending.pAttachments = specification.colorBlendAttachments.data();
+  }
   colorBlending.blendConstants[0] = 0.0f;
   colorBlending.blendConstants[1] = 0.0f;
   colorBlending.blendConstants[2] = 0.0f;
@@ -477,9 +587,15 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
     {
       std::cout << "Create Pipeline Layout" << std::endl;
     }
-    pipelineLayout =
-      make_pipeline_layout(specification.device, specification.descriptorSetLayout,
-        specification.pushConstantRanges, debug);
+    std::vector<vk::DescriptorSetLayout> setLayouts;
+    if (specification.descriptorSetLayout)
+    {
+      setLayouts.push_back(specification.descriptorSetLayout);
+      setLayouts.insert(setLayouts.end(), specification.additionalDescriptorSetLayouts.begin(),
+        specification.additionalDescriptorSetLayouts.end());
+    }
+    pipelineLayout = make_pipeline_layout(
+      specification.device, setLayouts, specification.pushConstantRanges, debug);
   }
   pipelineInfo.layout = pipelineLayout;
 
@@ -536,7 +652,8 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
   vk::Pipeline graphicsPipeline;
   try
   {
-    graphicsPipeline = (specification.device.createGraphicsPipeline(nullptr, pipelineInfo)).value;
+    graphicsPipeline =
+      specification.device.createGraphicsPipeline(specification.pipelineCache, pipelineInfo).value;
   }
   catch (vk::SystemError err)
   {
@@ -553,7 +670,8 @@ GraphicsPipelineOutBundle create_graphics_pipeline(
 
   // Finally clean up by destroying shader modules
   specification.device.destroyShaderModule(vertexShader);
-  specification.device.destroyShaderModule(fragmentShader);
+  if (fragmentShader)
+    specification.device.destroyShaderModule(fragmentShader);
 
   return output;
 }
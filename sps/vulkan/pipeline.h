@@ -14,11 +14,15 @@ namespace sps::vulkan
 struct GraphicsPipelineInBundle
 {
   vk::Device device;
+  vk::PipelineCache pipelineCache{ VK_NULL_HANDLE }; // Device::pipeline_cache()
   std::string vertexFilepath;
-  std::string fragmentFilepath;
+  std::string fragmentFilepath; // Empty: depth-only (no fragment stage, no color writes)
+  const vk::SpecializationInfo* fragmentSpecialization{ nullptr }; // Optional shader variant
+  vk::PipelineCreateFlags flags; // e.g. eCaptureStatisticsKHR
   vk::Extent2D swapchainExtent;
   vk::Format swapchainImageFormat;
   vk::DescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE }; // Optional
+  std::vector<vk::DescriptorSetLayout> additionalDescriptorSetLayouts; // Optional, sets 1..N
 
   // Vertex input (optional - if empty, no vertex buffers used)
   std::vector<vk::VertexInputBindingDescription> vertexBindings;
@@ -31,6 +35,7 @@ struct GraphicsPipelineInBundle
   // Depth testing
   bool depthTestEnabled{ false };
   bool depthWriteEnabled{ true };
+  vk::CompareOp depthCompareOp{ vk::CompareOp::eLess }; // eEqual after a depth pre-pass
   vk::Format depthFormat{ vk::Format::eD32Sfloat };
 
   // Stencil write (for SSS masking — writes stencil ref per draw)
@@ -38,6 +43,14 @@ struct GraphicsPipelineInBundle
 
   // Blending
   bool blendEnabled{ false };
+  bool colorWriteEnabled{ true }; // false: fragment shader only discards (depth pre-pass)
+
+  // Color attachments of the subpass (0 for depth-only render passes)
+  uint32_t colorAttachmentCount{ 1 };
+
+  // Optional: one blend state per color attachment (overrides blendEnabled,
+  // colorWriteEnabled and colorAttachmentCount)
+  std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachments;
 
   // Optional: use existing render pass instead of creating new one
   vk::RenderPass existingRenderPass{ VK_NULL_HANDLE };
@@ -64,7 +77,7 @@ struct GraphicsPipelineOutBundle
 };
 
 vk::PipelineLayout make_pipeline_layout(vk::Device device,
-  vk::DescriptorSetLayout descriptorSetLayout,
+  const std::vector<vk::DescriptorSetLayout>& descriptorSetLayouts,
   const std::vector<vk::PushConstantRange>& pushConstantRanges, bool debug);
 
 vk::RenderPass make_renderpass(vk::Device device, vk::Format swapchainImageFormat,
@@ -77,6 +90,19 @@ vk::RenderPass make_scene_renderpass(vk::Device device, vk::Format hdrFormat,
   vk::Format depthFormat, bool debug,
   vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1);
 
+/// Depth-only render pass: one cleared and stored depth-stencil attachment.
+/// Starts and ends in eDepthStencilAttachmentOptimal; the caller synchronizes.
+vk::RenderPass make_depth_renderpass(vk::Device device, vk::Format depthFormat, bool debug,
+  vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1);
+
+/// Weighted blended OIT render pass: a cleared accumulation and a cleared
+/// revealage color attachment, plus the scene depth-stencil, loaded and tested
+/// read-only. Colors start and end in eColorAttachmentOptimal, depth in
+/// eDepthStencilReadOnlyOptimal; the caller synchronizes.
+vk::RenderPass make_oit_renderpass(vk::Device device, vk::Format accumFormat,
+  vk::Format revealageFormat, vk::Format depthFormat, bool debug,
+  vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1);
+
 /// Composite render pass: single swapchain color attachment, no depth.
 vk::RenderPass make_composite_renderpass(vk::Device device, vk::Format swapchainFormat, bool debug);
 
@@ -8,7 +8,7 @@
 namespace sps::vulkan
 {
 
-std::unique_ptr<Mesh> load_ply(const Device& device, const std::string& filepath)
+std::unique_ptr<Mesh> load_ply(const Device& device, const std::string& filepath, bool host_visible)
 {
   // Check file exists
   if (!std::filesystem::exists(filepath))
@@ -256,11 +256,11 @@ std::unique_ptr<Mesh> load_ply(const Device& device, const std::string& filepath
   // Create mesh
   if (indices.empty())
   {
-    return std::make_unique<Mesh>(device, mesh_name, vertices);
+    return std::make_unique<Mesh>(device, mesh_name, vertices, host_visible);
   }
   else
   {
-    return std::make_unique<Mesh>(device, mesh_name, vertices, indices);
+    return std::make_unique<Mesh>(device, mesh_name, vertices, indices, host_visible);
   }
 }
 
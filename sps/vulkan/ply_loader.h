@@ -17,7 +17,9 @@ class Device;
 ///
 /// @param device The Vulkan device wrapper.
 /// @param filepath Path to the PLY file.
+/// @param host_visible Keep the mesh in HOST_VISIBLE memory (see Mesh).
 /// @return Loaded mesh, or nullptr on failure.
-std::unique_ptr<Mesh> load_ply(const Device& device, const std::string& filepath);
+std::unique_ptr<Mesh> load_ply(
+  const Device& device, const std::string& filepath, bool host_visible = false);
 
 } // namespace sps::vulkan
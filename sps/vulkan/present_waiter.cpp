@@ -0,0 +1,110 @@
+#include <sps/vulkan/present_waiter.h>
+
+#include <GLFW/glfw3.h>
+
+#include <utility>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+constexpr uint64_t WAIT_SLICE_NS = 5'000'000; // how quickly flush() is noticed
+constexpr double GIVE_UP_SECONDS = 1.0;       // never displayed (minimized, replaced swapchain)
+constexpr size_t MAX_PENDING = 16;
+
+} // anonymous namespace
+
+PresentWaiter::PresentWaiter(vk::Device device)
+  : m_device(device)
+{
+  m_thread = std::thread([this]() { thread_main(); });
+}
+
+PresentWaiter::~PresentWaiter()
+{
+  {
+    std::scoped_lock lock(m_mutex);
+    m_stop = true;
+    m_cancel = true;
+  }
+  m_wake.notify_one();
+  m_thread.join();
+}
+
+void PresentWaiter::push(vk::SwapchainKHR swapchain, uint64_t present_id, double input_time)
+{
+  {
+    std::scoped_lock lock(m_mutex);
+    m_pending.push_back({ swapchain, present_id, input_time });
+    if (m_pending.size() > MAX_PENDING)
+      m_pending.pop_front();
+  }
+  m_wake.notify_one();
+}
+
+void PresentWaiter::flush()
+{
+  std::unique_lock lock(m_mutex);
+  m_pending.clear();
+  m_cancel = true;
+  m_idle.wait(lock, [this]() { return !m_waiting; });
+  m_cancel = false;
+}
+
+std::vector<PresentWaiter::Displayed> PresentWaiter::take_displayed()
+{
+  std::scoped_lock lock(m_mutex);
+  return std::exchange(m_displayed, {});
+}
+
+void PresentWaiter::thread_main()
+{
+  std::unique_lock lock(m_mutex);
+  for (;;)
+  {
+    m_wake.wait(lock, [this]() { return m_stop || !m_pending.empty(); });
+    if (m_stop)
+      return;
+
+    const Pending present = m_pending.front();
+    m_pending.pop_front();
+    m_waiting = true;
+    lock.unlock();
+
+    // Completes once this present (or a later one replacing it) is displayed
+    const double give_up = glfwGetTime() + GIVE_UP_SECONDS;
+    bool displayed = false;
+    for (;;)
+    {
+      vk::Result result = vk::Result::eTimeout;
+      try
+      {
+        result = m_device.waitForPresentKHR(present.swapchain, present.id, WAIT_SLICE_NS);
+      }
+      catch (const vk::SystemError&)
+      {
+        break; // out of date or surface lost
+      }
+      if (result != vk::Result::eTimeout)
+      {
+        displayed = true;
+        break;
+      }
+
+      std::scoped_lock check(m_mutex);
+      if (m_cancel || glfwGetTime() > give_up)
+        break;
+    }
+    const double display_time = glfwGetTime();
+
+    lock.lock();
+    if (displayed && !m_cancel)
+      m_displayed.push_back({ present.input_time, display_time });
+    m_waiting = false;
+    m_idle.notify_all();
+  }
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+/// Waits for tagged presents (VK_KHR_present_id + VK_KHR_present_wait) on a
+/// helper thread, so a display time is taken when vkWaitForPresentKHR
+/// returns instead of whenever the render thread next checks.
+///
+/// Waits are bounded (short timeouts, dropped after a second), so flush()
+/// returns promptly even when a present is never shown (e.g. minimized).
+class PresentWaiter
+{
+public:
+  /// A present that reached the display (times from glfwGetTime()).
+  struct Displayed
+  {
+    double input_time;
+    double display_time;
+  };
+
+  explicit PresentWaiter(vk::Device device);
+  ~PresentWaiter();
+
+  PresentWaiter(const PresentWaiter&) = delete;
+  PresentWaiter& operator=(const PresentWaiter&) = delete;
+
+  /// Wait for present_id of swapchain; input_time is passed through.
+  void push(vk::SwapchainKHR swapchain, uint64_t present_id, double input_time);
+
+  /// Drop queued presents and wait for the wait in progress to return.
+  /// Call before the swapchain they refer to can be destroyed.
+  void flush();
+
+  /// Presents displayed since the last call, in present order.
+  [[nodiscard]] std::vector<Displayed> take_displayed();
+
+private:
+  struct Pending
+  {
+    vk::SwapchainKHR swapchain;
+    uint64_t id;
+    double input_time;
+  };
+
+  vk::Device m_device;
+  std::thread m_thread;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_idle;
+  std::deque<Pending> m_pending;
+  std::vector<Displayed> m_displayed;
+  bool m_waiting{ false }; // the thread is inside a wait
+  bool m_cancel{ false };  // flush(): abandon the wait in progress
+  bool m_stop{ false };
+
+  void thread_main();
+};
+
+} // namespace sps::vulkan
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+/// Sort (key, value) pairs by ascending key: LSD radix sort, 8 bits per pass.
+///
+/// Stable, O(passes * n). All digit histograms come from one read of the
+/// keys, and a pass whose digit is the same for every key is skipped, so keys
+/// that leave bytes unused (or constant) pay only for the bytes that vary.
+/// The scratch vectors are resized as needed; keep them across calls to
+/// avoid reallocating. On return keys and values may have swapped storage
+/// with the scratch vectors.
+template <typename Key>
+void radix_sort(std::vector<Key>& keys, std::vector<uint32_t>& values,
+  std::vector<Key>& key_scratch, std::vector<uint32_t>& value_scratch)
+{
+  static_assert(std::is_unsigned_v<Key>, "radix_sort needs unsigned integer keys");
+  constexpr size_t PASSES = sizeof(Key);
+
+  const size_t n = keys.size();
+  if (n < 2)
+    return;
+  key_scratch.resize(n);
+  value_scratch.resize(n);
+
+  std::array<std::array<uint32_t, 256>, PASSES> counts{};
+  for (const Key key : keys)
+  {
+    for (size_t pass = 0; pass < PASSES; ++pass)
+      ++counts[pass][(key >> (pass * 8)) & 0xFF];
+  }
+
+  for (size_t pass = 0; pass < PASSES; ++pass)
+  {
+    const size_t shift = pass * 8;
+    auto& count = counts[pass];
+    if (count[(keys[0] >> shift) & 0xFF] == n)
+      continue; // every key has this digit
+
+    // Histogram -> first slot of each digit
+    uint32_t offset = 0;
+    for (auto& c : count)
+    {
+      const uint32_t digit_count = c;
+      c = offset;
+      offset += digit_count;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      const uint32_t slot = count[(keys[i] >> shift) & 0xFF]++;
+      key_scratch[slot] = keys[i];
+      value_scratch[slot] = values[i];
+    }
+    keys.swap(key_scratch);
+    values.swap(value_scratch);
+  }
+}
+
+} // namespace sps::vulkan
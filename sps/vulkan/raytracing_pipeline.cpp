@@ -29,7 +29,7 @@ RayTracingPipeline::~RayTracingPipeline()
   if (m_sbt_buffer)
     dev.destroyBuffer(m_sbt_buffer);
   if (m_sbt_memory)
-    dev.freeMemory(m_sbt_memory);
+    m_device->free_memory(m_sbt_memory);
 }
 
 vk::ShaderModule RayTracingPipeline::create_shader_module(const std::string& path)
@@ -116,7 +116,8 @@ void RayTracingPipeline::create(const std::string& raygen_path, const std::strin
   pipelineInfo.maxPipelineRayRecursionDepth = 1;
   pipelineInfo.layout = m_layout;
 
-  auto result = dev.createRayTracingPipelineKHR(nullptr, nullptr, pipelineInfo);
+  auto result =
+    dev.createRayTracingPipelineKHR(nullptr, m_device->pipeline_cache(), pipelineInfo);
   if (result.result != vk::Result::eSuccess)
   {
     throw std::runtime_error("Failed to create ray tracing pipeline");
@@ -192,7 +193,7 @@ void RayTracingPipeline::create_shader_binding_table()
     memReqs.memoryTypeBits,
     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
-  m_sbt_memory = dev.allocateMemory(allocInfo);
+  m_sbt_memory = m_device->allocate_memory(allocInfo, MemoryCategory::Other);
   dev.bindBufferMemory(m_sbt_buffer, m_sbt_memory, 0);
 
   // Get buffer device address
@@ -1,11 +1,19 @@
 #include <sps/vulkan/render_graph.h>
+#include <sps/vulkan/buffer.h>
 #include <sps/vulkan/device.h>
 #include <sps/vulkan/renderer.h>
+#include <sps/vulkan/secondary_command_pools.h>
 #include <sps/vulkan/stages/composite_stage.h>
+#include <sps/vulkan/worker_pool.h>
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <array>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace sps::vulkan
 {
@@ -13,9 +21,29 @@ namespace sps::vulkan
 namespace
 {
 
+void set_viewport_and_scissor(vk::CommandBuffer cmd, vk::Extent2D extent)
+{
+  // Set dynamic viewport
+  vk::Viewport viewport{};
+  viewport.x = 0.0f;
+  viewport.y = 0.0f;
+  viewport.width = static_cast<float>(extent.width);
+  viewport.height = static_cast<float>(extent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+  cmd.setViewport(0, 1, &viewport);
+
+  // Set dynamic scissor
+  vk::Rect2D scissor{};
+  scissor.offset = vk::Offset2D{ 0, 0 };
+  scissor.extent = extent;
+  cmd.setScissor(0, 1, &scissor);
+}
+
 void begin_render_pass(const FrameContext& ctx, vk::RenderPass renderPass,
   vk::Framebuffer framebuffer, uint32_t clearCount,
-  const vk::ClearValue* clearValues)
+  const vk::ClearValue* clearValues,
+  vk::SubpassContents contents = vk::SubpassContents::eInline)
 {
   vk::RenderPassBeginInfo rpInfo{};
   rpInfo.renderPass = renderPass;
@@ -25,23 +53,13 @@ void begin_render_pass(const FrameContext& ctx, vk::RenderPass renderPass,
   rpInfo.clearValueCount = clearCount;
   rpInfo.pClearValues = clearValues;
 
-  ctx.command_buffer.beginRenderPass(&rpInfo, vk::SubpassContents::eInline);
+  ctx.command_buffer.beginRenderPass(&rpInfo, contents);
 
-  // Set dynamic viewport
-  vk::Viewport viewport{};
-  viewport.x = 0.0f;
-  viewport.y = 0.0f;
-  viewport.width = static_cast<float>(ctx.extent.width);
-  viewport.height = static_cast<float>(ctx.extent.height);
-  viewport.minDepth = 0.0f;
-  viewport.maxDepth = 1.0f;
-  ctx.command_buffer.setViewport(0, 1, &viewport);
-
-  // Set dynamic scissor
-  vk::Rect2D scissor{};
-  scissor.offset = vk::Offset2D{ 0, 0 };
-  scissor.extent = ctx.extent;
-  ctx.command_buffer.setScissor(0, 1, &scissor);
+  // Secondary command buffers set their own dynamic state
+  if (contents == vk::SubpassContents::eInline)
+  {
+    set_viewport_and_scissor(ctx.command_buffer, ctx.extent);
+  }
 }
 
 } // anonymous namespace
@@ -50,8 +68,10 @@ RenderGraph::~RenderGraph()
 {
   // Stages destroyed first — they may reference graph-owned images via descriptors.
   m_stages.clear();
+  m_secondary_pools.reset();
   destroy_scene_framebuffers();
   destroy_material_pool();
+  destroy_transient_images();
   destroy_hdr_resources();
 
   if (m_hdr_sampler && m_renderer)
@@ -65,6 +85,24 @@ RenderGraph::~RenderGraph()
     m_renderer->device().device().destroyDescriptorSetLayout(m_material_layout);
     m_material_layout = VK_NULL_HANDLE;
   }
+
+  if (m_bindless_layout && m_renderer)
+  {
+    m_renderer->device().device().destroyDescriptorSetLayout(m_bindless_layout);
+    m_bindless_layout = VK_NULL_HANDLE;
+  }
+
+  if (m_scene_data_layout && m_renderer)
+  {
+    m_renderer->device().device().destroyDescriptorSetLayout(m_scene_data_layout);
+    m_scene_data_layout = VK_NULL_HANDLE;
+  }
+
+  if (m_draw_cull_layout && m_renderer)
+  {
+    m_renderer->device().device().destroyDescriptorSetLayout(m_draw_cull_layout);
+    m_draw_cull_layout = VK_NULL_HANDLE;
+  }
 }
 
 void RenderGraph::create_material_descriptor_layout()
@@ -93,6 +131,142 @@ void RenderGraph::create_material_descriptor_layout()
 
   m_material_layout = m_renderer->device().device().createDescriptorSetLayout(layoutInfo);
   spdlog::info("Created graph-owned material descriptor layout (12 bindings)");
+
+  create_scene_data_layout();
+
+  if (m_bindless_requested && m_renderer->device().supports_bindless())
+  {
+    create_bindless_descriptor_layout();
+  }
+}
+
+void RenderGraph::create_bindless_descriptor_layout()
+{
+  // Upper bound for the texture table, within the per-stage sampler limits
+  // (3 more samplers are used by the IBL bindings)
+  constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
+  const auto& limits = m_renderer->device().physicalDevice().getProperties().limits;
+  uint32_t limit = std::min({ limits.maxPerStageDescriptorSamplers,
+    limits.maxPerStageDescriptorSampledImages, limits.maxDescriptorSetSamplers,
+    limits.maxDescriptorSetSampledImages });
+  if (limit <= 3)
+  {
+    spdlog::warn("Descriptor limits too small for bindless materials, using per-material sets");
+    return;
+  }
+  m_bindless_capacity = std::min(MAX_BINDLESS_TEXTURES, limit - 3);
+
+  // 5 bindings:
+  //   0: UBO (vertex + fragment)
+  //   1-3: IBL combined image samplers (BRDF LUT, irradiance, prefiltered)
+  //   4: texture table (variable-count combined image sampler array)
+  std::array<vk::DescriptorSetLayoutBinding, 5> bindings{};
+
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+  for (uint32_t i = 1; i <= 3; ++i)
+  {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = vk::ShaderStageFlagBits::eFragment;
+  }
+
+  bindings[4].binding = 4;
+  bindings[4].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+  bindings[4].descriptorCount = m_bindless_capacity;
+  bindings[4].stageFlags = vk::ShaderStageFlagBits::eFragment;
+
+  std::array<vk::DescriptorBindingFlags, 5> bindingFlags{};
+  bindingFlags[4] =
+    vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eVariableDescriptorCount;
+
+  vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{};
+  flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+  flagsInfo.pBindingFlags = bindingFlags.data();
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  layoutInfo.pNext = &flagsInfo;
+
+  m_bindless_layout = m_renderer->device().device().createDescriptorSetLayout(layoutInfo);
+  spdlog::info("Created bindless material descriptor layout (up to {} textures)", m_bindless_capacity);
+}
+
+void RenderGraph::create_scene_data_layout()
+{
+  // 2 bindings, both read-only SSBOs:
+  //   0: materials (GpuMaterial[]), indexed by the instance's material index
+  //   1: instances (GpuInstance[]), indexed by gl_InstanceIndex
+  std::array<vk::DescriptorSetLayoutBinding, 2> bindings{};
+  for (uint32_t i = 0; i < 2; ++i)
+  {
+    bindings[i].binding = i;
+    bindings[i].descriptorType = vk::DescriptorType::eStorageBuffer;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+  }
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+
+  m_scene_data_layout = m_renderer->device().device().createDescriptorSetLayout(layoutInfo);
+
+  if (!m_renderer->device().supports_indirect_count())
+    return;
+
+  // GPU-driven draws, 4 compute SSBO bindings:
+  //   0: draw sources (GpuDraw[]), read
+  //   1: indirect commands (DRAW_BUCKET_TOTAL regions of primitive_count), written
+  //   2: per-bucket draw counts, atomically incremented
+  //   3: per-primitive occlusion visibility of the previous frame (uint[])
+  std::array<vk::DescriptorSetLayoutBinding, 4> cull_bindings{};
+  for (uint32_t i = 0; i < 4; ++i)
+  {
+    cull_bindings[i].binding = i;
+    cull_bindings[i].descriptorType = vk::DescriptorType::eStorageBuffer;
+    cull_bindings[i].descriptorCount = 1;
+    cull_bindings[i].stageFlags = vk::ShaderStageFlagBits::eCompute;
+  }
+
+  layoutInfo.bindingCount = static_cast<uint32_t>(cull_bindings.size());
+  layoutInfo.pBindings = cull_bindings.data();
+  m_draw_cull_layout = m_renderer->device().device().createDescriptorSetLayout(layoutInfo);
+}
+
+vk::DescriptorSetLayout RenderGraph::scene_data_descriptor_layout() const
+{
+  return m_scene_data_layout;
+}
+
+vk::DescriptorSet RenderGraph::scene_data_descriptor_set() const
+{
+  return m_scene_data_set;
+}
+
+vk::Buffer RenderGraph::indirect_draw_buffer() const
+{
+  return m_indirect_buffer ? m_indirect_buffer->buffer() : vk::Buffer{};
+}
+
+vk::Buffer RenderGraph::draw_count_buffer() const
+{
+  return m_draw_count_buffer ? m_draw_count_buffer->buffer() : vk::Buffer{};
+}
+
+vk::DescriptorSetLayout RenderGraph::bindless_descriptor_layout() const
+{
+  return m_bindless_layout;
+}
+
+vk::DescriptorSet RenderGraph::bindless_descriptor_set(uint32_t frame_index) const
+{
+  return m_bindless_sets[frame_index];
 }
 
 vk::DescriptorSetLayout RenderGraph::material_descriptor_layout() const
@@ -109,15 +283,49 @@ void RenderGraph::destroy_material_pool()
   }
   m_default_sets.clear();
   m_material_sets.clear();
+
+  if (m_bindless_pool && m_renderer)
+  {
+    m_renderer->device().device().destroyDescriptorPool(m_bindless_pool);
+    m_bindless_pool = VK_NULL_HANDLE;
+  }
+  m_bindless_sets.clear();
+
+  if (m_scene_data_pool && m_renderer)
+  {
+    m_renderer->device().device().destroyDescriptorPool(m_scene_data_pool);
+    m_scene_data_pool = VK_NULL_HANDLE;
+  }
+
+  if (m_draw_cull_pool && m_renderer)
+  {
+    m_renderer->device().device().destroyDescriptorPool(m_draw_cull_pool);
+    m_draw_cull_pool = VK_NULL_HANDLE;
+  }
+  m_scene_data_set = VK_NULL_HANDLE;
+  m_draw_cull_set = VK_NULL_HANDLE;
+  m_material_buffer.reset();
+  m_instance_buffer.reset();
+  m_draw_buffer.reset();
+  m_indirect_buffer.reset();
+  m_draw_count_buffer.reset();
+  m_visibility_buffer.reset();
+  m_gpu_draw_count = 0;
 }
 
 void RenderGraph::allocate_material_descriptors(
   const MaterialTextureSet& default_textures,
   const std::vector<MaterialTextureSet>& material_textures,
+  const std::vector<GpuMaterial>& material_params,
+  const std::vector<GpuInstance>& instance_params,
+  const std::vector<GpuDraw>& draw_params,
   const std::vector<vk::DescriptorBufferInfo>& ubo_infos)
 {
   auto dev = m_renderer->device().device();
 
+  // New scene: stage chunking and the plan built on it are stale
+  invalidate();
+
   // Destroy old pool (implicitly frees all sets)
   destroy_material_pool();
 
@@ -177,6 +385,308 @@ void RenderGraph::allocate_material_descriptors(
 
   spdlog::info("Allocated {} material descriptor sets ({} frames x ({} materials + 1 default))",
     total_sets, m_frames_in_flight, mat_count);
+
+  // Material SSBO entries: scene materials, then the default material
+  std::vector<GpuMaterial> materials(mat_count + 1);
+  for (uint32_t m = 0; m < mat_count && m < material_params.size(); ++m)
+  {
+    materials[m] = material_params[m];
+  }
+
+  if (m_bindless_layout)
+  {
+    allocate_bindless_descriptors(default_textures, material_textures, materials, ubo_infos);
+  }
+
+  // Instance SSBO entries: scene primitives, then the legacy single-mesh draw
+  std::vector<GpuInstance> instances(instance_params.begin(), instance_params.end());
+  GpuInstance default_instance{};
+  default_instance.materialIndex = mat_count;
+  instances.push_back(default_instance);
+  m_default_instance = static_cast<uint32_t>(instances.size() - 1);
+
+  upload_scene_data(materials, instances, draw_params);
+}
+
+void RenderGraph::upload_scene_data(const std::vector<GpuMaterial>& materials,
+  const std::vector<GpuInstance>& instances, const std::vector<GpuDraw>& draws)
+{
+  auto dev = m_renderer->device().device();
+
+  // Static until the next scene/HDR load, so small host-visible buffers suffice
+  const vk::MemoryPropertyFlags host_memory =
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+  vk::DeviceSize material_size = sizeof(GpuMaterial) * materials.size();
+  m_material_buffer = std::make_unique<Buffer>(m_renderer->device(), "material_ssbo",
+    material_size, vk::BufferUsageFlagBits::eStorageBuffer, host_memory, MemoryCategory::Uniform);
+  m_material_buffer->update(materials.data(), material_size);
+
+  vk::DeviceSize instance_size = sizeof(GpuInstance) * instances.size();
+  m_instance_buffer = std::make_unique<Buffer>(m_renderer->device(), "instance_ssbo",
+    instance_size, vk::BufferUsageFlagBits::eStorageBuffer, host_memory, MemoryCategory::Uniform);
+  m_instance_buffer->update(instances.data(), instance_size);
+
+  vk::DescriptorPoolSize pool_size{ vk::DescriptorType::eStorageBuffer, 2 };
+
+  vk::DescriptorPoolCreateInfo poolInfo{};
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 1;
+  poolInfo.pPoolSizes = &pool_size;
+  m_scene_data_pool = dev.createDescriptorPool(poolInfo);
+
+  vk::DescriptorSetAllocateInfo allocInfo{};
+  allocInfo.descriptorPool = m_scene_data_pool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &m_scene_data_layout;
+  m_scene_data_set = dev.allocateDescriptorSets(allocInfo)[0];
+
+  std::array<vk::DescriptorBufferInfo, 2> buffer_infos = {
+    vk::DescriptorBufferInfo{ m_material_buffer->buffer(), 0, material_size },
+    vk::DescriptorBufferInfo{ m_instance_buffer->buffer(), 0, instance_size }
+  };
+
+  std::array<vk::WriteDescriptorSet, 2> writes{};
+  for (uint32_t i = 0; i < 2; ++i)
+  {
+    writes[i].dstSet = m_scene_data_set;
+    writes[i].dstBinding = i;
+    writes[i].descriptorType = vk::DescriptorType::eStorageBuffer;
+    writes[i].descriptorCount = 1;
+    writes[i].pBufferInfo = &buffer_infos[i];
+  }
+  dev.updateDescriptorSets(writes, {});
+
+  spdlog::info("Uploaded scene data ({} materials, {} instances)", materials.size(),
+    instances.size());
+
+  if (m_draw_cull_layout && !draws.empty())
+    upload_draw_data(draws);
+}
+
+void RenderGraph::upload_draw_data(const std::vector<GpuDraw>& draws)
+{
+  const Device& device = m_renderer->device();
+  auto dev = device.device();
+
+  const auto count = static_cast<uint32_t>(draws.size());
+  if (count > device.physicalDevice().getProperties().limits.maxDrawIndirectCount)
+  {
+    spdlog::warn("{} primitives exceed maxDrawIndirectCount, GPU-driven draws disabled", count);
+    return;
+  }
+
+  vk::DeviceSize draw_size = sizeof(GpuDraw) * draws.size();
+  m_draw_buffer = std::make_unique<Buffer>(device, "draw_ssbo", draw_size,
+    vk::BufferUsageFlagBits::eStorageBuffer,
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    MemoryCategory::Uniform);
+  m_draw_buffer->update(draws.data(), draw_size);
+
+  // GPU-only outputs of the cull pass: each bucket can hold every primitive
+  vk::DeviceSize indirect_size =
+    sizeof(vk::DrawIndexedIndirectCommand) * DRAW_BUCKET_TOTAL * draws.size();
+  m_indirect_buffer = std::make_unique<Buffer>(device, "indirect_draws", indirect_size,
+    vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+    vk::MemoryPropertyFlagBits::eDeviceLocal, MemoryCategory::Other);
+
+  vk::DeviceSize count_size = sizeof(uint32_t) * DRAW_BUCKET_TOTAL;
+  m_draw_count_buffer = std::make_unique<Buffer>(device, "indirect_draw_counts", count_size,
+    vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer
+      | vk::BufferUsageFlagBits::eTransferDst,
+    vk::MemoryPropertyFlagBits::eDeviceLocal, MemoryCategory::Other);
+
+  // Occlusion culling starts with everything visible
+  const std::vector<uint32_t> visible(draws.size(), 1u);
+  vk::DeviceSize visibility_size = sizeof(uint32_t) * draws.size();
+  m_visibility_buffer = std::make_unique<Buffer>(device, "draw_visibility", visibility_size,
+    vk::BufferUsageFlagBits::eStorageBuffer,
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    MemoryCategory::Other);
+  m_visibility_buffer->update(visible.data(), visibility_size);
+
+  vk::DescriptorPoolSize pool_size{ vk::DescriptorType::eStorageBuffer, 4 };
+
+  vk::DescriptorPoolCreateInfo poolInfo{};
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = 1;
+  poolInfo.pPoolSizes = &pool_size;
+  m_draw_cull_pool = dev.createDescriptorPool(poolInfo);
+
+  vk::DescriptorSetAllocateInfo allocInfo{};
+  allocInfo.descriptorPool = m_draw_cull_pool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &m_draw_cull_layout;
+  m_draw_cull_set = dev.allocateDescriptorSets(allocInfo)[0];
+
+  std::array<vk::DescriptorBufferInfo, 4> buffer_infos = {
+    vk::DescriptorBufferInfo{ m_draw_buffer->buffer(), 0, draw_size },
+    vk::DescriptorBufferInfo{ m_indirect_buffer->buffer(), 0, indirect_size },
+    vk::DescriptorBufferInfo{ m_draw_count_buffer->buffer(), 0, count_size },
+    vk::DescriptorBufferInfo{ m_visibility_buffer->buffer(), 0, visibility_size }
+  };
+
+  std::array<vk::WriteDescriptorSet, 4> writes{};
+  for (uint32_t i = 0; i < 4; ++i)
+  {
+    writes[i].dstSet = m_draw_cull_set;
+    writes[i].dstBinding = i;
+    writes[i].descriptorType = vk::DescriptorType::eStorageBuffer;
+    writes[i].descriptorCount = 1;
+    writes[i].pBufferInfo = &buffer_infos[i];
+  }
+  dev.updateDescriptorSets(writes, {});
+
+  m_gpu_draw_count = count;
+  spdlog::info("Uploaded GPU-driven draw data ({} primitives, {} KiB of indirect commands)",
+    count, indirect_size / 1024);
+}
+
+void RenderGraph::allocate_bindless_descriptors(const MaterialTextureSet& default_textures,
+  const std::vector<MaterialTextureSet>& material_textures,
+  std::vector<GpuMaterial>& materials,
+  const std::vector<vk::DescriptorBufferInfo>& ubo_infos)
+{
+  auto dev = m_renderer->device().device();
+
+  // MaterialTextureSet slots that are per-material (the rest are IBL), in
+  // GpuMaterial texture index order
+  constexpr std::array<uint32_t, 8> MATERIAL_SLOTS = { 0, 1, 2, 3, 4, 8, 9, 10 };
+
+  // Texture table: every distinct view + sampler pair, defaults first
+  std::vector<vk::DescriptorImageInfo> table;
+  std::map<std::pair<VkImageView, VkSampler>, uint32_t> table_index;
+  bool overflow = false;
+
+  auto add_texture = [&](const TextureBinding& binding, uint32_t fallback) -> uint32_t
+  {
+    auto key = std::make_pair(static_cast<VkImageView>(binding.view),
+      static_cast<VkSampler>(binding.sampler));
+    if (auto it = table_index.find(key); it != table_index.end())
+      return it->second;
+    if (table.size() >= m_bindless_capacity)
+    {
+      overflow = true;
+      return fallback;
+    }
+
+    uint32_t index = static_cast<uint32_t>(table.size());
+    table.push_back({ binding.sampler, binding.view, vk::ImageLayout::eShaderReadOnlyOptimal });
+    table_index.emplace(key, index);
+    return index;
+  };
+
+  auto assign_textures = [&](GpuMaterial& material, const MaterialTextureSet& textures,
+                           const std::array<uint32_t, 8>& fallbacks)
+  {
+    std::array<uint32_t*, 8> indices = { &material.baseColorTextureIndex,
+      &material.normalTextureIndex, &material.metallicRoughnessTextureIndex,
+      &material.emissiveTextureIndex, &material.aoTextureIndex,
+      &material.iridescenceTextureIndex, &material.iridescenceThicknessTextureIndex,
+      &material.thicknessTextureIndex };
+    for (size_t i = 0; i < MATERIAL_SLOTS.size(); ++i)
+    {
+      *indices[i] = add_texture(textures.textures[MATERIAL_SLOTS[i]], fallbacks[i]);
+    }
+  };
+
+  // Default material goes last so scene material indices map 1:1
+  const uint32_t mat_count = static_cast<uint32_t>(material_textures.size());
+
+  GpuMaterial& default_material = materials[mat_count];
+  assign_textures(default_material, default_textures, {});
+  const std::array<uint32_t, 8> default_indices = { default_material.baseColorTextureIndex,
+    default_material.normalTextureIndex, default_material.metallicRoughnessTextureIndex,
+    default_material.emissiveTextureIndex, default_material.aoTextureIndex,
+    default_material.iridescenceTextureIndex, default_material.iridescenceThicknessTextureIndex,
+    default_material.thicknessTextureIndex };
+
+  for (uint32_t m = 0; m < mat_count; ++m)
+  {
+    assign_textures(materials[m], material_textures[m], default_indices);
+  }
+
+  if (overflow)
+  {
+    spdlog::warn("Bindless texture table full ({} entries), extra textures use defaults",
+      m_bindless_capacity);
+  }
+
+  // Pool + one set per frame
+  const uint32_t table_size = static_cast<uint32_t>(table.size());
+  std::array<vk::DescriptorPoolSize, 2> pool_sizes{};
+  pool_sizes[0].type = vk::DescriptorType::eUniformBuffer;
+  pool_sizes[0].descriptorCount = m_frames_in_flight;
+  pool_sizes[1].type = vk::DescriptorType::eCombinedImageSampler;
+  pool_sizes[1].descriptorCount = m_frames_in_flight * (3 + table_size);
+
+  vk::DescriptorPoolCreateInfo poolInfo{};
+  poolInfo.maxSets = m_frames_in_flight;
+  poolInfo.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+  poolInfo.pPoolSizes = pool_sizes.data();
+  m_bindless_pool = dev.createDescriptorPool(poolInfo);
+
+  std::vector<vk::DescriptorSetLayout> layouts(m_frames_in_flight, m_bindless_layout);
+  std::vector<uint32_t> counts(m_frames_in_flight, table_size);
+
+  vk::DescriptorSetVariableDescriptorCountAllocateInfo countInfo{};
+  countInfo.descriptorSetCount = m_frames_in_flight;
+  countInfo.pDescriptorCounts = counts.data();
+
+  vk::DescriptorSetAllocateInfo allocInfo{};
+  allocInfo.descriptorPool = m_bindless_pool;
+  allocInfo.descriptorSetCount = m_frames_in_flight;
+  allocInfo.pSetLayouts = layouts.data();
+  allocInfo.pNext = &countInfo;
+  m_bindless_sets = dev.allocateDescriptorSets(allocInfo);
+
+  std::array<vk::DescriptorImageInfo, 3> ibl_infos{};
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    const auto& binding = default_textures.textures[5 + i];
+    ibl_infos[i] = { binding.sampler, binding.view, vk::ImageLayout::eShaderReadOnlyOptimal };
+  }
+
+  for (uint32_t f = 0; f < m_frames_in_flight; ++f)
+  {
+    std::vector<vk::WriteDescriptorSet> writes;
+
+    vk::WriteDescriptorSet ubo_write{};
+    ubo_write.dstSet = m_bindless_sets[f];
+    ubo_write.dstBinding = 0;
+    ubo_write.descriptorType = vk::DescriptorType::eUniformBuffer;
+    ubo_write.descriptorCount = 1;
+    ubo_write.pBufferInfo = &ubo_infos[f];
+    writes.push_back(ubo_write);
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+      vk::WriteDescriptorSet ibl_write{};
+      ibl_write.dstSet = m_bindless_sets[f];
+      ibl_write.dstBinding = 1 + i;
+      ibl_write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+      ibl_write.descriptorCount = 1;
+      ibl_write.pImageInfo = &ibl_infos[i];
+      writes.push_back(ibl_write);
+    }
+
+    if (table_size > 0)
+    {
+      vk::WriteDescriptorSet table_write{};
+      table_write.dstSet = m_bindless_sets[f];
+      table_write.dstBinding = 4;
+      table_write.dstArrayElement = 0;
+      table_write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+      table_write.descriptorCount = table_size;
+      table_write.pImageInfo = table.data();
+      writes.push_back(table_write);
+    }
+
+    dev.updateDescriptorSets(writes, {});
+  }
+
+  spdlog::info("Allocated {} bindless descriptor sets ({} textures, {} materials + 1 default)",
+    m_frames_in_flight, table_size, mat_count);
 }
 
 void RenderGraph::write_material_set(vk::DescriptorSet set,
@@ -238,97 +748,500 @@ void RenderGraph::set_composite_stage(const CompositeStage* stage)
   m_composite_stage = stage;
 }
 
-void RenderGraph::record(const FrameContext& ctx)
+void RenderGraph::set_async_compute(bool enabled)
 {
-  // Phase 1: PrePass stages (outside render pass)
-  for (auto& stage : m_stages)
+  m_async_compute = enabled && m_renderer->device().supports_async_compute();
+  if (enabled && !m_async_compute)
   {
-    if (stage->phase() == Phase::PrePass && stage->is_enabled())
+    spdlog::warn("No dedicated compute queue family, async compute disabled");
+  }
+  invalidate();
+}
+
+vk::PipelineStageFlags RenderGraph::compute_wait_stages() const
+{
+  if (!m_plan_async)
+    return vk::PipelineStageFlagBits::eAllCommands;
+  return m_barrier_plan.queue_wait_stages(Phase::PrePass)
+    | m_barrier_plan.queue_wait_stages(Phase::ScenePass);
+}
+
+vk::PipelineStageFlags RenderGraph::resume_wait_stages() const
+{
+  // Without acquires the wait still has to happen, so that the frame's
+  // graphics timeline value covers its compute work
+  const vk::PipelineStageFlags stages = m_barrier_plan.queue_wait_stages(Phase::CompositePass);
+  return stages ? stages : vk::PipelineStageFlags(vk::PipelineStageFlagBits::eAllCommands);
+}
+
+void RenderGraph::set_parallel_recording(WorkerPool* workers, uint32_t frames_in_flight)
+{
+  m_workers = workers;
+  m_secondary_pools.reset();
+  invalidate();
+  if (workers && workers->thread_count() > 1)
+  {
+    m_secondary_pools = std::make_unique<SecondaryCommandPools>(
+      m_renderer->device(), frames_in_flight, workers->thread_count());
+    spdlog::trace("Parallel recording: {} threads, {} frames in flight",
+      workers->thread_count(), frames_in_flight);
+  }
+}
+
+RenderGraph::PlanKey RenderGraph::plan_key(const FrameContext& ctx) const
+{
+  PlanKey key;
+  for (size_t i = 0; i < m_stages.size(); ++i)
+  {
+    if (m_stages[i]->is_enabled())
+      key.enabled |= uint64_t{ 1 } << i;
+  }
+  key.extent = ctx.extent;
+  key.mesh = ctx.mesh;
+  key.scene = ctx.scene;
+  key.async_compute = m_async_compute && ctx.compute_command_buffer && ctx.resume_command_buffer;
+  return key;
+}
+
+std::vector<bool> RenderGraph::live_stages(uint64_t enabled) const
+{
+  // Images each stage reads, writes, and overwrites without reading (Write)
+  struct Node
+  {
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+    std::vector<std::string> discards;
+  };
+
+  // ScenePass stages draw into the graph-declared attachments: one node
+  const size_t scene_node = m_stages.size();
+  std::vector<Node> nodes(m_stages.size() + 1);
+  std::unordered_map<std::string, size_t> node_of{ { "RenderGraph", scene_node } };
+  for (size_t i = 0; i < m_stages.size(); ++i)
+  {
+    node_of[m_stages[i]->name()] = m_stages[i]->phase() == Phase::ScenePass ? scene_node : i;
+  }
+
+  for (const auto& [image, records] : m_image_registry.all_access_records())
+  {
+    for (const auto& record : records)
     {
-      stage->record(ctx);
+      auto it = node_of.find(record.stage_name);
+      if (it == node_of.end())
+        continue;
+      Node& node = nodes[it->second];
+      if (record.intent != AccessIntent::Write)
+        node.reads.push_back(image);
+      if (record.intent != AccessIntent::Read)
+        node.writes.push_back(image);
+      if (record.intent == AccessIntent::Write)
+        node.discards.push_back(image);
     }
   }
 
-  // Phase 2: Scene render pass (HDR target)
-  bool any_scene_stage = false;
-  for (auto& stage : m_stages)
+  // Backward liveness from the swapchain: composite stages are the roots
+  std::set<std::string> needed;
+  auto visit = [&](const Node& node, bool root)
+  {
+    const bool live = root || node.writes.empty() ||
+      std::any_of(node.writes.begin(), node.writes.end(),
+        [&](const std::string& image) { return needed.count(image) > 0; });
+    if (!live)
+      return false;
+
+    // An overwrite hides every earlier producer of the image
+    for (const auto& image : node.discards)
+      needed.erase(image);
+    needed.insert(node.reads.begin(), node.reads.end());
+    return true;
+  };
+
+  auto is_enabled = [&](size_t i) { return (enabled >> i) & 1; };
+
+  std::vector<bool> live(m_stages.size(), false);
+  for (Phase phase :
+    { Phase::CompositePass, Phase::Intermediate, Phase::ScenePass, Phase::PrePass })
   {
-    if (stage->phase() == Phase::ScenePass && stage->is_enabled())
+    if (phase == Phase::ScenePass)
+    {
+      bool any_enabled = false;
+      for (size_t i = 0; i < m_stages.size(); ++i)
+        any_enabled = any_enabled || (m_stages[i]->phase() == phase && is_enabled(i));
+      if (!any_enabled || !visit(nodes[scene_node], false))
+        continue;
+      for (size_t i = 0; i < m_stages.size(); ++i)
+        live[i] = m_stages[i]->phase() == phase && is_enabled(i);
+      continue;
+    }
+
+    for (size_t i = m_stages.size(); i-- > 0;)
     {
-      any_scene_stage = true;
-      break;
+      if (m_stages[i]->phase() == phase && is_enabled(i))
+        live[i] = visit(nodes[i], phase == Phase::CompositePass);
     }
   }
+  return live;
+}
 
-  if (any_scene_stage)
+void RenderGraph::compile(const FrameContext& ctx, const PlanKey& key)
+{
+  if (m_stages.size() > 64)
   {
-    auto scene_rp = m_render_passes[static_cast<int>(Phase::ScenePass)];
-    auto scene_fb = m_scene_framebuffers[ctx.image_index];
+    throw std::runtime_error("RenderGraph: at most 64 stages are supported");
+  }
+
+  const std::vector<bool> live = live_stages(key.enabled);
+  m_culled_stages.clear();
+  for (size_t i = 0; i < m_stages.size(); ++i)
+  {
+    if (((key.enabled >> i) & 1) && !live[i])
+      m_culled_stages.push_back(m_stages[i]->name());
+  }
+
+  auto phase_live = [&](Phase phase)
+  {
+    for (size_t i = 0; i < m_stages.size(); ++i)
+    {
+      if (live[i] && m_stages[i]->phase() == phase)
+        return true;
+    }
+    return false;
+  };
+  const bool scene_pass_live = phase_live(Phase::ScenePass);
+
+  // Async compute: the Intermediate phase moves if nothing in it needs graphics
+  m_plan_async = key.async_compute && phase_live(Phase::Intermediate);
+  for (size_t i = 0; i < m_stages.size(); ++i)
+  {
+    if (live[i] && m_stages[i]->phase() == Phase::Intermediate && !m_stages[i]->compute_only())
+      m_plan_async = false;
+  }
 
-    // 3 clear values: color, depth, resolve (extra values ignored when not using MSAA)
-    std::array<vk::ClearValue, 3> clearValues{};
-    // Alpha=0: background pixels have no SSS blur (blur shader reads alpha as blur scale)
-    clearValues[0].color = vk::ClearColorValue{
-      std::array<float, 4>{ ctx.clear_color.r, ctx.clear_color.g, ctx.clear_color.b, 0.0f } };
-    clearValues[1].depthStencil = vk::ClearDepthStencilValue{ 1.0f, 0 };
-    clearValues[2].color = vk::ClearColorValue{
-      std::array<float, 4>{ ctx.clear_color.r, ctx.clear_color.g, ctx.clear_color.b, 0.0f } };
+  const Device& device = m_renderer->device();
+  PhaseQueueFamilies queue_families{};
+  queue_families.fill(device.m_graphics_queue_family_index);
+  if (m_plan_async)
+    queue_families[static_cast<size_t>(Phase::Intermediate)] = device.m_compute_queue_family_index;
 
-    begin_render_pass(ctx, scene_rp, scene_fb,
-      static_cast<uint32_t>(clearValues.size()), clearValues.data());
+  auto target_of = [&](Phase phase)
+  {
+    if (!m_plan_async)
+      return StepTarget::Primary;
+    if (phase == Phase::Intermediate)
+      return StepTarget::Compute;
+    return phase == Phase::CompositePass ? StepTarget::Resume : StepTarget::Primary;
+  };
+
+  // Barriers: this frame starts from the previous plan's end state, later
+  // frames from this plan's own
+  auto is_active = [&](const AccessRecord& record)
+  {
+    // Graph-declared accesses belong to the scene render pass attachments
+    if (record.stage_name == "RenderGraph")
+      return record.phase == Phase::ScenePass && scene_pass_live;
 
-    for (auto& stage : m_stages)
+    for (size_t i = 0; i < m_stages.size(); ++i)
     {
-      if (stage->phase() == Phase::ScenePass && stage->is_enabled())
+      if (live[i] && m_stages[i]->name() == record.stage_name)
+        return true;
+    }
+    return false;
+  };
+  BarrierPlan plan = BarrierPlan::compile(
+    m_image_registry, is_active, m_image_states, m_alias_slots, queue_families);
+  m_steady_barrier_plan = BarrierPlan::compile(
+    m_image_registry, is_active, plan.final_states(), m_alias_slots, queue_families);
+  m_barrier_plan_steady = plan.same_barriers(m_steady_barrier_plan);
+  m_barrier_plan = std::move(plan);
+
+  // Command buffers execute in recording order: every frame of this plan
+  // ends in the same state
+  m_image_states = m_barrier_plan.final_states();
+
+  // Parallel recording tasks, one per chunk in execution order
+  m_record_tasks.clear();
+  if (m_secondary_pools)
+  {
+    FrameContext parallel_ctx = ctx;
+    parallel_ctx.recording_threads = m_secondary_pools->thread_count();
+
+    bool split = false;
+    for (Phase phase : { Phase::PrePass, Phase::ScenePass, Phase::Intermediate })
+    {
+      // Secondaries come from graphics-family pools
+      if (target_of(phase) != StepTarget::Primary)
+        continue;
+      for (size_t i = 0; i < m_stages.size(); ++i)
       {
-        stage->record(ctx);
+        if (!live[i] || m_stages[i]->phase() != phase || m_stages[i]->begins_render_pass())
+          continue;
+        const uint32_t chunk_count = std::max(m_stages[i]->record_chunk_count(parallel_ctx), 1u);
+        split = split || chunk_count > 1;
+        for (uint32_t chunk = 0; chunk < chunk_count; ++chunk)
+        {
+          m_record_tasks.push_back({ m_stages[i].get(), chunk, chunk_count });
+        }
       }
     }
 
-    ctx.command_buffer.endRenderPass();
+    // Nothing splits: secondaries would cost more than they save
+    if (!split)
+      m_record_tasks.clear();
   }
+  m_task_buffers.resize(m_record_tasks.size());
 
-  // Phase 3: Intermediate stages (outside render pass, e.g. compute blur)
-  for (auto& stage : m_stages)
+  // Flatten: phases without live stages, and their render passes, drop out
+  m_plan_steps.clear();
+  uint32_t next_task = 0;
+  for (Phase phase : { Phase::PrePass, Phase::ScenePass, Phase::Intermediate, Phase::CompositePass })
   {
-    if (stage->phase() == Phase::Intermediate && stage->is_enabled())
+    if (!phase_live(phase))
+      continue;
+
+    const StepTarget target = target_of(phase);
+    if (!m_barrier_plan.barriers(phase).empty() || !m_steady_barrier_plan.barriers(phase).empty())
+      m_plan_steps.push_back({ StepOp::Barriers, phase, target });
+
+    const bool render_pass = phase == Phase::ScenePass || phase == Phase::CompositePass;
+    const bool secondaries =
+      !m_record_tasks.empty() && phase != Phase::CompositePass && target == StepTarget::Primary;
+    if (render_pass)
     {
-      stage->record(ctx);
+      PlanStep begin{ StepOp::BeginRenderPass, phase, target };
+      begin.contents =
+        secondaries ? vk::SubpassContents::eSecondaryCommandBuffers : vk::SubpassContents::eInline;
+      m_plan_steps.push_back(begin);
     }
+
+    if (secondaries)
+    {
+      // Tasks are sorted by stage; consecutive stages share one execute step,
+      // stages with their own render pass record inline in between
+      for (size_t i = 0; i < m_stages.size(); ++i)
+      {
+        if (!live[i] || m_stages[i]->phase() != phase)
+          continue;
+        if (m_stages[i]->begins_render_pass())
+        {
+          m_plan_steps.push_back({ StepOp::RecordStage, phase, target, m_stages[i].get() });
+          continue;
+        }
+        if (m_plan_steps.empty() || m_plan_steps.back().op != StepOp::ExecuteSecondaries)
+        {
+          PlanStep execute{ StepOp::ExecuteSecondaries, phase, target };
+          execute.task_begin = next_task;
+          execute.task_end = next_task;
+          m_plan_steps.push_back(execute);
+        }
+        while (next_task < m_record_tasks.size() && m_record_tasks[next_task].stage == m_stages[i].get())
+          ++next_task;
+        m_plan_steps.back().task_end = next_task;
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < m_stages.size(); ++i)
+      {
+        if (live[i] && m_stages[i]->phase() == phase)
+          m_plan_steps.push_back({ StepOp::RecordStage, phase, target, m_stages[i].get() });
+      }
+    }
+
+    if (render_pass)
+      m_plan_steps.push_back({ StepOp::EndRenderPass, phase, target });
+
+    if (!m_barrier_plan.releases(phase).empty() || !m_steady_barrier_plan.releases(phase).empty())
+      m_plan_steps.push_back({ StepOp::Releases, phase, target });
   }
 
-  // Phase 4: Composite render pass (swapchain target)
-  bool any_composite_stage = false;
-  for (auto& stage : m_stages)
+  m_plan_key = key;
+  m_plan_valid = true;
+  ++m_plan_compiles;
+  spdlog::trace("{}\n{}", plan_report(), m_barrier_plan.report());
+}
+
+std::string RenderGraph::plan_report() const
+{
+  static constexpr std::array<const char*, 4> phase_names = { "PrePass", "ScenePass",
+    "Intermediate", "CompositePass" };
+
+  std::string report = fmt::format("Render graph plan (compiled {} times, {} steps{}{}):",
+    m_plan_compiles, m_plan_steps.size(), m_record_tasks.empty() ? "" : ", parallel",
+    m_plan_async ? ", async compute" : "");
+  StepTarget target = StepTarget::Primary;
+  for (const auto& step : m_plan_steps)
   {
-    if (stage->phase() == Phase::CompositePass && stage->is_enabled())
+    if (step.target != target)
+    {
+      target = step.target;
+      report += target == StepTarget::Compute ? "\n  -- compute queue --" : "\n  -- graphics queue --";
+    }
+
+    const char* phase = phase_names[static_cast<size_t>(step.phase)];
+    switch (step.op)
     {
-      any_composite_stage = true;
-      break;
+      case StepOp::Barriers:
+        report += fmt::format("\n  barriers before {} ({})", phase,
+          m_barrier_plan.barriers(step.phase).size());
+        break;
+      case StepOp::Releases:
+        report += fmt::format("\n  ownership releases after {} ({})", phase,
+          m_barrier_plan.releases(step.phase).size());
+        break;
+      case StepOp::BeginRenderPass:
+        report += fmt::format("\n  begin {}{}", phase,
+          step.contents == vk::SubpassContents::eSecondaryCommandBuffers ? " (secondaries)" : "");
+        break;
+      case StepOp::EndRenderPass:
+        report += fmt::format("\n  end {}", phase);
+        break;
+      case StepOp::RecordStage:
+        report += fmt::format("\n    {}", step.stage->name());
+        break;
+      case StepOp::ExecuteSecondaries:
+        report += fmt::format("\n    {} secondaries ({})", step.task_end - step.task_begin, phase);
+        break;
     }
   }
+  for (const auto& name : m_culled_stages)
+  {
+    report += fmt::format("\n  culled {} (outputs not consumed)", name);
+  }
+  return report;
+}
+
+bool RenderGraph::record(const FrameContext& ctx)
+{
+  // Serial, before any (possibly parallel) recording
+  for (auto& stage : m_stages)
+  {
+    stage->begin_frame(ctx.frame_index);
+  }
+
+  const PlanKey key = plan_key(ctx);
+  if (!m_plan_valid || key != m_plan_key)
+  {
+    compile(ctx, key);
+  }
+  else if (!m_barrier_plan_steady)
+  {
+    m_barrier_plan = m_steady_barrier_plan;
+    m_barrier_plan_steady = true;
+  }
 
-  if (any_composite_stage)
+  if (!m_record_tasks.empty())
   {
-    // Single clear value: swapchain color
-    std::array<vk::ClearValue, 1> clearValues{};
-    clearValues[0].color = vk::ClearColorValue{
-      std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f } };
+    record_secondaries(ctx);
+  }
+
+  // One context per command buffer a step may target
+  std::array<FrameContext, 3> target_ctx{ ctx, ctx, ctx };
+  target_ctx[static_cast<size_t>(StepTarget::Compute)].command_buffer = ctx.compute_command_buffer;
+  target_ctx[static_cast<size_t>(StepTarget::Resume)].command_buffer = ctx.resume_command_buffer;
+
+  const bool sync2 = m_renderer->device().supports_synchronization2();
+  for (const auto& step : m_plan_steps)
+  {
+    const FrameContext& step_ctx = target_ctx[static_cast<size_t>(step.target)];
+    switch (step.op)
+    {
+      case StepOp::Barriers:
+        m_barrier_plan.record(step_ctx.command_buffer, step.phase, sync2);
+        break;
+      case StepOp::Releases:
+        m_barrier_plan.record_releases(step_ctx.command_buffer, step.phase, sync2);
+        break;
+      case StepOp::BeginRenderPass:
+        if (step.phase == Phase::ScenePass)
+          begin_scene_pass(step_ctx, step.contents);
+        else
+          begin_composite_pass(step_ctx);
+        break;
+      case StepOp::EndRenderPass:
+        step_ctx.command_buffer.endRenderPass();
+        break;
+      case StepOp::RecordStage:
+        step.stage->record(step_ctx);
+        break;
+      case StepOp::ExecuteSecondaries:
+        step_ctx.command_buffer.executeCommands(
+          step.task_end - step.task_begin, m_task_buffers.data() + step.task_begin);
+        break;
+    }
+  }
+  return m_plan_async;
+}
+
+void RenderGraph::begin_scene_pass(const FrameContext& ctx, vk::SubpassContents contents)
+{
+  auto scene_rp = m_render_passes[static_cast<int>(Phase::ScenePass)];
+  auto scene_fb = m_scene_framebuffers[ctx.image_index];
+
+  // 3 clear values: color, depth, resolve (extra values ignored when not using MSAA)
+  std::array<vk::ClearValue, 3> clearValues{};
+  // Alpha=0: background pixels have no SSS blur (blur shader reads alpha as blur scale)
+  clearValues[0].color = vk::ClearColorValue{
+    std::array<float, 4>{ ctx.clear_color.r, ctx.clear_color.g, ctx.clear_color.b, 0.0f } };
+  clearValues[1].depthStencil = vk::ClearDepthStencilValue{ 1.0f, 0 };
+  clearValues[2].color = vk::ClearColorValue{
+    std::array<float, 4>{ ctx.clear_color.r, ctx.clear_color.g, ctx.clear_color.b, 0.0f } };
+
+  begin_render_pass(ctx, scene_rp, scene_fb,
+    static_cast<uint32_t>(clearValues.size()), clearValues.data(), contents);
+}
+
+void RenderGraph::begin_composite_pass(const FrameContext& ctx)
+{
+  // Single clear value: swapchain color
+  std::array<vk::ClearValue, 1> clearValues{};
+  clearValues[0].color = vk::ClearColorValue{
+    std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f } };
+
+  begin_render_pass(ctx, m_render_passes[static_cast<int>(Phase::CompositePass)],
+    m_composite_stage->framebuffer(ctx.image_index),
+    static_cast<uint32_t>(clearValues.size()), clearValues.data());
+}
+
+void RenderGraph::record_secondaries(const FrameContext& ctx)
+{
+  // The caller waited for this slot's previous submission
+  m_secondary_pools->reset(ctx.frame_index);
+
+  FrameContext parallel_ctx = ctx;
+  parallel_ctx.recording_threads = m_secondary_pools->thread_count();
 
-    begin_render_pass(ctx, m_render_passes[static_cast<int>(Phase::CompositePass)],
-      m_composite_stage->framebuffer(ctx.image_index),
-      static_cast<uint32_t>(clearValues.size()), clearValues.data());
+  vk::CommandBufferInheritanceInfo sceneInheritance{};
+  sceneInheritance.renderPass = m_render_passes[static_cast<int>(Phase::ScenePass)];
+  sceneInheritance.subpass = 0;
+  sceneInheritance.framebuffer = m_scene_framebuffers[ctx.image_index];
+  const vk::CommandBufferInheritanceInfo noInheritance{};
 
-    for (auto& stage : m_stages)
+  m_workers->parallel_for(static_cast<uint32_t>(m_record_tasks.size()),
+    [&](uint32_t index, uint32_t thread)
     {
-      if (stage->phase() == Phase::CompositePass && stage->is_enabled())
+      const auto& task = m_record_tasks[index];
+      const bool in_scene_pass = task.stage->phase() == Phase::ScenePass;
+
+      vk::CommandBufferBeginInfo beginInfo{};
+      beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+      beginInfo.pInheritanceInfo = &noInheritance;
+      if (in_scene_pass)
       {
-        stage->record(ctx);
+        beginInfo.flags |= vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+        beginInfo.pInheritanceInfo = &sceneInheritance;
       }
-    }
 
-    ctx.command_buffer.endRenderPass();
-  }
+      FrameContext task_ctx = parallel_ctx;
+      task_ctx.command_buffer = m_secondary_pools->acquire(ctx.frame_index, thread);
+      task_ctx.command_buffer.begin(beginInfo);
+      if (in_scene_pass)
+      {
+        set_viewport_and_scissor(task_ctx.command_buffer, ctx.extent);
+      }
+      task.stage->record_chunk(task_ctx, task.chunk, task.chunk_count);
+      task_ctx.command_buffer.end();
+      m_task_buffers[index] = task_ctx.command_buffer;
+    });
 }
 
 void RenderGraph::on_swapchain_resize(const Device& device, vk::Extent2D extent)
@@ -362,8 +1275,9 @@ void RenderGraph::create_scene_framebuffers()
     if (m_renderer->msaa_samples() != vk::SampleCountFlagBits::e1)
     {
       // MSAA: [hdrMsaa, depth, hdrResolve]
+      const auto* msaa = m_image_registry.get("hdr_msaa");
       attachments = {
-        m_hdr_msaa_image_view,
+        msaa ? msaa->image_view : vk::ImageView{},
         m_renderer->depth_stencil().combined_view(),
         m_hdr_image_view
       };
@@ -393,8 +1307,9 @@ void RenderGraph::destroy_scene_framebuffers()
   if (!m_renderer || m_scene_framebuffers.empty())
     return;
 
+  // Frames in flight may still render into them
   for (auto fb : m_scene_framebuffers)
-    m_renderer->device().device().destroyFramebuffer(fb);
+    m_renderer->device().retire(fb);
   m_scene_framebuffers.clear();
 }
 
@@ -442,7 +1357,7 @@ void RenderGraph::create_hdr_resources()
   allocInfo.memoryTypeIndex = m_renderer->device().find_memory_type(
     memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_hdr_image_memory = dev.allocateMemory(allocInfo);
+  m_hdr_image_memory = m_renderer->device().allocate_memory(allocInfo, MemoryCategory::RenderTarget);
   dev.bindImageMemory(m_hdr_image, m_hdr_image_memory, 0);
 
   vk::ImageViewCreateInfo viewInfo{};
@@ -469,10 +1384,29 @@ void RenderGraph::create_hdr_resources()
     m_hdr_sampler = dev.createSampler(samplerInfo);
   }
 
-  // Optional MSAA color target
-  if (m_renderer->msaa_samples() != vk::SampleCountFlagBits::e1)
+  // Optional MSAA color target. It is a transient image: created (and possibly
+  // aliased) by realize_transient_images(). The sample count never changes, so
+  // declare it once.
+  if (m_renderer->msaa_samples() != vk::SampleCountFlagBits::e1 &&
+    !m_image_registry.is_transient("hdr_msaa"))
   {
-    create_msaa_color_resources();
+    m_image_registry.declare_transient("hdr_msaa",
+      { m_hdr_format,
+        vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment,
+        m_renderer->msaa_samples() });
+    m_image_registry.declare_access("hdr_msaa", "RenderGraph", Phase::ScenePass,
+      AccessIntent::Write, ImageUsage::ColorAttachment);
+  }
+
+  // Scene render pass attachments (cleared, so written without reading).
+  // "hdr" is the color attachment, or the resolve target with MSAA.
+  if (!m_scene_access_declared)
+  {
+    m_image_registry.declare_access("hdr", "RenderGraph", Phase::ScenePass,
+      AccessIntent::Write, ImageUsage::ColorAttachment);
+    m_image_registry.declare_access("depth_stencil", "RenderGraph", Phase::ScenePass,
+      AccessIntent::Write, ImageUsage::DepthStencilAttachment);
+    m_scene_access_declared = true;
   }
 
   // Update shared image registry
@@ -482,99 +1416,259 @@ void RenderGraph::create_hdr_resources()
   spdlog::trace("Created HDR image {}x{}", extent.width, extent.height);
 }
 
-void RenderGraph::create_msaa_color_resources()
-{
-  auto dev = m_renderer->device().device();
-  vk::Extent2D extent = m_renderer->swapchain().extent();
-
-  vk::ImageCreateInfo imageInfo{};
-  imageInfo.imageType = vk::ImageType::e2D;
-  imageInfo.extent.width = extent.width;
-  imageInfo.extent.height = extent.height;
-  imageInfo.extent.depth = 1;
-  imageInfo.mipLevels = 1;
-  imageInfo.arrayLayers = 1;
-  imageInfo.format = m_hdr_format;
-  imageInfo.tiling = vk::ImageTiling::eOptimal;
-  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
-  imageInfo.usage =
-    vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransientAttachment;
-  imageInfo.samples = m_renderer->msaa_samples();
-  imageInfo.sharingMode = vk::SharingMode::eExclusive;
-
-  m_hdr_msaa_image = dev.createImage(imageInfo);
-
-  vk::MemoryRequirements memRequirements =
-    dev.getImageMemoryRequirements(m_hdr_msaa_image);
-
-  vk::MemoryAllocateInfo allocInfo{};
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex = m_renderer->device().find_memory_type(
-    memRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-  m_hdr_msaa_image_memory = dev.allocateMemory(allocInfo);
-  dev.bindImageMemory(m_hdr_msaa_image, m_hdr_msaa_image_memory, 0);
-
-  vk::ImageViewCreateInfo viewInfo{};
-  viewInfo.image = m_hdr_msaa_image;
-  viewInfo.viewType = vk::ImageViewType::e2D;
-  viewInfo.format = m_hdr_format;
-  viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-  viewInfo.subresourceRange.baseMipLevel = 0;
-  viewInfo.subresourceRange.levelCount = 1;
-  viewInfo.subresourceRange.baseArrayLayer = 0;
-  viewInfo.subresourceRange.layerCount = 1;
-
-  m_hdr_msaa_image_view = dev.createImageView(viewInfo);
-
-  spdlog::trace("Created HDR MSAA color image {}x{} ({}x samples)", extent.width, extent.height,
-    static_cast<int>(m_renderer->msaa_samples()));
-}
-
 void RenderGraph::destroy_hdr_resources()
 {
   if (!m_renderer)
     return;
 
-  auto dev = m_renderer->device().device();
+  // Released once the frames in flight no longer use them (resize does not idle the device)
+  const Device& device = m_renderer->device();
 
   if (m_hdr_image_view)
   {
-    dev.destroyImageView(m_hdr_image_view);
+    device.retire(m_hdr_image_view);
     m_hdr_image_view = VK_NULL_HANDLE;
   }
   if (m_hdr_image)
   {
-    dev.destroyImage(m_hdr_image);
+    device.retire(m_hdr_image);
     m_hdr_image = VK_NULL_HANDLE;
   }
   if (m_hdr_image_memory)
   {
-    dev.freeMemory(m_hdr_image_memory);
+    device.retire_memory(m_hdr_image_memory);
     m_hdr_image_memory = VK_NULL_HANDLE;
   }
+}
+
+void RenderGraph::recreate_hdr_resources()
+{
+  destroy_hdr_resources();
+  create_hdr_resources();
+}
+
+// ---------------------------------------------------------------------------
+// Transient images
+// ---------------------------------------------------------------------------
+
+void RenderGraph::realize_transient_images()
+{
+  destroy_transient_images();
+
+  // Every image is new (HDR and depth-stencil are recreated before this call)
+  m_image_states.clear();
+  m_alias_slots.clear();
+  invalidate();
+
+  const Device& device = m_renderer->device();
+  auto dev = device.device();
+  vk::Extent2D extent = m_renderer->swapchain().extent();
+
+  struct Candidate
+  {
+    std::string name;
+    TransientImageDesc desc;
+    PhaseRange lifetime;
+  };
+
+  std::vector<Candidate> candidates;
+  for (const auto& [name, desc] : m_image_registry.transient_images())
+  {
+    auto lifetime = m_image_registry.lifetime(name);
+    if (!lifetime)
+    {
+      spdlog::warn("Transient image '{}' has no declared access, not created", name);
+      continue;
+    }
+    candidates.push_back({ name, desc, *lifetime });
+  }
+
+  // Deterministic assignment: earliest phase first, then by name
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+    if (a.lifetime.first != b.lifetime.first)
+      return static_cast<int>(a.lifetime.first) < static_cast<int>(b.lifetime.first);
+    return a.name < b.name;
+  });
+
+  // An alias slot is one allocation shared by images whose lifetimes are disjoint
+  struct AliasSlot
+  {
+    vk::DeviceSize size{ 0 };
+    uint32_t memory_type_bits{ ~0u };
+    std::vector<PhaseRange> lifetimes;
+    std::vector<size_t> images; // indices into m_transient_images
+  };
+
+  std::vector<AliasSlot> slots;
+  vk::DeviceSize unaliased_bytes = 0;
+
+  for (const auto& candidate : candidates)
+  {
+    vk::ImageCreateInfo imageInfo{};
+    imageInfo.imageType = vk::ImageType::e2D;
+    imageInfo.extent.width = extent.width;
+    imageInfo.extent.height = extent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = candidate.desc.format;
+    imageInfo.tiling = vk::ImageTiling::eOptimal;
+    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+    imageInfo.usage = candidate.desc.usage;
+    imageInfo.samples = candidate.desc.samples;
+    imageInfo.sharingMode = vk::SharingMode::eExclusive;
+
+    TransientImage transient{};
+    transient.name = candidate.name;
+    transient.format = candidate.desc.format;
+    transient.image = dev.createImage(imageInfo);
+
+    vk::MemoryRequirements memReqs = dev.getImageMemoryRequirements(transient.image);
+    unaliased_bytes += memReqs.size;
+
+    // Attachments that never leave a render pass prefer lazily-allocated memory.
+    // On tile-based GPUs it is never backed by physical pages, which beats
+    // aliasing — so it gets its own allocation and stays out of the slots.
+    if (candidate.desc.usage & vk::ImageUsageFlagBits::eTransientAttachment)
+    {
+      auto lazyType = device.try_find_memory_type(memReqs.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated);
+      if (lazyType)
+      {
+        vk::MemoryAllocateInfo allocInfo{};
+        allocInfo.allocationSize = memReqs.size;
+        allocInfo.memoryTypeIndex = *lazyType;
+        transient.dedicated_memory = device.allocate_memory(allocInfo, MemoryCategory::Transient);
+        dev.bindImageMemory(transient.image, transient.dedicated_memory, 0);
+
+        spdlog::info("Transient image '{}' is lazily allocated ({:.1f} MiB reserved, {} bytes committed)",
+          candidate.name, static_cast<double>(memReqs.size) / (1024.0 * 1024.0),
+          dev.getMemoryCommitment(transient.dedicated_memory));
+
+        m_transient_images.push_back(std::move(transient));
+        continue;
+      }
+    }
+
+    // With async compute the Intermediate phase overlaps the next frame's
+    // graphics phases, so disjoint phases no longer mean disjoint lifetimes
+    const PhaseRange intermediate{ Phase::Intermediate, Phase::Intermediate };
+    if (m_async_compute && candidate.lifetime.overlaps(intermediate))
+    {
+      vk::MemoryAllocateInfo allocInfo{};
+      allocInfo.allocationSize = memReqs.size;
+      allocInfo.memoryTypeIndex =
+        device.find_memory_type(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+      transient.dedicated_memory = device.allocate_memory(allocInfo, MemoryCategory::RenderTarget);
+      dev.bindImageMemory(transient.image, transient.dedicated_memory, 0);
+
+      m_transient_images.push_back(std::move(transient));
+      continue;
+    }
+
+    // First slot with a compatible device-local memory type whose occupants
+    // are never live in the same phase as this image
+    AliasSlot* target = nullptr;
+    for (auto& slot : slots)
+    {
+      bool disjoint = std::none_of(slot.lifetimes.begin(), slot.lifetimes.end(),
+        [&](const PhaseRange& other) { return other.overlaps(candidate.lifetime); });
+      uint32_t bits = slot.memory_type_bits & memReqs.memoryTypeBits;
+      if (disjoint && device.try_find_memory_type(bits, vk::MemoryPropertyFlagBits::eDeviceLocal))
+      {
+        target = &slot;
+        break;
+      }
+    }
+    if (!target)
+    {
+      slots.emplace_back();
+      target = &slots.back();
+    }
+
+    // Slot memory is bound at offset 0, so only size and type need to agree
+    target->size = std::max(target->size, memReqs.size);
+    target->memory_type_bits &= memReqs.memoryTypeBits;
+    target->lifetimes.push_back(candidate.lifetime);
+    target->images.push_back(m_transient_images.size());
+    m_alias_slots[candidate.name] = static_cast<int>(target - slots.data());
+
+    m_transient_images.push_back(std::move(transient));
+  }
 
-  if (m_hdr_msaa_image_view)
+  // Allocate one block per slot and bind every occupant to it
+  vk::DeviceSize aliased_bytes = 0;
+  for (const auto& slot : slots)
   {
-    dev.destroyImageView(m_hdr_msaa_image_view);
-    m_hdr_msaa_image_view = VK_NULL_HANDLE;
+    vk::MemoryAllocateInfo allocInfo{};
+    allocInfo.allocationSize = slot.size;
+    allocInfo.memoryTypeIndex =
+      device.find_memory_type(slot.memory_type_bits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    vk::DeviceMemory memory = device.allocate_memory(allocInfo, MemoryCategory::RenderTarget);
+    m_transient_memory.push_back(memory);
+    aliased_bytes += slot.size;
+
+    for (size_t index : slot.images)
+    {
+      dev.bindImageMemory(m_transient_images[index].image, memory, 0);
+    }
+  }
+
+  // Views + registry entries
+  for (auto& transient : m_transient_images)
+  {
+    vk::ImageViewCreateInfo viewInfo{};
+    viewInfo.image = transient.image;
+    viewInfo.viewType = vk::ImageViewType::e2D;
+    viewInfo.format = transient.format;
+    viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+    transient.view = dev.createImageView(viewInfo);
+
+    m_image_registry.set(transient.name, { transient.image, transient.view, {}, transient.format });
   }
-  if (m_hdr_msaa_image)
+
+  if (!slots.empty())
   {
-    dev.destroyImage(m_hdr_msaa_image);
-    m_hdr_msaa_image = VK_NULL_HANDLE;
+    spdlog::info("Transient images {}x{}: {} images in {} aliased allocations, {:.1f} MiB "
+                 "({:.1f} MiB without aliasing)",
+      extent.width, extent.height, m_transient_images.size(), slots.size(),
+      static_cast<double>(aliased_bytes) / (1024.0 * 1024.0),
+      static_cast<double>(unaliased_bytes) / (1024.0 * 1024.0));
   }
-  if (m_hdr_msaa_image_memory)
+
+  for (auto& stage : m_stages)
   {
-    dev.freeMemory(m_hdr_msaa_image_memory);
-    m_hdr_msaa_image_memory = VK_NULL_HANDLE;
+    stage->on_transient_images_realized();
   }
 }
 
-void RenderGraph::recreate_hdr_resources()
+void RenderGraph::destroy_transient_images()
 {
-  destroy_hdr_resources();
-  create_hdr_resources();
+  if (!m_renderer)
+    return;
+
+  // Retired like the HDR image: aliased memory included
+  const Device& device = m_renderer->device();
+
+  for (auto& transient : m_transient_images)
+  {
+    device.retire(transient.view);
+    device.retire(transient.image);
+    if (transient.dedicated_memory)
+      device.retire_memory(transient.dedicated_memory);
+  }
+  m_transient_images.clear();
+
+  for (auto memory : m_transient_memory)
+  {
+    device.retire_memory(memory);
+  }
+  m_transient_memory.clear();
 }
 
 } // namespace sps::vulkan
@@ -1,19 +1,27 @@
 #pragma once
 
+#include <sps/vulkan/barrier_plan.h>
+#include <sps/vulkan/gpu_material.h>
 #include <sps/vulkan/material_texture_set.h>
 #include <sps/vulkan/render_stage.h>
 #include <sps/vulkan/shared_image_registry.h>
 
+#include <algorithm>
 #include <array>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace sps::vulkan
 {
 
+class Buffer;
 class CompositeStage;
 class Device;
+class SecondaryCommandPools;
 class VulkanRenderer;
+class WorkerPool;
 
 /// Fixed-order render graph.
 ///
@@ -32,6 +40,50 @@ class VulkanRenderer;
 /// descriptor sets. The API is frame-indexed from day one for future N>1
 /// frames in flight support.
 ///
+/// ## Bindless materials
+///
+/// When the device supports descriptor indexing, the graph also builds one
+/// bindless set per frame: the UBO, the three IBL textures, and a
+/// variable-count array of every distinct material texture. Materials select
+/// their textures by table index (stored in GpuMaterial), so draws bind the
+/// set once instead of once per material.
+///
+/// ## Scene data
+///
+/// Per-material factors (GpuMaterial) and per-primitive transforms
+/// (GpuInstance) live in two storage buffers in a separate descriptor set
+/// (set 1), uploaded once per scene load and shared by every raster pipeline.
+/// A draw passes its primitive index as firstInstance; the vertex shader looks
+/// up the instance through gl_InstanceIndex and forwards its material index.
+/// Draws need no push constants, so the same data can feed indirect draws.
+///
+/// ## GPU-driven draws
+///
+/// When the device supports VK_KHR_draw_indirect_count (with multi-draw
+/// indirect and non-zero firstInstance), scene loads also upload one GpuDraw
+/// per primitive (world bounds, index range, draw bucket) and allocate the
+/// indirect command and count buffers. DrawCullStage fills them in a compute
+/// pass each frame; RasterOpaqueStage then issues one indirect-count draw per
+/// bucket instead of one draw per primitive. BLEND primitives get buckets of
+/// their own, drawn by OitAccumulateStage when order-independent
+/// transparency is on.
+///
+/// ## Occlusion culling
+///
+/// Two PrePass stages add Hi-Z occlusion culling to the GPU-driven path, using
+/// a per-primitive visibility buffer in the draw cull set that survives from
+/// one frame to the next:
+///   1. DrawCullStage only emits the fully opaque primitives that were visible
+///      last frame; OcclusionDepthStage draws them depth-only into
+///      "depth_stencil", in a render pass of its own.
+///   2. HiZCullStage downsamples that depth into a max-depth pyramid, tests
+///      every primitive's bounds against it, rewrites the indirect commands
+///      with everything that passes and records the visibility for the next
+///      frame.
+/// The scene pass then draws the survivors as usual. Primitives that became
+/// visible this frame are tested against real occluders, so nothing pops in
+/// late; the cost is drawing last frame's visible set twice (once depth-only).
+///
 /// ## Scene framebuffers
 ///
 /// The graph owns the scene framebuffers (one per swapchain image), which
@@ -45,25 +97,102 @@ class VulkanRenderer;
 /// shared images ("hdr", "depth_stencil") and stages declare their access
 /// intent (Read, Write, ReadWrite) at construction time.
 ///
+/// ## Transient images
+///
+/// Stages declare images they only need inside a frame (SSS ping, RT storage
+/// image, MSAA color target) with SharedImageRegistry::declare_transient().
+/// realize_transient_images() creates them at swapchain extent and derives
+/// each lifetime from the phases of its access declarations. Images whose
+/// lifetimes do not overlap share one device-local allocation. Lazily-allocated
+/// attachments keep their own (usually unbacked) memory instead.
+///
+/// Aliased contents never survive a phase boundary: the first access of a
+/// transient image in a frame must transition it from eUndefined, with a
+/// source stage covering the previous phase's work.
+///
 /// ## Barrier strategy
 ///
 /// No gratuitous barriers are injected between stages within a phase.
-/// Between phases, some barriers are unavoidable (e.g. ScenePass writes
-/// HDR → Intermediate reads it). Currently stages manage these manually.
+/// Between phases, the graph compiles the access declarations of the stages
+/// that run this frame into a BarrierPlan and records one batched barrier
+/// before each phase that needs it: layout transitions, read-after-write and
+/// write-after-read/write dependencies, including those against the previous
+/// frame (the state each image was left in is carried over) and against
+/// transient images sharing memory. The scene pass's attachments are declared
+/// by the graph itself (stage name "RenderGraph"); the scene render pass does
+/// no layout transitions of its own.
 ///
-/// The access declarations in the registry provide the information needed
-/// for the render graph to insert these between-phase barriers automatically:
-///   - For each shared image, inspect access_records() to see which stages
-///     read/write it and in which phase.
-///   - Insert a barrier only where a prior phase wrote and a later phase reads.
+/// Stages only synchronize their own internal steps (e.g. SSS horizontal →
+/// vertical pass, RT trace → blit). The "stats barriers" command dumps the plan.
 ///
 /// ## Multiple frames in flight
 ///
-/// Inter-frame synchronization uses per-frame resource indexing (rings),
-/// not barriers. Each stage duplicates its mutable resources N times and
-/// indexes by FrameContext::frame_index. Read-only resources (pipelines,
-/// samplers, render passes) stay shared. This avoids inter-frame barriers
-/// entirely — the only barriers are the intra-frame phase transitions above.
+/// CPU-written resources use per-frame indexing (rings): the graph owns one
+/// material/bindless descriptor set per frame (one per UBO passed to
+/// allocate_material_descriptors()), indexed by FrameContext::frame_index.
+/// Read-only resources (pipelines, samplers, render passes) and GPU-only
+/// images stay shared; their write-after-read hazards against the previous
+/// frame are covered by the source stages of each phase's first barrier.
+///
+/// ## Parallel recording
+///
+/// With a worker pool attached (set_parallel_recording()), every enabled
+/// PrePass, ScenePass and Intermediate stage records into its own secondary
+/// command buffer, split further into chunks where the stage asks for it
+/// (RenderStage::record_chunk_count()). All secondaries of a frame are
+/// recorded concurrently from per-thread, per-frame command pools; the
+/// primary then executes them in phase and registration order, with the scene
+/// pass begun for secondary contents. Composite stages stay inline on the
+/// primary: they are a few full-screen draws and the ImGui backend.
+///
+/// When no stage splits (small scenes), secondaries cost more than they save,
+/// so the graph falls back to recording everything inline. PrePass and
+/// Intermediate stages that begin their own render pass
+/// (RenderStage::begins_render_pass()) always record inline, between the runs
+/// of secondaries.
+///
+/// ## Compiled execution plan
+///
+/// record() does not walk the stage list. A compile step turns the current
+/// configuration into a flat list of steps (barrier batch, begin pass, record
+/// stage, execute secondaries, end pass) that each frame replays. Compiling:
+///   - culls enabled stages whose outputs nothing consumes: walking stages
+///     backwards from the composite pass (the swapchain), a stage is live if
+///     it writes an image a live later stage reads, or declares no writes at
+///     all (unknown side effects). ScenePass stages share the graph-declared
+///     attachments and live or die together;
+///   - skips render passes (and their barriers) with no live stage. The scene
+///     and composite passes never merge: they target different attachments
+///     with a sampling dependency in between;
+///   - compiles the barrier plan and the parallel recording tasks.
+///
+/// The plan is recompiled on invalidate() (resize, scene load, recording
+/// setup) and when a stage's is_enabled() changes. Enablement is driven by
+/// app-owned toggles, so the graph polls it as a one-bit-per-stage signature.
+///
+/// The first frame of a new plan starts from whatever the previous plan left
+/// the images in; every later frame starts from the plan's own end state, so
+/// two barrier plans are compiled and the steady one takes over after a frame.
+/// The "stats graph" command dumps the plan.
+///
+/// ## Async compute
+///
+/// With set_async_compute() and a dedicated compute queue family, an
+/// Intermediate phase whose live stages are all compute_only() is recorded
+/// into a separate compute command buffer, and the composite pass into a
+/// third (resume) buffer. The barrier plan assigns the Intermediate phase to
+/// the compute family and inserts queue family ownership transfers for the
+/// images crossing over (HDR and depth-stencil into the blur, HDR back to
+/// composite). The caller chains the three submissions with timeline
+/// semaphores (see record()).
+///
+/// HDR and depth-stencil exist once, so the next frame's first submission
+/// also waits for this frame's compute work, but only in the stages whose
+/// barriers touch the images the blur left behind (compute_wait_stages()).
+/// Culling, vertex work and anything else before those barriers overlaps the
+/// blur. Transient images the Intermediate phase uses get their own memory
+/// while async compute is on, since the next frame's graphics work may run
+/// alongside them. FrameTimer measures how much overlap there is.
 class RenderGraph
 {
 public:
@@ -84,8 +213,65 @@ public:
     return ptr;
   }
 
-  /// Record all enabled stages into the command buffer.
-  void record(const FrameContext& ctx);
+  /// Register a stage that records right before `next` (same phase), for
+  /// stages that depend on a stage registered earlier but must run first.
+  template <typename T, typename... Args>
+  T* add_before(const RenderStage* next, Args&&... args)
+  {
+    auto stage = std::make_unique<T>(std::forward<Args>(args)...);
+    T* ptr = stage.get();
+    auto it = std::find_if(m_stages.begin(), m_stages.end(),
+      [next](const std::unique_ptr<RenderStage>& s) { return s.get() == next; });
+    m_stages.insert(it, std::move(stage));
+    return ptr;
+  }
+
+  /// Record all enabled stages into the command buffer by replaying the
+  /// compiled plan (recompiled first when it is out of date).
+  /// Call only after waiting for the frame slot's previous submission: every
+  /// stage's begin_frame() runs first, and with parallel recording the slot's
+  /// secondary command pools are reset here.
+  /// @return Whether the frame was split for async compute: ctx.command_buffer,
+  ///   ctx.compute_command_buffer and ctx.resume_command_buffer must then be
+  ///   submitted in that order, each waiting for the previous one. Otherwise
+  ///   only ctx.command_buffer was recorded.
+  [[nodiscard]] bool record(const FrameContext& ctx);
+
+  /// Stages in which the last recorded frame's ctx.command_buffer waits for
+  /// the previous frame's compute work (empty: no wait needed). All stages
+  /// when the frame was not split, which only matters just after a switch.
+  [[nodiscard]] vk::PipelineStageFlags compute_wait_stages() const;
+
+  /// Stages in which the last recorded frame's ctx.resume_command_buffer
+  /// waits for the frame's compute work (only meaningful for split frames).
+  [[nodiscard]] vk::PipelineStageFlags resume_wait_stages() const;
+
+  /// Run compute-only Intermediate stages on the device's async compute queue
+  /// when the frame context provides the extra command buffers. Ignored when
+  /// the device has no dedicated compute queue family.
+  /// Call before realize_transient_images(), which decides their aliasing.
+  void set_async_compute(bool enabled);
+
+  /// Whether async compute is enabled and available.
+  [[nodiscard]] bool async_compute() const { return m_async_compute; }
+
+  /// Force the next record() to recompile the execution plan. Called by the
+  /// graph itself on resize, scene load and recording setup changes.
+  void invalidate() { m_plan_valid = false; }
+
+  /// Multi-line dump of the compiled plan, for logs and the command console.
+  [[nodiscard]] std::string plan_report() const;
+
+  /// Attach a worker pool for parallel recording (nullptr records serially).
+  /// (Re)creates the secondary command pools; call again when the number of
+  /// frames in flight changes, with the device idle.
+  void set_parallel_recording(WorkerPool* workers, uint32_t frames_in_flight);
+
+  /// Whether a worker pool is attached.
+  [[nodiscard]] bool parallel_recording() const { return m_secondary_pools != nullptr; }
+
+  /// The inter-phase barriers recorded for the most recent frame.
+  [[nodiscard]] const BarrierPlan& barrier_plan() const { return m_barrier_plan; }
 
   /// Propagate swapchain resize to all stages.
   void on_swapchain_resize(const Device& device, vk::Extent2D extent);
@@ -97,13 +283,15 @@ public:
   [[nodiscard]] vk::RenderPass render_pass(Phase phase) const;
 
   /// Create scene framebuffers from the registry images and scene render pass.
-  /// Call after populating the image registry and setting the scene render pass.
+  /// Call after populating the image registry, setting the scene render pass,
+  /// and realize_transient_images() (the MSAA color target is transient).
   void create_scene_framebuffers();
 
   /// Destroy and recreate scene framebuffers (called during swapchain resize).
   void recreate_scene_framebuffers();
 
-  /// Create the canonical material descriptor set layout (12 bindings).
+  /// Create the canonical material descriptor set layout (12 bindings), the
+  /// scene data layout, and the bindless layout when requested and supported.
   /// Call after set_renderer() but before adding stages that need it.
   void create_material_descriptor_layout();
 
@@ -117,12 +305,22 @@ public:
   /// Each set is written with the UBO buffer info for its frame and the
   /// texture bindings from the corresponding MaterialTextureSet.
   ///
+  /// Also uploads the material and instance SSBOs and rewrites the scene
+  /// data set. When bindless is enabled, rebuilds the texture table and one
+  /// bindless set per frame.
+  ///
   /// @param default_textures  Texture bindings for the default (non-scene) path.
   /// @param material_textures Per-material texture bindings.
+  /// @param material_params   Per-material factors (same order as material_textures).
+  /// @param instance_params   Per-primitive transforms (same order as scene primitives).
+  /// @param draw_params       Per-primitive GPU-driven draw sources (same order).
   /// @param ubo_infos         One UBO descriptor buffer info per frame in flight.
   void allocate_material_descriptors(
     const MaterialTextureSet& default_textures,
     const std::vector<MaterialTextureSet>& material_textures,
+    const std::vector<GpuMaterial>& material_params,
+    const std::vector<GpuInstance>& instance_params,
+    const std::vector<GpuDraw>& draw_params,
     const std::vector<vk::DescriptorBufferInfo>& ubo_infos);
 
   /// Get the default descriptor set for a given frame index.
@@ -135,17 +333,65 @@ public:
   /// Number of material descriptor sets (per frame). 0 when no scene is loaded.
   [[nodiscard]] uint32_t material_set_count() const;
 
+  /// Request the bindless material path. Call before create_material_descriptor_layout();
+  /// ignored when the device lacks the descriptor indexing features.
+  void set_bindless_requested(bool requested) { m_bindless_requested = requested; }
+
+  /// Whether the bindless material layout exists (requested and supported).
+  [[nodiscard]] bool bindless_enabled() const { return m_bindless_layout != VK_NULL_HANDLE; }
+
+  /// The bindless descriptor set layout (stable, never recreated).
+  [[nodiscard]] vk::DescriptorSetLayout bindless_descriptor_layout() const;
+
+  /// Get the bindless descriptor set for a given frame index.
+  [[nodiscard]] vk::DescriptorSet bindless_descriptor_set(uint32_t frame_index) const;
+
+  /// The scene data descriptor set layout (set 1: material + instance SSBOs).
+  [[nodiscard]] vk::DescriptorSetLayout scene_data_descriptor_layout() const;
+
+  /// The scene data descriptor set. Static between scene loads, so one set
+  /// serves every frame in flight.
+  [[nodiscard]] vk::DescriptorSet scene_data_descriptor_set() const;
+
+  /// Number of primitives with GPU-driven draw data (0 when unsupported or no scene).
+  [[nodiscard]] uint32_t gpu_draw_count() const { return m_gpu_draw_count; }
+
+  /// The draw cull descriptor set layout (draw sources, indirect commands,
+  /// counts, occlusion visibility). Null when the device lacks indirect count support.
+  [[nodiscard]] vk::DescriptorSetLayout draw_cull_descriptor_layout() const { return m_draw_cull_layout; }
+
+  /// The draw cull descriptor set (valid while gpu_draw_count() > 0).
+  [[nodiscard]] vk::DescriptorSet draw_cull_descriptor_set() const { return m_draw_cull_set; }
+
+  /// Indirect commands: bucket b occupies gpu_draw_count() commands from
+  /// b * gpu_draw_count().
+  [[nodiscard]] vk::Buffer indirect_draw_buffer() const;
+
+  /// One uint32_t draw count per bucket.
+  [[nodiscard]] vk::Buffer draw_count_buffer() const;
+
+  /// Instance index for the legacy single-mesh draw (identity transform,
+  /// default material). Scene primitive i uses instance index i.
+  [[nodiscard]] uint32_t default_instance() const { return m_default_instance; }
+
   /// Register the composite stage so the graph can query its framebuffer.
   void set_composite_stage(const CompositeStage* stage);
 
-  /// Create the HDR image, sampler, optional MSAA color target, and register in the image registry.
+  /// Create the HDR image and sampler, register them in the image registry, and
+  /// declare the optional MSAA color target as a transient image.
   /// Call after set_renderer() but before adding stages that need the HDR image.
   void create_hdr_resources();
 
-  /// Destroy and recreate HDR + MSAA images, then update the registry.
+  /// Destroy and recreate the HDR image, then update the registry.
   /// Call during swapchain resize, before recreate_scene_framebuffers().
   void recreate_hdr_resources();
 
+  /// Create all declared transient images, alias their memory, register them
+  /// in the image registry, and notify stages via on_transient_images_realized().
+  /// Call after every stage is added, and on swapchain resize after
+  /// recreate_hdr_resources() but before recreate_scene_framebuffers().
+  void realize_transient_images();
+
   /// The HDR image format (static, never changes).
   [[nodiscard]] static constexpr vk::Format hdr_format() { return vk::Format::eR16G16B16A16Sfloat; }
 
@@ -169,8 +415,134 @@ private:
   std::vector<vk::Framebuffer> m_scene_framebuffers;
   SharedImageRegistry m_image_registry;
 
+  // Parallel recording
+  struct RecordTask
+  {
+    RenderStage* stage{ nullptr };
+    uint32_t chunk{ 0 };
+    uint32_t chunk_count{ 1 };
+  };
+  WorkerPool* m_workers{ nullptr }; // non-owning
+  std::unique_ptr<SecondaryCommandPools> m_secondary_pools;
+  std::vector<RecordTask> m_record_tasks;     // compiled; empty when recording inline
+  std::vector<vk::CommandBuffer> m_task_buffers; // [task], re-recorded every frame
+
+  /// Record m_record_tasks into secondaries on the worker pool.
+  void record_secondaries(const FrameContext& ctx);
+
+  // Compiled execution plan
+  enum class StepOp
+  {
+    Barriers,           // batched inter-phase barriers before `phase`
+    Releases,           // queue family ownership releases after `phase`
+    BeginRenderPass,    // scene or composite render pass, by `phase`
+    EndRenderPass,
+    RecordStage,        // record `stage` inline
+    ExecuteSecondaries  // execute m_task_buffers[task_begin, task_end)
+  };
+  /// Command buffer a step records into (see FrameContext).
+  enum class StepTarget
+  {
+    Primary, // ctx.command_buffer
+    Compute, // ctx.compute_command_buffer
+    Resume   // ctx.resume_command_buffer
+  };
+  struct PlanStep
+  {
+    StepOp op;
+    Phase phase;
+    StepTarget target{ StepTarget::Primary };
+    RenderStage* stage{ nullptr };
+    vk::SubpassContents contents{ vk::SubpassContents::eInline };
+    uint32_t task_begin{ 0 };
+    uint32_t task_end{ 0 };
+  };
+  /// Everything the plan was compiled from that may change without invalidate().
+  struct PlanKey
+  {
+    uint64_t enabled{ 0 }; // bit i: m_stages[i]->is_enabled()
+    vk::Extent2D extent;
+    const Mesh* mesh{ nullptr };
+    const GltfScene* scene{ nullptr };
+    bool async_compute{ false }; // requested and the context has the buffers
+
+    bool operator==(const PlanKey&) const = default;
+  };
+  bool m_plan_valid{ false };
+  bool m_plan_async{ false }; // Intermediate phase runs on the compute queue
+  PlanKey m_plan_key;
+  std::vector<PlanStep> m_plan_steps;
+  std::vector<std::string> m_culled_stages; // names, for plan_report()
+  uint32_t m_plan_compiles{ 0 };
+
+  /// Enablement signature and scene inputs of this frame.
+  [[nodiscard]] PlanKey plan_key(const FrameContext& ctx) const;
+
+  /// Cull, compile barriers and tasks, and flatten everything into m_plan_steps.
+  void compile(const FrameContext& ctx, const PlanKey& key);
+
+  /// Which enabled stages produce something a later stage (or the swapchain) consumes.
+  [[nodiscard]] std::vector<bool> live_stages(uint64_t enabled) const;
+
+  bool m_async_compute{ false };
+
+  // Inter-phase barriers
+  bool m_scene_access_declared{ false };
+  BarrierPlan m_barrier_plan;        // recorded this frame
+  BarrierPlan m_steady_barrier_plan; // recorded from the plan's second frame on
+  bool m_barrier_plan_steady{ true };
+  std::map<std::string, ImageState> m_image_states; // end-of-frame state, reset with the images
+  std::map<std::string, int> m_alias_slots;         // transient image name -> memory slot
+
+  /// Begin the scene render pass with its clear values.
+  void begin_scene_pass(const FrameContext& ctx, vk::SubpassContents contents);
+
+  /// Begin the composite render pass on the swapchain framebuffer.
+  void begin_composite_pass(const FrameContext& ctx);
+
+  // Bindless material resources
+  bool m_bindless_requested{ true };
+  uint32_t m_bindless_capacity{ 0 }; // max texture table size (layout upper bound)
+  vk::DescriptorSetLayout m_bindless_layout{ VK_NULL_HANDLE };
+  vk::DescriptorPool m_bindless_pool{ VK_NULL_HANDLE };
+  std::vector<vk::DescriptorSet> m_bindless_sets; // [frame_index]
+
+  // Scene data (set 1)
+  vk::DescriptorSetLayout m_scene_data_layout{ VK_NULL_HANDLE };
+  vk::DescriptorPool m_scene_data_pool{ VK_NULL_HANDLE };
+  vk::DescriptorSet m_scene_data_set{ VK_NULL_HANDLE };
+  std::unique_ptr<Buffer> m_material_buffer; // GpuMaterial[material_count + 1]
+  std::unique_ptr<Buffer> m_instance_buffer; // GpuInstance[primitive_count + 1]
+  uint32_t m_default_instance{ 0 };
+
+  // GPU-driven draws (cull pass set)
+  vk::DescriptorSetLayout m_draw_cull_layout{ VK_NULL_HANDLE };
+  vk::DescriptorPool m_draw_cull_pool{ VK_NULL_HANDLE };
+  vk::DescriptorSet m_draw_cull_set{ VK_NULL_HANDLE };
+  std::unique_ptr<Buffer> m_draw_buffer;       // GpuDraw[primitive_count]
+  std::unique_ptr<Buffer> m_indirect_buffer;   // DrawIndexedIndirectCommand[bucket][primitive_count]
+  std::unique_ptr<Buffer> m_draw_count_buffer; // uint32_t[bucket]
+  std::unique_ptr<Buffer> m_visibility_buffer; // uint32_t[primitive_count], written by HiZCullStage
+  uint32_t m_gpu_draw_count{ 0 };
+
   void destroy_scene_framebuffers();
   void destroy_material_pool();
+  void create_bindless_descriptor_layout();
+  void create_scene_data_layout();
+
+  /// Build the texture table and bindless sets; fills the texture indices of
+  /// `materials` (scene materials followed by the default material).
+  void allocate_bindless_descriptors(const MaterialTextureSet& default_textures,
+    const std::vector<MaterialTextureSet>& material_textures,
+    std::vector<GpuMaterial>& materials,
+    const std::vector<vk::DescriptorBufferInfo>& ubo_infos);
+
+  /// Upload the material and instance SSBOs and write the scene data set.
+  void upload_scene_data(const std::vector<GpuMaterial>& materials,
+    const std::vector<GpuInstance>& instances, const std::vector<GpuDraw>& draws);
+
+  /// Upload the draw sources, create the indirect buffers and write the cull set.
+  void upload_draw_data(const std::vector<GpuDraw>& draws);
 
   // HDR image (single-sample resolve target + composite source)
   static constexpr vk::Format m_hdr_format = vk::Format::eR16G16B16A16Sfloat;
@@ -179,13 +551,21 @@ private:
   vk::ImageView m_hdr_image_view{ VK_NULL_HANDLE };
   vk::Sampler m_hdr_sampler{ VK_NULL_HANDLE };
 
-  // MSAA color target (resolves to m_hdr_image in scene framebuffer)
-  vk::Image m_hdr_msaa_image{ VK_NULL_HANDLE };
-  vk::DeviceMemory m_hdr_msaa_image_memory{ VK_NULL_HANDLE };
-  vk::ImageView m_hdr_msaa_image_view{ VK_NULL_HANDLE };
-
   void destroy_hdr_resources();
-  void create_msaa_color_resources();
+
+  // Transient images (includes the "hdr_msaa" color target when MSAA is on)
+  struct TransientImage
+  {
+    std::string name;
+    vk::Format format{ vk::Format::eUndefined };
+    vk::Image image{ VK_NULL_HANDLE };
+    vk::ImageView view{ VK_NULL_HANDLE };
+    vk::DeviceMemory dedicated_memory{ VK_NULL_HANDLE }; // lazily-allocated, not aliased
+  };
+  std::vector<TransientImage> m_transient_images;
+  std::vector<vk::DeviceMemory> m_transient_memory; // one per alias slot
+
+  void destroy_transient_images();
 
   /// Write one descriptor set with a UBO and 11 texture bindings.
   void write_material_set(vk::DescriptorSet set,
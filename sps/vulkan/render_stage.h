@@ -11,10 +11,13 @@
 namespace sps::vulkan
 {
 
+class BlendDrawList;
 class Camera;
 class Device;
+class FrustumCuller;
 struct GltfScene;
 class Mesh;
+class OpaqueDrawList;
 
 /// Execution phase for render stages.
 /// Determines which render pass (if any) the stage runs in.
@@ -33,15 +36,24 @@ struct FrameContext
   vk::CommandBuffer command_buffer;
   uint32_t image_index;
   uint32_t frame_index{ 0 }; // Index into per-frame resource rings (0..frames_in_flight-1)
+  uint32_t recording_threads{ 1 }; // Threads available for parallel recording (1 = serial)
   vk::Extent2D extent;
 
   // Scene data (read-only, not owned)
   const Mesh* mesh;
   const GltfScene* scene;
   const Camera* camera;
+  const FrustumCuller* culler{ nullptr }; // scene primitive visibility (null: draw all)
+  const OpaqueDrawList* opaque_draws{ nullptr }; // sorted, culled opaque draws (null: loader order)
+  const BlendDrawList* blend_draws{ nullptr };   // back-to-front BLEND draws (null: none drawn)
 
   // Clear color (background)
   glm::vec3 clear_color{ 0.0f, 0.0f, 0.0f };
+
+  // Async compute (optional): a compute queue command buffer, and the graphics
+  // command buffer that continues after it (see RenderGraph)
+  vk::CommandBuffer compute_command_buffer;
+  vk::CommandBuffer resume_command_buffer;
 };
 
 /// Abstract base class for a render stage.
@@ -56,23 +68,37 @@ struct FrameContext
 ///   - Intermediate: runs between render passes (e.g. compute blur)
 ///   - CompositePass: runs inside the composite render pass (swapchain target)
 ///
-/// ## Multiple frames in flight (not yet supported)
+/// ## Multiple frames in flight
 ///
 /// Self-contained stages (those that own their pipelines, descriptors, and
 /// framebuffers) are the right granularity for multiple frames in flight.
-/// The render graph provides frames_in_flight() (constant, for resource
-/// allocation) and FrameContext::frame_index (per-frame, 0..N-1).
+/// FrameContext::frame_index cycles 0..N-1, where N is the renderer's
+/// frames_in_flight() (1..3, configurable, may change at runtime).
 ///
 /// Read-only resources (pipeline, sampler, render pass) stay shared.
-/// Write-per-frame resources (descriptor sets, framebuffers, storage images)
-/// are allocated as rings of frames_in_flight copies, indexed by frame_index.
+/// Resources the CPU writes per frame (uniform buffers and the descriptor
+/// sets that reference them) are allocated as rings of N copies, indexed by
+/// frame_index. GPU-only images (HDR, depth, transients) stay single-copy:
+/// frames execute in submission order on one queue, and the barriers at the
+/// start of each frame order them against the previous frame.
 ///
 /// Each stage decides what to duplicate — the app should not need to know
-/// that e.g. CompositeStage needs N descriptor sets while SSSBlurStage
-/// needs N ping images.
+/// that e.g. RayTracingStage needs N descriptor sets.
+///
+/// ## Parallel recording
 ///
-/// Currently frames_in_flight is always 1. When increasing it, stages that
-/// are not yet self-contained will need migration first.
+/// With parallel recording enabled, the graph records every PrePass,
+/// ScenePass and Intermediate stage into its own secondary command buffer on
+/// a worker pool, and a stage may split itself into chunks (one secondary
+/// each) via record_chunk_count(). Consequences for stages:
+///   - record() and record_chunk() may run concurrently with other stages and
+///     with other chunks of the same stage: they must not mutate CPU state.
+///   - Each secondary starts with no bound state. Every chunk binds its own
+///     pipeline, descriptor sets, vertex/index buffers and dynamic state;
+///     the graph sets viewport and scissor for ScenePass secondaries.
+///   - Render passes can only begin in a primary command buffer. PrePass and
+///     Intermediate stages that begin their own override begins_render_pass()
+///     and are recorded inline, between the other stages' secondaries.
 class RenderStage
 {
 public:
@@ -86,12 +112,31 @@ public:
   /// Record commands for this stage into ctx.command_buffer.
   virtual void record(const FrameContext& ctx) = 0;
 
+  /// Number of independent chunks the stage can be split into this frame.
+  /// Chunks are recorded in parallel and executed in chunk order.
+  [[nodiscard]] virtual uint32_t record_chunk_count(const FrameContext& /*ctx*/) const { return 1; }
+
+  /// Record one chunk of this stage. The default records the whole stage.
+  virtual void record_chunk(const FrameContext& ctx, uint32_t /*chunk*/, uint32_t /*chunk_count*/)
+  {
+    record(ctx);
+  }
+
   /// Whether this stage should execute this frame.
   [[nodiscard]] virtual bool is_enabled() const { return true; }
 
   /// The execution phase of this stage.
   [[nodiscard]] virtual Phase phase() const { return Phase::ScenePass; }
 
+  /// Whether record() issues only compute work (dispatches, pipeline barriers).
+  /// An Intermediate phase made of such stages may move to an async compute queue,
+  /// where ctx.command_buffer belongs to the compute queue family.
+  [[nodiscard]] virtual bool compute_only() const { return false; }
+
+  /// Whether record() begins and ends a render pass of its own (PrePass and
+  /// Intermediate stages only). Such stages always record on the primary.
+  [[nodiscard]] virtual bool begins_render_pass() const { return false; }
+
   /// Whether this stage records inside a render pass.
   /// PrePass and Intermediate stages return false; Scene and Composite return true.
   [[nodiscard]] bool uses_render_pass() const
@@ -104,6 +149,16 @@ public:
   /// Only stages with swapchain-dependent resources need to override.
   virtual void on_swapchain_resize(const Device& /*device*/, vk::Extent2D /*extent*/) {}
 
+  /// Called after the render graph (re)creates transient images.
+  /// Stages that declared transients refresh handles and descriptors here.
+  virtual void on_transient_images_realized() {}
+
+  /// Called on the render thread before the frame slot is recorded, once the
+  /// slot's previous submission has completed. Stages update per-frame
+  /// resources of that slot here (e.g. descriptor sets left stale by a resize,
+  /// which frames still in flight on other slots may be using).
+  virtual void begin_frame(uint32_t /*frame_index*/) {}
+
   [[nodiscard]] const std::string& name() const { return m_name; }
 
   /// Number of frames that may be in flight simultaneously.
@@ -5,6 +5,8 @@
 #include <sps/vulkan/meta.hpp>
 #include <sps/vulkan/renderer.h>
 
+#include <algorithm>
+
 namespace sps::vulkan
 {
 VulkanRenderer::VulkanRenderer(const RendererConfig& config)
@@ -13,8 +15,10 @@ VulkanRenderer::VulkanRenderer(const RendererConfig& config)
   , m_window_mode(config.window_mode)
   , m_window_title(config.window_title)
   , m_vsync_enabled(config.vsync)
+  , m_low_latency_enabled(config.low_latency)
   , m_msaa_samples(config.msaa_samples)
   , m_depth_format(config.depth_format)
+  , m_requested_frames_in_flight(config.frames_in_flight)
 {
   // 1. Window
   spdlog::trace("Creating window");
@@ -57,7 +61,12 @@ VulkanRenderer::VulkanRenderer(const RendererConfig& config)
 
   vk::PhysicalDeviceFeatures required_features{};
   required_features.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
-  const vk::PhysicalDeviceFeatures optional_features{};
+  // GPU-driven draws: one indirect-count draw per bucket, firstInstance selects the primitive
+  vk::PhysicalDeviceFeatures optional_features{};
+  optional_features.multiDrawIndirect = VK_TRUE;
+  optional_features.drawIndirectFirstInstance = VK_TRUE;
+  // Weighted blended OIT: accumulation and revealage blend differently
+  optional_features.independentBlend = VK_TRUE;
 
   std::vector<const char*> required_extensions{
     VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -71,13 +80,15 @@ VulkanRenderer::VulkanRenderer(const RendererConfig& config)
   m_device = std::make_unique<Device>(*m_instance, m_surface->get(),
     config.use_distinct_data_transfer_queue,
     physical_device, required_extensions, required_features, optional_features);
+  m_device->load_pipeline_cache(config.pipeline_cache_dir);
 
   // 5. Swapchain
   std::uint32_t fb_width, fb_height;
   m_window->get_framebuffer_size(fb_width, fb_height);
 
   spdlog::trace("Creating swapchain");
-  m_swapchain = std::make_unique<Swapchain>(*m_device, m_surface->get(), fb_width, fb_height, m_vsync_enabled);
+  m_swapchain = std::make_unique<Swapchain>(
+    *m_device, m_surface->get(), fb_width, fb_height, m_vsync_enabled, m_low_latency_enabled);
 
   // 6. Command pool + sync objects
   create_sync_objects();
@@ -105,10 +116,22 @@ void VulkanRenderer::create_sync_objects()
 {
   spdlog::trace("Creating command pool and sync objects");
   m_command_pool = make_command_pool(*m_device, true);
-  m_main_command_buffer = make_command_buffers(*m_device, *m_swapchain, m_command_pool, m_command_buffers, true);
+  if (m_device->supports_async_compute())
+  {
+    vk::CommandPoolCreateInfo poolInfo{};
+    poolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    poolInfo.queueFamilyIndex = m_device->m_compute_queue_family_index;
+    m_compute_command_pool = m_device->device().createCommandPool(poolInfo);
+  }
+
+  vk::CommandBufferAllocateInfo allocInfo{};
+  allocInfo.commandPool = m_command_pool;
+  allocInfo.level = vk::CommandBufferLevel::ePrimary;
+  allocInfo.commandBufferCount = 1;
+  m_main_command_buffer = m_device->device().allocateCommandBuffers(allocInfo)[0];
+
+  create_frame_ring();
 
-  m_in_flight = std::make_unique<Fence>(*m_device, "in-flight", true);
-  m_image_available = std::make_unique<Semaphore>(*m_device, "image-available");
   m_render_finished.resize(m_swapchain->image_count());
   for (std::uint32_t i = 0; i < m_swapchain->image_count(); i++)
   {
@@ -116,8 +139,76 @@ void VulkanRenderer::create_sync_objects()
   }
 }
 
+void VulkanRenderer::create_frame_ring()
+{
+  // ImGui and other per-image consumers rotate through swapchain_image_count
+  // buffers, so never run further ahead than there are images.
+  const std::uint32_t max_frames = std::min(MAX_FRAMES_IN_FLIGHT, m_swapchain->image_count());
+  const std::uint32_t count = std::clamp(m_requested_frames_in_flight, 1u, max_frames);
+  if (count != m_requested_frames_in_flight)
+  {
+    spdlog::warn("Requested {} frames in flight, clamping to {}", m_requested_frames_in_flight, count);
+  }
+
+  vk::CommandBufferAllocateInfo allocInfo{};
+  allocInfo.commandPool = m_command_pool;
+  allocInfo.level = vk::CommandBufferLevel::ePrimary;
+  allocInfo.commandBufferCount = 2 * count;
+  auto command_buffers = m_device->device().allocateCommandBuffers(allocInfo);
+
+  std::vector<vk::CommandBuffer> compute_buffers;
+  if (m_compute_command_pool)
+  {
+    allocInfo.commandPool = m_compute_command_pool;
+    allocInfo.commandBufferCount = count;
+    compute_buffers = m_device->device().allocateCommandBuffers(allocInfo);
+  }
+
+  m_frames.resize(count);
+  m_swapchain->set_retire_after_presents(count + 1);
+  for (std::uint32_t i = 0; i < count; i++)
+  {
+    m_frames[i].command_buffer = command_buffers[2 * i];
+    m_frames[i].resume_command_buffer = command_buffers[2 * i + 1];
+    m_frames[i].compute_command_buffer = compute_buffers.empty() ? vk::CommandBuffer{} : compute_buffers[i];
+    m_frames[i].timeline_value = 0;
+    m_frames[i].image_available =
+      std::make_unique<Semaphore>(*m_device, "image-available-" + std::to_string(i));
+  }
+  spdlog::info("Frames in flight: {}", count);
+}
+
+void VulkanRenderer::destroy_frame_ring()
+{
+  for (auto& frame : m_frames)
+  {
+    m_device->device().freeCommandBuffers(m_command_pool, frame.command_buffer);
+    m_device->device().freeCommandBuffers(m_command_pool, frame.resume_command_buffer);
+    if (frame.compute_command_buffer)
+      m_device->device().freeCommandBuffers(m_compute_command_pool, frame.compute_command_buffer);
+  }
+  m_frames.clear();
+}
+
+void VulkanRenderer::wait_frame(std::uint32_t frame) const
+{
+  m_device->wait_graphics(m_frames[frame].timeline_value);
+}
+
+void VulkanRenderer::set_frames_in_flight(std::uint32_t count)
+{
+  m_device->wait_graphics_idle();
+  m_requested_frames_in_flight = count;
+  destroy_frame_ring();
+  create_frame_ring();
+}
+
 void VulkanRenderer::recreate_sync_objects()
 {
+  // Presents of the old swapchain may still wait on the old semaphores
+  m_swapchain->defer_until_presented(
+    [old = std::make_shared<decltype(m_render_finished)>(std::move(m_render_finished))]() mutable
+    { old.reset(); });
   m_render_finished.clear();
   m_render_finished.resize(m_swapchain->image_count());
   for (std::uint32_t i = 0; i < m_swapchain->image_count(); i++)
@@ -129,6 +220,8 @@ void VulkanRenderer::recreate_sync_objects()
 void VulkanRenderer::create_depth_resources()
 {
   vk::Extent2D extent = m_swapchain->extent();
+  // Not transient: the SSS blur samples the stencil and the OIT pass tests
+  // the depth after the scene pass, so both are stored (see make_scene_renderpass).
   m_depth_stencil = std::make_unique<DepthStencilAttachment>(
     *m_device, m_depth_format, extent, m_msaa_samples);
   spdlog::trace("Created depth-stencil buffer {}x{}", extent.width, extent.height);
@@ -136,7 +229,10 @@ void VulkanRenderer::create_depth_resources()
 
 void VulkanRenderer::recreate_depth_resources()
 {
-  m_depth_stencil.reset();
+  // Frames in flight may still use the old attachment
+  m_device->defer_release(
+    [old = std::shared_ptr<DepthStencilAttachment>(std::move(m_depth_stencil))]() mutable
+    { old.reset(); });
   create_depth_resources();
 }
 
@@ -171,9 +267,10 @@ VulkanRenderer::~VulkanRenderer()
   // HDR + MSAA destroyed by RenderGraph destructor
   m_depth_stencil.reset();
 
-  m_in_flight.reset();
-  m_image_available.reset();
+  destroy_frame_ring();
   m_render_finished.clear();
   m_device->device().destroyCommandPool(m_command_pool);
+  if (m_compute_command_pool)
+    m_device->device().destroyCommandPool(m_compute_command_pool);
 }
 } // namespace sps::vulkan
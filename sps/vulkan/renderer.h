@@ -2,7 +2,6 @@
 
 #include <sps/vulkan/depth_stencil_attachment.h>
 #include <sps/vulkan/device.h>
-#include <sps/vulkan/fence.h>
 #include <sps/vulkan/instance.h>
 #include <sps/vulkan/screenshot.h>
 #include <sps/vulkan/semaphore.h>
@@ -30,18 +29,28 @@ struct RendererConfig
   bool enable_validation{ true };
   bool enable_renderdoc{ false };
   bool vsync{ true };
+  /// MAILBOX when available plus just-in-time frame starts (see Application)
+  bool low_latency{ false };
 
   std::string preferred_gpu;
   std::optional<std::uint32_t> preferred_gpu_index;
+  /// Directory of the persistent pipeline cache (empty = in-memory only)
+  std::string pipeline_cache_dir;
   bool use_distinct_data_transfer_queue{ true };
 
   vk::SampleCountFlagBits msaa_samples{ vk::SampleCountFlagBits::e1 };
   vk::Format depth_format{ vk::Format::eD32SfloatS8Uint };
+
+  /// Frames the CPU may record ahead of the GPU (clamped to 1..MAX_FRAMES_IN_FLIGHT
+  /// and to the swapchain image count).
+  std::uint32_t frames_in_flight{ 2 };
 };
 
 class VulkanRenderer
 {
 public:
+  static constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
   VulkanRenderer() = default;
   explicit VulkanRenderer(const RendererConfig& config);
   VulkanRenderer(const VulkanRenderer&) = delete;
@@ -78,17 +87,56 @@ public:
   // Command pool + sync objects
   [[nodiscard]] vk::CommandPool command_pool() const { return m_command_pool; }
   [[nodiscard]] vk::CommandBuffer main_command_buffer() const { return m_main_command_buffer; }
-  [[nodiscard]] std::vector<vk::CommandBuffer>& command_buffers() { return m_command_buffers; }
-  [[nodiscard]] Fence& in_flight() { return *m_in_flight; }
-  [[nodiscard]] Semaphore& image_available() { return *m_image_available; }
+
+  // Per-frame ring (indexed by frame index 0..frames_in_flight-1)
+  [[nodiscard]] std::uint32_t frames_in_flight() const
+  {
+    return static_cast<std::uint32_t>(m_frames.size());
+  }
+  [[nodiscard]] vk::CommandBuffer frame_command_buffer(std::uint32_t frame) const
+  {
+    return m_frames[frame].command_buffer;
+  }
+  /// Graphics command buffer for the part of a frame after its async compute work.
+  [[nodiscard]] vk::CommandBuffer frame_resume_command_buffer(std::uint32_t frame) const
+  {
+    return m_frames[frame].resume_command_buffer;
+  }
+  /// Async compute command buffer (VK_NULL_HANDLE without a compute queue).
+  [[nodiscard]] vk::CommandBuffer frame_compute_command_buffer(std::uint32_t frame) const
+  {
+    return m_frames[frame].compute_command_buffer;
+  }
+  [[nodiscard]] Semaphore& image_available(std::uint32_t frame)
+  {
+    return *m_frames[frame].image_available;
+  }
+
+  /// Block until the GPU has finished the last submission from this slot
+  /// (graphics timeline wait; newer frames may still be executing).
+  void wait_frame(std::uint32_t frame) const;
+
+  /// Record the graphics timeline value that retires this slot.
+  void set_frame_timeline_value(std::uint32_t frame, std::uint64_t value)
+  {
+    m_frames[frame].timeline_value = value;
+  }
+
+  // Per-swapchain-image (indexed by acquired image index)
   [[nodiscard]] Semaphore& render_finished(std::uint32_t index) { return *m_render_finished[index]; }
 
   /// Recreate per-swapchain-image semaphores (call after swapchain recreate).
   void recreate_sync_objects();
 
+  /// Rebuild the per-frame ring with a new frame count. Waits for the device
+  /// to go idle. The count is clamped as described in RendererConfig.
+  void set_frames_in_flight(std::uint32_t count);
+
   // Mutable access to config values stored here
   bool& vsync_enabled() { return m_vsync_enabled; }
   [[nodiscard]] bool vsync_enabled() const { return m_vsync_enabled; }
+  bool& low_latency_enabled() { return m_low_latency_enabled; }
+  [[nodiscard]] bool low_latency_enabled() const { return m_low_latency_enabled; }
 
   std::uint32_t& window_width() { return m_window_width; }
   std::uint32_t& window_height() { return m_window_height; }
@@ -102,6 +150,7 @@ private:
   std::string m_window_title;
 
   bool m_vsync_enabled{ true };
+  bool m_low_latency_enabled{ false };
   vk::SampleCountFlagBits m_msaa_samples{ vk::SampleCountFlagBits::e1 };
   vk::Format m_depth_format{ vk::Format::eD32SfloatS8Uint };
 
@@ -113,13 +162,25 @@ private:
 
   // Command pool + sync objects
   vk::CommandPool m_command_pool;
+  vk::CommandPool m_compute_command_pool; // async compute family, if any
   vk::CommandBuffer m_main_command_buffer;
-  std::vector<vk::CommandBuffer> m_command_buffers;
-  std::unique_ptr<Fence> m_in_flight;
-  std::unique_ptr<Semaphore> m_image_available;
   std::vector<std::unique_ptr<Semaphore>> m_render_finished;
 
+  /// Resources the CPU reuses once the GPU has finished frame N - frames_in_flight.
+  struct FrameSync
+  {
+    vk::CommandBuffer command_buffer;
+    vk::CommandBuffer resume_command_buffer;  // graphics, after async compute
+    vk::CommandBuffer compute_command_buffer; // async compute queue
+    std::unique_ptr<Semaphore> image_available;
+    std::uint64_t timeline_value{ 0 }; // graphics timeline value of the slot's last submit
+  };
+  std::vector<FrameSync> m_frames;
+  std::uint32_t m_requested_frames_in_flight{ 2 };
+
   void create_sync_objects();
+  void create_frame_ring();
+  void destroy_frame_ring();
 
   // Depth-stencil
   std::unique_ptr<DepthStencilAttachment> m_depth_stencil;
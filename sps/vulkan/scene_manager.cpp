@@ -83,6 +83,11 @@ void SceneManager::set_ibl_settings(const IBLSettings& settings)
   m_ibl_settings = settings;
 }
 
+void SceneManager::set_host_visible_meshes(bool host_visible)
+{
+  m_host_visible_meshes = host_visible;
+}
+
 SceneManager::LoadResult SceneManager::load_initial_scene(
   const std::string& geometry_source,
   const std::string& gltf_file,
@@ -92,7 +97,7 @@ SceneManager::LoadResult SceneManager::load_initial_scene(
 
   if (geometry_source == "gltf" && !gltf_file.empty())
   {
-    GltfScene scene = load_gltf_scene(m_device, gltf_file);
+    GltfScene scene = load_gltf_scene(m_device, gltf_file, m_host_visible_meshes);
 
     if (scene.mesh)
     {
@@ -115,7 +120,7 @@ SceneManager::LoadResult SceneManager::load_initial_scene(
   }
   else if (geometry_source == "ply" && !ply_file.empty())
   {
-    m_mesh = load_ply(m_device, ply_file);
+    m_mesh = load_ply(m_device, ply_file, m_host_visible_meshes);
 
     if (m_mesh)
     {
@@ -137,7 +142,8 @@ SceneManager::LoadResult SceneManager::load_initial_scene(
     { { -0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 1.0f } }
   };
 
-  m_mesh = std::make_unique<Mesh>(m_device, "default triangle", vertices);
+  m_mesh =
+    std::make_unique<Mesh>(m_device, "default triangle", vertices, m_host_visible_meshes);
   spdlog::trace("Created default triangle mesh");
 
   result.success = true;
@@ -237,6 +243,62 @@ std::vector<MaterialTextureSet> SceneManager::material_texture_sets() const
   return sets;
 }
 
+std::vector<GpuMaterial> SceneManager::material_params() const
+{
+  if (!m_scene)
+    return {};
+
+  std::vector<GpuMaterial> params;
+  params.reserve(m_scene->materials.size());
+  for (const auto& mat : m_scene->materials)
+  {
+    params.push_back(make_gpu_material(mat));
+  }
+  return params;
+}
+
+std::vector<uint32_t> SceneManager::material_features() const
+{
+  if (!m_scene)
+    return {};
+
+  std::vector<uint32_t> features;
+  features.reserve(m_scene->materials.size());
+  for (const auto& mat : m_scene->materials)
+  {
+    features.push_back(sps::vulkan::material_features(mat));
+  }
+  return features;
+}
+
+std::vector<GpuInstance> SceneManager::instance_params() const
+{
+  if (!m_scene)
+    return {};
+
+  std::vector<GpuInstance> params;
+  params.reserve(m_scene->primitives.size());
+  for (const auto& prim : m_scene->primitives)
+  {
+    params.push_back(make_gpu_instance(prim));
+  }
+  return params;
+}
+
+std::vector<GpuDraw> SceneManager::draw_params() const
+{
+  if (!m_scene)
+    return {};
+
+  std::vector<GpuDraw> params;
+  params.reserve(m_scene->primitives.size());
+  for (const auto& prim : m_scene->primitives)
+  {
+    params.push_back(make_gpu_draw(prim, m_scene->materials[prim.materialIndex]));
+  }
+  return params;
+}
+
 SceneManager::LoadResult SceneManager::load_model(const std::string& path)
 {
   LoadResult result;
@@ -249,7 +311,7 @@ SceneManager::LoadResult SceneManager::load_model(const std::string& path)
   m_bounds = AABB{};
 
   // Load new scene
-  GltfScene scene = load_gltf_scene(m_device, path);
+  GltfScene scene = load_gltf_scene(m_device, path, m_host_visible_meshes);
   if (!scene.mesh)
   {
     spdlog::error("Failed to load model: {}", path);
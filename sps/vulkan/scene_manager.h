@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sps/vulkan/gltf_loader.h>
+#include <sps/vulkan/gpu_material.h>
 #include <sps/vulkan/ibl.h>
 #include <sps/vulkan/material_texture_set.h>
 
@@ -44,6 +45,10 @@ public:
   /// Set IBL generation settings (call before create_defaults/load_hdr).
   void set_ibl_settings(const IBLSettings& settings);
 
+  /// Keep meshes loaded from now on in HOST_VISIBLE memory instead of
+  /// DEVICE_LOCAL (see Mesh). Takes effect on the next load.
+  void set_host_visible_meshes(bool host_visible);
+
   /// Create 1x1 fallback textures and IBL environment.
   void create_defaults(const std::string& hdr_file = "");
 
@@ -51,10 +56,10 @@ public:
   LoadResult load_initial_scene(const std::string& geometry_source,
     const std::string& gltf_file, const std::string& ply_file);
 
-  /// Runtime model switch. Caller must call device.wait_idle() first.
+  /// Runtime model switch. Caller must call device.wait_graphics_idle() first.
   LoadResult load_model(const std::string& path);
 
-  /// Switch HDR environment. Caller must call device.wait_idle() first.
+  /// Switch HDR environment. Caller must call device.wait_graphics_idle() first.
   void load_hdr(const std::string& hdr_file);
 
   // Read-only accessors
@@ -70,6 +75,22 @@ public:
   /// Texture bindings for each material in the current scene.
   [[nodiscard]] std::vector<MaterialTextureSet> material_texture_sets() const;
 
+  /// Shader material data for each material in the current scene (same order
+  /// as material_texture_sets()). Texture indices are assigned by the RenderGraph.
+  [[nodiscard]] std::vector<GpuMaterial> material_params() const;
+
+  /// Shading features of each material in the current scene (MATERIAL_FEATURE_*
+  /// bits, same order as material_params()).
+  [[nodiscard]] std::vector<uint32_t> material_features() const;
+
+  /// Shader instance data for each primitive in the current scene (same order
+  /// as GltfScene::primitives). Entry i is drawn with firstInstance = i.
+  [[nodiscard]] std::vector<GpuInstance> instance_params() const;
+
+  /// GPU-driven draw sources for each primitive in the current scene (same
+  /// order as instance_params()).
+  [[nodiscard]] std::vector<GpuDraw> draw_params() const;
+
   // IBL delegation
   [[nodiscard]] const IBL* ibl() const;
   [[nodiscard]] float ibl_intensity() const;
@@ -80,6 +101,7 @@ private:
   std::unique_ptr<Mesh> m_mesh;
   std::optional<GltfScene> m_scene;
   AABB m_bounds;
+  bool m_host_visible_meshes{ false };
 
   // Fallback textures (1x1 defaults)
   std::unique_ptr<Texture> m_defaultTexture;
@@ -53,7 +53,7 @@ bool save_screenshot(
     mem_reqs.memoryTypeBits,
     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
 
-  vk::DeviceMemory dst_memory = dev.allocateMemory(alloc_info);
+  vk::DeviceMemory dst_memory = device.allocate_memory(alloc_info, MemoryCategory::Staging);
   dev.bindImageMemory(dst_image, dst_memory, 0);
 
   // Create command buffer for copy operation
@@ -175,11 +175,8 @@ bool save_screenshot(
   submit_info.commandBufferCount = 1;
   submit_info.pCommandBuffers = &cmd_buffer;
 
-  vk::Fence fence = dev.createFence({});
-  device.graphics_queue().submit(submit_info, fence);
-  (void)dev.waitForFences(fence, VK_TRUE, UINT64_MAX);
+  device.wait_graphics(device.submit_graphics(submit_info));
 
-  dev.destroyFence(fence);
   dev.freeCommandBuffers(command_pool, cmd_buffer);
 
   // Map memory and read pixels
@@ -221,7 +218,7 @@ bool save_screenshot(
 
   // Cleanup
   dev.destroyImage(dst_image);
-  dev.freeMemory(dst_memory);
+  device.free_memory(dst_memory);
 
   // Save to file
   bool success = false;
@@ -0,0 +1,67 @@
+#include <sps/vulkan/secondary_command_pools.h>
+
+#include <sps/vulkan/device.h>
+
+#include <cassert>
+
+namespace sps::vulkan
+{
+
+SecondaryCommandPools::SecondaryCommandPools(
+  const Device& device, uint32_t frames_in_flight, uint32_t thread_count)
+  : m_device(device)
+  , m_frames_in_flight(frames_in_flight)
+  , m_thread_count(thread_count)
+{
+  // Transient: buffers are re-recorded every frame; no per-buffer reset needed
+  vk::CommandPoolCreateInfo poolInfo{};
+  poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+  poolInfo.queueFamilyIndex = device.m_graphics_queue_family_index;
+
+  m_pools.resize(static_cast<size_t>(frames_in_flight) * thread_count);
+  for (auto& pool : m_pools)
+  {
+    pool.pool = device.device().createCommandPool(poolInfo);
+  }
+}
+
+SecondaryCommandPools::~SecondaryCommandPools()
+{
+  // Destroying a pool frees its command buffers
+  for (auto& pool : m_pools)
+  {
+    if (pool.pool)
+      m_device.device().destroyCommandPool(pool.pool);
+  }
+}
+
+void SecondaryCommandPools::reset(uint32_t frame_index)
+{
+  assert(frame_index < m_frames_in_flight);
+  for (uint32_t t = 0; t < m_thread_count; ++t)
+  {
+    auto& pool = m_pools[frame_index * m_thread_count + t];
+    if (pool.used == 0)
+      continue;
+    m_device.device().resetCommandPool(pool.pool);
+    pool.used = 0;
+  }
+}
+
+vk::CommandBuffer SecondaryCommandPools::acquire(uint32_t frame_index, uint32_t thread)
+{
+  assert(frame_index < m_frames_in_flight && thread < m_thread_count);
+  auto& pool = m_pools[frame_index * m_thread_count + thread];
+
+  if (pool.used == pool.buffers.size())
+  {
+    vk::CommandBufferAllocateInfo allocInfo{};
+    allocInfo.commandPool = pool.pool;
+    allocInfo.level = vk::CommandBufferLevel::eSecondary;
+    allocInfo.commandBufferCount = 1;
+    pool.buffers.push_back(m_device.device().allocateCommandBuffers(allocInfo)[0]);
+  }
+  return pool.buffers[pool.used++];
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+class Device;
+
+/// Per-frame, per-thread command pools for secondary command buffers.
+///
+/// Vulkan command pools are externally synchronized, so each recording thread
+/// gets its own pool; each frame in flight gets its own set, so a frame can
+/// reset its pools while older frames still execute theirs. Buffers are kept
+/// across resets and reused, so steady-state frames allocate nothing.
+///
+/// Thread t may only call acquire() with thread index t; reset() must not
+/// overlap recording and must follow the wait for the frame slot's previous
+/// submission.
+class SecondaryCommandPools
+{
+public:
+  SecondaryCommandPools(const Device& device, uint32_t frames_in_flight, uint32_t thread_count);
+  ~SecondaryCommandPools();
+
+  SecondaryCommandPools(const SecondaryCommandPools&) = delete;
+  SecondaryCommandPools& operator=(const SecondaryCommandPools&) = delete;
+
+  /// Reset every thread's pool for a frame; previously acquired buffers become reusable.
+  void reset(uint32_t frame_index);
+
+  /// Next unused secondary command buffer from a thread's pool (allocated on demand).
+  [[nodiscard]] vk::CommandBuffer acquire(uint32_t frame_index, uint32_t thread);
+
+  [[nodiscard]] uint32_t frames_in_flight() const { return m_frames_in_flight; }
+  [[nodiscard]] uint32_t thread_count() const { return m_thread_count; }
+
+private:
+  struct Pool
+  {
+    vk::CommandPool pool{ VK_NULL_HANDLE };
+    std::vector<vk::CommandBuffer> buffers;
+    uint32_t used{ 0 };
+  };
+
+  const Device& m_device;
+  uint32_t m_frames_in_flight;
+  uint32_t m_thread_count;
+  std::vector<Pool> m_pools; // [frame_index * thread_count + thread]
+};
+
+} // namespace sps::vulkan
@@ -0,0 +1,331 @@
+#include <sps/vulkan/shader_compiler.h>
+
+#include <sps/vulkan/config.h>
+
+#include <spdlog/spdlog.h>
+
+#ifdef SPS_RUNTIME_SHADER_COMPILATION
+#include <shaderc/shaderc.hpp>
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#endif
+
+namespace sps::vulkan
+{
+
+#ifdef SPS_RUNTIME_SHADER_COMPILATION
+
+namespace
+{
+
+/// How the offline build compiles one .spv (keep in sync with shaders/CMakeLists.txt)
+struct ShaderVariant
+{
+  std::string_view spv_stem;
+  std::string_view source;
+  std::array<const char*, 2> defines;
+  bool vulkan_1_2;
+};
+
+// Variants whose source or defines differ from the file stem
+constexpr ShaderVariant VARIANTS[] = {
+  { "fragment_bindless", "fragment.frag", { "BINDLESS", nullptr }, true },
+  { "depth_mask_bindless", "depth_mask.frag", { "BINDLESS", nullptr }, true },
+  { "fragment_oit", "fragment.frag", { "OIT", nullptr }, false },
+  { "fragment_oit_bindless", "fragment.frag", { "BINDLESS", "OIT" }, true },
+  { "hiz_build_ms", "hiz_build.comp", { "MULTISAMPLED", nullptr }, false },
+  { "oit_resolve_ms", "oit_resolve.comp", { "MULTISAMPLED", nullptr }, false },
+};
+
+constexpr std::uint32_t SPIRV_MAGIC = 0x07230203;
+
+struct StageExtension
+{
+  std::string_view extension;
+  shaderc_shader_kind kind;
+  bool vulkan_1_2; // ray tracing needs SPIR-V 1.4+
+};
+
+constexpr StageExtension STAGE_EXTENSIONS[] = {
+  { ".vert", shaderc_vertex_shader, false },
+  { ".frag", shaderc_fragment_shader, false },
+  { ".comp", shaderc_compute_shader, false },
+  { ".rgen", shaderc_raygen_shader, true },
+  { ".rmiss", shaderc_miss_shader, true },
+  { ".rchit", shaderc_closesthit_shader, true },
+};
+
+std::string read_text(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file)
+    return {};
+  std::ostringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+std::uint64_t fnv1a(std::string_view data, std::uint64_t hash = 14695981039346656037ull)
+{
+  for (unsigned char c : data)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+/// Resolves #include "name" against the shader source directory
+class SourceDirIncluder : public shaderc::CompileOptions::IncluderInterface
+{
+public:
+  shaderc_include_result* GetInclude(const char* requested_source, shaderc_include_type /*type*/,
+    const char* /*requesting_source*/, size_t /*include_depth*/) override
+  {
+    auto* include = new Include{};
+    const auto path = std::filesystem::path(SHADER_SOURCE_DIR) / requested_source;
+    include->content = read_text(path);
+    if (include->content.empty())
+    {
+      // An empty source name reports content as the error
+      include->content = "cannot open " + path.string();
+    }
+    else
+    {
+      include->name = path.string();
+    }
+    include->result.source_name = include->name.c_str();
+    include->result.source_name_length = include->name.size();
+    include->result.content = include->content.c_str();
+    include->result.content_length = include->content.size();
+    include->result.user_data = include;
+    return &include->result;
+  }
+
+  void ReleaseInclude(shaderc_include_result* data) override
+  {
+    delete static_cast<Include*>(data->user_data);
+  }
+
+private:
+  struct Include
+  {
+    std::string name;
+    std::string content;
+    shaderc_include_result result{};
+  };
+};
+
+struct CompilerState
+{
+  std::mutex mutex;
+  bool enabled{ false };
+  std::filesystem::path cache_dir;
+  std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cache;
+};
+
+CompilerState& state()
+{
+  static CompilerState s;
+  return s;
+}
+
+} // anonymous namespace
+
+bool runtime_shader_compilation_available()
+{
+  return true;
+}
+
+void enable_runtime_shader_compilation(const std::string& cache_dir)
+{
+  auto& s = state();
+  std::scoped_lock lock(s.mutex);
+  s.enabled = true;
+  s.cache_dir = cache_dir;
+  spdlog::info("Runtime shader compilation enabled (sources: {}, SPIR-V cache: {})",
+    SHADER_SOURCE_DIR, cache_dir.empty() ? "memory only" : cache_dir);
+}
+
+std::vector<std::uint32_t> compile_shader_for(const std::string& spv_path)
+{
+  auto& s = state();
+  {
+    std::scoped_lock lock(s.mutex);
+    if (!s.enabled)
+      return {};
+  }
+
+  // Map the .spv back to its source file, stage and defines
+  const std::string stem = std::filesystem::path(spv_path).stem().string();
+  std::string source_name;
+  std::vector<const char*> defines;
+  bool vulkan_1_2 = false;
+  for (const auto& variant : VARIANTS)
+  {
+    if (variant.spv_stem == stem)
+    {
+      source_name = variant.source;
+      for (const char* define : variant.defines)
+      {
+        if (define)
+          defines.push_back(define);
+      }
+      vulkan_1_2 = variant.vulkan_1_2;
+    }
+  }
+
+  const StageExtension* stage = nullptr;
+  for (const auto& candidate : STAGE_EXTENSIONS)
+  {
+    if (source_name.empty()
+      && std::filesystem::exists(
+        std::filesystem::path(SHADER_SOURCE_DIR) / (stem + std::string(candidate.extension))))
+    {
+      source_name = stem + std::string(candidate.extension);
+    }
+    if (source_name.ends_with(candidate.extension))
+      stage = &candidate;
+  }
+  if (!stage)
+    return {};
+  vulkan_1_2 = vulkan_1_2 || stage->vulkan_1_2;
+
+  const auto source_path = std::filesystem::path(SHADER_SOURCE_DIR) / source_name;
+  const std::string source = read_text(source_path);
+  if (source.empty())
+    return {};
+
+  auto make_options = [&]()
+  {
+    shaderc::CompileOptions options;
+    for (const char* define : defines)
+      options.AddMacroDefinition(define);
+    options.SetTargetEnvironment(shaderc_target_env_vulkan,
+      vulkan_1_2 ? shaderc_env_version_vulkan_1_2 : shaderc_env_version_vulkan_1_0);
+    options.SetIncluder(std::make_unique<SourceDirIncluder>());
+    return options;
+  };
+
+  // Key: preprocessed source (includes expanded) + defines + target environment
+  shaderc::Compiler compiler;
+  const auto preprocessed = compiler.PreprocessGlsl(
+    source, stage->kind, source_path.string().c_str(), make_options());
+  if (preprocessed.GetCompilationStatus() != shaderc_compilation_status_success)
+  {
+    spdlog::error("Failed to preprocess {}: {}", source_name, preprocessed.GetErrorMessage());
+    return {};
+  }
+  std::uint64_t key = fnv1a({ preprocessed.cbegin(), preprocessed.cend() });
+  for (const char* define : defines)
+    key = fnv1a(define, fnv1a("\n-D", key));
+  key = fnv1a(vulkan_1_2 ? "\nvulkan1.2" : "\nvulkan1.0", key);
+
+  // Memory, then disk
+  std::filesystem::path cache_file;
+  {
+    std::scoped_lock lock(s.mutex);
+    if (auto it = s.cache.find(key); it != s.cache.end())
+      return it->second;
+    if (!s.cache_dir.empty())
+      cache_file = s.cache_dir / fmt::format("{:016x}.spv", key);
+  }
+  if (!cache_file.empty() && std::filesystem::exists(cache_file))
+  {
+    std::vector<std::uint32_t> spirv;
+    {
+      std::ifstream file(cache_file, std::ios::binary | std::ios::ate);
+      const auto size = file ? static_cast<std::size_t>(file.tellg()) : 0;
+      if (size > 0 && size % sizeof(std::uint32_t) == 0)
+      {
+        spirv.resize(size / sizeof(std::uint32_t));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(spirv.data()),
+          static_cast<std::streamsize>(spirv.size() * sizeof(std::uint32_t)));
+        if (!file || spirv[0] != SPIRV_MAGIC)
+          spirv.clear();
+      }
+    }
+    if (!spirv.empty())
+    {
+      std::scoped_lock lock(s.mutex);
+      return s.cache.emplace(key, std::move(spirv)).first->second;
+    }
+
+    // Truncated or corrupt: drop it and compile again
+    spdlog::warn("Discarding invalid SPIR-V cache file {}", cache_file.string());
+    std::error_code ec;
+    std::filesystem::remove(cache_file, ec);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto result =
+    compiler.CompileGlslToSpv(source, stage->kind, source_path.string().c_str(), make_options());
+  if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+  {
+    spdlog::error("Failed to compile {}: {}", source_name, result.GetErrorMessage());
+    return {};
+  }
+  std::vector<std::uint32_t> spirv(result.cbegin(), result.cend());
+  spdlog::info("Compiled {} -> {} in {:.1f} ms", source_name, stem + ".spv",
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+  if (!cache_file.empty())
+  {
+    // Background pipeline builds may compile the same key concurrently: each
+    // writes its own temporary file and renames it into place, so a reader
+    // never sees a torn file (the last rename wins, with identical content)
+    std::error_code ec;
+    std::filesystem::create_directories(cache_file.parent_path(), ec);
+    const auto tmp_path = std::filesystem::path(cache_file).concat(fmt::format(
+      ".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    bool written = false;
+    {
+      std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(spirv.data()),
+        static_cast<std::streamsize>(spirv.size() * sizeof(std::uint32_t)));
+      written = static_cast<bool>(file);
+    }
+    if (written)
+      std::filesystem::rename(tmp_path, cache_file, ec);
+    if (!written || ec)
+    {
+      spdlog::warn("Failed to write SPIR-V cache {}", cache_file.string());
+      std::filesystem::remove(tmp_path, ec);
+    }
+  }
+
+  std::scoped_lock lock(s.mutex);
+  return s.cache.emplace(key, std::move(spirv)).first->second;
+}
+
+#else
+
+bool runtime_shader_compilation_available()
+{
+  return false;
+}
+
+void enable_runtime_shader_compilation(const std::string& /*cache_dir*/)
+{
+  spdlog::warn("Runtime shader compilation requested, but the engine was built without "
+               "shaderc (VULK3D_RUNTIME_SHADER_COMPILATION): using the offline .spv files");
+}
+
+std::vector<std::uint32_t> compile_shader_for(const std::string& /*spv_path*/)
+{
+  return {};
+}
+
+#endif
+
+} // namespace sps::vulkan
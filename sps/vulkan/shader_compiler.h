@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+/// Optional in-process GLSL compilation (shaderc), so edited shaders reload
+/// without an external rebuild.
+///
+/// The offline build (shaders/CMakeLists.txt) stays the default. With
+/// runtime compilation enabled, createModule() maps each .spv path back to
+/// its GLSL source and defines (e.g. fragment_bindless.spv = fragment.frag
+/// with BINDLESS), resolves #include "tonemap.glsl" and friends against the
+/// shader source directory, and compiles in process. Shaders without a known
+/// source keep loading their .spv.
+///
+/// SPIR-V is cached in memory and on disk, keyed by a hash of the
+/// preprocessed source (includes expanded) plus the defines and target
+/// environment: an unchanged shader is never recompiled, an edited one
+/// (or one whose include changed) is, in milliseconds. Thread-safe, so
+/// background pipeline builds can compile too.
+///
+/// Requires building with VULK3D_RUNTIME_SHADER_COMPILATION=ON.
+
+/// Whether the engine was built with shaderc.
+[[nodiscard]] bool runtime_shader_compilation_available();
+
+/// Turn runtime compilation on. No-op (with a warning) when unavailable.
+/// @param cache_dir Directory of the on-disk SPIR-V cache (empty = memory only)
+void enable_runtime_shader_compilation(const std::string& cache_dir);
+
+/// Compile the GLSL source that the offline build compiles to spv_path.
+/// @return SPIR-V words; empty when runtime compilation is off, the source is
+///   unknown or compilation failed (callers then load spv_path itself)
+[[nodiscard]] std::vector<std::uint32_t> compile_shader_for(const std::string& spv_path);
+
+} // namespace sps::vulkan
@@ -1,5 +1,7 @@
 #include <sps/vulkan/shaders.h>
 
+#include <sps/vulkan/shader_compiler.h>
+
 #include <fstream>
 #include <iostream>
 
@@ -32,11 +34,22 @@ std::vector<char> readFile(std::string filename, bool debug)
 vk::ShaderModule createModule(std::string filename, vk::Device device, bool debug)
 {
 
-  std::vector<char> sourceCode = readFile(filename, debug);
+  // Compiled from GLSL when runtime shader compilation is enabled
+  std::vector<uint32_t> spirv = compile_shader_for(filename);
+  std::vector<char> sourceCode;
   vk::ShaderModuleCreateInfo moduleInfo = {};
   moduleInfo.flags = vk::ShaderModuleCreateFlags();
-  moduleInfo.codeSize = sourceCode.size();
-  moduleInfo.pCode = reinterpret_cast<const uint32_t*>(sourceCode.data());
+  if (!spirv.empty())
+  {
+    moduleInfo.codeSize = spirv.size() * sizeof(uint32_t);
+    moduleInfo.pCode = spirv.data();
+  }
+  else
+  {
+    sourceCode = readFile(filename, debug);
+    moduleInfo.codeSize = sourceCode.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(sourceCode.data());
+  }
 
   try
   {
@@ -20,6 +20,9 @@ std::vector<char> readFile(std::string filename, bool debug);
 /**
         Make a shader module.
 
+        With runtime shader compilation enabled, the SPIR-V is compiled from
+        the GLSL source of the file instead (see shader_compiler.h).
+
         \param filename a string holding the filepath to the spir-v file.
         \param device the logical device
         \param debug whether the system is running in debug mode
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 // Debug shader: Visualize subsurface scattering contribution
 // Shows the back-lighting translucency term only (white = strong SSS, black = none)
@@ -19,28 +20,14 @@ layout(set = 0, binding = 0) uniform UniformBufferObject {
 
 layout(set = 0, binding = 11) uniform sampler2D thicknessTexture;
 
-layout(push_constant) uniform PushConstants {
-  mat4 model;
-  vec4 baseColorFactor;
-  float metallicFactor;
-  float roughnessFactor;
-  float alphaCutoff;
-  uint alphaMode;
-  float iridescenceFactor;
-  float iridescenceIor;
-  float iridescenceThicknessMin;
-  float iridescenceThicknessMax;
-  float transmissionFactor;
-  float thicknessFactor;
-  uint attenuationColorPacked;
-  float attenuationDistance;
-} pc;
+#include "scene_data.glsl"
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragNormal;
 layout(location = 2) in vec3 fragPos;
 layout(location = 3) in vec2 fragTexCoord;
 layout(location = 4) in mat3 fragTBN;
+layout(location = 7) flat in uint fragMaterialIndex;
 
 layout(location = 0) out vec4 outColor;
 
@@ -55,11 +42,13 @@ vec3 unpackColor(uint packed)
 
 void main()
 {
+  Material mat = materials[fragMaterialIndex];
+
   vec3 N = normalize(fragNormal);
   vec3 V = normalize(ubo.viewPos.xyz - fragPos);
 
   // Two-sided normal handling
-  bool doubleSided = (pc.alphaMode & 4u) != 0u;
+  bool doubleSided = (mat.alphaMode & 4u) != 0u;
   if (doubleSided && !gl_FrontFacing) {
     N = -N;
   }
@@ -73,7 +62,7 @@ void main()
   }
 
   // Thickness: exponential falloff so even thick areas transmit some light
-  float thickness = texture(thicknessTexture, fragTexCoord).g * pc.thicknessFactor;
+  float thickness = texture(thicknessTexture, fragTexCoord).g * mat.thicknessFactor;
   float transmission = exp(-thickness * 3.0);
 
   // Barré-Brisebois back-lighting
@@ -82,8 +71,8 @@ void main()
   vec3 scatteredL = L + N * distortion;
   float backLight = pow(clamp(dot(V, -scatteredL), 0.0, 1.0), power);
 
-  vec3 attColor = unpackColor(pc.attenuationColorPacked);
-  vec3 sss = attColor * backLight * transmission * pc.transmissionFactor;
+  vec3 attColor = unpackColor(mat.attenuationColorPacked);
+  vec3 sss = attColor * backLight * transmission * mat.transmissionFactor;
 
   // Boost for visualization (SSS contribution is subtle in PBR)
   outColor = vec4(sss * 3.0, 1.0);
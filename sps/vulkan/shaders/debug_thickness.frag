@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 // Debug shader: Visualize volume thickness
 // Shows thickness texture (G channel) * thicknessFactor as grayscale
@@ -6,34 +7,22 @@
 
 layout(set = 0, binding = 11) uniform sampler2D thicknessTexture;
 
-layout(push_constant) uniform PushConstants {
-  mat4 model;
-  vec4 baseColorFactor;
-  float metallicFactor;
-  float roughnessFactor;
-  float alphaCutoff;
-  uint alphaMode;
-  float iridescenceFactor;
-  float iridescenceIor;
-  float iridescenceThicknessMin;
-  float iridescenceThicknessMax;
-  float transmissionFactor;
-  float thicknessFactor;
-  uint attenuationColorPacked;
-  float attenuationDistance;
-} pc;
+#include "scene_data.glsl"
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragNormal;
 layout(location = 2) in vec3 fragPos;
 layout(location = 3) in vec2 fragTexCoord;
 layout(location = 4) in mat3 fragTBN;
+layout(location = 7) flat in uint fragMaterialIndex;
 
 layout(location = 0) out vec4 outColor;
 
 void main()
 {
-  float thickness = texture(thicknessTexture, fragTexCoord).g * pc.thicknessFactor;
+  Material mat = materials[fragMaterialIndex];
+
+  float thickness = texture(thicknessTexture, fragTexCoord).g * mat.thicknessFactor;
 
   // Heat map: zero=black, thin=blue, medium=green, thick=red
   // Black for no thickness data (models without KHR_materials_volume have thicknessFactor=0)
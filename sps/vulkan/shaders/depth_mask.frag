@@ -0,0 +1,32 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+// Depth pre-pass fragment shader for alpha-tested (MASK) materials.
+// Discards exactly the fragments fragment.frag discards, so the scene pass's
+// EQUAL depth test sees the same coverage. No color output.
+// Built twice, like fragment.frag: depth_mask.spv and depth_mask_bindless.spv.
+
+#include "scene_data.glsl"
+
+#ifdef BINDLESS
+layout(set = 0, binding = 4) uniform sampler2D textures[];
+#define baseColorTexture textures[nonuniformEXT(mat.baseColorTextureIndex)]
+#else
+layout(set = 0, binding = 1) uniform sampler2D baseColorTexture;
+#endif
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in uint fragMaterialIndex;
+
+void main()
+{
+  Material mat = materials[fragMaterialIndex];
+  if ((mat.alphaMode & 3u) != 1u)
+    return;
+
+  float alpha = texture(baseColorTexture, fragTexCoord).a * mat.baseColorFactor.a;
+  if (alpha < mat.alphaCutoff) discard;
+}
@@ -0,0 +1,36 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Position-only vertex shader for depth-only passes (no fragment shader).
+// Same transform as vertex.vert, so the depths match the scene pass
+// (invariant: exactly, as the depth pre-pass's EQUAL test requires).
+
+// Camera uniform buffer (std140 layout)
+// Must match C++ UniformBufferObject struct exactly
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+  mat4 view;
+  mat4 proj;
+  mat4 viewInverse;
+  mat4 projInverse;
+  vec4 lightPosition;
+  vec4 lightColor;
+  vec4 lightAmbient;
+  vec4 viewPos;
+  vec4 material;
+  vec4 flags;
+  vec4 ibl_params;
+} ubo;
+
+layout(location = 0) in vec3 inPosition;
+
+#include "scene_data.glsl"
+
+invariant gl_Position;
+
+void main()
+{
+  // firstInstance of the draw selects the instance
+  Instance inst = instances[gl_InstanceIndex];
+  vec4 worldPos = inst.model * vec4(inPosition, 1.0);
+  gl_Position = ubo.proj * ubo.view * worldPos;
+}
@@ -0,0 +1,43 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Depth pre-pass vertex shader for alpha-tested (MASK) materials: position,
+// plus what depth_mask.frag needs for the alpha test. Same transform as
+// vertex.vert (invariant), so the depths match the scene pass exactly.
+
+// Camera uniform buffer (std140 layout)
+// Must match C++ UniformBufferObject struct exactly
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+  mat4 view;
+  mat4 proj;
+  mat4 viewInverse;
+  mat4 projInverse;
+  vec4 lightPosition;
+  vec4 lightColor;
+  vec4 lightAmbient;
+  vec4 viewPos;
+  vec4 material;
+  vec4 flags;
+  vec4 ibl_params;
+} ubo;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 3) in vec2 inTexCoord;
+
+#include "scene_data.glsl"
+
+invariant gl_Position;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragMaterialIndex;
+
+void main()
+{
+  // firstInstance of the draw selects the instance
+  Instance inst = instances[gl_InstanceIndex];
+  fragMaterialIndex = inst.materialIndex;
+  fragTexCoord = inTexCoord;
+
+  vec4 worldPos = inst.model * vec4(inPosition, 1.0);
+  gl_Position = ubo.proj * ubo.view * worldPos;
+}
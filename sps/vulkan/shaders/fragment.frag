@@ -1,5 +1,8 @@
 #version 450
 #extension GL_GOOGLE_include_directive : require
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
 
 // PBR shader with Cook-Torrance BRDF
 // References:
@@ -23,6 +26,32 @@ layout(set = 0, binding = 0) uniform UniformBufferObject {
   vec4 ibl_params;      // x = useIBL, y = iblIntensity, z = tonemapMode, w = reserved
 } ubo;
 
+#include "scene_data.glsl"
+
+#ifdef BINDLESS
+// Bindless variant (compiled to fragment_bindless.spv with -DBINDLESS).
+// One descriptor set per frame; materials select textures by table index.
+
+// IBL textures
+layout(set = 0, binding = 1) uniform sampler2D brdfLUT;           // BRDF integration LUT
+layout(set = 0, binding = 2) uniform samplerCube irradianceMap;   // Diffuse IBL
+layout(set = 0, binding = 3) uniform samplerCube prefilterMap;    // Specular IBL (mips = roughness)
+
+// All distinct material textures
+layout(set = 0, binding = 4) uniform sampler2D textures[];
+
+// The shading code below is shared with the classic path: textures keep
+// their names and resolve through the current material's table indices.
+#define baseColorTexture textures[nonuniformEXT(mat.baseColorTextureIndex)]
+#define normalTexture textures[nonuniformEXT(mat.normalTextureIndex)]
+#define metallicRoughnessTexture textures[nonuniformEXT(mat.metallicRoughnessTextureIndex)]
+#define emissiveTexture textures[nonuniformEXT(mat.emissiveTextureIndex)]
+#define aoTexture textures[nonuniformEXT(mat.aoTextureIndex)]
+#define iridescenceTexture textures[nonuniformEXT(mat.iridescenceTextureIndex)]
+#define iridescenceThicknessTexture textures[nonuniformEXT(mat.iridescenceThicknessTextureIndex)]
+#define thicknessTexture textures[nonuniformEXT(mat.thicknessTextureIndex)]
+
+#else
 // Textures
 layout(set = 0, binding = 1) uniform sampler2D baseColorTexture;
 layout(set = 0, binding = 2) uniform sampler2D normalTexture;
@@ -41,34 +70,32 @@ layout(set = 0, binding = 10) uniform sampler2D iridescenceThicknessTexture; //
 
 // Subsurface scattering textures
 layout(set = 0, binding = 11) uniform sampler2D thicknessTexture;            // G=thickness (KHR_materials_volume)
-
-// Push constant for per-draw material properties
-layout(push_constant) uniform PushConstants {
-  mat4 model;                  // 64 bytes (vertex stage)
-  vec4 baseColorFactor;        // 16 bytes
-  float metallicFactor;        //  4 bytes
-  float roughnessFactor;       //  4 bytes
-  float alphaCutoff;           //  4 bytes
-  uint alphaMode;              //  4 bytes  bits[1:0]=0 OPAQUE,1 MASK,2 BLEND; bit[2]=doubleSided
-  float iridescenceFactor;     //  4 bytes
-  float iridescenceIor;        //  4 bytes
-  float iridescenceThicknessMin; // 4 bytes
-  float iridescenceThicknessMax; // 4 bytes
-  // TODO: transmissionFactor is currently a per-material scalar from glTF.
-  // Replace with a per-pixel transmission texture for spatially-varying SSS control.
-  float transmissionFactor;      // 4 bytes
-  float thicknessFactor;         // 4 bytes
-  uint attenuationColorPacked;   // 4 bytes  R8G8B8 packed unorm
-  float attenuationDistance;     // 4 bytes  (total: 128)
-} pc;
+#endif
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragNormal;
 layout(location = 2) in vec3 fragPos;
 layout(location = 3) in vec2 fragTexCoord;
 layout(location = 4) in mat3 fragTBN;  // Tangent-Bitangent-Normal matrix
+layout(location = 7) flat in uint fragMaterialIndex;
 
 layout(location = 0) out vec4 outColor;
+#ifdef OIT
+// Weighted blended OIT variant (fragment_oit*.spv, built with -DOIT): draws
+// BLEND primitives only, into the accumulation (outColor) and revealage targets
+layout(location = 1) out float outRevealage;
+#endif
+
+// Shader variant: the features this pipeline shades (MATERIAL_FEATURE_* bits,
+// must match gpu_material.h). RasterOpaqueStage specializes one pipeline per
+// distinct material feature set; the default is the uber shader.
+layout(constant_id = 0) const uint MATERIAL_FEATURES = 63u;
+const bool FEATURE_NORMAL_MAP = (MATERIAL_FEATURES & 1u) != 0u;
+const bool FEATURE_EMISSIVE = (MATERIAL_FEATURES & 2u) != 0u;
+const bool FEATURE_AO = (MATERIAL_FEATURES & 4u) != 0u;
+const bool FEATURE_IRIDESCENCE = (MATERIAL_FEATURES & 8u) != 0u;
+const bool FEATURE_SSS = (MATERIAL_FEATURES & 16u) != 0u;
+const bool FEATURE_IBL = (MATERIAL_FEATURES & 32u) != 0u;
 
 const float PI = 3.14159265359;
 const float GAMMA = 2.2;
@@ -201,11 +228,13 @@ vec3 getIBLGGXFresnel(vec3 N, vec3 V, float roughness, vec3 F0, float specularWe
 
 void main()
 {
+  Material mat = materials[fragMaterialIndex];
+
   // Determine normal based on normal mapping toggle
   // Reference: https://learnopengl.com/Advanced-Lighting/Normal-Mapping
   vec3 N;
 
-  if (ubo.flags.x > 0.5) {
+  if (FEATURE_NORMAL_MAP && ubo.flags.x > 0.5) {
     // Normal mapping enabled - sample and transform
     // Normal texture uses UNORM format (no sRGB conversion by GPU)
     vec3 normalMap = texture(normalTexture, fragTexCoord).rgb;
@@ -218,12 +247,12 @@ void main()
 
   // Sample base color texture (sRGB format — GPU converts to linear automatically)
   vec4 texColor = texture(baseColorTexture, fragTexCoord);
-  vec4 baseColor = texColor * pc.baseColorFactor;
+  vec4 baseColor = texColor * mat.baseColorFactor;
   vec3 albedo = baseColor.rgb;
 
   // Use texture color if available (non-white), otherwise use vertex color
   if (texColor.r > 0.99 && texColor.g > 0.99 && texColor.b > 0.99 &&
-      pc.baseColorFactor.r > 0.99 && pc.baseColorFactor.g > 0.99 && pc.baseColorFactor.b > 0.99) {
+      mat.baseColorFactor.r > 0.99 && mat.baseColorFactor.g > 0.99 && mat.baseColorFactor.b > 0.99) {
     // Default white texture with white factor - use vertex color
     albedo = fragColor;
   }
@@ -231,14 +260,8 @@ void main()
   // Sample metallic/roughness texture (glTF format: G=roughness, B=metallic)
   // Multiply by material factors per glTF spec
   vec4 mrSample = texture(metallicRoughnessTexture, fragTexCoord);
-  float perceptualRoughness = mrSample.g * pc.roughnessFactor;
-  float metallic = mrSample.b * pc.metallicFactor;
-
-  // Sample ambient occlusion (glTF stores AO in R channel)
-  float ao = texture(aoTexture, fragTexCoord).r;
-
-  // Sample emissive texture
-  vec3 emissive = texture(emissiveTexture, fragTexCoord).rgb;
+  float perceptualRoughness = mrSample.g * mat.roughnessFactor;
+  float metallic = mrSample.b * mat.metallicFactor;
 
   // Clamp roughness and metallic to valid ranges
   perceptualRoughness = clamp(perceptualRoughness, 0.0, 1.0);
@@ -252,7 +275,7 @@ void main()
   vec3 V = normalize(ubo.viewPos.xyz - fragPos);
 
   // Two-sided normal handling (Khronos glTF-Sample-Viewer approach)
-  bool doubleSided = (pc.alphaMode & 4u) != 0u;
+  bool doubleSided = (mat.alphaMode & 4u) != 0u;
   if (doubleSided && !gl_FrontFacing) {
     N = -N;
   }
@@ -298,18 +321,21 @@ void main()
   float VdotH = clamp(dot(V, H), 0.0, 1.0);
 
   // Iridescence: evaluate thin-film Fresnel if factor > 0
-  float iridescenceFac = pc.iridescenceFactor * texture(iridescenceTexture, fragTexCoord).r;
-  float iridescenceThickness = mix(pc.iridescenceThicknessMin, pc.iridescenceThicknessMax,
-    texture(iridescenceThicknessTexture, fragTexCoord).g);
-  if (iridescenceThickness == 0.0) iridescenceFac = 0.0;
-
+  float iridescenceFac = 0.0;
   vec3 iridescenceFresnel_dielectric = vec3(0.0);
   vec3 iridescenceFresnel_metallic = vec3(0.0);
-  if (iridescenceFac > 0.0) {
-    iridescenceFresnel_dielectric = evalIridescence(1.0, pc.iridescenceIor, NdotV,
-      iridescenceThickness, f0_dielectric);
-    iridescenceFresnel_metallic = evalIridescence(1.0, pc.iridescenceIor, NdotV,
-      iridescenceThickness, albedo);
+  if (FEATURE_IRIDESCENCE) {
+    iridescenceFac = mat.iridescenceFactor * texture(iridescenceTexture, fragTexCoord).r;
+    float iridescenceThickness = mix(mat.iridescenceThicknessMin, mat.iridescenceThicknessMax,
+      texture(iridescenceThicknessTexture, fragTexCoord).g);
+    if (iridescenceThickness == 0.0) iridescenceFac = 0.0;
+
+    if (iridescenceFac > 0.0) {
+      iridescenceFresnel_dielectric = evalIridescence(1.0, mat.iridescenceIor, NdotV,
+        iridescenceThickness, f0_dielectric);
+      iridescenceFresnel_metallic = evalIridescence(1.0, mat.iridescenceIor, NdotV,
+        iridescenceThickness, albedo);
+    }
   }
 
   // Fresnel term
@@ -328,7 +354,7 @@ void main()
   vec3 metal_brdf = F * specularBRDF;
 
   // Apply iridescence to direct lighting BRDF
-  if (iridescenceFac > 0.0) {
+  if (FEATURE_IRIDESCENCE && iridescenceFac > 0.0) {
     metal_brdf = mix(metal_brdf, vec3(specularBRDF) * iridescenceFresnel_metallic, iridescenceFac);
     dielectric_brdf = mix(dielectric_brdf,
       rgb_mix(diffuseBRDF, vec3(specularBRDF), iridescenceFresnel_dielectric), iridescenceFac);
@@ -341,14 +367,14 @@ void main()
 
   // Subsurface translucency (Barré-Brisebois back-lighting)
   // alphaMode bit 3: derive transmission from thickness (no explicit transmission data)
-  bool thicknessAsTransmission = (pc.alphaMode & 8u) != 0u;
+  bool thicknessAsTransmission = (mat.alphaMode & 8u) != 0u;
   float sssScale = ubo.ibl_params.w;
-  if (sssScale > 0.0 && pc.transmissionFactor > 0.0) {
+  if (FEATURE_SSS && sssScale > 0.0 && mat.transmissionFactor > 0.0) {
     // Thickness texture is in [0,1], thicknessFactor scales to world units
-    float thickness = texture(thicknessTexture, fragTexCoord).g * pc.thicknessFactor;
+    float thickness = texture(thicknessTexture, fragTexCoord).g * mat.thicknessFactor;
     // Exponential falloff: thin areas transmit more, thick areas less
     float transmission = exp(-thickness * 1.5);
-    vec3 attColor = unpackColor(pc.attenuationColorPacked);
+    vec3 attColor = unpackColor(mat.attenuationColorPacked);
 
     // Barré-Brisebois wrap lighting
     const float distortion = 0.2;
@@ -362,16 +388,16 @@ void main()
     // When deriving from thickness, use per-pixel transmission.
     // When explicit transmission exists, use scalar transmissionFactor
     // (thickness still modulates via exp() above for back-lighting intensity).
-    float effectiveTransmission = thicknessAsTransmission ? transmission : pc.transmissionFactor;
+    float effectiveTransmission = thicknessAsTransmission ? transmission : mat.transmissionFactor;
     Lo += sss * albedo * radiance * effectiveTransmission * sssScale;
   }
 
   // Get material parameters from uniforms
   float metallicAmbient = ubo.material.z;  // Fake IBL strength for metals
   float aoStrength = ubo.material.w;       // AO influence
-  bool useEmissive = ubo.flags.y > 0.5;
-  bool useAO = ubo.flags.z > 0.5;
-  bool useIBL = ubo.ibl_params.x > 0.5;
+  bool useEmissive = FEATURE_EMISSIVE && ubo.flags.y > 0.5;
+  bool useAO = FEATURE_AO && ubo.flags.z > 0.5;
+  bool useIBL = FEATURE_IBL && ubo.ibl_params.x > 0.5;
   float iblIntensity = ubo.ibl_params.y;
 
   // Ambient/IBL lighting
@@ -392,7 +418,7 @@ void main()
     vec3 f_dielectric_brdf = mix(f_diffuse_ibl, f_specular_ibl, f_dielectric_fresnel);
 
     // Apply iridescence to IBL
-    if (iridescenceFac > 0.0) {
+    if (FEATURE_IRIDESCENCE && iridescenceFac > 0.0) {
       f_metal_brdf = mix(f_metal_brdf, f_specular_ibl * iridescenceFresnel_metallic, iridescenceFac);
       f_dielectric_brdf = mix(f_dielectric_brdf,
         rgb_mix(f_diffuse_ibl, f_specular_ibl, iridescenceFresnel_dielectric), iridescenceFac);
@@ -415,12 +441,14 @@ void main()
   // Apply AO to entire color (matching glTF-Sample-Viewer)
   // Formula: color = color * (1.0 + strength * (ao - 1.0))
   if (useAO) {
+    float ao = texture(aoTexture, fragTexCoord).r;  // glTF stores AO in R channel
     color = color * (1.0 + aoStrength * (ao - 1.0));
   }
 
   // Add emissive (before tone mapping for HDR glow effect)
   // Reference: https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#reference-material
   if (useEmissive) {
+    vec3 emissive = texture(emissiveTexture, fragTexCoord).rgb;
     color += emissive;  // Emissive texture is sRGB format — GPU converts to linear on sample
   }
 
@@ -431,19 +459,32 @@ void main()
   // When we have explicit transmission data, all pixels of the material get blur.
   // When deriving from thickness, only pixels with thickness > 0 get blur
   // (e.g. teeth blur but gingiva doesn't, based on the thickness texture).
-  float blurMask;
-  if (thicknessAsTransmission) {
-    float t = texture(thicknessTexture, fragTexCoord).g * pc.thicknessFactor;
+  float blurMask = 0.0;
+  if (!FEATURE_SSS) {
+    // Variant without SSS materials: no blur
+  } else if (thicknessAsTransmission) {
+    float t = texture(thicknessTexture, fragTexCoord).g * mat.thicknessFactor;
     blurMask = (t > 0.0) ? 1.0 : 0.0;
   } else {
-    blurMask = (pc.transmissionFactor > 0.0) ? 1.0 : 0.0;
+    blurMask = (mat.transmissionFactor > 0.0) ? 1.0 : 0.0;
   }
 
+#ifdef OIT
+  // Weighted blended OIT (McGuire & Bavoil 2013): the premultiplied color and
+  // coverage are summed with a weight that favours fragments near the camera,
+  // and the revealage target multiplies (1 - alpha) (blend states set by
+  // RasterOpaqueStage). OitResolveStage divides the sum by its weights.
+  float alpha = baseColor.a;
+  float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8
+    * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+  outColor = vec4(color * alpha, alpha) * weight;
+  outRevealage = alpha;
+#else
   // Alpha mode handling (late discard per Khronos reference)
-  uint alphaModeValue = pc.alphaMode & 3u;  // Mask off doubleSided bit
+  uint alphaModeValue = mat.alphaMode & 3u;  // Mask off doubleSided bit
   if (alphaModeValue == 1u) {
     // MASK: discard fragments below cutoff
-    if (baseColor.a < pc.alphaCutoff) discard;
+    if (baseColor.a < mat.alphaCutoff) discard;
     outColor = vec4(color, blurMask);
   } else if (alphaModeValue == 2u) {
     // BLEND: output with alpha for blending (can't use alpha for blur mask here)
@@ -452,4 +493,5 @@ void main()
     // OPAQUE (default): alpha carries SSS blur mask (0.0 = no blur, 1.0 = blur)
     outColor = vec4(color, blurMask);
   }
+#endif
 }
@@ -0,0 +1,48 @@
+// Static per-scene shader data (descriptor set 1, shared by all raster pipelines)
+// Uploaded once per scene load; draws select their instance via firstInstance.
+
+// Per-material factors and bindless texture table indices (std430, 96 bytes)
+// Must match C++ GpuMaterial struct exactly
+struct Material {
+  vec4 baseColorFactor;
+  float metallicFactor;
+  float roughnessFactor;
+  float alphaCutoff;
+  uint alphaMode;              // bits[1:0]=0 OPAQUE,1 MASK,2 BLEND; bit[2]=doubleSided
+  float iridescenceFactor;
+  float iridescenceIor;
+  float iridescenceThicknessMin;
+  float iridescenceThicknessMax;
+  // TODO: transmissionFactor is currently a per-material scalar from glTF.
+  // Replace with a per-pixel transmission texture for spatially-varying SSS control.
+  float transmissionFactor;
+  float thicknessFactor;
+  uint attenuationColorPacked; // R8G8B8 packed unorm
+  float attenuationDistance;
+  uint baseColorTextureIndex;  // texture table indices (bindless variant only)
+  uint normalTextureIndex;
+  uint metallicRoughnessTextureIndex;
+  uint emissiveTextureIndex;
+  uint aoTextureIndex;
+  uint iridescenceTextureIndex;
+  uint iridescenceThicknessTextureIndex;
+  uint thicknessTextureIndex;
+};
+
+// Per-draw instance data (std430, 80 bytes)
+// Must match C++ GpuInstance struct exactly
+struct Instance {
+  mat4 model;
+  uint materialIndex;
+  uint pad0;
+  uint pad1;
+  uint pad2;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Materials {
+  Material materials[];
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer Instances {
+  Instance instances[];
+};
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 // Camera uniform buffer (std140 layout)
 // Must match C++ UniformBufferObject struct exactly
@@ -23,19 +24,11 @@ layout(location = 2) in vec3 inColor;
 layout(location = 3) in vec2 inTexCoord;
 layout(location = 4) in vec4 inTangent;  // xyz=tangent, w=handedness
 
-// Push constant for per-draw material properties
-layout(push_constant) uniform PushConstants {
-  mat4 model;                  // 64 bytes (vertex stage)
-  vec4 baseColorFactor;        // 16 bytes (fragment stage)
-  float metallicFactor;        //  4 bytes (fragment stage)
-  float roughnessFactor;       //  4 bytes (fragment stage)
-  float alphaCutoff;           //  4 bytes (fragment stage)
-  uint alphaMode;              //  4 bytes (fragment stage) 0=OPAQUE, 1=MASK, 2=BLEND
-  float iridescenceFactor;     //  4 bytes (fragment stage)
-  float iridescenceIor;        //  4 bytes (fragment stage)
-  float iridescenceThicknessMin; // 4 bytes (fragment stage)
-  float iridescenceThicknessMax; // 4 bytes (fragment stage)
-} pc;
+#include "scene_data.glsl"
+
+// Depth pre-pass shaders compute the same position: bit-identical depths for
+// the scene pass's EQUAL depth test
+invariant gl_Position;
 
 // Outputs to fragment shader
 layout(location = 0) out vec3 fragColor;
@@ -43,11 +36,16 @@ layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec3 fragPos;
 layout(location = 3) out vec2 fragTexCoord;
 layout(location = 4) out mat3 fragTBN;  // Tangent-Bitangent-Normal matrix
+layout(location = 7) flat out uint fragMaterialIndex;
 
 void main()
 {
+  // Per-draw data: firstInstance of the draw selects the instance
+  Instance inst = instances[gl_InstanceIndex];
+  fragMaterialIndex = inst.materialIndex;
+
   // World position via model matrix
-  vec4 worldPos = pc.model * vec4(inPosition, 1.0);
+  vec4 worldPos = inst.model * vec4(inPosition, 1.0);
   fragPos = worldPos.xyz;
 
   gl_Position = ubo.proj * ubo.view * worldPos;
@@ -55,7 +53,7 @@ void main()
   fragTexCoord = inTexCoord;
 
   // Transform normal and tangent by model matrix (upper 3x3)
-  mat3 normalMatrix = mat3(pc.model);
+  mat3 normalMatrix = mat3(inst.model);
   fragNormal = normalize(normalMatrix * inNormal);
 
   // Compute TBN matrix for normal mapping
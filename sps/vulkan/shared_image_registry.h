@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -16,10 +17,26 @@ enum class Phase;
 enum class AccessIntent
 {
   Read,      // Sample or load (e.g. CompositeStage reading HDR)
-  Write,     // Store only (e.g. a clear pass)
+  Write,     // Overwrite: previous contents are discarded (e.g. a cleared attachment)
   ReadWrite  // Load + store (e.g. SSSBlurStage ping-ponging HDR)
 };
 
+/// How a stage uses a shared image. Determines the pipeline stages, access
+/// types, and image layout the render graph's barriers transition to.
+enum class ImageUsage
+{
+  ColorAttachment,        // color or resolve attachment of a render pass
+  DepthStencilAttachment, // depth-stencil attachment of a render pass
+  DepthStencilReadOnly,   // depth-stencil attachment tested without writes (read-only layout)
+  DepthStencilSampled,    // depth/stencil sampled in a compute shader (read-only layout)
+  SampledFragment,        // sampled in a fragment shader
+  SampledCompute,         // sampled in a compute shader
+  StorageCompute,         // storage image in a compute shader
+  StorageRayTracing,      // storage image in ray tracing shaders
+  TransferSrc,            // copy / blit source
+  TransferDst             // copy / blit destination
+};
+
 /// Non-owning description of a shared image resource.
 /// All handles are borrowed — the actual owner (typically VulkanRenderer) manages lifetime.
 struct SharedImageEntry
@@ -38,6 +55,32 @@ struct AccessRecord
   std::string stage_name;
   Phase phase;
   AccessIntent intent;
+  ImageUsage usage;                      // how the stage expects the image on entry
+  std::optional<ImageUsage> final_usage; // how the stage leaves it, if it transitions it itself
+};
+
+/// Creation parameters for a transient image.
+/// Transient images are sized to the swapchain extent, single mip, single layer.
+/// The render graph owns them and may alias their memory (see RenderGraph).
+struct TransientImageDesc
+{
+  vk::Format format{ vk::Format::eUndefined };
+  vk::ImageUsageFlags usage{};
+  vk::SampleCountFlagBits samples{ vk::SampleCountFlagBits::e1 };
+};
+
+/// Inclusive range of phases in which an image is accessed.
+struct PhaseRange
+{
+  Phase first;
+  Phase last;
+
+  /// Whether two ranges share at least one phase.
+  [[nodiscard]] bool overlaps(const PhaseRange& other) const
+  {
+    return static_cast<int>(first) <= static_cast<int>(other.last)
+      && static_cast<int>(other.first) <= static_cast<int>(last);
+  }
 };
 
 /// String-keyed registry for shared images that multiple stages need to access.
@@ -47,11 +90,15 @@ struct AccessRecord
 /// 2. **Access declarations**: stages declare their intent via declare_access()
 ///    at construction time. The render graph later uses these declarations
 ///    to insert pipeline barriers between phases automatically.
+/// 3. **Transient declarations**: stages declare images they only need within
+///    a frame via declare_transient(). The render graph creates them, derives
+///    their lifetime from the access declarations, and lets images with
+///    disjoint lifetimes share memory.
 ///
 /// Populated by the application (or whoever owns the images) before stage construction
 /// and updated on swapchain resize. Stages query it to get current handles.
 ///
-/// Typical entries: "hdr", "depth_stencil", "hdr_msaa".
+/// Typical entries: "hdr", "depth_stencil", "hdr_msaa" (transient).
 class SharedImageRegistry
 {
 public:
@@ -72,10 +119,15 @@ public:
   /// Called once at stage construction. Multiple stages may declare access
   /// to the same image — the render graph uses the full list to determine
   /// what barriers are needed between phases.
+  ///
+  /// @param usage How the image must be ready when the stage starts.
+  /// @param final_usage How the stage leaves the image, when it transitions
+  ///   the image itself (e.g. storage write, then blit source). Defaults to usage.
   void declare_access(const std::string& image_name, const std::string& stage_name,
-    Phase phase, AccessIntent intent)
+    Phase phase, AccessIntent intent, ImageUsage usage,
+    std::optional<ImageUsage> final_usage = std::nullopt)
   {
-    m_access[image_name].push_back({ stage_name, phase, intent });
+    m_access[image_name].push_back({ stage_name, phase, intent, usage, final_usage });
   }
 
   /// All access declarations for a given image, in declaration order.
@@ -88,9 +140,54 @@ public:
     return it != m_access.end() ? it->second : empty;
   }
 
+  /// All access declarations, keyed by image name.
+  [[nodiscard]] const std::unordered_map<std::string, std::vector<AccessRecord>>& all_access_records() const
+  {
+    return m_access;
+  }
+
+  /// Declare a graph-owned transient image. Called once at stage construction,
+  /// together with declare_access() for the same name. The handles become
+  /// available through get() after RenderGraph::realize_transient_images().
+  void declare_transient(const std::string& name, const TransientImageDesc& desc)
+  {
+    m_transients[name] = desc;
+  }
+
+  [[nodiscard]] bool is_transient(const std::string& name) const
+  {
+    return m_transients.find(name) != m_transients.end();
+  }
+
+  /// All transient declarations, keyed by image name.
+  [[nodiscard]] const std::unordered_map<std::string, TransientImageDesc>& transient_images() const
+  {
+    return m_transients;
+  }
+
+  /// Lifetime of an image within a frame: the first and last phase of any
+  /// declared access. Empty if no stage has declared access.
+  [[nodiscard]] std::optional<PhaseRange> lifetime(const std::string& image_name) const
+  {
+    const auto& records = access_records(image_name);
+    if (records.empty())
+      return std::nullopt;
+
+    PhaseRange range{ records.front().phase, records.front().phase };
+    for (const auto& record : records)
+    {
+      if (static_cast<int>(record.phase) < static_cast<int>(range.first))
+        range.first = record.phase;
+      if (static_cast<int>(record.phase) > static_cast<int>(range.last))
+        range.last = record.phase;
+    }
+    return range;
+  }
+
 private:
   std::unordered_map<std::string, SharedImageEntry> m_entries;
   std::unordered_map<std::string, std::vector<AccessRecord>> m_access;
+  std::unordered_map<std::string, TransientImageDesc> m_transients;
 };
 
 } // namespace sps::vulkan
@@ -9,7 +9,7 @@
 namespace sps::vulkan
 {
 
-CompositeStage::CompositeStage(const VulkanRenderer& renderer, const RenderGraph& graph,
+CompositeStage::CompositeStage(const VulkanRenderer& renderer, RenderGraph& graph,
   vk::RenderPass render_pass, const float* exposure, const int* tonemap_mode)
   : RenderStage("CompositeStage")
   , m_renderer(renderer)
@@ -18,6 +18,9 @@ CompositeStage::CompositeStage(const VulkanRenderer& renderer, const RenderGraph
   , m_exposure(exposure)
   , m_tonemap_mode(tonemap_mode)
 {
+  graph.image_registry().declare_access(
+    "hdr", name(), phase(), AccessIntent::Read, ImageUsage::SampledFragment);
+
   create_descriptor();
   create_pipeline();
   create_framebuffers();
@@ -56,7 +59,18 @@ void CompositeStage::create_descriptor()
   layoutInfo.pBindings = &binding;
   m_descriptor_layout = dev.createDescriptorSetLayout(layoutInfo);
 
-  // Descriptor pool
+  // Pool + set with the HDR image
+  update_descriptor();
+}
+
+void CompositeStage::update_descriptor()
+{
+  auto dev = m_renderer.device().device();
+
+  // Frames in flight may still sample through the current set: write a fresh
+  // one and retire the old pool instead of updating it in place
+  m_renderer.device().retire(m_descriptor_pool);
+
   vk::DescriptorPoolSize poolSize{};
   poolSize.type = vk::DescriptorType::eCombinedImageSampler;
   poolSize.descriptorCount = 1;
@@ -74,14 +88,6 @@ void CompositeStage::create_descriptor()
   allocInfo.pSetLayouts = &m_descriptor_layout;
   m_descriptor_set = dev.allocateDescriptorSets(allocInfo)[0];
 
-  // Write descriptor with HDR image
-  update_descriptor();
-}
-
-void CompositeStage::update_descriptor()
-{
-  auto dev = m_renderer.device().device();
-
   const auto* hdr = m_graph.image_registry().get("hdr");
   vk::DescriptorImageInfo imageInfo{};
   imageInfo.sampler = hdr->sampler;
@@ -117,6 +123,7 @@ void CompositeStage::create_pipeline()
   // Create pipeline
   sps::vulkan::GraphicsPipelineInBundle specification{};
   specification.device = dev;
+  specification.pipelineCache = m_renderer.device().pipeline_cache();
   specification.vertexFilepath = SHADER_DIR "fullscreen_quad.spv";
   specification.fragmentFilepath = SHADER_DIR "composite.spv";
   specification.swapchainExtent = m_renderer.swapchain().extent();
@@ -156,9 +163,8 @@ void CompositeStage::create_framebuffers()
 
 void CompositeStage::destroy_framebuffers()
 {
-  auto dev = m_renderer.device().device();
   for (auto fb : m_framebuffers)
-    dev.destroyFramebuffer(fb);
+    m_renderer.device().retire(fb);
   m_framebuffers.clear();
 }
 
@@ -18,7 +18,7 @@ class VulkanRenderer;
 class CompositeStage : public RenderStage
 {
 public:
-  CompositeStage(const VulkanRenderer& renderer, const RenderGraph& graph,
+  CompositeStage(const VulkanRenderer& renderer, RenderGraph& graph,
     vk::RenderPass render_pass, const float* exposure, const int* tonemap_mode);
   ~CompositeStage() override;
 
@@ -38,6 +38,7 @@ void Debug2DStage::create_pipeline(vk::RenderPass composite_render_pass,
 {
   GraphicsPipelineInBundle specification{};
   specification.device = m_renderer.device().device();
+  specification.pipelineCache = m_renderer.device().pipeline_cache();
   specification.vertexFilepath = SHADER_DIR "fullscreen_quad.spv";
   specification.fragmentFilepath = SHADER_DIR "debug_texture2d.spv";
   specification.swapchainExtent = m_renderer.swapchain().extent();
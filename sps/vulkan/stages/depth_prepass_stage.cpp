@@ -0,0 +1,27 @@
+#include <sps/vulkan/stages/depth_prepass_stage.h>
+#include <sps/vulkan/stages/raster_opaque_stage.h>
+
+namespace sps::vulkan
+{
+
+void DepthPrepassStage::record(const FrameContext& ctx)
+{
+  m_opaque.record_depth_prepass(ctx, 0, 1);
+}
+
+uint32_t DepthPrepassStage::record_chunk_count(const FrameContext& ctx) const
+{
+  return m_opaque.record_chunk_count(ctx);
+}
+
+void DepthPrepassStage::record_chunk(const FrameContext& ctx, uint32_t chunk, uint32_t chunk_count)
+{
+  m_opaque.record_depth_prepass(ctx, chunk, chunk_count);
+}
+
+bool DepthPrepassStage::is_enabled() const
+{
+  return m_opaque.is_enabled() && m_opaque.depth_prepass_active();
+}
+
+} // namespace sps::vulkan
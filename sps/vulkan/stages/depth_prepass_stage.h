@@ -0,0 +1,38 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+
+namespace sps::vulkan
+{
+
+class RasterOpaqueStage;
+
+/// Depth-only pre-pass of the scene pass: lays down the depth of every
+/// OPAQUE + MASK primitive before RasterOpaqueStage shades them with an EQUAL
+/// depth test, so overdraw costs vertex work and depth tests instead of PBR
+/// fragment shading.
+///
+/// Runs in the scene render pass and must be registered right before the
+/// opaque stage (RenderGraph::add_before). Pipelines and draws come from
+/// RasterOpaqueStage (record_depth_prepass()), which also owns the toggle —
+/// no stale handles after shader hot-reload, and both stages always agree on
+/// whether the pre-pass runs.
+class DepthPrepassStage : public RenderStage
+{
+public:
+  explicit DepthPrepassStage(const RasterOpaqueStage& opaque_stage)
+    : RenderStage("DepthPrepassStage")
+    , m_opaque(opaque_stage)
+  {
+  }
+
+  void record(const FrameContext& ctx) override;
+  [[nodiscard]] uint32_t record_chunk_count(const FrameContext& ctx) const override;
+  void record_chunk(const FrameContext& ctx, uint32_t chunk, uint32_t chunk_count) override;
+  [[nodiscard]] bool is_enabled() const override;
+
+private:
+  const RasterOpaqueStage& m_opaque;
+};
+
+} // namespace sps::vulkan
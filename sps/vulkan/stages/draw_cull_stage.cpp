@@ -0,0 +1,156 @@
+#include <sps/vulkan/stages/draw_cull_stage.h>
+
+#include <spdlog/spdlog.h>
+#include <sps/vulkan/camera.h>
+#include <sps/vulkan/config.h>
+#include <sps/vulkan/frustum_culler.h>
+#include <sps/vulkan/gpu_material.h>
+#include <sps/vulkan/render_graph.h>
+#include <sps/vulkan/renderer.h>
+#include <sps/vulkan/shaders.h>
+#include <sps/vulkan/stages/hiz_cull_stage.h>
+#include <sps/vulkan/stages/raster_opaque_stage.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+struct CullPushConstants
+{
+  glm::vec4 planes[6];
+  uint32_t draw_count;
+  uint32_t bucket_capacity;
+  uint32_t occluders_only; // keep only last frame's visible opaque occluders
+};
+
+static_assert(sizeof(CullPushConstants) <= 128, "Must fit the guaranteed push constant size");
+
+} // anonymous namespace
+
+DrawCullStage::DrawCullStage(const VulkanRenderer& renderer, const RenderGraph& graph,
+  const RasterOpaqueStage& opaque_stage)
+  : RenderStage("DrawCullStage")
+  , m_renderer(renderer)
+  , m_graph(graph)
+  , m_opaque(opaque_stage)
+{
+  if (m_graph.draw_cull_descriptor_layout())
+  {
+    create_pipeline();
+    spdlog::info("Created draw cull stage (GPU-driven opaque draws)");
+  }
+}
+
+DrawCullStage::~DrawCullStage()
+{
+  auto dev = m_renderer.device().device();
+
+  if (m_pipeline)
+    dev.destroyPipeline(m_pipeline);
+  if (m_pipeline_layout)
+    dev.destroyPipelineLayout(m_pipeline_layout);
+}
+
+void DrawCullStage::create_pipeline()
+{
+  auto dev = m_renderer.device().device();
+
+  vk::PushConstantRange pcRange{};
+  pcRange.stageFlags = vk::ShaderStageFlagBits::eCompute;
+  pcRange.offset = 0;
+  pcRange.size = sizeof(CullPushConstants);
+
+  const vk::DescriptorSetLayout set_layout = m_graph.draw_cull_descriptor_layout();
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &set_layout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pcRange;
+  m_pipeline_layout = dev.createPipelineLayout(pipelineLayoutInfo);
+
+  auto shaderModule = sps::vulkan::createModule(SHADER_DIR "draw_cull.spv", dev, true);
+
+  vk::PipelineShaderStageCreateInfo stageInfo{};
+  stageInfo.stage = vk::ShaderStageFlagBits::eCompute;
+  stageInfo.module = shaderModule;
+  stageInfo.pName = "main";
+
+  vk::ComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.stage = stageInfo;
+  pipelineInfo.layout = m_pipeline_layout;
+
+  m_pipeline =
+    dev.createComputePipeline(m_renderer.device().pipeline_cache(), pipelineInfo).value;
+
+  dev.destroyShaderModule(shaderModule);
+}
+
+bool DrawCullStage::is_enabled() const
+{
+  return m_pipeline && m_opaque.is_enabled() && m_opaque.gpu_driven();
+}
+
+void DrawCullStage::record(const FrameContext& ctx)
+{
+  auto cmd = ctx.command_buffer;
+  const uint32_t draw_count = m_graph.gpu_draw_count();
+
+  // The previous frame's indirect draws read the buffers this frame rewrites
+  {
+    vk::MemoryBarrier memBarrier{};
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eDrawIndirect,
+      vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader, {},
+      memBarrier, {}, {});
+  }
+
+  cmd.fillBuffer(m_graph.draw_count_buffer(), 0, VK_WHOLE_SIZE, 0);
+
+  {
+    vk::MemoryBarrier memBarrier{};
+    memBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    memBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+      vk::PipelineStageFlagBits::eComputeShader, {}, memBarrier, {}, {});
+  }
+
+  CullPushConstants pc{};
+  if (ctx.camera)
+  {
+    const auto planes = frustum_planes(ctx.camera->view_projection_matrix());
+    std::copy(planes.begin(), planes.end(), pc.planes);
+  }
+  else
+  {
+    // No camera: keep everything
+    for (auto& plane : pc.planes)
+      plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  }
+  pc.draw_count = draw_count;
+  pc.bucket_capacity = draw_count;
+  pc.occluders_only = (m_occlusion && m_occlusion->is_enabled()) ? 1u : 0u;
+
+  cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+  cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0,
+    m_graph.draw_cull_descriptor_set(), {});
+  cmd.pushConstants(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+    static_cast<uint32_t>(sizeof(pc)), &pc);
+  cmd.dispatch((draw_count + 63) / 64, 1, 1);
+
+  // Commands and counts are consumed by the scene pass's indirect draws
+  {
+    vk::MemoryBarrier memBarrier{};
+    memBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+    memBarrier.dstAccessMask = vk::AccessFlagBits::eIndirectCommandRead;
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+      vk::PipelineStageFlagBits::eDrawIndirect, {}, memBarrier, {}, {});
+  }
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+
+namespace sps::vulkan
+{
+
+class HiZCullStage;
+class RasterOpaqueStage;
+class RenderGraph;
+class VulkanRenderer;
+
+/// GPU-driven draw generation for RasterOpaqueStage.
+///
+/// Runs as a PrePass compute stage whenever the opaque stage draws indirectly:
+/// clears the per-bucket draw counts, then one invocation per scene primitive
+/// tests its world bounds against the camera frustum and appends a
+/// VkDrawIndexedIndirectCommand to its bucket. Reads and writes only the
+/// graph-owned draw buffers (see RenderGraph, "GPU-driven draws"), so it
+/// synchronizes them itself: against the previous frame's indirect reads
+/// before the clear, and against this frame's before returning.
+///
+/// Recording cost is one fill and one dispatch, independent of the scene.
+///
+/// With occlusion culling active (see set_occlusion_stage()), the stage only
+/// emits the previous frame's visible opaque primitives: the occluders that
+/// OcclusionDepthStage draws before HiZCullStage culls the full set.
+class DrawCullStage : public RenderStage
+{
+public:
+  DrawCullStage(const VulkanRenderer& renderer, const RenderGraph& graph,
+    const RasterOpaqueStage& opaque_stage);
+  ~DrawCullStage() override;
+
+  DrawCullStage(const DrawCullStage&) = delete;
+  DrawCullStage& operator=(const DrawCullStage&) = delete;
+
+  void record(const FrameContext& ctx) override;
+  [[nodiscard]] bool is_enabled() const override;
+  [[nodiscard]] Phase phase() const override { return Phase::PrePass; }
+  [[nodiscard]] bool compute_only() const override { return true; }
+
+  /// Hi-Z stage that consumes this stage's output as occluders (null: none).
+  void set_occlusion_stage(const HiZCullStage* occlusion) { m_occlusion = occlusion; }
+
+private:
+  const VulkanRenderer& m_renderer;
+  const RenderGraph& m_graph;
+  const RasterOpaqueStage& m_opaque;
+  const HiZCullStage* m_occlusion{ nullptr };
+
+  vk::PipelineLayout m_pipeline_layout{ VK_NULL_HANDLE };
+  vk::Pipeline m_pipeline{ VK_NULL_HANDLE };
+
+  void create_pipeline();
+};
+
+} // namespace sps::vulkan
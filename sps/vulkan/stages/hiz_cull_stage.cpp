@@ -0,0 +1,431 @@
+#include <sps/vulkan/stages/hiz_cull_stage.h>
+
+#include <spdlog/spdlog.h>
+#include <sps/vulkan/camera.h>
+#include <sps/vulkan/config.h>
+#include <sps/vulkan/render_graph.h>
+#include <sps/vulkan/renderer.h>
+#include <sps/vulkan/shaders.h>
+#include <sps/vulkan/stages/occlusion_depth_stage.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+constexpr vk::Format PYRAMID_FORMAT = vk::Format::eR32Sfloat;
+
+struct BuildPushConstants
+{
+  int32_t src_size[2];
+  int32_t dst_size[2];
+  int32_t sample_count;
+};
+
+struct CullPushConstants
+{
+  glm::mat4 view_proj;
+  glm::vec2 pyramid_size;
+  uint32_t draw_count;
+  uint32_t bucket_capacity;
+  uint32_t level_count;
+};
+
+static_assert(sizeof(CullPushConstants) <= 128, "Must fit the guaranteed push constant size");
+
+vk::Pipeline create_compute_pipeline(
+  vk::Device dev, vk::PipelineCache cache, vk::PipelineLayout layout, const char* path)
+{
+  auto shaderModule = sps::vulkan::createModule(path, dev, true);
+
+  vk::PipelineShaderStageCreateInfo stageInfo{};
+  stageInfo.stage = vk::ShaderStageFlagBits::eCompute;
+  stageInfo.module = shaderModule;
+  stageInfo.pName = "main";
+
+  vk::ComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.stage = stageInfo;
+  pipelineInfo.layout = layout;
+
+  vk::Pipeline pipeline = dev.createComputePipeline(cache, pipelineInfo).value;
+
+  dev.destroyShaderModule(shaderModule);
+  return pipeline;
+}
+
+void compute_barrier(vk::CommandBuffer cmd, vk::PipelineStageFlags src_stages,
+  vk::AccessFlags src_access, vk::PipelineStageFlags dst_stages, vk::AccessFlags dst_access)
+{
+  vk::MemoryBarrier memBarrier{};
+  memBarrier.srcAccessMask = src_access;
+  memBarrier.dstAccessMask = dst_access;
+  cmd.pipelineBarrier(src_stages, dst_stages, {}, memBarrier, {}, {});
+}
+
+} // anonymous namespace
+
+HiZCullStage::HiZCullStage(const VulkanRenderer& renderer, RenderGraph& graph,
+  const OcclusionDepthStage& depth_stage)
+  : RenderStage("HiZCullStage")
+  , m_renderer(renderer)
+  , m_graph(graph)
+  , m_depth_stage(depth_stage)
+{
+  // OcclusionDepthStage hands the depth over in the sampled layout
+  m_graph.image_registry().declare_access(
+    "depth_stencil", name(), phase(), AccessIntent::Read, ImageUsage::DepthStencilSampled);
+
+  // The pyramid is written once the depth buffer exists
+  if (m_graph.draw_cull_descriptor_layout())
+  {
+    create_pipelines();
+    spdlog::info("Created Hi-Z cull stage (occlusion culling)");
+  }
+}
+
+HiZCullStage::~HiZCullStage()
+{
+  auto dev = m_renderer.device().device();
+
+  destroy_pyramid();
+
+  for (auto pipeline : { m_cull_pipeline, m_build_pipeline, m_depth_build_pipeline })
+  {
+    if (pipeline)
+      dev.destroyPipeline(pipeline);
+  }
+  if (m_cull_pipeline_layout)
+    dev.destroyPipelineLayout(m_cull_pipeline_layout);
+  if (m_build_pipeline_layout)
+    dev.destroyPipelineLayout(m_build_pipeline_layout);
+  if (m_pyramid_layout)
+    dev.destroyDescriptorSetLayout(m_pyramid_layout);
+  if (m_build_layout)
+    dev.destroyDescriptorSetLayout(m_build_layout);
+  if (m_sampler)
+    dev.destroySampler(m_sampler);
+}
+
+void HiZCullStage::create_pipelines()
+{
+  auto dev = m_renderer.device().device();
+
+  // Build set: 0 = source (depth or previous level), 1 = destination level
+  std::array<vk::DescriptorSetLayoutBinding, 2> bindings{};
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+  bindings[0].descriptorCount = 1;
+  bindings[0].stageFlags = vk::ShaderStageFlagBits::eCompute;
+  bindings[1].binding = 1;
+  bindings[1].descriptorType = vk::DescriptorType::eStorageImage;
+  bindings[1].descriptorCount = 1;
+  bindings[1].stageFlags = vk::ShaderStageFlagBits::eCompute;
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_build_layout = dev.createDescriptorSetLayout(layoutInfo);
+
+  // Cull set 1: the whole pyramid (set 0 is the graph's draw cull set)
+  layoutInfo.bindingCount = 1;
+  m_pyramid_layout = dev.createDescriptorSetLayout(layoutInfo);
+
+  // Texel fetches only: nearest, every level
+  vk::SamplerCreateInfo samplerInfo{};
+  samplerInfo.magFilter = vk::Filter::eNearest;
+  samplerInfo.minFilter = vk::Filter::eNearest;
+  samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+  samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+  m_sampler = dev.createSampler(samplerInfo);
+
+  vk::PushConstantRange pcRange{};
+  pcRange.stageFlags = vk::ShaderStageFlagBits::eCompute;
+  pcRange.offset = 0;
+  pcRange.size = sizeof(BuildPushConstants);
+
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &m_build_layout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pcRange;
+  m_build_pipeline_layout = dev.createPipelineLayout(pipelineLayoutInfo);
+
+  const std::array<vk::DescriptorSetLayout, 2> cull_layouts = { m_graph.draw_cull_descriptor_layout(),
+    m_pyramid_layout };
+  pcRange.size = sizeof(CullPushConstants);
+  pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(cull_layouts.size());
+  pipelineLayoutInfo.pSetLayouts = cull_layouts.data();
+  m_cull_pipeline_layout = dev.createPipelineLayout(pipelineLayoutInfo);
+
+  const bool msaa = m_renderer.msaa_samples() != vk::SampleCountFlagBits::e1;
+  const auto cache = m_renderer.device().pipeline_cache();
+  m_depth_build_pipeline = create_compute_pipeline(dev, cache, m_build_pipeline_layout,
+    msaa ? SHADER_DIR "hiz_build_ms.spv" : SHADER_DIR "hiz_build.spv");
+  m_build_pipeline =
+    create_compute_pipeline(dev, cache, m_build_pipeline_layout, SHADER_DIR "hiz_build.spv");
+  m_cull_pipeline =
+    create_compute_pipeline(dev, cache, m_cull_pipeline_layout, SHADER_DIR "hiz_cull.spv");
+}
+
+void HiZCullStage::create_pyramid()
+{
+  const Device& device = m_renderer.device();
+  auto dev = device.device();
+
+  m_depth_extent = m_renderer.swapchain().extent();
+  if (m_depth_extent.width == 0 || m_depth_extent.height == 0)
+    return;
+
+  // Power-of-two base: every level halves exactly, so a level-n texel covers
+  // exactly 2^n base texels per axis
+  const vk::Extent2D base{ std::bit_floor(m_depth_extent.width),
+    std::bit_floor(m_depth_extent.height) };
+  const uint32_t level_count = std::bit_width(std::max(base.width, base.height));
+
+  vk::ImageCreateInfo imageInfo{};
+  imageInfo.imageType = vk::ImageType::e2D;
+  imageInfo.extent = vk::Extent3D{ base.width, base.height, 1 };
+  imageInfo.mipLevels = level_count;
+  imageInfo.arrayLayers = 1;
+  imageInfo.format = PYRAMID_FORMAT;
+  imageInfo.tiling = vk::ImageTiling::eOptimal;
+  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+  imageInfo.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
+  imageInfo.samples = vk::SampleCountFlagBits::e1;
+  imageInfo.sharingMode = vk::SharingMode::eExclusive;
+  m_pyramid = dev.createImage(imageInfo);
+
+  vk::MemoryRequirements memReqs = dev.getImageMemoryRequirements(m_pyramid);
+  vk::MemoryAllocateInfo allocInfo{};
+  allocInfo.allocationSize = memReqs.size;
+  allocInfo.memoryTypeIndex =
+    device.find_memory_type(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+  m_pyramid_memory = device.allocate_memory(allocInfo, MemoryCategory::RenderTarget);
+  dev.bindImageMemory(m_pyramid, m_pyramid_memory, 0);
+
+  vk::ImageViewCreateInfo viewInfo{};
+  viewInfo.image = m_pyramid;
+  viewInfo.viewType = vk::ImageViewType::e2D;
+  viewInfo.format = PYRAMID_FORMAT;
+  viewInfo.subresourceRange = vk::ImageSubresourceRange{ vk::ImageAspectFlagBits::eColor, 0,
+    level_count, 0, 1 };
+  m_pyramid_view = dev.createImageView(viewInfo);
+
+  for (uint32_t level = 0; level < level_count; ++level)
+  {
+    viewInfo.subresourceRange.baseMipLevel = level;
+    viewInfo.subresourceRange.levelCount = 1;
+    m_level_views.push_back(dev.createImageView(viewInfo));
+    m_level_extents.push_back(
+      vk::Extent2D{ std::max(base.width >> level, 1u), std::max(base.height >> level, 1u) });
+  }
+
+  // One build set per level, plus the cull pass's pyramid set
+  std::array<vk::DescriptorPoolSize, 2> poolSizes{};
+  poolSizes[0].type = vk::DescriptorType::eCombinedImageSampler;
+  poolSizes[0].descriptorCount = level_count + 1;
+  poolSizes[1].type = vk::DescriptorType::eStorageImage;
+  poolSizes[1].descriptorCount = level_count;
+
+  vk::DescriptorPoolCreateInfo poolInfo{};
+  poolInfo.maxSets = level_count + 1;
+  poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  poolInfo.pPoolSizes = poolSizes.data();
+  m_descriptor_pool = dev.createDescriptorPool(poolInfo);
+
+  std::vector<vk::DescriptorSetLayout> layouts(level_count, m_build_layout);
+  layouts.push_back(m_pyramid_layout);
+  vk::DescriptorSetAllocateInfo allocSetInfo{};
+  allocSetInfo.descriptorPool = m_descriptor_pool;
+  allocSetInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+  allocSetInfo.pSetLayouts = layouts.data();
+  m_build_sets = dev.allocateDescriptorSets(allocSetInfo);
+  m_pyramid_set = m_build_sets.back();
+  m_build_sets.pop_back();
+
+  // The pyramid stays in General: written as storage, read with texel fetches
+  std::vector<vk::DescriptorImageInfo> sources(level_count);
+  std::vector<vk::DescriptorImageInfo> destinations(level_count);
+  std::vector<vk::WriteDescriptorSet> writes;
+  for (uint32_t level = 0; level < level_count; ++level)
+  {
+    if (level == 0)
+    {
+      sources[level] = { m_sampler, m_renderer.depth_stencil().depth_view(),
+        vk::ImageLayout::eDepthStencilReadOnlyOptimal };
+    }
+    else
+    {
+      sources[level] = { m_sampler, m_level_views[level - 1], vk::ImageLayout::eGeneral };
+    }
+    destinations[level] = { {}, m_level_views[level], vk::ImageLayout::eGeneral };
+
+    vk::WriteDescriptorSet write{};
+    write.dstSet = m_build_sets[level];
+    write.descriptorCount = 1;
+    write.dstBinding = 0;
+    write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    write.pImageInfo = &sources[level];
+    writes.push_back(write);
+    write.dstBinding = 1;
+    write.descriptorType = vk::DescriptorType::eStorageImage;
+    write.pImageInfo = &destinations[level];
+    writes.push_back(write);
+  }
+
+  vk::DescriptorImageInfo pyramidInfo{ m_sampler, m_pyramid_view, vk::ImageLayout::eGeneral };
+  vk::WriteDescriptorSet pyramidWrite{};
+  pyramidWrite.dstSet = m_pyramid_set;
+  pyramidWrite.dstBinding = 0;
+  pyramidWrite.descriptorCount = 1;
+  pyramidWrite.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+  pyramidWrite.pImageInfo = &pyramidInfo;
+  writes.push_back(pyramidWrite);
+
+  dev.updateDescriptorSets(writes, {});
+
+  spdlog::trace("Created Hi-Z pyramid {}x{} ({} levels)", base.width, base.height, level_count);
+}
+
+void HiZCullStage::destroy_pyramid()
+{
+  // Frames in flight may still read the old pyramid
+  const Device& device = m_renderer.device();
+
+  if (m_descriptor_pool)
+  {
+    device.retire(m_descriptor_pool);
+    m_descriptor_pool = VK_NULL_HANDLE;
+  }
+  m_build_sets.clear();
+  m_pyramid_set = VK_NULL_HANDLE;
+
+  for (auto view : m_level_views)
+    device.retire(view);
+  m_level_views.clear();
+  m_level_extents.clear();
+
+  if (m_pyramid_view)
+  {
+    device.retire(m_pyramid_view);
+    m_pyramid_view = VK_NULL_HANDLE;
+  }
+  if (m_pyramid)
+  {
+    device.retire(m_pyramid);
+    m_pyramid = VK_NULL_HANDLE;
+  }
+  if (m_pyramid_memory)
+  {
+    device.retire_memory(m_pyramid_memory);
+    m_pyramid_memory = VK_NULL_HANDLE;
+  }
+}
+
+void HiZCullStage::on_transient_images_realized()
+{
+  // Runs at startup and on every resize (depth is recreated first)
+  if (!m_cull_pipeline)
+    return;
+  destroy_pyramid();
+  create_pyramid();
+}
+
+bool HiZCullStage::is_enabled() const
+{
+  return m_cull_pipeline && m_pyramid && m_depth_stage.is_enabled();
+}
+
+void HiZCullStage::record(const FrameContext& ctx)
+{
+  auto cmd = ctx.command_buffer;
+  const auto level_count = static_cast<uint32_t>(m_level_views.size());
+
+  // OcclusionDepthStage left the depth in DepthStencilReadOnlyOptimal.
+  // The previous pyramid is discarded; the previous frame's cull pass read it.
+  {
+    vk::ImageMemoryBarrier barrier{};
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barrier.oldLayout = vk::ImageLayout::eUndefined;
+    barrier.newLayout = vk::ImageLayout::eGeneral;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_pyramid;
+    barrier.subresourceRange =
+      vk::ImageSubresourceRange{ vk::ImageAspectFlagBits::eColor, 0, level_count, 0, 1 };
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+      vk::PipelineStageFlagBits::eComputeShader, {}, {}, {}, barrier);
+  }
+
+  // Pyramid: level 0 from the depth buffer, then each level from the previous
+  BuildPushConstants build{};
+  build.sample_count = static_cast<int32_t>(m_renderer.msaa_samples());
+  vk::Extent2D src = m_depth_extent;
+  cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_depth_build_pipeline);
+  for (uint32_t level = 0; level < level_count; ++level)
+  {
+    if (level == 1)
+      cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_build_pipeline);
+
+    const vk::Extent2D dst = m_level_extents[level];
+    build.src_size[0] = static_cast<int32_t>(src.width);
+    build.src_size[1] = static_cast<int32_t>(src.height);
+    build.dst_size[0] = static_cast<int32_t>(dst.width);
+    build.dst_size[1] = static_cast<int32_t>(dst.height);
+
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_build_pipeline_layout, 0,
+      m_build_sets[level], {});
+    cmd.pushConstants(m_build_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+      static_cast<uint32_t>(sizeof(build)), &build);
+    cmd.dispatch((dst.width + 7) / 8, (dst.height + 7) / 8, 1);
+
+    // Read by the next level, or by the cull pass after the last one
+    compute_barrier(cmd, vk::PipelineStageFlagBits::eComputeShader,
+      vk::AccessFlagBits::eShaderWrite, vk::PipelineStageFlagBits::eComputeShader,
+      vk::AccessFlagBits::eShaderRead);
+    src = dst;
+  }
+
+  // The occluder pass consumed the commands and counts this pass rewrites
+  compute_barrier(cmd, vk::PipelineStageFlagBits::eDrawIndirect, {},
+    vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eComputeShader, {});
+  cmd.fillBuffer(m_graph.draw_count_buffer(), 0, VK_WHOLE_SIZE, 0);
+  compute_barrier(cmd, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite,
+    vk::PipelineStageFlagBits::eComputeShader,
+    vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+  const uint32_t draw_count = m_graph.gpu_draw_count();
+  CullPushConstants cull{};
+  cull.view_proj = ctx.camera ? ctx.camera->view_projection_matrix() : glm::mat4(1.0f);
+  cull.pyramid_size = glm::vec2(m_level_extents[0].width, m_level_extents[0].height);
+  cull.draw_count = draw_count;
+  cull.bucket_capacity = draw_count;
+  cull.level_count = level_count;
+
+  const std::array<vk::DescriptorSet, 2> sets = { m_graph.draw_cull_descriptor_set(), m_pyramid_set };
+  cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_cull_pipeline);
+  cmd.bindDescriptorSets(
+    vk::PipelineBindPoint::eCompute, m_cull_pipeline_layout, 0, sets, {});
+  cmd.pushConstants(m_cull_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+    static_cast<uint32_t>(sizeof(cull)), &cull);
+  cmd.dispatch((draw_count + 63) / 64, 1, 1);
+
+  // Commands and counts feed the scene pass; the visibility feeds the next
+  // frame's occluder selection in DrawCullStage
+  compute_barrier(cmd, vk::PipelineStageFlagBits::eComputeShader,
+    vk::AccessFlagBits::eShaderWrite,
+    vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eComputeShader,
+    vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eShaderRead);
+}
+
+} // namespace sps::vulkan
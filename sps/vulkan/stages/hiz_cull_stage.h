@@ -0,0 +1,72 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+
+#include <vector>
+
+namespace sps::vulkan
+{
+
+class OcclusionDepthStage;
+class RenderGraph;
+class VulkanRenderer;
+
+/// Second phase of Hi-Z occlusion culling (see RenderGraph, "Occlusion culling").
+///
+/// Reduces the occluder depth OcclusionDepthStage left in "depth_stencil" to
+/// a max-depth pyramid (one compute dispatch per level), then tests the
+/// bounds of every GPU-driven primitive against it. Survivors replace the
+/// occluder commands in the graph's indirect buffers, and the per-primitive
+/// result is kept in the visibility buffer as the next frame's occluder set.
+///
+/// The pyramid is owned here and rebuilt on resize: R32F, with a power-of-two
+/// base no larger than the depth buffer and a full mip chain. Like
+/// DrawCullStage, the stage synchronizes its buffer accesses itself.
+class HiZCullStage : public RenderStage
+{
+public:
+  HiZCullStage(const VulkanRenderer& renderer, RenderGraph& graph,
+    const OcclusionDepthStage& depth_stage);
+  ~HiZCullStage() override;
+
+  HiZCullStage(const HiZCullStage&) = delete;
+  HiZCullStage& operator=(const HiZCullStage&) = delete;
+
+  void record(const FrameContext& ctx) override;
+  [[nodiscard]] bool is_enabled() const override;
+  [[nodiscard]] Phase phase() const override { return Phase::PrePass; }
+  [[nodiscard]] bool compute_only() const override { return true; }
+  void on_transient_images_realized() override;
+
+private:
+  const VulkanRenderer& m_renderer;
+  RenderGraph& m_graph;
+  const OcclusionDepthStage& m_depth_stage;
+
+  // Owned resources
+  vk::DescriptorSetLayout m_build_layout{ VK_NULL_HANDLE };   // source sampler + destination level
+  vk::DescriptorSetLayout m_pyramid_layout{ VK_NULL_HANDLE }; // whole pyramid, for the cull pass
+  vk::PipelineLayout m_build_pipeline_layout{ VK_NULL_HANDLE };
+  vk::PipelineLayout m_cull_pipeline_layout{ VK_NULL_HANDLE };
+  vk::Pipeline m_depth_build_pipeline{ VK_NULL_HANDLE }; // level 0 from the (multisampled) depth
+  vk::Pipeline m_build_pipeline{ VK_NULL_HANDLE };       // level n from level n-1
+  vk::Pipeline m_cull_pipeline{ VK_NULL_HANDLE };
+  vk::Sampler m_sampler{ VK_NULL_HANDLE };
+
+  // Pyramid and its descriptors (recreated on resize)
+  vk::Image m_pyramid{ VK_NULL_HANDLE };
+  vk::DeviceMemory m_pyramid_memory{ VK_NULL_HANDLE };
+  vk::ImageView m_pyramid_view{ VK_NULL_HANDLE };
+  std::vector<vk::ImageView> m_level_views;
+  std::vector<vk::Extent2D> m_level_extents;
+  vk::DescriptorPool m_descriptor_pool{ VK_NULL_HANDLE };
+  std::vector<vk::DescriptorSet> m_build_sets; // [level]
+  vk::DescriptorSet m_pyramid_set{ VK_NULL_HANDLE };
+  vk::Extent2D m_depth_extent{};
+
+  void create_pipelines();
+  void create_pyramid();
+  void destroy_pyramid();
+};
+
+} // namespace sps::vulkan
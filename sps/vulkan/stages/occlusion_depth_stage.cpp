@@ -0,0 +1,198 @@
+#include <sps/vulkan/stages/occlusion_depth_stage.h>
+
+#include <spdlog/spdlog.h>
+#include <sps/vulkan/config.h>
+#include <sps/vulkan/gpu_material.h>
+#include <sps/vulkan/mesh.h>
+#include <sps/vulkan/pipeline.h>
+#include <sps/vulkan/render_graph.h>
+#include <sps/vulkan/renderer.h>
+#include <sps/vulkan/stages/raster_opaque_stage.h>
+#include <sps/vulkan/vertex.h>
+
+namespace sps::vulkan
+{
+
+OcclusionDepthStage::OcclusionDepthStage(const VulkanRenderer& renderer, RenderGraph& graph,
+  const RasterOpaqueStage& opaque_stage, const bool* enabled)
+  : RenderStage("OcclusionDepthStage")
+  , m_renderer(renderer)
+  , m_graph(graph)
+  , m_opaque(opaque_stage)
+  , m_enabled(enabled)
+{
+  // Cleared and drawn here, then handed to HiZCullStage for sampling
+  m_graph.image_registry().declare_access("depth_stencil", name(), phase(), AccessIntent::Write,
+    ImageUsage::DepthStencilAttachment, ImageUsage::DepthStencilSampled);
+
+  // Indirect draws with the bindless UBO set: only on the GPU-driven path
+  if (m_graph.draw_cull_descriptor_layout() && m_graph.bindless_enabled())
+  {
+    create_pipeline();
+    spdlog::info("Created occlusion depth stage (Hi-Z occluder pass)");
+  }
+}
+
+OcclusionDepthStage::~OcclusionDepthStage()
+{
+  auto dev = m_renderer.device().device();
+
+  destroy_framebuffer();
+
+  if (m_pipeline)
+    dev.destroyPipeline(m_pipeline);
+  if (m_pipeline_layout)
+    dev.destroyPipelineLayout(m_pipeline_layout);
+  if (m_render_pass)
+    dev.destroyRenderPass(m_render_pass);
+}
+
+void OcclusionDepthStage::create_pipeline()
+{
+  auto dev = m_renderer.device().device();
+
+  m_render_pass =
+    make_depth_renderpass(dev, m_renderer.depth_format(), true, m_renderer.msaa_samples());
+
+  sps::vulkan::GraphicsPipelineInBundle specification{};
+  specification.device = dev;
+  specification.pipelineCache = m_renderer.device().pipeline_cache();
+  specification.vertexFilepath = SHADER_DIR "depth_only.spv";
+  specification.swapchainExtent = m_renderer.swapchain().extent();
+  specification.swapchainImageFormat = RenderGraph::hdr_format();
+  specification.descriptorSetLayout = m_graph.bindless_descriptor_layout();
+  specification.additionalDescriptorSetLayouts = { m_graph.scene_data_descriptor_layout() };
+
+  // Positions only
+  auto binding = Vertex::binding_description();
+  auto attributes = Vertex::attribute_descriptions();
+  specification.vertexBindings = { binding };
+  specification.vertexAttributes = { attributes[0] };
+
+  specification.backfaceCulling = true;
+  specification.dynamicCullMode = true;
+  specification.depthTestEnabled = true;
+  specification.depthWriteEnabled = true;
+  specification.depthFormat = m_renderer.depth_format();
+  specification.msaaSamples = m_renderer.msaa_samples();
+  specification.existingRenderPass = m_render_pass;
+  specification.colorAttachmentCount = 0;
+
+  auto output = sps::vulkan::create_graphics_pipeline(specification, true);
+  m_pipeline_layout = output.layout;
+  m_pipeline = output.pipeline;
+}
+
+void OcclusionDepthStage::create_framebuffer()
+{
+  if (!m_render_pass)
+    return;
+
+  const auto& depth = m_renderer.depth_stencil();
+  m_depth_stencil_image = depth.image();
+  m_extent = m_renderer.swapchain().extent();
+
+  vk::ImageView attachment = depth.combined_view();
+  vk::FramebufferCreateInfo fbInfo{};
+  fbInfo.renderPass = m_render_pass;
+  fbInfo.attachmentCount = 1;
+  fbInfo.pAttachments = &attachment;
+  fbInfo.width = m_extent.width;
+  fbInfo.height = m_extent.height;
+  fbInfo.layers = 1;
+  m_framebuffer = m_renderer.device().device().createFramebuffer(fbInfo);
+}
+
+void OcclusionDepthStage::destroy_framebuffer()
+{
+  if (m_framebuffer)
+  {
+    m_renderer.device().retire(m_framebuffer);
+    m_framebuffer = VK_NULL_HANDLE;
+  }
+}
+
+void OcclusionDepthStage::on_transient_images_realized()
+{
+  // Runs at startup and on every resize (depth is recreated first)
+  destroy_framebuffer();
+  create_framebuffer();
+}
+
+bool OcclusionDepthStage::is_enabled() const
+{
+  return *m_enabled && m_pipeline && m_framebuffer && m_opaque.is_enabled()
+    && m_opaque.gpu_driven();
+}
+
+void OcclusionDepthStage::record(const FrameContext& ctx)
+{
+  auto cmd = ctx.command_buffer;
+
+  // The render graph has transitioned the depth-stencil image to
+  // DepthStencilAttachmentOptimal
+  vk::ClearValue clearValue{};
+  clearValue.depthStencil = vk::ClearDepthStencilValue{ 1.0f, 0 };
+
+  vk::RenderPassBeginInfo beginInfo{};
+  beginInfo.renderPass = m_render_pass;
+  beginInfo.framebuffer = m_framebuffer;
+  beginInfo.renderArea.offset = vk::Offset2D{ 0, 0 };
+  beginInfo.renderArea.extent = m_extent;
+  beginInfo.clearValueCount = 1;
+  beginInfo.pClearValues = &clearValue;
+  cmd.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+
+  if (ctx.mesh && ctx.scene)
+  {
+    vk::Viewport viewport{ 0.0f, 0.0f, static_cast<float>(m_extent.width),
+      static_cast<float>(m_extent.height), 0.0f, 1.0f };
+    cmd.setViewport(0, 1, &viewport);
+    vk::Rect2D scissor{ { 0, 0 }, m_extent };
+    cmd.setScissor(0, 1, &scissor);
+
+    ctx.mesh->bind(cmd);
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+      m_graph.bindless_descriptor_set(ctx.frame_index), {});
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 1,
+      m_graph.scene_data_descriptor_set(), {});
+
+    // DrawCullStage wrote this frame's occluders into the usual buckets
+    // (MASK buckets stay empty: alpha-tested primitives are never occluders)
+    const uint32_t capacity = m_graph.gpu_draw_count();
+    constexpr auto stride = static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+    for (uint32_t bucket = 0; bucket < DRAW_BUCKET_COUNT; ++bucket)
+    {
+      if (bucket & DRAW_BUCKET_ALPHA_MASK)
+        continue;
+      cmd.setCullModeEXT((bucket & DRAW_BUCKET_DOUBLE_SIDED) ? vk::CullModeFlagBits::eNone
+                                                             : vk::CullModeFlagBits::eBack);
+      cmd.drawIndexedIndirectCountKHR(m_graph.indirect_draw_buffer(),
+        vk::DeviceSize{ bucket } * capacity * stride, m_graph.draw_count_buffer(),
+        vk::DeviceSize{ bucket } * sizeof(uint32_t), capacity, stride);
+    }
+  }
+
+  cmd.endRenderPass();
+
+  // HiZCullStage samples the depth in a compute shader
+  vk::ImageMemoryBarrier barrier{};
+  barrier.srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+  barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+  barrier.oldLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+  barrier.newLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = m_depth_stencil_image;
+  barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
+  if (m_renderer.depth_stencil().has_stencil())
+    barrier.subresourceRange.aspectMask |= vk::ImageAspectFlagBits::eStencil;
+  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.layerCount = 1;
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+    vk::PipelineStageFlagBits::eComputeShader, {}, {}, {}, barrier);
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+
+namespace sps::vulkan
+{
+
+class RasterOpaqueStage;
+class RenderGraph;
+class VulkanRenderer;
+
+/// First phase of Hi-Z occlusion culling (see RenderGraph, "Occlusion culling").
+///
+/// Draws the occluders DrawCullStage emitted for this frame (fully opaque
+/// primitives that were visible last frame) depth-only into "depth_stencil",
+/// with one indirect-count draw per bucket and a position-only pipeline. The
+/// draws need a render pass outside the scene pass, so the stage owns a
+/// depth-only render pass and framebuffer and records on the primary command
+/// buffer. It leaves the depth in DepthStencilReadOnlyOptimal for
+/// HiZCullStage; the scene pass clears it again.
+///
+/// Runs while the toggle is on and the opaque stage draws GPU-driven.
+class OcclusionDepthStage : public RenderStage
+{
+public:
+  OcclusionDepthStage(const VulkanRenderer& renderer, RenderGraph& graph,
+    const RasterOpaqueStage& opaque_stage, const bool* enabled);
+  ~OcclusionDepthStage() override;
+
+  OcclusionDepthStage(const OcclusionDepthStage&) = delete;
+  OcclusionDepthStage& operator=(const OcclusionDepthStage&) = delete;
+
+  void record(const FrameContext& ctx) override;
+  [[nodiscard]] bool is_enabled() const override;
+  [[nodiscard]] Phase phase() const override { return Phase::PrePass; }
+  [[nodiscard]] bool begins_render_pass() const override { return true; }
+  void on_transient_images_realized() override;
+
+private:
+  const VulkanRenderer& m_renderer;
+  RenderGraph& m_graph;
+  const RasterOpaqueStage& m_opaque;
+  const bool* m_enabled;
+
+  // Owned resources
+  vk::RenderPass m_render_pass{ VK_NULL_HANDLE };
+  vk::PipelineLayout m_pipeline_layout{ VK_NULL_HANDLE };
+  vk::Pipeline m_pipeline{ VK_NULL_HANDLE };
+  vk::Framebuffer m_framebuffer{ VK_NULL_HANDLE };
+
+  // Cached from the renderer (refreshed on resize)
+  vk::Image m_depth_stencil_image;
+  vk::Extent2D m_extent{};
+
+  void create_pipeline();
+  void create_framebuffer();
+  void destroy_framebuffer();
+};
+
+} // namespace sps::vulkan
@@ -0,0 +1,209 @@
+#include <sps/vulkan/stages/oit_accumulate_stage.h>
+
+#include <spdlog/spdlog.h>
+#include <sps/vulkan/frustum_culler.h>
+#include <sps/vulkan/gltf_loader.h>
+#include <sps/vulkan/gpu_material.h>
+#include <sps/vulkan/mesh.h>
+#include <sps/vulkan/render_graph.h>
+#include <sps/vulkan/renderer.h>
+#include <sps/vulkan/stages/raster_opaque_stage.h>
+
+#include <array>
+
+namespace sps::vulkan
+{
+
+OitAccumulateStage::OitAccumulateStage(const VulkanRenderer& renderer, RenderGraph& graph,
+  const RasterOpaqueStage& opaque_stage, const bool* enabled, const bool* use_rt,
+  const bool* debug_2d)
+  : RenderStage("OitAccumulateStage")
+  , m_renderer(renderer)
+  , m_graph(graph)
+  , m_opaque(opaque_stage)
+  , m_enabled(enabled)
+  , m_use_rt(use_rt)
+  , m_debug_2d(debug_2d)
+{
+  // Both targets only live within the Intermediate phase, at the scene's sample count
+  auto& registry = m_graph.image_registry();
+  const vk::ImageUsageFlags usage =
+    vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled;
+  registry.declare_transient(
+    "oit_accum", { RasterOpaqueStage::OIT_ACCUM_FORMAT, usage, m_renderer.msaa_samples() });
+  registry.declare_transient(
+    "oit_revealage", { RasterOpaqueStage::OIT_REVEALAGE_FORMAT, usage, m_renderer.msaa_samples() });
+
+  // Cleared by the render pass, then handed to OitResolveStage for sampling
+  for (const char* target : { "oit_accum", "oit_revealage" })
+  {
+    registry.declare_access(target, name(), phase(), AccessIntent::Write,
+      ImageUsage::ColorAttachment, ImageUsage::SampledCompute);
+  }
+
+  // Depth tested against the opaque scene, never written
+  registry.declare_access(
+    "depth_stencil", name(), phase(), AccessIntent::Read, ImageUsage::DepthStencilReadOnly);
+
+  spdlog::info("Created OIT accumulate stage (weighted blended transparency)");
+}
+
+OitAccumulateStage::~OitAccumulateStage()
+{
+  destroy_framebuffer();
+}
+
+void OitAccumulateStage::create_framebuffer()
+{
+  const auto* accum = m_graph.image_registry().get("oit_accum");
+  const auto* revealage = m_graph.image_registry().get("oit_revealage");
+  if (!m_opaque.oit_render_pass() || !accum || !revealage)
+    return;
+
+  m_accum_image = accum->image;
+  m_revealage_image = revealage->image;
+  m_extent = m_renderer.swapchain().extent();
+
+  // The registry's depth view is the stencil aspect: attach the combined view
+  std::array<vk::ImageView, 3> attachments = { accum->image_view, revealage->image_view,
+    m_renderer.depth_stencil().combined_view() };
+  vk::FramebufferCreateInfo fbInfo{};
+  fbInfo.renderPass = m_opaque.oit_render_pass();
+  fbInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+  fbInfo.pAttachments = attachments.data();
+  fbInfo.width = m_extent.width;
+  fbInfo.height = m_extent.height;
+  fbInfo.layers = 1;
+  m_framebuffer = m_renderer.device().device().createFramebuffer(fbInfo);
+}
+
+void OitAccumulateStage::destroy_framebuffer()
+{
+  if (m_framebuffer)
+  {
+    m_renderer.device().retire(m_framebuffer);
+    m_framebuffer = VK_NULL_HANDLE;
+  }
+}
+
+void OitAccumulateStage::on_transient_images_realized()
+{
+  // Runs at startup and on every resize (depth is recreated first)
+  destroy_framebuffer();
+  create_framebuffer();
+}
+
+bool OitAccumulateStage::is_enabled() const
+{
+  return *m_enabled && !*m_use_rt && !*m_debug_2d && m_opaque.oit_pipeline() && m_framebuffer;
+}
+
+void OitAccumulateStage::record(const FrameContext& ctx)
+{
+  auto cmd = ctx.command_buffer;
+
+  // The render graph has transitioned both targets to ColorAttachmentOptimal
+  // and the depth-stencil image to DepthStencilReadOnlyOptimal
+  std::array<vk::ClearValue, 3> clearValues{};
+  clearValues[0].color = vk::ClearColorValue{ std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 0.0f } };
+  clearValues[1].color = vk::ClearColorValue{ std::array<float, 4>{ 1.0f, 0.0f, 0.0f, 0.0f } };
+
+  vk::RenderPassBeginInfo beginInfo{};
+  beginInfo.renderPass = m_opaque.oit_render_pass();
+  beginInfo.framebuffer = m_framebuffer;
+  beginInfo.renderArea.offset = vk::Offset2D{ 0, 0 };
+  beginInfo.renderArea.extent = m_extent;
+  beginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+  beginInfo.pClearValues = clearValues.data();
+  cmd.beginRenderPass(beginInfo, vk::SubpassContents::eInline);
+
+  if (ctx.mesh && ctx.scene && m_graph.material_set_count() > 0)
+  {
+    vk::Viewport viewport{ 0.0f, 0.0f, static_cast<float>(m_extent.width),
+      static_cast<float>(m_extent.height), 0.0f, 1.0f };
+    cmd.setViewport(0, 1, &viewport);
+    vk::Rect2D scissor{ { 0, 0 }, m_extent };
+    cmd.setScissor(0, 1, &scissor);
+
+    auto layout = m_opaque.pipeline_layout();
+    ctx.mesh->bind(cmd);
+    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_opaque.oit_pipeline());
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 1,
+      m_graph.scene_data_descriptor_set(), {});
+    if (m_opaque.uses_bindless())
+    {
+      cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0,
+        m_graph.bindless_descriptor_set(ctx.frame_index), {});
+    }
+
+    if (m_opaque.gpu_driven())
+    {
+      // DrawCullStage (and HiZCullStage) wrote the BLEND buckets as well
+      const uint32_t capacity = m_graph.gpu_draw_count();
+      constexpr auto stride = static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+      for (uint32_t bucket = DRAW_BUCKET_BLEND; bucket < DRAW_BUCKET_TOTAL; ++bucket)
+      {
+        cmd.setCullModeEXT((bucket & DRAW_BUCKET_DOUBLE_SIDED) ? vk::CullModeFlagBits::eNone
+                                                               : vk::CullModeFlagBits::eBack);
+        cmd.drawIndexedIndirectCountKHR(m_graph.indirect_draw_buffer(),
+          vk::DeviceSize{ bucket } * capacity * stride, m_graph.draw_count_buffer(),
+          vk::DeviceSize{ bucket } * sizeof(uint32_t), capacity, stride);
+      }
+    }
+    else
+    {
+      // Loader order: the result does not depend on it. Unchanged state is not
+      // set again (the first draw sets the cull mode).
+      vk::CullModeFlags cull_mode = vk::CullModeFlagBits::eFrontAndBack;
+      uint32_t material_index = ~0u;
+      const auto& primitives = ctx.scene->primitives;
+      for (uint32_t i = 0; i < static_cast<uint32_t>(primitives.size()); ++i)
+      {
+        const auto& prim = primitives[i];
+        const auto& mat = ctx.scene->materials[prim.materialIndex];
+        if (mat.alphaMode != AlphaMode::Blend || (ctx.culler && !ctx.culler->visible(i)))
+          continue;
+
+        const vk::CullModeFlags draw_cull_mode =
+          mat.doubleSided ? vk::CullModeFlagBits::eNone : vk::CullModeFlagBits::eBack;
+        if (draw_cull_mode != cull_mode)
+        {
+          cmd.setCullModeEXT(draw_cull_mode);
+          cull_mode = draw_cull_mode;
+        }
+
+        if (!m_opaque.uses_bindless() && prim.materialIndex != material_index)
+        {
+          cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0,
+            m_graph.material_descriptor_set(ctx.frame_index, prim.materialIndex), {});
+          material_index = prim.materialIndex;
+        }
+
+        // Instance index = primitive index (see RenderGraph scene data)
+        cmd.drawIndexed(prim.indexCount, 1, prim.firstIndex, prim.vertexOffset, i);
+      }
+    }
+  }
+
+  cmd.endRenderPass();
+
+  // OitResolveStage samples both targets in a compute shader
+  std::array<vk::ImageMemoryBarrier, 2> barriers{};
+  for (size_t i = 0; i < barriers.size(); ++i)
+  {
+    barriers[i].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    barriers[i].dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    barriers[i].oldLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    barriers[i].newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    barriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barriers[i].subresourceRange =
+      vk::ImageSubresourceRange{ vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 };
+  }
+  barriers[0].image = m_accum_image;
+  barriers[1].image = m_revealage_image;
+  cmd.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput,
+    vk::PipelineStageFlagBits::eComputeShader, {}, {}, {}, barriers);
+}
+
+} // namespace sps::vulkan
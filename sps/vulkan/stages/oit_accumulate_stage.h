@@ -0,0 +1,69 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+
+namespace sps::vulkan
+{
+
+class RasterOpaqueStage;
+class RenderGraph;
+class VulkanRenderer;
+
+/// Accumulation pass of weighted blended order-independent transparency
+/// (McGuire & Bavoil 2013), replacing RasterBlendStage while enabled.
+///
+/// Draws every visible BLEND primitive, in any order, into two transient
+/// targets registered in the SharedImageRegistry: "oit_accum" (RGBA16F, sum of
+/// weighted premultiplied colors) and "oit_revealage" (R16F, product of
+/// 1 - alpha). The scene depth is tested read-only, so opaque geometry still
+/// hides what lies behind it. OitResolveStage then blends the result over the
+/// HDR image before the composite pass.
+///
+/// No sort is needed, so the draws take the opaque pass's paths: with
+/// GPU-driven draws, one indirect-count draw per BLEND bucket that
+/// DrawCullStage (and HiZCullStage) filled; otherwise CPU draws in loader
+/// order, skipping state that does not change.
+///
+/// Runs in the Intermediate phase after the SSS blur (which must only see
+/// opaque surfaces), in a render pass of its own (owned by RasterOpaqueStage,
+/// with the pipeline), so it records on the primary command buffer and keeps
+/// the phase off the async compute queue. It leaves both targets in
+/// ShaderReadOnlyOptimal for the resolve.
+class OitAccumulateStage : public RenderStage
+{
+public:
+  OitAccumulateStage(const VulkanRenderer& renderer, RenderGraph& graph,
+    const RasterOpaqueStage& opaque_stage, const bool* enabled, const bool* use_rt,
+    const bool* debug_2d);
+  ~OitAccumulateStage() override;
+
+  OitAccumulateStage(const OitAccumulateStage&) = delete;
+  OitAccumulateStage& operator=(const OitAccumulateStage&) = delete;
+
+  void record(const FrameContext& ctx) override;
+  [[nodiscard]] bool is_enabled() const override;
+  [[nodiscard]] Phase phase() const override { return Phase::Intermediate; }
+  [[nodiscard]] bool begins_render_pass() const override { return true; }
+  void on_transient_images_realized() override;
+
+private:
+  const VulkanRenderer& m_renderer;
+  RenderGraph& m_graph;
+  const RasterOpaqueStage& m_opaque;
+  const bool* m_enabled;
+  const bool* m_use_rt;
+  const bool* m_debug_2d;
+
+  // Owned resources
+  vk::Framebuffer m_framebuffer{ VK_NULL_HANDLE };
+
+  // Cached from registry (refreshed on resize)
+  vk::Image m_accum_image;
+  vk::Image m_revealage_image;
+  vk::Extent2D m_extent{};
+
+  void create_framebuffer();
+  void destroy_framebuffer();
+};
+
+} // namespace sps::vulkan
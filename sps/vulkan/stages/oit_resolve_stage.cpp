@@ -0,0 +1,224 @@
+#include <sps/vulkan/stages/oit_resolve_stage.h>
+
+#include <spdlog/spdlog.h>
+#include <sps/vulkan/config.h>
+#include <sps/vulkan/render_graph.h>
+#include <sps/vulkan/renderer.h>
+#include <sps/vulkan/shaders.h>
+#include <sps/vulkan/stages/oit_accumulate_stage.h>
+
+#include <array>
+
+namespace sps::vulkan
+{
+
+namespace
+{
+
+struct ResolvePushConstants
+{
+  int32_t size[2];
+  int32_t sample_count;
+};
+
+} // anonymous namespace
+
+OitResolveStage::OitResolveStage(const VulkanRenderer& renderer, RenderGraph& graph,
+  const OitAccumulateStage& accumulate_stage)
+  : RenderStage("OitResolveStage")
+  , m_renderer(renderer)
+  , m_graph(graph)
+  , m_accumulate(accumulate_stage)
+{
+  // Declare access intent for shared images (the render graph inserts the barriers)
+  m_graph.image_registry().declare_access(
+    "hdr", name(), phase(), AccessIntent::ReadWrite, ImageUsage::StorageCompute);
+  m_graph.image_registry().declare_access(
+    "oit_accum", name(), phase(), AccessIntent::Read, ImageUsage::SampledCompute);
+  m_graph.image_registry().declare_access(
+    "oit_revealage", name(), phase(), AccessIntent::Read, ImageUsage::SampledCompute);
+
+  // Descriptors are written once the graph realizes the OIT targets
+  create_pipeline();
+  spdlog::info("Created OIT resolve stage (self-contained)");
+}
+
+OitResolveStage::~OitResolveStage()
+{
+  auto dev = m_renderer.device().device();
+
+  destroy_descriptors();
+
+  if (m_pipeline)
+    dev.destroyPipeline(m_pipeline);
+  if (m_pipeline_layout)
+    dev.destroyPipelineLayout(m_pipeline_layout);
+  if (m_descriptor_layout)
+    dev.destroyDescriptorSetLayout(m_descriptor_layout);
+  if (m_sampler)
+    dev.destroySampler(m_sampler);
+}
+
+void OitResolveStage::create_pipeline()
+{
+  auto dev = m_renderer.device().device();
+
+  // 0 = HDR (storage), 1 = accumulation, 2 = revealage
+  std::array<vk::DescriptorSetLayoutBinding, 3> bindings{};
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    bindings[i].binding = i;
+    bindings[i].descriptorType =
+      i == 0 ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eCombinedImageSampler;
+    bindings[i].descriptorCount = 1;
+    bindings[i].stageFlags = vk::ShaderStageFlagBits::eCompute;
+  }
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_descriptor_layout = dev.createDescriptorSetLayout(layoutInfo);
+
+  // Texel fetches only (nearest, clamp-to-edge)
+  vk::SamplerCreateInfo samplerInfo{};
+  samplerInfo.magFilter = vk::Filter::eNearest;
+  samplerInfo.minFilter = vk::Filter::eNearest;
+  samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+  m_sampler = dev.createSampler(samplerInfo);
+
+  vk::PushConstantRange pcRange{};
+  pcRange.stageFlags = vk::ShaderStageFlagBits::eCompute;
+  pcRange.offset = 0;
+  pcRange.size = sizeof(ResolvePushConstants);
+
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &m_descriptor_layout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pcRange;
+  m_pipeline_layout = dev.createPipelineLayout(pipelineLayoutInfo);
+
+  // The targets have the scene's sample count
+  const bool msaa = m_renderer.msaa_samples() != vk::SampleCountFlagBits::e1;
+  auto shaderModule = sps::vulkan::createModule(
+    msaa ? SHADER_DIR "oit_resolve_ms.spv" : SHADER_DIR "oit_resolve.spv", dev, true);
+
+  vk::PipelineShaderStageCreateInfo stageInfo{};
+  stageInfo.stage = vk::ShaderStageFlagBits::eCompute;
+  stageInfo.module = shaderModule;
+  stageInfo.pName = "main";
+
+  vk::ComputePipelineCreateInfo pipelineInfo{};
+  pipelineInfo.stage = stageInfo;
+  pipelineInfo.layout = m_pipeline_layout;
+
+  m_pipeline =
+    dev.createComputePipeline(m_renderer.device().pipeline_cache(), pipelineInfo).value;
+
+  dev.destroyShaderModule(shaderModule);
+}
+
+void OitResolveStage::create_descriptors()
+{
+  auto dev = m_renderer.device().device();
+
+  const auto* hdr = m_graph.image_registry().get("hdr");
+  const auto* accum = m_graph.image_registry().get("oit_accum");
+  const auto* revealage = m_graph.image_registry().get("oit_revealage");
+  if (!hdr || !accum || !revealage)
+    return;
+
+  std::array<vk::DescriptorPoolSize, 2> poolSizes{};
+  poolSizes[0].type = vk::DescriptorType::eStorageImage;
+  poolSizes[0].descriptorCount = 1;
+  poolSizes[1].type = vk::DescriptorType::eCombinedImageSampler;
+  poolSizes[1].descriptorCount = 2;
+
+  vk::DescriptorPoolCreateInfo poolInfo{};
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  poolInfo.pPoolSizes = poolSizes.data();
+  m_descriptor_pool = dev.createDescriptorPool(poolInfo);
+
+  vk::DescriptorSetAllocateInfo allocInfo{};
+  allocInfo.descriptorPool = m_descriptor_pool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &m_descriptor_layout;
+  m_descriptor_set = dev.allocateDescriptorSets(allocInfo)[0];
+
+  // HDR stays in General for the Intermediate phase; the targets are sampled
+  std::array<vk::DescriptorImageInfo, 3> imageInfos{};
+  imageInfos[0].imageView = hdr->image_view;
+  imageInfos[0].imageLayout = vk::ImageLayout::eGeneral;
+  imageInfos[1].sampler = m_sampler;
+  imageInfos[1].imageView = accum->image_view;
+  imageInfos[1].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+  imageInfos[2].sampler = m_sampler;
+  imageInfos[2].imageView = revealage->image_view;
+  imageInfos[2].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+  std::array<vk::WriteDescriptorSet, 3> writes{};
+  for (uint32_t i = 0; i < 3; ++i)
+  {
+    writes[i].dstSet = m_descriptor_set;
+    writes[i].dstBinding = i;
+    writes[i].descriptorCount = 1;
+    writes[i].descriptorType =
+      i == 0 ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eCombinedImageSampler;
+    writes[i].pImageInfo = &imageInfos[i];
+  }
+  dev.updateDescriptorSets(writes, {});
+}
+
+void OitResolveStage::destroy_descriptors()
+{
+  if (m_descriptor_pool)
+  {
+    m_renderer.device().retire(m_descriptor_pool);
+    m_descriptor_pool = VK_NULL_HANDLE;
+    m_descriptor_set = VK_NULL_HANDLE;
+  }
+}
+
+void OitResolveStage::on_transient_images_realized()
+{
+  // Runs at startup and on every resize (HDR is recreated first)
+  m_extent = m_renderer.swapchain().extent();
+  destroy_descriptors();
+  create_descriptors();
+}
+
+bool OitResolveStage::is_enabled() const
+{
+  return m_descriptor_set && m_accumulate.is_enabled();
+}
+
+void OitResolveStage::record(const FrameContext& ctx)
+{
+  auto cmd = ctx.command_buffer;
+
+  // The render graph has transitioned HDR to General; OitAccumulateStage left
+  // both targets in ShaderReadOnlyOptimal. SSSBlurStage may have written HDR
+  // earlier in this phase.
+  vk::MemoryBarrier memBarrier{};
+  memBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+  memBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+  cmd.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+    vk::PipelineStageFlagBits::eComputeShader, {}, memBarrier, {}, {});
+
+  ResolvePushConstants pc{};
+  pc.size[0] = static_cast<int32_t>(m_extent.width);
+  pc.size[1] = static_cast<int32_t>(m_extent.height);
+  pc.sample_count = static_cast<int32_t>(m_renderer.msaa_samples());
+
+  cmd.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+  cmd.pushConstants(m_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+    static_cast<uint32_t>(sizeof(pc)), &pc);
+  cmd.bindDescriptorSets(
+    vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, m_descriptor_set, {});
+  cmd.dispatch((m_extent.width + 15) / 16, (m_extent.height + 15) / 16, 1);
+}
+
+} // namespace sps::vulkan
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <sps/vulkan/render_stage.h>
+
+namespace sps::vulkan
+{
+
+class OitAccumulateStage;
+class RenderGraph;
+class VulkanRenderer;
+
+/// Resolve pass of weighted blended order-independent transparency.
+///
+/// One compute dispatch over the HDR image: reads the "oit_accum" and
+/// "oit_revealage" targets OitAccumulateStage filled (averaging the samples
+/// with MSAA) and blends the weighted average color over the opaque scene by
+/// its coverage. Runs right after the accumulation pass, so the composite
+/// pass sees the finished image.
+///
+/// Self-contained stage: owns its compute pipeline and descriptors, refreshed
+/// when transient images are realized. Runs whenever the accumulate stage does.
+class OitResolveStage : public RenderStage
+{
+public:
+  OitResolveStage(const VulkanRenderer& renderer, RenderGraph& graph,
+    const OitAccumulateStage& accumulate_stage);
+  ~OitResolveStage() override;
+
+  OitResolveStage(const OitResolveStage&) = delete;
+  OitResolveStage& operator=(const OitResolveStage&) = delete;
+
+  void record(const FrameContext& ctx) override;
+  [[nodiscard]] bool is_enabled() const override;
+  [[nodiscard]] Phase phase() const override { return Phase::Intermediate; }
+  [[nodiscard]] bool compute_only() const override { return true; }
+  void on_transient_images_realized() override;
+
+private:
+  const VulkanRenderer& m_renderer;
+  RenderGraph& m_graph;
+  const OitAccumulateStage& m_accumulate;
+
+  // Owned resources
+  vk::DescriptorSetLayout m_descriptor_layout{ VK_NULL_HANDLE };
+  vk::DescriptorPool m_descriptor_pool{ VK_NULL_HANDLE };
+  vk::DescriptorSet m_descriptor_set{ VK_NULL_HANDLE };
+  vk::PipelineLayout m_pipeline_layout{ VK_NULL_HANDLE };
+  vk::Pipeline m_pipeline{ VK_NULL_HANDLE };
+  vk::Sampler m_sampler{ VK_NULL_HANDLE };
+
+  vk::Extent2D m_extent{};
+
+  void create_pipeline();
+  void create_descriptors();
+  void destroy_descriptors();
+};
+
+} // namespace sps::vulkan
@@ -5,11 +5,14 @@
 namespace sps::vulkan
 {
 
+class OitAccumulateStage;
 class RasterOpaqueStage;
 class RenderGraph;
 
 /// Draws BLEND primitives sorted back-to-front using the blend pipeline.
-/// Depth write is disabled; alpha blending is enabled.
+/// Depth write is disabled; alpha blending is enabled. The order comes from
+/// FrameContext::blend_draws (BlendDrawList, built before recording).
+/// Disabled while the order-independent transparency stage draws them instead.
 ///
 /// Queries pipeline and layout from RasterOpaqueStage each frame — no stale handles
 /// even after shader hot-reload.
@@ -29,11 +32,15 @@ public:
   void record(const FrameContext& ctx) override;
   [[nodiscard]] bool is_enabled() const override;
 
+  /// Yield to weighted blended OIT whenever this stage runs (null: never).
+  void set_oit_stage(const OitAccumulateStage* oit_stage) { m_oit = oit_stage; }
+
 private:
   const RasterOpaqueStage& m_opaque;
   const RenderGraph& m_graph;
   const bool* m_use_rt;
   const bool* m_debug_2d;
+  const OitAccumulateStage* m_oit{ nullptr };
 };
 
 } // namespace sps::vulkan
@@ -2,8 +2,10 @@
 
 #include <spdlog/spdlog.h>
 #include <sps/vulkan/debug_constants.h>
+#include <sps/vulkan/frustum_culler.h>
 #include <sps/vulkan/gltf_loader.h>
 #include <sps/vulkan/mesh.h>
+#include <sps/vulkan/opaque_draw_list.h>
 #include <sps/vulkan/pipeline.h>
 #include <sps/vulkan/render_graph.h>
 #include <sps/vulkan/renderer.h>
@@ -11,40 +13,155 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace sps::vulkan
 {
 
+namespace
+{
+
+/// Distinct feature sets of the materials and of their union (GPU-driven
+/// draws), less the globally disabled features. The uber set needs no variant.
+std::vector<uint32_t> variant_feature_sets(
+  const std::vector<uint32_t>& material_features, uint32_t global_features)
+{
+  std::vector<uint32_t> sets;
+  uint32_t scene_features = 0;
+  for (uint32_t features : material_features)
+  {
+    sets.push_back(features & global_features);
+    scene_features |= features & global_features;
+  }
+  if (!material_features.empty())
+    sets.push_back(scene_features);
+
+  std::sort(sets.begin(), sets.end());
+  sets.erase(std::unique(sets.begin(), sets.end()), sets.end());
+  sets.erase(std::remove(sets.begin(), sets.end(), MATERIAL_FEATURE_ALL), sets.end());
+  return sets;
+}
+
+/// The pipeline of the specification with MATERIAL_FEATURES (constant_id 0) set
+vk::Pipeline create_variant_pipeline(GraphicsPipelineInBundle specification, uint32_t features)
+{
+  const vk::SpecializationMapEntry entry{ 0, 0, sizeof(uint32_t) };
+  const vk::SpecializationInfo info{ 1, &entry, sizeof(uint32_t), &features };
+  specification.fragmentSpecialization = &info;
+  return create_graphics_pipeline(specification, true).pipeline;
+}
+
+/// Compiler statistics of a pipeline's fragment shader (the pipeline must be
+/// created with eCaptureStatisticsKHR)
+std::vector<vk::PipelineExecutableStatisticKHR> fragment_statistics(
+  vk::Device dev, vk::Pipeline pipeline)
+{
+  const auto executables = dev.getPipelineExecutablePropertiesKHR(vk::PipelineInfoKHR{ pipeline });
+  for (uint32_t i = 0; i < static_cast<uint32_t>(executables.size()); ++i)
+  {
+    if (executables[i].stages & vk::ShaderStageFlagBits::eFragment)
+      return dev.getPipelineExecutableStatisticsKHR(vk::PipelineExecutableInfoKHR{ pipeline, i });
+  }
+  return {};
+}
+
+double statistic_value(const vk::PipelineExecutableStatisticKHR& statistic)
+{
+  switch (statistic.format)
+  {
+    case vk::PipelineExecutableStatisticFormatKHR::eBool32:
+      return statistic.value.b32;
+    case vk::PipelineExecutableStatisticFormatKHR::eInt64:
+      return static_cast<double>(statistic.value.i64);
+    case vk::PipelineExecutableStatisticFormatKHR::eUint64:
+      return static_cast<double>(statistic.value.u64);
+    case vk::PipelineExecutableStatisticFormatKHR::eFloat64:
+      return statistic.value.f64;
+  }
+  return 0.0;
+}
+
+} // anonymous namespace
+
 RasterOpaqueStage::RasterOpaqueStage(const VulkanRenderer& renderer,
   vk::RenderPass scene_render_pass, const RenderGraph& graph,
   const std::string& vertex_shader, const std::string& fragment_shader,
-  const bool* use_rt, const bool* debug_2d)
+  const bool* use_rt, const bool* debug_2d, const bool* gpu_driven, const bool* depth_prepass)
   : RenderStage("RasterOpaqueStage")
   , m_renderer(renderer)
   , m_scene_render_pass(scene_render_pass)
   , m_graph(graph)
   , m_use_rt(use_rt)
   , m_debug_2d(debug_2d)
+  , m_gpu_driven(gpu_driven)
+  , m_depth_prepass(depth_prepass)
   , m_vertex_shader(vertex_shader)
   , m_fragment_shader(fragment_shader)
 {
-  create_pipelines();
+  // The OIT pipeline blends its two targets differently
+  if (m_renderer.device().supports_independent_blend())
+  {
+    m_oit_render_pass = make_oit_renderpass(m_renderer.device().device(), OIT_ACCUM_FORMAT,
+      OIT_REVEALAGE_FORMAT, m_renderer.depth_format(), true, m_renderer.msaa_samples());
+  }
+  // The first pipelines are needed before the first frame
+  m_target = make_request(vertex_shader, fragment_shader, 0);
+  install_pipelines(build_pipelines(m_target));
   spdlog::info("Created raster opaque stage (self-contained)");
 }
 
 RasterOpaqueStage::~RasterOpaqueStage()
 {
-  destroy_pipelines();
+  auto dev = m_renderer.device().device();
+
+  // Background builds use the stage: finish them first
+  if (m_prewarm.valid())
+    m_prewarm.wait();
+  if (m_pending.valid())
+    destroy_pipeline_set(dev, m_pending.get());
+  destroy_pipeline_set(dev, installed_pipelines());
+  if (m_oit_render_pass)
+    dev.destroyRenderPass(m_oit_render_pass);
+}
+
+RasterOpaqueStage::PipelineRequest RasterOpaqueStage::make_request(
+  const std::string& vertex_shader, const std::string& fragment_shader, int mode) const
+{
+  PipelineRequest request{};
+  request.vertex_shader = vertex_shader;
+  request.fragment_shader = fragment_shader;
+  request.mode = mode;
+  // Only the PBR shader has a bindless variant
+  request.bindless = m_graph.bindless_enabled()
+    && fragment_shader == debug::fragment_shaders[debug::SHADER_PBR];
+  request.material_layout = request.bindless ? m_graph.bindless_descriptor_layout()
+                                             : m_graph.material_descriptor_layout();
+  request.scene_data_layout = m_graph.scene_data_descriptor_layout();
+  request.extent = m_renderer.swapchain().extent();
+  request.depth_format = m_renderer.depth_format();
+  request.msaa_samples = m_renderer.msaa_samples();
+  request.material_features = m_material_features;
+  request.global_features = m_global_features;
+  return request;
 }
 
-void RasterOpaqueStage::create_pipelines()
+RasterOpaqueStage::PipelineSet RasterOpaqueStage::build_pipelines(
+  const PipelineRequest& request) const
 {
+  PipelineSet set{};
+  set.request = request;
+
   sps::vulkan::GraphicsPipelineInBundle specification{};
   specification.device = m_renderer.device().device();
-  specification.vertexFilepath = m_vertex_shader;
-  specification.fragmentFilepath = m_fragment_shader;
-  specification.swapchainExtent = m_renderer.swapchain().extent();
+  specification.pipelineCache = m_renderer.device().pipeline_cache();
+  specification.vertexFilepath = request.vertex_shader;
+  specification.fragmentFilepath =
+    request.bindless ? debug::bindless_fragment_shader : request.fragment_shader;
+  specification.swapchainExtent = request.extent;
   specification.swapchainImageFormat = RenderGraph::hdr_format();
-  specification.descriptorSetLayout = m_graph.material_descriptor_layout();
+  specification.descriptorSetLayout = request.material_layout;
+  specification.additionalDescriptorSetLayouts = { request.scene_data_layout };
 
   auto binding = Vertex::binding_description();
   auto attributes = Vertex::attribute_descriptions();
@@ -54,14 +171,20 @@ void RasterOpaqueStage::create_pipelines()
   specification.backfaceCulling = true;
   specification.dynamicCullMode = true;
   specification.depthTestEnabled = true;
-  specification.depthFormat = m_renderer.depth_format();
-  specification.msaaSamples = m_renderer.msaa_samples();
+  specification.depthFormat = request.depth_format;
+  specification.msaaSamples = request.msaa_samples;
   specification.existingRenderPass = m_scene_render_pass;
 
-  vk::PushConstantRange pcRange{
-    vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, 128
-  };
-  specification.pushConstantRanges = { pcRange };
+  // Feature variants of the PBR shader; their statistics are compared with
+  // the uber pipeline's when the driver reports them
+  const bool pbr = request.fragment_shader == debug::fragment_shaders[debug::SHADER_PBR];
+  if (pbr)
+  {
+    set.variant_features =
+      variant_feature_sets(request.material_features, request.global_features);
+    if (!set.variant_features.empty() && m_renderer.device().supports_pipeline_statistics())
+      specification.flags = vk::PipelineCreateFlagBits::eCaptureStatisticsKHR;
+  }
 
   // Pipeline 1: opaque (no blend, depth write on, stencil write for SSS masking)
   specification.blendEnabled = false;
@@ -69,154 +192,593 @@ void RasterOpaqueStage::create_pipelines()
   specification.stencilWriteEnabled = true;
 
   auto output = sps::vulkan::create_graphics_pipeline(specification, true);
-  m_pipeline_layout = output.layout;
-  m_pipeline = output.pipeline;
+  set.layout = output.layout;
+  set.opaque = output.pipeline;
+  specification.existingPipelineLayout = set.layout;
+
+  // Pipeline 1 per feature variant
+  for (uint32_t features : set.variant_features)
+    set.variant_opaque.push_back(create_variant_pipeline(specification, features));
+  specification.flags = {};
 
   // Pipeline 2: blend (alpha blend on, depth write off, stencil disabled)
   specification.blendEnabled = true;
   specification.depthWriteEnabled = false;
   specification.stencilWriteEnabled = false;
-  specification.existingPipelineLayout = m_pipeline_layout;
 
-  auto blendOutput = sps::vulkan::create_graphics_pipeline(specification, true);
-  m_blend_pipeline = blendOutput.pipeline;
+  set.blend = sps::vulkan::create_graphics_pipeline(specification, true).pipeline;
+
+  // Pipeline 3: weighted blended OIT (depth write off, into the OIT render
+  // pass). Accumulation sums, revealage multiplies by 1 - alpha.
+  if (m_oit_render_pass && pbr)
+  {
+    auto oit = specification;
+    oit.fragmentFilepath =
+      request.bindless ? SHADER_DIR "fragment_oit_bindless.spv" : SHADER_DIR "fragment_oit.spv";
+    oit.existingRenderPass = m_oit_render_pass;
+
+    vk::PipelineColorBlendAttachmentState accum{};
+    accum.blendEnable = VK_TRUE;
+    accum.srcColorBlendFactor = vk::BlendFactor::eOne;
+    accum.dstColorBlendFactor = vk::BlendFactor::eOne;
+    accum.colorBlendOp = vk::BlendOp::eAdd;
+    accum.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+    accum.dstAlphaBlendFactor = vk::BlendFactor::eOne;
+    accum.alphaBlendOp = vk::BlendOp::eAdd;
+    accum.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
+      | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+
+    vk::PipelineColorBlendAttachmentState revealage{};
+    revealage.blendEnable = VK_TRUE;
+    revealage.srcColorBlendFactor = vk::BlendFactor::eZero;
+    revealage.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcColor;
+    revealage.colorBlendOp = vk::BlendOp::eAdd;
+    revealage.srcAlphaBlendFactor = vk::BlendFactor::eZero;
+    revealage.dstAlphaBlendFactor = vk::BlendFactor::eOne;
+    revealage.alphaBlendOp = vk::BlendOp::eAdd;
+    revealage.colorWriteMask = vk::ColorComponentFlagBits::eR;
+
+    oit.colorBlendAttachments = { accum, revealage };
+    set.oit = sps::vulkan::create_graphics_pipeline(oit, true).pipeline;
+  }
+
+  // The pre-pass shaders repeat vertex.vert's (invariant) position transform
+  if (request.vertex_shader != debug::vertex_shaders[debug::SHADER_PBR])
+    return set;
+
+  // Pipeline 4: opaque after the depth pre-pass (depth EQUAL, no depth write;
+  // stencil is still written for SSS masking)
+  specification.blendEnabled = false;
+  specification.depthWriteEnabled = false;
+  specification.depthCompareOp = vk::CompareOp::eEqual;
+  specification.stencilWriteEnabled = true;
+  set.equal = sps::vulkan::create_graphics_pipeline(specification, true).pipeline;
+  for (uint32_t features : set.variant_features)
+    set.variant_equal.push_back(create_variant_pipeline(specification, features));
+
+  // Pipeline 5: depth pre-pass, position only (no fragment shader)
+  specification.vertexFilepath = SHADER_DIR "depth_only.spv";
+  specification.fragmentFilepath.clear();
+  specification.vertexAttributes = { attributes[0] };
+  specification.depthWriteEnabled = true;
+  specification.depthCompareOp = vk::CompareOp::eLess;
+  specification.stencilWriteEnabled = false;
+  set.prepass = sps::vulkan::create_graphics_pipeline(specification, true).pipeline;
+
+  // Pipeline 6: depth pre-pass for MASK materials (discards, no color writes)
+  specification.vertexFilepath = SHADER_DIR "depth_textured.spv";
+  specification.fragmentFilepath =
+    request.bindless ? SHADER_DIR "depth_mask_bindless.spv" : SHADER_DIR "depth_mask.spv";
+  specification.vertexAttributes = { attributes[0], attributes[3] };
+  specification.colorWriteEnabled = false;
+  set.prepass_mask = sps::vulkan::create_graphics_pipeline(specification, true).pipeline;
+  return set;
 }
 
-void RasterOpaqueStage::destroy_pipelines()
-{
-  auto dev = m_renderer.device().device();
 
-  if (m_blend_pipeline)
+void RasterOpaqueStage::destroy_pipeline_set(vk::Device dev, const PipelineSet& set)
+{
+  for (const auto* variants : { &set.variant_opaque, &set.variant_equal })
+  {
+    for (auto pipeline : *variants)
+    {
+      if (pipeline)
+        dev.destroyPipeline(pipeline);
+    }
+  }
+  for (auto pipeline :
+    { set.prepass_mask, set.prepass, set.equal, set.oit, set.blend, set.opaque })
   {
-    dev.destroyPipeline(m_blend_pipeline);
-    m_blend_pipeline = VK_NULL_HANDLE;
+    if (pipeline)
+      dev.destroyPipeline(pipeline);
   }
-  if (m_pipeline)
+  if (set.layout)
+    dev.destroyPipelineLayout(set.layout);
+}
+
+void RasterOpaqueStage::install_pipelines(const PipelineSet& set)
+{
+  m_pipeline_layout = set.layout;
+  m_pipeline = set.opaque;
+  m_blend_pipeline = set.blend;
+  m_oit_pipeline = set.oit;
+  m_equal_pipeline = set.equal;
+  m_prepass_pipeline = set.prepass;
+  m_prepass_mask_pipeline = set.prepass_mask;
+  m_vertex_shader = set.request.vertex_shader;
+  m_fragment_shader = set.request.fragment_shader;
+  m_bindless = set.request.bindless;
+  if (set.request.mode >= 0)
+    m_current_mode = set.request.mode;
+
+  // Each material draws with the variant of its features (the uber pipeline
+  // when a variant failed to compile)
+  m_variant_features = set.variant_features;
+  m_variant_pipelines = set.variant_opaque;
+  m_variant_equal_pipelines = set.variant_equal;
+  m_variant_global_features = set.request.global_features;
+  auto find_variant = [&](uint32_t features)
+  {
+    const auto it =
+      std::lower_bound(m_variant_features.begin(), m_variant_features.end(), features);
+    if (it == m_variant_features.end() || *it != features)
+      return NO_VARIANT;
+    const auto variant = static_cast<uint32_t>(it - m_variant_features.begin());
+    return m_variant_pipelines[variant] ? variant : NO_VARIANT;
+  };
+  m_material_variant.clear();
+  uint32_t scene_features = 0;
+  for (uint32_t features : set.request.material_features)
   {
-    dev.destroyPipeline(m_pipeline);
-    m_pipeline = VK_NULL_HANDLE;
+    m_material_variant.push_back(find_variant(features & m_variant_global_features));
+    scene_features |= features & m_variant_global_features;
   }
-  if (m_pipeline_layout)
+  m_union_variant = m_material_variant.empty() ? NO_VARIANT : find_variant(scene_features);
+}
+
+RasterOpaqueStage::PipelineSet RasterOpaqueStage::installed_pipelines() const
+{
+  PipelineSet set{};
+  set.layout = m_pipeline_layout;
+  set.opaque = m_pipeline;
+  set.blend = m_blend_pipeline;
+  set.oit = m_oit_pipeline;
+  set.equal = m_equal_pipeline;
+  set.prepass = m_prepass_pipeline;
+  set.prepass_mask = m_prepass_mask_pipeline;
+  set.variant_opaque = m_variant_pipelines;
+  set.variant_equal = m_variant_equal_pipelines;
+  return set;
+}
+
+void RasterOpaqueStage::start_build(PipelineRequest request)
+{
+  m_target = request;
+
+  // One build at a time: a newer request waits for the running one and
+  // replaces any request queued before it
+  if (m_pending.valid())
   {
-    dev.destroyPipelineLayout(m_pipeline_layout);
-    m_pipeline_layout = VK_NULL_HANDLE;
+    m_queued = std::move(request);
+    return;
   }
+
+  m_pending_start = std::chrono::steady_clock::now();
+  m_pending = std::async(std::launch::async,
+    [this, request = std::move(request)]() { return build_pipelines(request); });
 }
 
 void RasterOpaqueStage::reload_shaders(
   const std::string& vertex_shader, const std::string& fragment_shader)
 {
-  destroy_pipelines();
-  m_vertex_shader = vertex_shader;
-  m_fragment_shader = fragment_shader;
-  create_pipelines();
-  spdlog::info("Reloaded raster shaders: {} + {}", vertex_shader, fragment_shader);
+  start_build(make_request(vertex_shader, fragment_shader, -1));
 }
 
 void RasterOpaqueStage::apply_shader_mode(int mode)
 {
   if (mode >= 0 && mode < debug::SHADER_3D_COUNT)
+    start_build(make_request(debug::vertex_shaders[mode], debug::fragment_shaders[mode], mode));
+}
+
+void RasterOpaqueStage::poll_pipelines()
+{
+  if (!m_pending.valid()
+    || m_pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    return;
+  }
+
+  auto dev = m_renderer.device().device();
+  PipelineSet set = m_pending.get();
+  const double ms =
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_pending_start)
+      .count();
+
+  // Superseded while compiling: never used, so no frame references it
+  if (m_queued)
+  {
+    destroy_pipeline_set(dev, set);
+    auto next = std::move(*m_queued);
+    m_queued.reset();
+    start_build(std::move(next));
+    return;
+  }
+
+  if (!set.opaque)
+  {
+    destroy_pipeline_set(dev, set);
+    spdlog::error("Failed to compile raster shaders {} + {}, keeping the current ones",
+      set.request.vertex_shader, set.request.fragment_shader);
+    return;
+  }
+
+  // Frames already submitted may still use the old pipelines
+  const bool same_shaders = set.request.vertex_shader == m_vertex_shader
+    && set.request.fragment_shader == m_fragment_shader;
+  m_renderer.device().defer_release(
+    [dev, old = installed_pipelines()]() { destroy_pipeline_set(dev, old); });
+  install_pipelines(set);
+  if (same_shaders)
+  {
+    spdlog::info("Built {} shader variants for {} materials (compiled in {:.1f} ms on a worker "
+                 "thread)",
+      m_variant_features.size(), m_material_variant.size(), ms);
+  }
+  else
+  {
+    spdlog::info("Reloaded raster shaders: {} + {} (compiled in {:.1f} ms on a worker thread)",
+      m_vertex_shader, m_fragment_shader, ms);
+  }
+  report_variant_statistics();
+}
+
+void RasterOpaqueStage::set_material_features(std::vector<uint32_t> features)
+{
+  // The installed variants belong to the previous materials
+  m_material_features = std::move(features);
+  m_material_variant.clear();
+  m_union_variant = NO_VARIANT;
+  rebuild_variants();
+}
+
+void RasterOpaqueStage::set_global_features(uint32_t features)
+{
+  if (features == m_global_features)
+    return;
+  m_global_features = features;
+  rebuild_variants();
+}
+
+void RasterOpaqueStage::rebuild_variants()
+{
+  // The shaders of the latest request: a pending shader switch is kept
+  start_build(make_request(m_target.vertex_shader, m_target.fragment_shader, m_target.mode));
+}
+
+void RasterOpaqueStage::report_variant_statistics() const
+{
+  if (!m_renderer.device().supports_pipeline_statistics() || m_variant_pipelines.empty())
+    return;
+
+  auto dev = m_renderer.device().device();
+  const auto uber = fragment_statistics(dev, m_pipeline);
+  for (uint32_t v = 0; v < static_cast<uint32_t>(m_variant_pipelines.size()); ++v)
+  {
+    if (!m_variant_pipelines[v])
+      continue;
+
+    // Statistic names are driver specific (e.g. register count, instruction count)
+    std::string comparison;
+    for (const auto& statistic : fragment_statistics(dev, m_variant_pipelines[v]))
+    {
+      const std::string name = statistic.name.data();
+      const auto it = std::find_if(uber.begin(), uber.end(),
+        [&](const auto& u) { return name == u.name.data(); });
+      if (it == uber.end())
+        continue;
+
+      const double before = statistic_value(*it);
+      const double after = statistic_value(statistic);
+      if (!comparison.empty())
+        comparison += ", ";
+      comparison += fmt::format("{} {} -> {}", name, before, after);
+      if (before > 0.0)
+        comparison += fmt::format(" ({:+.0f}%)", (after - before) / before * 100.0);
+    }
+
+    const auto materials = std::count(m_material_variant.begin(), m_material_variant.end(), v);
+    spdlog::info("Shader variant {:#04x} ({} materials{}) vs the uber shader: {}",
+      m_variant_features[v], materials, v == m_union_variant ? ", GPU-driven draws" : "",
+      comparison.empty() ? "no comparable statistics" : comparison);
+  }
+}
+
+uint32_t RasterOpaqueStage::material_variant(uint32_t material_index) const
+{
+  return material_index < m_material_variant.size() ? m_material_variant[material_index]
+                                                    : NO_VARIANT;
+}
+
+vk::Pipeline RasterOpaqueStage::shading_pipeline(uint32_t variant) const
+{
+  const bool equal = depth_prepass_active();
+  const auto& variants = equal ? m_variant_equal_pipelines : m_variant_pipelines;
+  // Variants built before a global toggle was switched back on lack its code
+  if (variant < variants.size() && variants[variant]
+    && (m_global_features & ~m_variant_global_features) == 0)
+  {
+    return variants[variant];
+  }
+  return equal ? m_equal_pipeline : m_pipeline;
+}
+
+void RasterOpaqueStage::prewarm_shader_modes()
+{
+  if (m_prewarm.valid())
+    return;
+
+  // Requests are captured here; the worker only creates and destroys pipelines
+  std::vector<PipelineRequest> requests;
+  for (int mode = 0; mode < debug::SHADER_3D_COUNT; ++mode)
   {
-    m_current_mode = mode;
-    reload_shaders(debug::vertex_shaders[mode], debug::fragment_shaders[mode]);
+    if (mode != m_current_mode)
+    {
+      requests.push_back(
+        make_request(debug::vertex_shaders[mode], debug::fragment_shaders[mode], mode));
+    }
   }
+
+  m_prewarm = std::async(std::launch::async,
+    [this, requests = std::move(requests)]()
+    {
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto& request : requests)
+        destroy_pipeline_set(m_renderer.device().device(), build_pipelines(request));
+      spdlog::info("Prewarmed {} shader modes in {:.1f} ms", requests.size(),
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count());
+    });
 }
 
 void RasterOpaqueStage::record(const FrameContext& ctx)
 {
-  // Push constant struct matching shader layout (128 bytes)
-  struct PushConstants
-  {
-    glm::mat4 model;
-    glm::vec4 baseColorFactor;
-    float metallicFactor;
-    float roughnessFactor;
-    float alphaCutoff;
-    uint32_t alphaMode;
-    float iridescenceFactor;
-    float iridescenceIor;
-    float iridescenceThicknessMin;
-    float iridescenceThicknessMax;
-    float transmissionFactor;
-    float thicknessFactor;
-    uint32_t attenuationColorPacked;
-    float attenuationDistance;
-  } pc{};
+  record_chunk(ctx, 0, 1);
+}
+
+uint32_t RasterOpaqueStage::record_chunk_count(const FrameContext& ctx) const
+{
+  if (!ctx.mesh || !ctx.scene || m_graph.material_set_count() == 0 || gpu_driven())
+    return 1;
 
+  const auto count = static_cast<uint32_t>(
+    ctx.opaque_draws ? ctx.opaque_draws->draws().size() : ctx.scene->primitives.size());
+  return std::clamp(count / MIN_PRIMITIVES_PER_CHUNK, 1u, std::max(ctx.recording_threads, 1u));
+}
+
+void RasterOpaqueStage::record_chunk(const FrameContext& ctx, uint32_t chunk, uint32_t chunk_count)
+{
   if (!ctx.mesh)
     return;
 
-  ctx.mesh->bind(ctx.command_buffer);
+  auto cmd = ctx.command_buffer;
+  ctx.mesh->bind(cmd);
+  vk::Pipeline pipeline =
+    shading_pipeline(ctx.scene && gpu_driven() ? m_union_variant : NO_VARIANT);
+  cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
 
-  if (ctx.scene && !ctx.scene->primitives.empty() && m_graph.material_set_count() > 0)
+  // Materials and instances are static scene data: one bind for all draws
+  cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 1,
+    m_graph.scene_data_descriptor_set(), {});
+  if (m_bindless)
   {
-    // Multi-material scene: draw OPAQUE + MASK primitives
-    ctx.command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+      m_graph.bindless_descriptor_set(ctx.frame_index), {});
+  }
 
-    for (const auto& prim : ctx.scene->primitives)
+  if (ctx.scene && gpu_driven())
+  {
+    // GPU-driven: DrawCullStage wrote each bucket's commands and count
+    const uint32_t capacity = m_graph.gpu_draw_count();
+    constexpr auto stride = static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+    for (uint32_t bucket = 0; bucket < DRAW_BUCKET_COUNT; ++bucket)
     {
+      cmd.setCullModeEXT((bucket & DRAW_BUCKET_DOUBLE_SIDED) ? vk::CullModeFlagBits::eNone
+                                                             : vk::CullModeFlagBits::eBack);
+      cmd.setStencilReference(
+        vk::StencilFaceFlagBits::eFrontAndBack, (bucket & DRAW_BUCKET_SSS) ? 1u : 0u);
+      cmd.drawIndexedIndirectCountKHR(m_graph.indirect_draw_buffer(),
+        vk::DeviceSize{ bucket } * capacity * stride, m_graph.draw_count_buffer(),
+        vk::DeviceSize{ bucket } * sizeof(uint32_t), capacity, stride);
+    }
+  }
+  else if (ctx.scene && !ctx.scene->primitives.empty() && m_graph.material_set_count() > 0)
+  {
+    // Multi-material scene: draw this chunk's OPAQUE + MASK primitives, in
+    // state-sorted order when the frame has a draw list (already culled)
+    const auto& primitives = ctx.scene->primitives;
+    const auto* sorted = ctx.opaque_draws ? &ctx.opaque_draws->draws() : nullptr;
+    const auto count = static_cast<uint64_t>(sorted ? sorted->size() : primitives.size());
+    const auto first = static_cast<uint32_t>(count * chunk / chunk_count);
+    const auto last = static_cast<uint32_t>(count * (chunk + 1) / chunk_count);
+
+    // State of the previous draw: unchanged state is not set again
+    vk::CullModeFlags cull_mode = vk::CullModeFlagBits::eFrontAndBack; // never used: first draw sets it
+    uint32_t stencil_reference = ~0u;
+    uint32_t material_index = ~0u;
+    for (uint32_t d = first; d < last; ++d)
+    {
+      const uint32_t i = sorted ? (*sorted)[d] : d;
+      const auto& prim = primitives[i];
       const auto& mat = ctx.scene->materials[prim.materialIndex];
 
-      if (mat.alphaMode == AlphaMode::Blend)
-        continue; // Skip blend primitives — handled by RasterBlendStage
+      if (!sorted)
+      {
+        if (mat.alphaMode == AlphaMode::Blend)
+          continue; // Skip blend primitives — handled by RasterBlendStage
+        if (ctx.culler && !ctx.culler->visible(i))
+          continue;
+      }
+
+      // The feature variant of the material (its dynamic state carries over)
+      const vk::Pipeline draw_pipeline = shading_pipeline(material_variant(prim.materialIndex));
+      if (draw_pipeline != pipeline)
+      {
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, draw_pipeline);
+        pipeline = draw_pipeline;
+      }
 
       // Per-material back-face culling: cull back faces unless material is double-sided
-      ctx.command_buffer.setCullModeEXT(
-        mat.doubleSided ? vk::CullModeFlagBits::eNone : vk::CullModeFlagBits::eBack);
+      const vk::CullModeFlags draw_cull_mode =
+        mat.doubleSided ? vk::CullModeFlagBits::eNone : vk::CullModeFlagBits::eBack;
+      if (draw_cull_mode != cull_mode)
+      {
+        cmd.setCullModeEXT(draw_cull_mode);
+        cull_mode = draw_cull_mode;
+      }
 
       // Write stencil=1 for SSS materials, stencil=0 for others
-      ctx.command_buffer.setStencilReference(
-        vk::StencilFaceFlagBits::eFrontAndBack,
-        mat.transmissionFactor > 0.0f ? 1u : 0u);
-
-      pc.model = prim.modelMatrix;
-      pc.baseColorFactor = mat.baseColorFactor;
-      pc.metallicFactor = mat.metallicFactor;
-      pc.roughnessFactor = mat.roughnessFactor;
-      pc.alphaCutoff = mat.alphaCutoff;
-      pc.alphaMode = static_cast<uint32_t>(mat.alphaMode) | (mat.doubleSided ? 4u : 0u)
-                   | (mat.deriveTransmissionFromThickness ? 8u : 0u);
-      pc.iridescenceFactor = mat.iridescenceFactor;
-      pc.iridescenceIor = mat.iridescenceIor;
-      pc.iridescenceThicknessMin = mat.iridescenceThicknessMin;
-      pc.iridescenceThicknessMax = mat.iridescenceThicknessMax;
-      pc.transmissionFactor = mat.transmissionFactor;
-      pc.thicknessFactor = mat.thicknessFactor;
-      pc.attenuationColorPacked =
-        (uint32_t(glm::clamp(mat.attenuationColor.r, 0.0f, 1.0f) * 255.0f) << 0) |
-        (uint32_t(glm::clamp(mat.attenuationColor.g, 0.0f, 1.0f) * 255.0f) << 8) |
-        (uint32_t(glm::clamp(mat.attenuationColor.b, 0.0f, 1.0f) * 255.0f) << 16);
-      pc.attenuationDistance = mat.attenuationDistance;
-
-      ctx.command_buffer.pushConstants(m_pipeline_layout,
-        vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0,
-        static_cast<uint32_t>(sizeof(pc)), &pc);
-      ctx.command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout,
-        0, m_graph.material_descriptor_set(ctx.frame_index, prim.materialIndex), {});
-      ctx.command_buffer.drawIndexed(prim.indexCount, 1, prim.firstIndex, prim.vertexOffset, 0);
+      const uint32_t draw_stencil_reference = mat.transmissionFactor > 0.0f ? 1u : 0u;
+      if (draw_stencil_reference != stencil_reference)
+      {
+        cmd.setStencilReference(vk::StencilFaceFlagBits::eFrontAndBack, draw_stencil_reference);
+        stencil_reference = draw_stencil_reference;
+      }
+
+      if (!m_bindless && prim.materialIndex != material_index)
+      {
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+          m_graph.material_descriptor_set(ctx.frame_index, prim.materialIndex), {});
+        material_index = prim.materialIndex;
+      }
+
+      // firstInstance selects the primitive's transform and material
+      cmd.drawIndexed(prim.indexCount, 1, prim.firstIndex, prim.vertexOffset, i);
     }
   }
-  else
+  else if (chunk == 0)
   {
     // Legacy single-draw path: opaque defaults
-    ctx.command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_pipeline);
-    ctx.command_buffer.setCullModeEXT(vk::CullModeFlagBits::eBack);
-    ctx.command_buffer.setStencilReference(vk::StencilFaceFlagBits::eFrontAndBack, 0u);
-
-    pc.model = glm::mat4(1.0f);
-    pc.baseColorFactor = glm::vec4(1.0f);
-    pc.metallicFactor = 1.0f;
-    pc.roughnessFactor = 1.0f;
-    pc.alphaCutoff = 0.5f;
-    pc.alphaMode = 0; // OPAQUE
-
-    ctx.command_buffer.pushConstants(m_pipeline_layout,
-      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0,
-      static_cast<uint32_t>(sizeof(pc)), &pc);
-    ctx.command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+    cmd.setCullModeEXT(vk::CullModeFlagBits::eBack);
+    cmd.setStencilReference(vk::StencilFaceFlagBits::eFrontAndBack, 0u);
+
+    if (!m_bindless)
+    {
+      cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+        m_graph.default_descriptor_set(ctx.frame_index), {});
+    }
+    ctx.mesh->draw(cmd, m_graph.default_instance());
+  }
+}
+
+void RasterOpaqueStage::record_depth_prepass(
+  const FrameContext& ctx, uint32_t chunk, uint32_t chunk_count) const
+{
+  if (!ctx.mesh)
+    return;
+
+  auto cmd = ctx.command_buffer;
+  ctx.mesh->bind(cmd);
+  cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_prepass_pipeline);
+
+  cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 1,
+    m_graph.scene_data_descriptor_set(), {});
+  if (m_bindless)
+  {
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+      m_graph.bindless_descriptor_set(ctx.frame_index), {});
+  }
+  else
+  {
+    // Position-only draws need set 0 for the camera only: any set will do
+    cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
       m_graph.default_descriptor_set(ctx.frame_index), {});
-    ctx.mesh->draw(ctx.command_buffer);
   }
+
+  if (ctx.scene && gpu_driven())
+  {
+    // Same buckets as the opaque pass; MASK buckets come last
+    const uint32_t capacity = m_graph.gpu_draw_count();
+    constexpr auto stride = static_cast<uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+    for (uint32_t bucket = 0; bucket < DRAW_BUCKET_COUNT; ++bucket)
+    {
+      if (bucket == DRAW_BUCKET_ALPHA_MASK)
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, m_prepass_mask_pipeline);
+      cmd.setCullModeEXT((bucket & DRAW_BUCKET_DOUBLE_SIDED) ? vk::CullModeFlagBits::eNone
+                                                             : vk::CullModeFlagBits::eBack);
+      cmd.drawIndexedIndirectCountKHR(m_graph.indirect_draw_buffer(),
+        vk::DeviceSize{ bucket } * capacity * stride, m_graph.draw_count_buffer(),
+        vk::DeviceSize{ bucket } * sizeof(uint32_t), capacity, stride);
+    }
+  }
+  else if (ctx.scene && !ctx.scene->primitives.empty() && m_graph.material_set_count() > 0)
+  {
+    // This chunk's OPAQUE + MASK primitives, as in record_chunk() (sorted
+    // order: front to back, alpha-tested primitives last)
+    const auto& primitives = ctx.scene->primitives;
+    const auto* sorted = ctx.opaque_draws ? &ctx.opaque_draws->draws() : nullptr;
+    const auto count = static_cast<uint64_t>(sorted ? sorted->size() : primitives.size());
+    const auto first = static_cast<uint32_t>(count * chunk / chunk_count);
+    const auto last = static_cast<uint32_t>(count * (chunk + 1) / chunk_count);
+
+    bool masked = false;
+    vk::CullModeFlags cull_mode = vk::CullModeFlagBits::eFrontAndBack; // never used: first draw sets it
+    uint32_t material_index = ~0u;
+    for (uint32_t d = first; d < last; ++d)
+    {
+      const uint32_t i = sorted ? (*sorted)[d] : d;
+      const auto& prim = primitives[i];
+      const auto& mat = ctx.scene->materials[prim.materialIndex];
+
+      if (!sorted)
+      {
+        if (mat.alphaMode == AlphaMode::Blend)
+          continue;
+        if (ctx.culler && !ctx.culler->visible(i))
+          continue;
+      }
+
+      const bool mask = mat.alphaMode == AlphaMode::Mask;
+      if (mask != masked)
+      {
+        cmd.bindPipeline(vk::PipelineBindPoint::eGraphics,
+          mask ? m_prepass_mask_pipeline : m_prepass_pipeline);
+        masked = mask;
+      }
+      const vk::CullModeFlags draw_cull_mode =
+        mat.doubleSided ? vk::CullModeFlagBits::eNone : vk::CullModeFlagBits::eBack;
+      if (draw_cull_mode != cull_mode)
+      {
+        cmd.setCullModeEXT(draw_cull_mode);
+        cull_mode = draw_cull_mode;
+      }
+
+      // The alpha test samples the material's base color texture
+      if (mask && !m_bindless && prim.materialIndex != material_index)
+      {
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_pipeline_layout, 0,
+          m_graph.material_descriptor_set(ctx.frame_index, prim.materialIndex), {});
+        material_index = prim.materialIndex;
+      }
+
+      cmd.drawIndexed(prim.indexCount, 1, prim.firstIndex, prim.vertexOffset, i);
+    }
+  }
+  else if (chunk == 0)
+  {
+    // Legacy single-draw path: opaque defaults
+    cmd.setCullModeEXT(vk::CullModeFlagBits::eBack);
+    ctx.mesh->draw(cmd, m_graph.default_instance());
+  }
+}
+
+bool RasterOpaqueStage::depth_prepass_active() const
+{
+  return *m_depth_prepass && m_prepass_pipeline;
+}
+
+bool RasterOpaqueStage::gpu_driven() const
+{
+  return *m_gpu_driven && m_bindless && m_graph.gpu_draw_count() > 0;
 }
 
 bool RasterOpaqueStage::is_enabled() const
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <sps/vulkan/gpu_material.h>
 #include <sps/vulkan/render_stage.h>
 
+#include <chrono>
+#include <future>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace sps::vulkan
 {
@@ -15,27 +20,99 @@ class VulkanRenderer;
 ///
 /// Self-contained stage: owns the shared raster pipeline layout, the opaque pipeline,
 /// and the blend pipeline. RasterBlendStage queries blend_pipeline() and pipeline_layout().
+///
+/// Draws take no push constants: transforms and material factors come from
+/// the graph's scene data set (set 1), selected by firstInstance.
+/// The PBR shader runs bindless when the graph provides a bindless layout
+/// (one set 0 bind per frame); debug shaders keep per-material set 0 binds.
+///
+/// Large scenes split their primitives into contiguous chunks that the graph
+/// records in parallel; each chunk rebinds the mesh, pipeline and sets.
+///
+/// CPU-recorded draws follow FrameContext::opaque_draws when the frame has
+/// one (state-sorted, see OpaqueDrawList), and state commands that would
+/// repeat the previous draw's state are skipped.
+///
+/// GPU-driven path: with bindless materials and indirect count support, the
+/// scene's draws are generated by DrawCullStage and recorded as one
+/// vkCmdDrawIndexedIndirectCount per draw bucket (cull mode x stencil
+/// reference), so recording cost no longer grows with the primitive count.
+///
+/// Depth pre-pass: when enabled, DepthPrepassStage lays down the scene depth
+/// first, through record_depth_prepass() (position-only pipeline, plus an
+/// alpha-tested one for MASK materials). The opaque pass then shades with
+/// depthCompareOp EQUAL and depth writes off, so every pixel runs the PBR
+/// shader once. Only the scene vertex shader (vertex.vert) is guaranteed to
+/// reproduce the pre-pass depths exactly; other vertex shaders skip it.
+///
+/// Order-independent transparency: the stage also owns the weighted blended
+/// OIT render pass and, with the PBR shader, the pipeline that draws BLEND
+/// primitives into it (see OitAccumulateStage). Both need the
+/// independentBlend device feature and are not created without it.
+///
+/// Shader switches compile off the render thread: reload_shaders() and
+/// apply_shader_mode() start a build on a worker thread while the current
+/// pipelines keep rendering, and poll_pipelines() (once per frame, before
+/// recording) swaps the finished set in. The replaced pipelines go to
+/// Device::defer_release(), so they outlive the frames that still use them.
+///
+/// Feature variants: the PBR shader's MATERIAL_FEATURES specialization
+/// constant compiles out the code of features a material does not use (no
+/// normal texture: no TBN path, no iridescence: no thin-film code) and of
+/// features switched off globally. The stage builds one opaque (and EQUAL)
+/// pipeline per distinct feature set of the scene's materials, in the
+/// background like a shader switch, and picks each draw's variant by
+/// material; GPU-driven draws use the variant of the scene's union. Until a
+/// variant set is installed, draws use the uber pipeline.
 class RasterOpaqueStage : public RenderStage
 {
 public:
   RasterOpaqueStage(const VulkanRenderer& renderer,
     vk::RenderPass scene_render_pass, const RenderGraph& graph,
     const std::string& vertex_shader, const std::string& fragment_shader,
-    const bool* use_rt, const bool* debug_2d);
+    const bool* use_rt, const bool* debug_2d, const bool* gpu_driven, const bool* depth_prepass);
   ~RasterOpaqueStage() override;
 
   RasterOpaqueStage(const RasterOpaqueStage&) = delete;
   RasterOpaqueStage& operator=(const RasterOpaqueStage&) = delete;
 
   void record(const FrameContext& ctx) override;
+  [[nodiscard]] uint32_t record_chunk_count(const FrameContext& ctx) const override;
+  void record_chunk(const FrameContext& ctx, uint32_t chunk, uint32_t chunk_count) override;
   [[nodiscard]] bool is_enabled() const override;
 
-  /// Hot-reload shaders: destroys and recreates both pipelines + layout.
+  /// Fewest primitives worth a chunk of their own (smaller splits cost more
+  /// in secondary command buffer overhead than they save).
+  static constexpr uint32_t MIN_PRIMITIVES_PER_CHUNK = 512;
+
+  /// Hot-reload shaders: builds a new layout and pipelines in the background.
+  /// A request made while another build runs replaces any queued before it.
   void reload_shaders(const std::string& vertex_shader, const std::string& fragment_shader);
 
-  /// Switch to a predefined shader mode (index into debug_constants.h tables).
+  /// Switch to a predefined shader mode (index into debug_constants.h tables),
+  /// in the background like reload_shaders().
   void apply_shader_mode(int mode);
 
+  /// Swap in pipelines whose background build has finished. Call at a frame
+  /// boundary, before any stage records.
+  void poll_pipelines();
+
+  /// Build (and discard) the pipelines of every other 3D shader mode on a
+  /// worker thread, so later switches hit the pipeline cache.
+  void prewarm_shader_modes();
+
+  /// Shading features of each scene material (MATERIAL_FEATURE_* bits, indexed
+  /// by material). Draws use the uber pipeline until the matching variants,
+  /// built in the background, are installed.
+  void set_material_features(std::vector<uint32_t> features);
+
+  /// Features the global toggles leave on (normal mapping, emissive, AO, IBL).
+  /// Call once per frame, before poll_pipelines(); a change rebuilds the variants.
+  void set_global_features(uint32_t features);
+
+  /// Whether a shader switch is still compiling.
+  [[nodiscard]] bool pipelines_pending() const { return m_pending.valid(); }
+
   [[nodiscard]] int current_shader_mode() const { return m_current_mode; }
   [[nodiscard]] const std::string& current_vertex_shader() const { return m_vertex_shader; }
   [[nodiscard]] const std::string& current_fragment_shader() const { return m_fragment_shader; }
@@ -44,23 +121,119 @@ public:
   [[nodiscard]] vk::Pipeline blend_pipeline() const { return m_blend_pipeline; }
   [[nodiscard]] vk::PipelineLayout pipeline_layout() const { return m_pipeline_layout; }
 
+  /// Formats of the OIT accumulation and revealage targets.
+  static constexpr vk::Format OIT_ACCUM_FORMAT = vk::Format::eR16G16B16A16Sfloat;
+  static constexpr vk::Format OIT_REVEALAGE_FORMAT = vk::Format::eR16Sfloat;
+
+  /// Shared resources for OitAccumulateStage. Both are null without
+  /// independentBlend; the pipeline also unless the current fragment shader
+  /// is the PBR shader.
+  [[nodiscard]] vk::RenderPass oit_render_pass() const { return m_oit_render_pass; }
+  [[nodiscard]] vk::Pipeline oit_pipeline() const { return m_oit_pipeline; }
+
+  /// Whether the current pipelines use the bindless material layout.
+  [[nodiscard]] bool uses_bindless() const { return m_bindless; }
+
+  /// Whether scene draws come from DrawCullStage's indirect buffers: requested,
+  /// bindless (no per-material binds), and the graph has draw data.
+  [[nodiscard]] bool gpu_driven() const;
+
+  /// Whether DepthPrepassStage lays down depth for this pass: requested, and
+  /// the current vertex shader supports it.
+  [[nodiscard]] bool depth_prepass_active() const;
+
+  /// Record one chunk of the depth pre-pass: the same draws as record_chunk(),
+  /// depth only. Chunks split the primitives like record_chunk_count().
+  void record_depth_prepass(const FrameContext& ctx, uint32_t chunk, uint32_t chunk_count) const;
+
 private:
   const VulkanRenderer& m_renderer;
   vk::RenderPass m_scene_render_pass;  // non-owning
   const RenderGraph& m_graph;
   const bool* m_use_rt;
   const bool* m_debug_2d;
+  const bool* m_gpu_driven;
+  const bool* m_depth_prepass;
 
+  vk::RenderPass m_oit_render_pass{ VK_NULL_HANDLE }; // independent of the shaders
   vk::PipelineLayout m_pipeline_layout{ VK_NULL_HANDLE };
   vk::Pipeline m_pipeline{ VK_NULL_HANDLE };
   vk::Pipeline m_blend_pipeline{ VK_NULL_HANDLE };
+  vk::Pipeline m_oit_pipeline{ VK_NULL_HANDLE };          // BLEND into the OIT targets
+  vk::Pipeline m_equal_pipeline{ VK_NULL_HANDLE };        // opaque after the depth pre-pass
+  vk::Pipeline m_prepass_pipeline{ VK_NULL_HANDLE };      // depth pre-pass, position only
+  vk::Pipeline m_prepass_mask_pipeline{ VK_NULL_HANDLE }; // depth pre-pass, alpha tested
 
   std::string m_vertex_shader;
   std::string m_fragment_shader;
   int m_current_mode{ 0 };
-
-  void create_pipelines();
-  void destroy_pipelines();
+  bool m_bindless{ false };
+
+  static constexpr uint32_t NO_VARIANT = ~0u; // draw with the uber pipeline
+
+  // Feature variants (render thread; recording threads only read the installed ones)
+  std::vector<uint32_t> m_material_features;             // requested, per material
+  uint32_t m_global_features{ MATERIAL_FEATURE_ALL };    // requested
+  std::vector<uint32_t> m_variant_features;              // installed, per variant
+  std::vector<vk::Pipeline> m_variant_pipelines;         // opaque, per variant
+  std::vector<vk::Pipeline> m_variant_equal_pipelines;   // EQUAL depth, per variant
+  uint32_t m_variant_global_features{ MATERIAL_FEATURE_ALL }; // built for
+  std::vector<uint32_t> m_material_variant;              // per material, or NO_VARIANT
+  uint32_t m_union_variant{ NO_VARIANT };                // GPU-driven draws
+
+  /// Everything a pipeline build reads from the renderer and graph, captured
+  /// on the render thread so the build itself can run on any thread.
+  struct PipelineRequest
+  {
+    std::string vertex_shader;
+    std::string fragment_shader;
+    int mode{ -1 }; // -1: not a predefined shader mode
+    bool bindless{ false };
+    vk::DescriptorSetLayout material_layout; // set 0
+    vk::DescriptorSetLayout scene_data_layout; // set 1
+    vk::Extent2D extent;
+    vk::Format depth_format{ vk::Format::eUndefined };
+    vk::SampleCountFlagBits msaa_samples{ vk::SampleCountFlagBits::e1 };
+    std::vector<uint32_t> material_features; // PBR feature variants
+    uint32_t global_features{ MATERIAL_FEATURE_ALL };
+  };
+
+  /// The layout and pipelines built from one request, replaced as a whole.
+  struct PipelineSet
+  {
+    PipelineRequest request;
+    vk::PipelineLayout layout;
+    vk::Pipeline opaque;
+    vk::Pipeline blend;
+    vk::Pipeline oit;
+    vk::Pipeline equal;
+    vk::Pipeline prepass;
+    vk::Pipeline prepass_mask;
+    std::vector<uint32_t> variant_features; // distinct feature sets, except the uber set
+    std::vector<vk::Pipeline> variant_opaque;
+    std::vector<vk::Pipeline> variant_equal; // empty without the pre-pass pipelines
+  };
+
+  // Background builds (render thread only; the workers run build_pipelines())
+  std::future<PipelineSet> m_pending;
+  std::optional<PipelineRequest> m_queued;
+  PipelineRequest m_target; // latest request passed to start_build()
+  std::chrono::steady_clock::time_point m_pending_start;
+  std::future<void> m_prewarm;
+
+  [[nodiscard]] PipelineRequest make_request(
+    const std::string& vertex_shader, const std::string& fragment_shader, int mode) const;
+  [[nodiscard]] PipelineSet build_pipelines(const PipelineRequest& request) const;
+  [[nodiscard]] PipelineSet installed_pipelines() const;
+  void install_pipelines(const PipelineSet& set);
+  void start_build(PipelineRequest request);
+  void rebuild_variants();
+  void report_variant_statistics() const;
+  static void destroy_pipeline_set(vk::Device dev, const PipelineSet& set);
+
+  /// Pipeline for a draw of the given variant (NO_VARIANT: the uber pipeline).
+  [[nodiscard]] vk::Pipeline shading_pipeline(uint32_t variant) const;
+  [[nodiscard]] uint32_t material_variant(uint32_t material_index) const;
 };
 
 } // namespace sps::vulkan
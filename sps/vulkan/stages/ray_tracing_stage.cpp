@@ -18,20 +18,28 @@ namespace sps::vulkan
 {
 
 RayTracingStage::RayTracingStage(const VulkanRenderer& renderer, RenderGraph& graph,
-  const bool* use_rt, vk::Buffer uniform_buffer)
+  const bool* use_rt, std::vector<vk::Buffer> uniform_buffers)
   : RenderStage("RayTracingStage")
   , m_renderer(renderer)
   , m_graph(graph)
   , m_use_rt(use_rt)
-  , m_uniform_buffer(uniform_buffer)
+  , m_uniform_buffers(std::move(uniform_buffers))
 {
-  m_graph.image_registry().declare_access("hdr", name(), phase(), AccessIntent::Write);
+  // Blit destination; the render graph transitions it before and after this stage
+  m_graph.image_registry().declare_access(
+    "hdr", name(), phase(), AccessIntent::Write, ImageUsage::TransferDst);
 
   update_from_registry();
 
   if (m_renderer.device().supports_ray_tracing())
   {
-    create_storage_image();
+    // Storage image only lives within the PrePass phase (trace, then blit)
+    m_graph.image_registry().declare_transient("rt_storage",
+      { vk::Format::eR8G8B8A8Unorm,
+        vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc });
+    // Traced into, then turned into the blit source by record()
+    m_graph.image_registry().declare_access("rt_storage", name(), phase(), AccessIntent::Write,
+      ImageUsage::StorageRayTracing, ImageUsage::TransferSrc);
   }
 }
 
@@ -45,8 +53,6 @@ RayTracingStage::~RayTracingStage()
   m_material_index_buffer.reset();
   m_fallback_texture.reset();
 
-  destroy_storage_image();
-
   if (m_descriptor_pool)
     dev.destroyDescriptorPool(m_descriptor_pool);
   if (m_descriptor_layout)
@@ -57,67 +63,11 @@ void RayTracingStage::update_from_registry()
 {
   if (auto* hdr = m_graph.image_registry().get("hdr"))
     m_hdr_image = hdr->image;
-}
-
-void RayTracingStage::create_storage_image()
-{
-  auto dev = m_renderer.device().device();
-  vk::Extent2D extent = m_renderer.swapchain().extent();
-
-  vk::ImageCreateInfo imageInfo{};
-  imageInfo.imageType = vk::ImageType::e2D;
-  imageInfo.format = vk::Format::eR8G8B8A8Unorm;
-  imageInfo.extent.width = extent.width;
-  imageInfo.extent.height = extent.height;
-  imageInfo.extent.depth = 1;
-  imageInfo.mipLevels = 1;
-  imageInfo.arrayLayers = 1;
-  imageInfo.samples = vk::SampleCountFlagBits::e1;
-  imageInfo.tiling = vk::ImageTiling::eOptimal;
-  imageInfo.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc;
-  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
-
-  m_rt_image = dev.createImage(imageInfo);
-
-  vk::MemoryRequirements memReqs = dev.getImageMemoryRequirements(m_rt_image);
-
-  vk::MemoryAllocateInfo allocInfo{};
-  allocInfo.allocationSize = memReqs.size;
-  allocInfo.memoryTypeIndex =
-    m_renderer.device().find_memory_type(memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-  m_rt_image_memory = dev.allocateMemory(allocInfo);
-  dev.bindImageMemory(m_rt_image, m_rt_image_memory, 0);
-
-  vk::ImageViewCreateInfo viewInfo{};
-  viewInfo.image = m_rt_image;
-  viewInfo.viewType = vk::ImageViewType::e2D;
-  viewInfo.format = vk::Format::eR8G8B8A8Unorm;
-  viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-  viewInfo.subresourceRange.baseMipLevel = 0;
-  viewInfo.subresourceRange.levelCount = 1;
-  viewInfo.subresourceRange.baseArrayLayer = 0;
-  viewInfo.subresourceRange.layerCount = 1;
-
-  m_rt_image_view = dev.createImageView(viewInfo);
-
-  spdlog::trace("Created RT storage image {}x{}", extent.width, extent.height);
-}
-
-void RayTracingStage::destroy_storage_image()
-{
-  auto dev = m_renderer.device().device();
-
-  if (m_rt_image_view)
-    dev.destroyImageView(m_rt_image_view);
-  if (m_rt_image)
-    dev.destroyImage(m_rt_image);
-  if (m_rt_image_memory)
-    dev.freeMemory(m_rt_image_memory);
-
-  m_rt_image_view = VK_NULL_HANDLE;
-  m_rt_image = VK_NULL_HANDLE;
-  m_rt_image_memory = VK_NULL_HANDLE;
+  if (auto* storage = m_graph.image_registry().get("rt_storage"))
+  {
+    m_rt_image = storage->image;
+    m_rt_image_view = storage->image_view;
+  }
 }
 
 void RayTracingStage::build_material_index_buffer(const Mesh& mesh, const GltfScene* scene)
@@ -162,17 +112,18 @@ void RayTracingStage::create_descriptor(const Mesh& mesh, const GltfScene* scene
   // Determine texture count (at least 1 for fallback)
   m_texture_count = scene ? std::max(static_cast<uint32_t>(scene->materials.size()), 1u) : 1;
 
-  // Create descriptor pool (+3 IBL: prefiltered env, irradiance, BRDF LUT)
+  // Create descriptor pool (+3 IBL: prefiltered env, irradiance, BRDF LUT), one set per frame
+  const uint32_t frame_count = static_cast<uint32_t>(m_uniform_buffers.size());
   std::vector<vk::DescriptorPoolSize> poolSizes = {
-    { vk::DescriptorType::eAccelerationStructureKHR, 1 },
-    { vk::DescriptorType::eStorageImage, 1 },
-    { vk::DescriptorType::eUniformBuffer, 1 },
-    { vk::DescriptorType::eStorageBuffer, 3 },  // vertex + index + material index
-    { vk::DescriptorType::eCombinedImageSampler, m_texture_count + 3 }  // +3 for IBL (prefiltered, irradiance, BRDF LUT)
+    { vk::DescriptorType::eAccelerationStructureKHR, frame_count },
+    { vk::DescriptorType::eStorageImage, frame_count },
+    { vk::DescriptorType::eUniformBuffer, frame_count },
+    { vk::DescriptorType::eStorageBuffer, 3 * frame_count },  // vertex + index + material index
+    { vk::DescriptorType::eCombinedImageSampler, (m_texture_count + 3) * frame_count }  // +3 for IBL (prefiltered, irradiance, BRDF LUT)
   };
 
   vk::DescriptorPoolCreateInfo poolInfo{};
-  poolInfo.maxSets = 1;
+  poolInfo.maxSets = frame_count;
   poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
   poolInfo.pPoolSizes = poolSizes.data();
 
@@ -215,14 +166,14 @@ void RayTracingStage::create_descriptor(const Mesh& mesh, const GltfScene* scene
 
   m_descriptor_layout = dev.createDescriptorSetLayout(layoutInfo);
 
-  // Allocate descriptor set
+  // Allocate descriptor sets
+  std::vector<vk::DescriptorSetLayout> layouts(frame_count, m_descriptor_layout);
   vk::DescriptorSetAllocateInfo allocInfo{};
   allocInfo.descriptorPool = m_descriptor_pool;
-  allocInfo.descriptorSetCount = 1;
-  allocInfo.pSetLayouts = &m_descriptor_layout;
+  allocInfo.descriptorSetCount = frame_count;
+  allocInfo.pSetLayouts = layouts.data();
 
-  auto sets = dev.allocateDescriptorSets(allocInfo);
-  m_descriptor_set = sets[0];
+  m_descriptor_sets = dev.allocateDescriptorSets(allocInfo);
 
   // Build texture image infos (one per material, fallback for missing)
   std::vector<vk::DescriptorImageInfo> textureInfos(m_texture_count);
@@ -273,10 +224,13 @@ void RayTracingStage::create_descriptor(const Mesh& mesh, const GltfScene* scene
   imageInfo.imageView = m_rt_image_view;
   imageInfo.imageLayout = vk::ImageLayout::eGeneral;
 
-  vk::DescriptorBufferInfo bufferInfo{};
-  bufferInfo.buffer = m_uniform_buffer;
-  bufferInfo.offset = 0;
-  bufferInfo.range = VK_WHOLE_SIZE;
+  std::vector<vk::DescriptorBufferInfo> bufferInfos(frame_count);
+  for (uint32_t f = 0; f < frame_count; f++)
+  {
+    bufferInfos[f].buffer = m_uniform_buffers[f];
+    bufferInfos[f].offset = 0;
+    bufferInfos[f].range = VK_WHOLE_SIZE;
+  }
 
   vk::DescriptorBufferInfo vertexBufferInfo{};
   vertexBufferInfo.buffer = mesh.vertex_buffer();
@@ -293,81 +247,84 @@ void RayTracingStage::create_descriptor(const Mesh& mesh, const GltfScene* scene
   materialIndexInfo.offset = 0;
   materialIndexInfo.range = VK_WHOLE_SIZE;
 
+  // Write template (dstSet and the UBO are filled in per frame below)
   std::vector<vk::WriteDescriptorSet> writes(10);
 
   // TLAS
-  writes[0].dstSet = m_descriptor_set;
   writes[0].dstBinding = 0;
   writes[0].descriptorCount = 1;
   writes[0].descriptorType = vk::DescriptorType::eAccelerationStructureKHR;
   writes[0].pNext = &asWrite;
 
   // Storage image
-  writes[1].dstSet = m_descriptor_set;
   writes[1].dstBinding = 1;
   writes[1].descriptorCount = 1;
   writes[1].descriptorType = vk::DescriptorType::eStorageImage;
   writes[1].pImageInfo = &imageInfo;
 
   // Uniform buffer
-  writes[2].dstSet = m_descriptor_set;
   writes[2].dstBinding = 2;
   writes[2].descriptorCount = 1;
   writes[2].descriptorType = vk::DescriptorType::eUniformBuffer;
-  writes[2].pBufferInfo = &bufferInfo;
+  writes[2].pBufferInfo = &bufferInfos[0];
 
   // Vertex buffer
-  writes[3].dstSet = m_descriptor_set;
   writes[3].dstBinding = 3;
   writes[3].descriptorCount = 1;
   writes[3].descriptorType = vk::DescriptorType::eStorageBuffer;
   writes[3].pBufferInfo = &vertexBufferInfo;
 
   // Index buffer
-  writes[4].dstSet = m_descriptor_set;
   writes[4].dstBinding = 4;
   writes[4].descriptorCount = 1;
   writes[4].descriptorType = vk::DescriptorType::eStorageBuffer;
   writes[4].pBufferInfo = &indexBufferInfo;
 
   // Material index buffer
-  writes[5].dstSet = m_descriptor_set;
   writes[5].dstBinding = 5;
   writes[5].descriptorCount = 1;
   writes[5].descriptorType = vk::DescriptorType::eStorageBuffer;
   writes[5].pBufferInfo = &materialIndexInfo;
 
   // Base color textures
-  writes[6].dstSet = m_descriptor_set;
   writes[6].dstBinding = 6;
   writes[6].descriptorCount = m_texture_count;
   writes[6].descriptorType = vk::DescriptorType::eCombinedImageSampler;
   writes[6].pImageInfo = textureInfos.data();
 
   // Prefiltered environment cubemap
-  writes[7].dstSet = m_descriptor_set;
   writes[7].dstBinding = 7;
   writes[7].descriptorCount = 1;
   writes[7].descriptorType = vk::DescriptorType::eCombinedImageSampler;
   writes[7].pImageInfo = &envInfo;
 
   // Irradiance cubemap
-  writes[8].dstSet = m_descriptor_set;
   writes[8].dstBinding = 8;
   writes[8].descriptorCount = 1;
   writes[8].descriptorType = vk::DescriptorType::eCombinedImageSampler;
   writes[8].pImageInfo = &irradianceInfo;
 
   // BRDF LUT
-  writes[9].dstSet = m_descriptor_set;
   writes[9].dstBinding = 9;
   writes[9].descriptorCount = 1;
   writes[9].descriptorType = vk::DescriptorType::eCombinedImageSampler;
   writes[9].pImageInfo = &brdfLutInfo;
 
-  dev.updateDescriptorSets(writes, {});
+  std::vector<vk::WriteDescriptorSet> frameWrites;
+  frameWrites.reserve(writes.size() * frame_count);
+  for (uint32_t f = 0; f < frame_count; f++)
+  {
+    for (auto write : writes)
+    {
+      write.dstSet = m_descriptor_sets[f];
+      if (write.dstBinding == 2)
+        write.pBufferInfo = &bufferInfos[f];
+      frameWrites.push_back(write);
+    }
+  }
+  dev.updateDescriptorSets(frameWrites, {});
 
-  spdlog::trace("Created RT descriptor set with {} textures + IBL", m_texture_count);
+  spdlog::trace("Created {} RT descriptor sets with {} textures + IBL", frame_count, m_texture_count);
 }
 
 void RayTracingStage::create_pipeline()
@@ -425,8 +382,8 @@ void RayTracingStage::build_acceleration_structures(const Mesh& mesh, const Gltf
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &cmd;
 
-  m_renderer.device().graphics_queue().submit(submitInfo, nullptr);
-  m_renderer.device().wait_idle();
+  // The command buffer is freed right below, so wait for this batch (not the device)
+  m_renderer.device().wait_graphics(m_renderer.device().submit_graphics(submitInfo));
 
   m_renderer.device().device().freeCommandBuffers(m_renderer.command_pool(), cmd);
 
@@ -450,7 +407,7 @@ void RayTracingStage::on_mesh_changed(const Mesh& mesh, const GltfScene* scene,
   {
     dev.destroyDescriptorPool(m_descriptor_pool);
     m_descriptor_pool = VK_NULL_HANDLE;
-    m_descriptor_set = VK_NULL_HANDLE;
+    m_descriptor_sets.clear();
   }
   if (m_descriptor_layout)
   {
@@ -467,7 +424,7 @@ void RayTracingStage::on_mesh_changed(const Mesh& mesh, const GltfScene* scene,
 
 void RayTracingStage::update_environment(const IBL& ibl)
 {
-  if (!m_descriptor_set)
+  if (m_descriptor_sets.empty())
     return;
 
   vk::DescriptorImageInfo envInfo{};
@@ -485,55 +442,63 @@ void RayTracingStage::update_environment(const IBL& ibl)
   brdfLutInfo.sampler = ibl.brdf_lut_sampler();
   brdfLutInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
-  std::array<vk::WriteDescriptorSet, 3> writes{};
-
-  writes[0].dstSet = m_descriptor_set;
-  writes[0].dstBinding = 7;
-  writes[0].descriptorCount = 1;
-  writes[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-  writes[0].pImageInfo = &envInfo;
-
-  writes[1].dstSet = m_descriptor_set;
-  writes[1].dstBinding = 8;
-  writes[1].descriptorCount = 1;
-  writes[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-  writes[1].pImageInfo = &irradianceInfo;
+  for (vk::DescriptorSet set : m_descriptor_sets)
+  {
+    std::array<vk::WriteDescriptorSet, 3> writes{};
+
+    writes[0].dstSet = set;
+    writes[0].dstBinding = 7;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[0].pImageInfo = &envInfo;
+
+    writes[1].dstSet = set;
+    writes[1].dstBinding = 8;
+    writes[1].descriptorCount = 1;
+    writes[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[1].pImageInfo = &irradianceInfo;
+
+    writes[2].dstSet = set;
+    writes[2].dstBinding = 9;
+    writes[2].descriptorCount = 1;
+    writes[2].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[2].pImageInfo = &brdfLutInfo;
+
+    m_renderer.device().device().updateDescriptorSets(writes, {});
+  }
+}
 
-  writes[2].dstSet = m_descriptor_set;
-  writes[2].dstBinding = 9;
-  writes[2].descriptorCount = 1;
-  writes[2].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-  writes[2].pImageInfo = &brdfLutInfo;
+void RayTracingStage::set_uniform_buffers(std::vector<vk::Buffer> uniform_buffers)
+{
+  m_uniform_buffers = std::move(uniform_buffers);
+}
 
-  m_renderer.device().device().updateDescriptorSets(writes, {});
+void RayTracingStage::on_transient_images_realized()
+{
+  // Runs at startup and on every resize (HDR is recreated first). Frames in
+  // flight may still use their sets: binding 1 is rewritten per slot in begin_frame()
+  update_from_registry();
+  m_stale_image_binding.assign(m_descriptor_sets.size(), true);
 }
 
-void RayTracingStage::on_swapchain_resize(const Device& /*device*/, vk::Extent2D /*extent*/)
+void RayTracingStage::begin_frame(uint32_t frame_index)
 {
-  if (!m_rt_image)
+  if (frame_index >= m_stale_image_binding.size() || !m_stale_image_binding[frame_index])
     return;
+  m_stale_image_binding[frame_index] = false;
 
-  update_from_registry();
+  vk::DescriptorImageInfo imageInfo{};
+  imageInfo.imageView = m_rt_image_view;
+  imageInfo.imageLayout = vk::ImageLayout::eGeneral;
 
-  destroy_storage_image();
-  create_storage_image();
+  vk::WriteDescriptorSet write{};
+  write.dstSet = m_descriptor_sets[frame_index];
+  write.dstBinding = 1;
+  write.descriptorCount = 1;
+  write.descriptorType = vk::DescriptorType::eStorageImage;
+  write.pImageInfo = &imageInfo;
 
-  // Update descriptor binding 1 (storage image)
-  if (m_descriptor_set)
-  {
-    vk::DescriptorImageInfo imageInfo{};
-    imageInfo.imageView = m_rt_image_view;
-    imageInfo.imageLayout = vk::ImageLayout::eGeneral;
-
-    vk::WriteDescriptorSet write{};
-    write.dstSet = m_descriptor_set;
-    write.dstBinding = 1;
-    write.descriptorCount = 1;
-    write.descriptorType = vk::DescriptorType::eStorageImage;
-    write.pImageInfo = &imageInfo;
-
-    m_renderer.device().device().updateDescriptorSets(write, {});
-  }
+  m_renderer.device().device().updateDescriptorSets(write, {});
 }
 
 bool RayTracingStage::is_enabled() const
@@ -545,28 +510,21 @@ void RayTracingStage::record(const FrameContext& ctx)
 {
   vk::Extent2D extent = ctx.extent;
 
-  // 1. Transition HDR image to TransferDstOptimal for receiving blit
-  vk::ImageMemoryBarrier hdrBarrier{};
-  hdrBarrier.oldLayout = vk::ImageLayout::eUndefined;
-  hdrBarrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
-  hdrBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  hdrBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  hdrBarrier.image = m_hdr_image;
-  hdrBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-  hdrBarrier.subresourceRange.baseMipLevel = 0;
-  hdrBarrier.subresourceRange.levelCount = 1;
-  hdrBarrier.subresourceRange.baseArrayLayer = 0;
-  hdrBarrier.subresourceRange.layerCount = 1;
-  hdrBarrier.srcAccessMask = {};
-  hdrBarrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
-
-  ctx.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, hdrBarrier);
-
-  // 2. Transition RT storage image to General for writing
+  // The render graph has transitioned HDR to TransferDstOptimal and the RT
+  // storage image to General (see the access declarations in the constructor)
+
+  // 1. Bind RT pipeline and trace rays
+  ctx.command_buffer.bindPipeline(vk::PipelineBindPoint::eRayTracingKHR, m_rt_pipeline->pipeline());
+  ctx.command_buffer.bindDescriptorSets(
+    vk::PipelineBindPoint::eRayTracingKHR, m_rt_pipeline->layout(), 0,
+    m_descriptor_sets[ctx.frame_index], {});
+
+  m_rt_pipeline->trace_rays(ctx.command_buffer, extent.width, extent.height);
+
+  // 2. Transition RT storage image to TransferSrcOptimal for blit
   vk::ImageMemoryBarrier rtBarrier{};
-  rtBarrier.oldLayout = vk::ImageLayout::eUndefined;
-  rtBarrier.newLayout = vk::ImageLayout::eGeneral;
+  rtBarrier.oldLayout = vk::ImageLayout::eGeneral;
+  rtBarrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
   rtBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
   rtBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
   rtBarrier.image = m_rt_image;
@@ -575,29 +533,13 @@ void RayTracingStage::record(const FrameContext& ctx)
   rtBarrier.subresourceRange.levelCount = 1;
   rtBarrier.subresourceRange.baseArrayLayer = 0;
   rtBarrier.subresourceRange.layerCount = 1;
-  rtBarrier.srcAccessMask = {};
-  rtBarrier.dstAccessMask = vk::AccessFlagBits::eShaderWrite;
-
-  ctx.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::PipelineStageFlagBits::eRayTracingShaderKHR, {}, {}, {}, rtBarrier);
-
-  // 3. Bind RT pipeline and trace rays
-  ctx.command_buffer.bindPipeline(vk::PipelineBindPoint::eRayTracingKHR, m_rt_pipeline->pipeline());
-  ctx.command_buffer.bindDescriptorSets(
-    vk::PipelineBindPoint::eRayTracingKHR, m_rt_pipeline->layout(), 0, m_descriptor_set, {});
-
-  m_rt_pipeline->trace_rays(ctx.command_buffer, extent.width, extent.height);
-
-  // 4. Transition RT storage image to TransferSrcOptimal for blit
-  rtBarrier.oldLayout = vk::ImageLayout::eGeneral;
-  rtBarrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
   rtBarrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
   rtBarrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
 
   ctx.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eRayTracingShaderKHR,
     vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, rtBarrier);
 
-  // 5. Blit RT image to HDR image
+  // 3. Blit RT image to HDR image
   vk::ImageBlit blitRegion{};
   blitRegion.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
   blitRegion.srcSubresource.layerCount = 1;
@@ -613,15 +555,6 @@ void RayTracingStage::record(const FrameContext& ctx)
   ctx.command_buffer.blitImage(m_rt_image, vk::ImageLayout::eTransferSrcOptimal,
     m_hdr_image, vk::ImageLayout::eTransferDstOptimal, blitRegion,
     vk::Filter::eNearest);
-
-  // 6. Transition HDR image to ShaderReadOnlyOptimal for composite pass sampling
-  hdrBarrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-  hdrBarrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-  hdrBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-  hdrBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-  ctx.command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-    vk::PipelineStageFlagBits::eFragmentShader, {}, {}, {}, hdrBarrier);
 }
 
 } // namespace sps::vulkan
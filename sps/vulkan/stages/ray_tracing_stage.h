@@ -19,20 +19,26 @@ class RenderGraph;
 class Texture;
 class VulkanRenderer;
 
-/// Self-contained ray tracing stage: owns storage image, descriptor set,
-/// pipeline, and acceleration structures.
+/// Self-contained ray tracing stage: owns descriptor set, pipeline, and
+/// acceleration structures.
 ///
-/// Traces rays into a private storage image (R8G8B8A8Unorm), then blits
+/// Traces rays into a transient storage image ("rt_storage", R8G8B8A8Unorm,
+/// owned and possibly aliased by the render graph), then blits
 /// the result to the shared HDR image from the registry. The composite
 /// stage handles tone mapping + gamma + present, same as the raster path.
 ///
 /// Acceleration structures are rebuilt on mesh change via on_mesh_changed().
-/// Storage image is resized on swapchain resize via on_swapchain_resize().
+/// The storage image binding is refreshed lazily after
+/// on_transient_images_realized(): each frame slot's set is rewritten in
+/// begin_frame(), once that slot's previous frame has completed.
+///
+/// One descriptor set per frame in flight: the sets differ only in the
+/// uniform buffer (binding 2), which the CPU rewrites every frame.
 class RayTracingStage : public RenderStage
 {
 public:
   RayTracingStage(const VulkanRenderer& renderer, RenderGraph& graph,
-    const bool* use_rt, vk::Buffer uniform_buffer);
+    const bool* use_rt, std::vector<vk::Buffer> uniform_buffers);
   ~RayTracingStage() override;
 
   RayTracingStage(const RayTracingStage&) = delete;
@@ -41,7 +47,8 @@ public:
   void record(const FrameContext& ctx) override;
   [[nodiscard]] bool is_enabled() const override;
   [[nodiscard]] Phase phase() const override { return Phase::PrePass; }
-  void on_swapchain_resize(const Device& device, vk::Extent2D extent) override;
+  void on_transient_images_realized() override;
+  void begin_frame(uint32_t frame_index) override;
 
   /// Rebuild BLAS/TLAS and update descriptor bindings for new mesh.
   /// @param mesh The mesh with vertex/index buffers.
@@ -53,11 +60,15 @@ public:
   /// Update environment cubemap binding (e.g. after HDR switch).
   void update_environment(const IBL& ibl);
 
+  /// Replace the per-frame uniform buffers (one per frame in flight).
+  /// Takes effect on the next on_mesh_changed(), which reallocates the sets.
+  void set_uniform_buffers(std::vector<vk::Buffer> uniform_buffers);
+
 private:
   const VulkanRenderer& m_renderer;
   RenderGraph& m_graph;
   const bool* m_use_rt;
-  vk::Buffer m_uniform_buffer;
+  std::vector<vk::Buffer> m_uniform_buffers; // [frame_index]
 
   // Acceleration structures
   std::unique_ptr<AccelerationStructure> m_blas;
@@ -66,15 +77,12 @@ private:
   // RT pipeline (pipeline + layout + SBT)
   std::unique_ptr<RayTracingPipeline> m_rt_pipeline;
 
-  // RT storage image (render target)
-  vk::Image m_rt_image{ VK_NULL_HANDLE };
-  vk::DeviceMemory m_rt_image_memory{ VK_NULL_HANDLE };
-  vk::ImageView m_rt_image_view{ VK_NULL_HANDLE };
 
-  // RT descriptor set
+  // RT descriptor sets
   vk::DescriptorPool m_descriptor_pool{ VK_NULL_HANDLE };
   vk::DescriptorSetLayout m_descriptor_layout{ VK_NULL_HANDLE };
-  vk::DescriptorSet m_descriptor_set{ VK_NULL_HANDLE };
+  std::vector<vk::DescriptorSet> m_descriptor_sets; // [frame_index]
+  std::vector<bool> m_stale_image_binding;          // [frame_index], binding 1
 
   // Material index buffer (triangleID -> materialIndex)
   std::unique_ptr<Buffer> m_material_index_buffer;
@@ -85,11 +93,10 @@ private:
   // Number of textures bound in descriptor (for pool sizing)
   uint32_t m_texture_count{ 0 };
 
-  // Cached HDR image handle from registry
+  // Cached from registry (refreshed when transient images are realized)
   vk::Image m_hdr_image;
-
-  void create_storage_image();
-  void destroy_storage_image();
+  vk::Image m_rt_image;          // transient storage image (render target)
+  vk::ImageView m_rt_image_view;
   void create_descriptor(const Mesh& mesh, const GltfScene* scene, const IBL* ibl);
   void create_pipeline();
   void build_acceleration_structures(const Mesh& mesh, const GltfScene* scene);
@@ -23,15 +23,23 @@ SSSBlurStage::SSSBlurStage(const VulkanRenderer& renderer, RenderGraph& graph,
   , m_blur_width_g(blur_width_g)
   , m_blur_width_b(blur_width_b)
 {
-  // Declare access intent for shared images (used by render graph for barrier insertion)
-  m_graph.image_registry().declare_access("hdr", name(), phase(), AccessIntent::ReadWrite);
-  m_graph.image_registry().declare_access("depth_stencil", name(), phase(), AccessIntent::Read);
-
-  update_from_registry();
+  // Declare access intent for shared images (the render graph inserts the barriers)
+  m_graph.image_registry().declare_access(
+    "hdr", name(), phase(), AccessIntent::ReadWrite, ImageUsage::StorageCompute);
+  m_graph.image_registry().declare_access(
+    "depth_stencil", name(), phase(), AccessIntent::Read, ImageUsage::DepthStencilSampled);
+
+  // Ping image only lives within the Intermediate phase
+  m_graph.image_registry().declare_transient("sss_ping",
+    { RenderGraph::hdr_format(),
+      vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled });
+  // Fully written by the horizontal pass: previous contents are never read
+  m_graph.image_registry().declare_access(
+    "sss_ping", name(), phase(), AccessIntent::Write, ImageUsage::StorageCompute);
+
+  // Descriptors are written once the graph realizes the ping image
   create_pipeline();
-  create_ping_image();
-  create_descriptors();
-  spdlog::info("Created SSS blur stage (self-contained) {}x{}", m_extent.width, m_extent.height);
+  spdlog::info("Created SSS blur stage (self-contained)");
 }
 
 SSSBlurStage::~SSSBlurStage()
@@ -39,7 +47,6 @@ SSSBlurStage::~SSSBlurStage()
   auto dev = m_renderer.device().device();
 
   destroy_descriptors();
-  destroy_ping_image();
 
   if (m_pipeline)
     dev.destroyPipeline(m_pipeline);
@@ -55,9 +62,11 @@ void SSSBlurStage::update_from_registry()
 {
   const auto* hdr = m_graph.image_registry().get("hdr");
   const auto* ds = m_graph.image_registry().get("depth_stencil");
+  const auto* ping = m_graph.image_registry().get("sss_ping");
 
   m_hdr_image = hdr ? hdr->image : vk::Image{};
   m_depth_stencil_image = ds ? ds->image : vk::Image{};
+  m_ping_image = ping ? ping->image : vk::Image{};
   m_extent = m_renderer.swapchain().extent();
 }
 
@@ -119,108 +128,12 @@ void SSSBlurStage::create_pipeline()
   pipelineInfo.stage = stageInfo;
   pipelineInfo.layout = m_pipeline_layout;
 
-  m_pipeline = dev.createComputePipeline(nullptr, pipelineInfo).value;
+  m_pipeline =
+    dev.createComputePipeline(m_renderer.device().pipeline_cache(), pipelineInfo).value;
 
   dev.destroyShaderModule(shaderModule);
 }
 
-void SSSBlurStage::create_ping_image()
-{
-  auto dev = m_renderer.device().device();
-
-  vk::ImageCreateInfo imageInfo{};
-  imageInfo.imageType = vk::ImageType::e2D;
-  imageInfo.extent.width = m_extent.width;
-  imageInfo.extent.height = m_extent.height;
-  imageInfo.extent.depth = 1;
-  imageInfo.mipLevels = 1;
-  imageInfo.arrayLayers = 1;
-  imageInfo.format = RenderGraph::hdr_format();
-  imageInfo.tiling = vk::ImageTiling::eOptimal;
-  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
-  imageInfo.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
-  imageInfo.samples = vk::SampleCountFlagBits::e1;
-  imageInfo.sharingMode = vk::SharingMode::eExclusive;
-
-  m_ping_image = dev.createImage(imageInfo);
-
-  vk::MemoryRequirements memReqs = dev.getImageMemoryRequirements(m_ping_image);
-  vk::MemoryAllocateInfo allocInfo{};
-  allocInfo.allocationSize = memReqs.size;
-  allocInfo.memoryTypeIndex = m_renderer.device().find_memory_type(
-    memReqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-
-  m_ping_image_memory = dev.allocateMemory(allocInfo);
-  dev.bindImageMemory(m_ping_image, m_ping_image_memory, 0);
-
-  vk::ImageViewCreateInfo viewInfo{};
-  viewInfo.image = m_ping_image;
-  viewInfo.viewType = vk::ImageViewType::e2D;
-  viewInfo.format = RenderGraph::hdr_format();
-  viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-  viewInfo.subresourceRange.baseMipLevel = 0;
-  viewInfo.subresourceRange.levelCount = 1;
-  viewInfo.subresourceRange.baseArrayLayer = 0;
-  viewInfo.subresourceRange.layerCount = 1;
-
-  m_ping_image_view = dev.createImageView(viewInfo);
-
-  // Transition ping image to General layout
-  vk::CommandBufferAllocateInfo allocCmdInfo{};
-  allocCmdInfo.commandPool = m_renderer.command_pool();
-  allocCmdInfo.level = vk::CommandBufferLevel::ePrimary;
-  allocCmdInfo.commandBufferCount = 1;
-  auto cmd = dev.allocateCommandBuffers(allocCmdInfo)[0];
-  cmd.begin(vk::CommandBufferBeginInfo{ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
-
-  vk::ImageMemoryBarrier barrier{};
-  barrier.oldLayout = vk::ImageLayout::eUndefined;
-  barrier.newLayout = vk::ImageLayout::eGeneral;
-  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-  barrier.image = m_ping_image;
-  barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-  barrier.subresourceRange.baseMipLevel = 0;
-  barrier.subresourceRange.levelCount = 1;
-  barrier.subresourceRange.baseArrayLayer = 0;
-  barrier.subresourceRange.layerCount = 1;
-  barrier.srcAccessMask = {};
-  barrier.dstAccessMask = vk::AccessFlagBits::eShaderWrite;
-  cmd.pipelineBarrier(
-    vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::PipelineStageFlagBits::eComputeShader,
-    {}, {}, {}, barrier);
-
-  cmd.end();
-  vk::SubmitInfo submitInfo{};
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &cmd;
-  m_renderer.device().graphics_queue().submit(submitInfo);
-  m_renderer.device().graphics_queue().waitIdle();
-  dev.freeCommandBuffers(m_renderer.command_pool(), cmd);
-}
-
-void SSSBlurStage::destroy_ping_image()
-{
-  auto dev = m_renderer.device().device();
-
-  if (m_ping_image_view)
-  {
-    dev.destroyImageView(m_ping_image_view);
-    m_ping_image_view = VK_NULL_HANDLE;
-  }
-  if (m_ping_image)
-  {
-    dev.destroyImage(m_ping_image);
-    m_ping_image = VK_NULL_HANDLE;
-  }
-  if (m_ping_image_memory)
-  {
-    dev.freeMemory(m_ping_image_memory);
-    m_ping_image_memory = VK_NULL_HANDLE;
-  }
-}
-
 void SSSBlurStage::create_descriptors()
 {
   auto dev = m_renderer.device().device();
@@ -251,13 +164,14 @@ void SSSBlurStage::create_descriptors()
   // Get image views from registry
   const auto* hdr = m_graph.image_registry().get("hdr");
   const auto* ds = m_graph.image_registry().get("depth_stencil");
+  const auto* ping = m_graph.image_registry().get("sss_ping");
 
   vk::DescriptorImageInfo hdrInfo{};
   hdrInfo.imageView = hdr ? hdr->image_view : vk::ImageView{};
   hdrInfo.imageLayout = vk::ImageLayout::eGeneral;
 
   vk::DescriptorImageInfo pingInfo{};
-  pingInfo.imageView = m_ping_image_view;
+  pingInfo.imageView = ping ? ping->image_view : vk::ImageView{};
   pingInfo.imageLayout = vk::ImageLayout::eGeneral;
 
   vk::DescriptorImageInfo stencilInfo{};
@@ -309,23 +223,20 @@ void SSSBlurStage::create_descriptors()
 
 void SSSBlurStage::destroy_descriptors()
 {
-  auto dev = m_renderer.device().device();
-
   if (m_descriptor_pool)
   {
-    dev.destroyDescriptorPool(m_descriptor_pool);
+    m_renderer.device().retire(m_descriptor_pool);
     m_descriptor_pool = VK_NULL_HANDLE;
     m_h_descriptor = VK_NULL_HANDLE;
     m_v_descriptor = VK_NULL_HANDLE;
   }
 }
 
-void SSSBlurStage::on_swapchain_resize(const Device& /*device*/, vk::Extent2D /*extent*/)
+void SSSBlurStage::on_transient_images_realized()
 {
+  // Runs at startup and on every resize (HDR and depth are recreated first)
   update_from_registry();
   destroy_descriptors();
-  destroy_ping_image();
-  create_ping_image();
   create_descriptors();
 }
 
@@ -335,50 +246,8 @@ void SSSBlurStage::record(const FrameContext& ctx)
   uint32_t w = m_extent.width;
   uint32_t h = m_extent.height;
 
-  // Transition HDR from ShaderReadOnlyOptimal to General for compute read/write
-  {
-    vk::ImageMemoryBarrier barrier{};
-    barrier.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    barrier.newLayout = vk::ImageLayout::eGeneral;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = m_hdr_image;
-    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
-
-    cmd.pipelineBarrier(
-      vk::PipelineStageFlagBits::eColorAttachmentOutput,
-      vk::PipelineStageFlagBits::eComputeShader,
-      {}, {}, {}, barrier);
-  }
-
-  // Transition depth-stencil to read-only for stencil sampling in compute
-  {
-    vk::ImageMemoryBarrier dsBarrier{};
-    dsBarrier.oldLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
-    dsBarrier.newLayout = vk::ImageLayout::eDepthStencilReadOnlyOptimal;
-    dsBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    dsBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    dsBarrier.image = m_depth_stencil_image;
-    dsBarrier.subresourceRange.aspectMask =
-      vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
-    dsBarrier.subresourceRange.baseMipLevel = 0;
-    dsBarrier.subresourceRange.levelCount = 1;
-    dsBarrier.subresourceRange.baseArrayLayer = 0;
-    dsBarrier.subresourceRange.layerCount = 1;
-    dsBarrier.srcAccessMask = vk::AccessFlagBits::eDepthStencilAttachmentWrite;
-    dsBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-    cmd.pipelineBarrier(
-      vk::PipelineStageFlagBits::eLateFragmentTests,
-      vk::PipelineStageFlagBits::eComputeShader,
-      {}, {}, {}, dsBarrier);
-  }
+  // The render graph has transitioned HDR and the ping image to General and
+  // the depth-stencil image to DepthStencilReadOnlyOptimal
 
   uint32_t groupsX = (w + 15) / 16;
   uint32_t groupsY = (h + 15) / 16;
@@ -420,31 +289,6 @@ void SSSBlurStage::record(const FrameContext& ctx)
     static_cast<uint32_t>(sizeof(pc)), &pc);
   cmd.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipeline_layout, 0, m_v_descriptor, {});
   cmd.dispatch(groupsX, groupsY, 1);
-
-  // Transition HDR back to ShaderReadOnlyOptimal for composite sampling
-  {
-    vk::ImageMemoryBarrier barrier{};
-    barrier.oldLayout = vk::ImageLayout::eGeneral;
-    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = m_hdr_image;
-    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
-    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-
-    cmd.pipelineBarrier(
-      vk::PipelineStageFlagBits::eComputeShader,
-      vk::PipelineStageFlagBits::eFragmentShader,
-      {}, {}, {}, barrier);
-  }
-
-  // No need to transition depth-stencil back — scene render pass has
-  // initialLayout = eUndefined which discards old content
 }
 
 } // namespace sps::vulkan
@@ -10,13 +10,16 @@ class VulkanRenderer;
 
 /// Screen-space subsurface scattering blur stage.
 ///
-/// Self-contained stage: owns its compute pipeline, descriptors, and ping image.
-/// Runs as an Intermediate stage between the scene and composite passes.
+/// Self-contained stage: owns its compute pipeline and descriptors. The ping
+/// image is a transient image ("sss_ping") owned by the render graph, which may
+/// alias it with images used in other phases.
+/// Runs as an Intermediate stage between the scene and composite passes, on
+/// the async compute queue when the render graph has one.
 /// Applies a separable (horizontal + vertical) blur to SSS pixels only
 /// (identified by alpha == 1 in the HDR buffer), with per-channel blur widths.
 ///
 /// Queries the SharedImageRegistry (via RenderGraph) for "hdr" and "depth_stencil"
-/// entries. Refreshes cached handles on swapchain resize.
+/// entries. Refreshes cached handles and descriptors when transient images are realized.
 class SSSBlurStage : public RenderStage
 {
 public:
@@ -31,7 +34,8 @@ public:
   void record(const FrameContext& ctx) override;
   [[nodiscard]] bool is_enabled() const override { return *m_enabled && !*m_use_rt; }
   [[nodiscard]] Phase phase() const override { return Phase::Intermediate; }
-  void on_swapchain_resize(const Device& device, vk::Extent2D extent) override;
+  [[nodiscard]] bool compute_only() const override { return true; }
+  void on_transient_images_realized() override;
 
 private:
   const VulkanRenderer& m_renderer;
@@ -51,19 +55,13 @@ private:
   vk::Pipeline m_pipeline{ VK_NULL_HANDLE };
   vk::Sampler m_stencil_sampler{ VK_NULL_HANDLE };
 
-  // Ping image (intermediate for separable blur)
-  vk::Image m_ping_image{ VK_NULL_HANDLE };
-  vk::DeviceMemory m_ping_image_memory{ VK_NULL_HANDLE };
-  vk::ImageView m_ping_image_view{ VK_NULL_HANDLE };
-
   // Cached from registry (refreshed on resize)
   vk::Image m_hdr_image;
+  vk::Image m_ping_image; // transient intermediate for separable blur
   vk::Image m_depth_stencil_image;
   vk::Extent2D m_extent{};
 
   void create_pipeline();
-  void create_ping_image();
-  void destroy_ping_image();
   void create_descriptors();
   void destroy_descriptors();
   void update_from_registry();
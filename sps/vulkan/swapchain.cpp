@@ -63,14 +63,23 @@ vk::Extent2D Swapchain::choose_image_extent(const vk::Extent2D& requested_extent
 
 vk::PresentModeKHR Swapchain::choose_present_mode(
   const std::vector<vk::PresentModeKHR>& available_present_modes,
-  const std::vector<vk::PresentModeKHR>& present_mode_priority_list, const bool vsync_enabled)
+  const std::vector<vk::PresentModeKHR>& present_mode_priority_list, const bool vsync_enabled,
+  const bool low_latency)
 {
   assert(!available_present_modes.empty());
   assert(!present_mode_priority_list.empty());
 
   vk::PresentModeKHR chosenPresentMode = vk::PresentModeKHR::eFifo;
 
-  if (!vsync_enabled)
+  // Mailbox does not tear either, but replaces a queued image instead of
+  // blocking, so the displayed frame is never older than one refresh
+  if (low_latency
+    && std::find(available_present_modes.begin(), available_present_modes.end(),
+         vk::PresentModeKHR::eMailbox) != available_present_modes.end())
+  {
+    chosenPresentMode = vk::PresentModeKHR::eMailbox;
+  }
+  else if (!vsync_enabled)
   {
     for (const auto requested_present_mode : present_mode_priority_list)
     {
@@ -319,7 +328,8 @@ void Swapchain::setup_swapchain(
   // Present modes
   createInfo.presentMode =
     choose_present_mode(m_device.physicalDevice().getSurfacePresentModesKHR(m_surface),
-      default_present_mode_priorities, vsync_enabled);
+      default_present_mode_priorities, vsync_enabled, m_low_latency);
+  m_present_mode = createInfo.presentMode;
 
   createInfo.oldSwapchain = old_swapchain;
 
@@ -338,14 +348,20 @@ void Swapchain::setup_swapchain(
 
   if (old_swapchain != vk::SwapchainKHR(nullptr))
   {
-    for (auto const img_view : m_img_views)
-    {
-      // An image view for each frame
-      m_device.device().destroyImageView(img_view);
-    }
+    // Retired, not idled: frames in flight may still render to the old images
+    // and queued presents still reference the swapchain. Destroyed after the
+    // new swapchain has gone through enough presents.
+    defer_until_presented(
+      [dev = m_device.device(), old_swapchain, views = std::move(m_img_views)]()
+      {
+        for (auto const img_view : views)
+        {
+          dev.destroyImageView(img_view);
+        }
+        dev.destroySwapchainKHR(old_swapchain);
+      });
     m_imgs.clear();
     m_img_views.clear();
-    m_device.device().destroySwapchainKHR(old_swapchain);
   }
 
   // Store the ACTUAL chosen extent, not the requested extent
@@ -384,10 +400,11 @@ void Swapchain::setup_swapchain(
 }
 
 Swapchain::Swapchain(Device& device, const VkSurfaceKHR surface, const std::uint32_t width,
-  const std::uint32_t height, const bool vsync_enabled)
+  const std::uint32_t height, const bool vsync_enabled, const bool low_latency)
   : m_device(device)
   , m_surface(surface)
   , m_vsync_enabled(vsync_enabled)
+  , m_low_latency(low_latency)
 {
   setup_swapchain(width, height, vsync_enabled);
 }
@@ -403,10 +420,35 @@ Swapchain::Swapchain(Swapchain&& other) noexcept
   m_extent = other.m_extent;
   // Consider adding frame with sets of semaphores
   m_vsync_enabled = other.m_vsync_enabled;
+  m_low_latency = other.m_low_latency;
+  m_present_mode = other.m_present_mode;
+  m_pending_releases = std::move(other.m_pending_releases);
+  m_present_count = other.m_present_count;
+  m_retire_after_presents = other.m_retire_after_presents;
+}
+
+void Swapchain::defer_until_presented(std::function<void()> release)
+{
+  m_pending_releases.push_back({ m_present_count + m_retire_after_presents, std::move(release) });
+}
+
+void Swapchain::on_presented()
+{
+  ++m_present_count;
+  while (!m_pending_releases.empty() && m_pending_releases.front().present_count <= m_present_count)
+  {
+    m_device.defer_release(std::move(m_pending_releases.front().release));
+    m_pending_releases.pop_front();
+  }
 }
 
 Swapchain::~Swapchain()
 {
+  // The device is idle at shutdown
+  for (auto& pending : m_pending_releases)
+  {
+    pending.release();
+  }
   m_device.device().destroySwapchainKHR(m_swapchain);
   for (auto const img_view : m_img_views)
   {
@@ -13,6 +13,9 @@
 
 #include <sps/vulkan/swapchain_simple.h>
 
+#include <deque>
+#include <functional>
+
 namespace sps::vulkan
 {
 
@@ -37,6 +40,18 @@ private:
   //  std::unique_ptr<Semaphore> m_img_available;
   [[nodiscard]] std::vector<vk::Image> get_swapchain_images();
   bool m_vsync_enabled{ true };
+  bool m_low_latency{ false };
+  vk::PresentModeKHR m_present_mode{ vk::PresentModeKHR::eFifo };
+
+  // Releases waiting for the presentation engine (see defer_until_presented)
+  struct PendingRelease
+  {
+    std::uint64_t present_count; // released once m_present_count reaches this
+    std::function<void()> release;
+  };
+  std::deque<PendingRelease> m_pending_releases;
+  std::uint64_t m_present_count{ 0 };
+  std::uint32_t m_retire_after_presents{ 2 };
 
   std::optional<vk::CompositeAlphaFlagBitsKHR> choose_composite_alpha(
     const vk::CompositeAlphaFlagBitsKHR request_composite_alpha,
@@ -49,7 +64,8 @@ private:
   // Make this default to mailbox
   vk::PresentModeKHR choose_present_mode(
     const std::vector<vk::PresentModeKHR>& available_present_modes,
-    const std::vector<vk::PresentModeKHR>& present_mode_priority_list, const bool vsync_enabled);
+    const std::vector<vk::PresentModeKHR>& present_mode_priority_list, const bool vsync_enabled,
+    const bool low_latency);
 
   std::optional<vk::SurfaceFormatKHR> choose_surface_format(
     const std::vector<vk::SurfaceFormatKHR>& available_formats,
@@ -66,8 +82,26 @@ public:
 
   void set_vsync(bool enabled) { m_vsync_enabled = enabled; }
 
+  /// Prefer MAILBOX (tear-free, newest frame wins) over the vsync setting.
+  /// Takes effect on the next recreate().
+  void set_low_latency(bool enabled) { m_low_latency = enabled; }
+
+  /// Presents after which objects handed to defer_until_presented() are
+  /// released (frames in flight + 1).
+  void set_retire_after_presents(std::uint32_t presents) { m_retire_after_presents = presents; }
+
+  /// Release an object a queued present may still use (old swapchain,
+  /// render-finished semaphores): graphics completion does not mean the
+  /// presentation engine has consumed a present's wait semaphore. Released
+  /// through Device::defer_release() once set_retire_after_presents() more
+  /// presents have been queued successfully.
+  void defer_until_presented(std::function<void()> release);
+
+  /// Count a successfully queued present and hand due releases on.
+  void on_presented();
+
   Swapchain(Device& device, VkSurfaceKHR surface, std::uint32_t width, std::uint32_t height,
-    bool vsync_enabled);
+    bool vsync_enabled, bool low_latency = false);
 
   Swapchain(const Swapchain&) = delete;
   Swapchain(Swapchain&&) noexcept;
@@ -83,6 +117,8 @@ public:
     return static_cast<std::uint32_t>(m_imgs.size());
   }
 
+  [[nodiscard]] vk::PresentModeKHR present_mode() const { return m_present_mode; }
+
   [[nodiscard]] vk::Format image_format() const { return m_surface_format.value().format; }
 
   [[nodiscard]] const std::vector<vk::ImageView>& image_views() const { return m_img_views; }
@@ -85,7 +85,7 @@ Texture::~Texture()
 
   if (m_memory)
   {
-    dev.freeMemory(m_memory);
+    m_device->free_memory(m_memory);
     m_memory = VK_NULL_HANDLE;
   }
 
@@ -127,7 +127,7 @@ Texture& Texture::operator=(Texture&& other) noexcept
       if (m_image)
         dev.destroyImage(m_image);
       if (m_memory)
-        dev.freeMemory(m_memory);
+        m_device->free_memory(m_memory);
     }
 
     // Move from other
@@ -182,7 +182,7 @@ void Texture::create_image()
   alloc_info.memoryTypeIndex =
     m_device->find_memory_type(mem_reqs.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_memory = dev.allocateMemory(alloc_info);
+  m_memory = m_device->allocate_memory(alloc_info, MemoryCategory::Texture);
   dev.bindImageMemory(m_image, m_memory, 0);
 
   // Set debug name
@@ -259,10 +259,12 @@ void Texture::transition_layout(
   else if (old_layout == vk::ImageLayout::eTransferDstOptimal &&
            new_layout == vk::ImageLayout::eShaderReadOnlyOptimal)
   {
+    // Sampled by raster fragment, compute and ray tracing shaders; the upload
+    // is not waited on, so this barrier orders every later reader
     barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
     barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
     src_stage = vk::PipelineStageFlagBits::eTransfer;
-    dst_stage = vk::PipelineStageFlagBits::eFragmentShader;
+    dst_stage = vk::PipelineStageFlagBits::eAllCommands;
   }
   else
   {
@@ -277,12 +279,13 @@ void Texture::upload_pixels(const uint8_t* pixels)
   auto dev = m_device->device();
   vk::DeviceSize image_size = m_width * m_height * 4; // RGBA
 
-  // Create staging buffer
-  Buffer staging(*m_device, m_name + " staging", image_size,
+  // Create staging buffer (released once the upload has completed on the GPU)
+  auto staging = std::make_shared<Buffer>(*m_device, m_name + " staging", image_size,
     vk::BufferUsageFlagBits::eTransferSrc,
-    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+    MemoryCategory::Staging);
 
-  staging.update(pixels, image_size);
+  staging->update(pixels, image_size);
 
   // Create command buffer for transfer
   vk::CommandPoolCreateInfo pool_info{};
@@ -318,7 +321,7 @@ void Texture::upload_pixels(const uint8_t* pixels)
   region.imageOffset = vk::Offset3D{ 0, 0, 0 };
   region.imageExtent = vk::Extent3D{ m_width, m_height, 1 };
 
-  cmd.copyBufferToImage(staging.buffer(), m_image, vk::ImageLayout::eTransferDstOptimal, region);
+  cmd.copyBufferToImage(staging->buffer(), m_image, vk::ImageLayout::eTransferDstOptimal, region);
 
   // Transition to shader read
   transition_layout(
@@ -326,17 +329,20 @@ void Texture::upload_pixels(const uint8_t* pixels)
 
   cmd.end();
 
-  // Submit and wait
+  // Submit without waiting: later graphics submissions are ordered after the
+  // layout transition above
   vk::SubmitInfo submit_info{};
   submit_info.commandBufferCount = 1;
   submit_info.pCommandBuffers = &cmd;
 
-  m_device->graphics_queue().submit(submit_info, nullptr);
-  m_device->graphics_queue().waitIdle();
+  m_device->submit_graphics(submit_info);
 
-  // Cleanup
-  dev.freeCommandBuffers(cmd_pool, cmd);
-  dev.destroyCommandPool(cmd_pool);
+  // Cleanup (destroying the pool frees its command buffer)
+  m_device->defer_release([staging, dev, cmd_pool]() mutable
+    {
+      staging.reset();
+      dev.destroyCommandPool(cmd_pool);
+    });
 }
 
 } // namespace sps::vulkan
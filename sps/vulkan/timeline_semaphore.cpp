@@ -0,0 +1,53 @@
+#include <sps/vulkan/timeline_semaphore.h>
+
+#include <sps/vulkan/device.h>
+
+#include <cassert>
+#include <utility>
+
+namespace sps::vulkan
+{
+
+TimelineSemaphore::TimelineSemaphore(
+  const Device& device, const std::string& name, std::uint64_t initial_value)
+  : m_device(device)
+  , m_name(name)
+{
+  assert(!name.empty());
+  vk::SemaphoreTypeCreateInfo typeInfo{};
+  typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+  typeInfo.initialValue = initial_value;
+
+  vk::SemaphoreCreateInfo semaphoreInfo{};
+  semaphoreInfo.pNext = &typeInfo;
+  device.create_semaphore(semaphoreInfo, &m_semaphore, m_name);
+}
+
+TimelineSemaphore::TimelineSemaphore(TimelineSemaphore&& other) noexcept
+  : m_device(other.m_device)
+{
+  m_semaphore = std::exchange(other.m_semaphore, VK_NULL_HANDLE);
+  m_name = std::move(other.m_name);
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+  if (m_semaphore)
+    m_device.device().destroySemaphore(m_semaphore);
+}
+
+std::uint64_t TimelineSemaphore::value() const
+{
+  return m_device.device().getSemaphoreCounterValue(m_semaphore);
+}
+
+bool TimelineSemaphore::wait(std::uint64_t value, std::uint64_t timeout_limit) const
+{
+  vk::SemaphoreWaitInfo waitInfo{};
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &m_semaphore;
+  waitInfo.pValues = &value;
+  return m_device.device().waitSemaphores(waitInfo, timeout_limit) == vk::Result::eSuccess;
+}
+
+}
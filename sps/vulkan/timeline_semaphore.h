@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace sps::vulkan
+{
+// Forward declaration
+class Device;
+
+/// RAII wrapper class for a timeline VkSemaphore (Vulkan 1.2 core).
+///
+/// The counter only ever increases. GPU submissions signal a value when they
+/// complete; the CPU waits for (or polls) a value instead of a fence.
+class TimelineSemaphore
+{
+  const Device& m_device;
+  vk::Semaphore m_semaphore{ VK_NULL_HANDLE };
+  std::string m_name;
+
+public:
+  /// Default constructor
+  /// @param device The const reference to a device RAII wrapper instance.
+  /// @param name The internal debug marker name of the VkSemaphore.
+  /// @param initial_value Counter value at creation.
+  TimelineSemaphore(const Device& device, const std::string& name, std::uint64_t initial_value = 0);
+  TimelineSemaphore(const TimelineSemaphore&) = delete;
+  TimelineSemaphore(TimelineSemaphore&&) noexcept;
+  ~TimelineSemaphore();
+
+  TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+  TimelineSemaphore& operator=(TimelineSemaphore&&) = delete;
+
+  [[nodiscard]] vk::Semaphore get() const { return m_semaphore; }
+
+  /// Current counter value (vkGetSemaphoreCounterValue).
+  [[nodiscard]] std::uint64_t value() const;
+
+  /// Block until the counter reaches value (vkWaitSemaphores).
+  /// @param timeout_limit Timeout in nanoseconds.
+  /// @return False if the timeout expired first.
+  bool wait(std::uint64_t value,
+    std::uint64_t timeout_limit = std::numeric_limits<std::uint64_t>::max()) const;
+};
+}
@@ -21,7 +21,8 @@ public:
   /// @param name Debug name for the buffer.
   UniformBuffer(const Device& device, const std::string& name)
     : Buffer(device, name, sizeof(T), vk::BufferUsageFlagBits::eUniformBuffer,
-        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent)
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        MemoryCategory::Uniform)
   {
   }
 
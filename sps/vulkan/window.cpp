@@ -70,10 +70,13 @@ void Window::poll()
 
 void Window::set_resize_pending(std::uint32_t width, std::uint32_t height)
 {
+  if (!m_resize_pending)
+    m_resize_time = glfwGetTime();
   m_pending_width = width;
   m_pending_height = height;
   m_resize_pending = true;
-  spdlog::warn("RESIZE CALLBACK: {} x {}", width, height);
+  // Fires continuously during an interactive resize
+  spdlog::trace("Resize callback: {} x {}", width, height);
 }
 
 void Window::get_pending_resize(std::uint32_t& width, std::uint32_t& height)
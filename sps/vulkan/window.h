@@ -27,6 +27,7 @@ private:
   bool m_resize_pending{ false };
   std::uint32_t m_pending_width{ 0 };
   std::uint32_t m_pending_height{ 0 };
+  double m_resize_time{ 0.0 }; // glfwGetTime() of the first callback since the last resize
 
 public:
   Window(const std::string& title, std::uint32_t width, std::uint32_t height, bool visible,
@@ -52,6 +53,8 @@ public:
   // Resize support
   void set_resize_pending(std::uint32_t width, std::uint32_t height);
   [[nodiscard]] bool has_pending_resize() const { return m_resize_pending; }
+  /// glfwGetTime() when the pending resize was first reported (for latency stats).
+  [[nodiscard]] double resize_pending_since() const { return m_resize_time; }
   void get_pending_resize(std::uint32_t& width, std::uint32_t& height);
   void wait_for_focus();
   void set_user_ptr(void* user_ptr);
@@ -0,0 +1,119 @@
+#include <sps/vulkan/worker_pool.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace sps::vulkan
+{
+
+WorkerPool::WorkerPool(uint32_t worker_count)
+{
+  m_threads.reserve(worker_count);
+  for (uint32_t i = 0; i < worker_count; ++i)
+  {
+    m_threads.emplace_back(&WorkerPool::worker_main, this, i + 1);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  for (auto& thread : m_threads)
+  {
+    thread.join();
+  }
+}
+
+uint32_t WorkerPool::default_worker_count()
+{
+  constexpr uint32_t MAX_WORKERS = 7;
+  const uint32_t hardware = std::thread::hardware_concurrency();
+  return hardware > 1 ? std::min(hardware - 1, MAX_WORKERS) : 0;
+}
+
+void WorkerPool::parallel_for(uint32_t task_count, const Task& task)
+{
+  if (task_count == 0)
+    return;
+
+  // Nothing to share: run inline without waking anyone
+  if (m_threads.empty() || task_count == 1)
+  {
+    for (uint32_t i = 0; i < task_count; ++i)
+      task(i, 0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_task_count = task_count;
+    m_next_task.store(0, std::memory_order_relaxed);
+    m_active = static_cast<uint32_t>(m_threads.size());
+    m_error = nullptr;
+    ++m_generation;
+  }
+  m_wake.notify_all();
+
+  run_tasks(0);
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_active == 0; });
+    m_task = nullptr;
+    error = std::exchange(m_error, nullptr);
+  }
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void WorkerPool::worker_main(uint32_t thread)
+{
+  uint64_t seen = 0;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+      if (m_stop)
+        return;
+      seen = m_generation;
+    }
+
+    run_tasks(thread);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_active == 0)
+        m_done.notify_one();
+    }
+  }
+}
+
+void WorkerPool::run_tasks(uint32_t thread)
+{
+  for (;;)
+  {
+    const uint32_t i = m_next_task.fetch_add(1, std::memory_order_relaxed);
+    if (i >= m_task_count)
+      return;
+
+    try
+    {
+      (*m_task)(i, thread);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_error)
+        m_error = std::current_exception();
+    }
+  }
+}
+
+} // namespace sps::vulkan
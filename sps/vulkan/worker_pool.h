@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sps::vulkan
+{
+
+/// Fixed-size pool of worker threads for fork-join work (e.g. command recording).
+///
+/// parallel_for() hands out task indices to the workers and to the calling
+/// thread, and returns once every task has run. Each task also receives the
+/// index of the thread running it (0 = caller, 1..worker_count = workers), so
+/// callers can keep per-thread resources such as command pools without locks.
+///
+/// Only one parallel_for() may run at a time. An exception thrown by a task is
+/// rethrown on the calling thread after all tasks have finished.
+class WorkerPool
+{
+public:
+  using Task = std::function<void(uint32_t task, uint32_t thread)>;
+
+  /// @param worker_count Number of threads to spawn in addition to the caller.
+  explicit WorkerPool(uint32_t worker_count);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /// Threads that may run tasks, including the calling thread.
+  [[nodiscard]] uint32_t thread_count() const
+  {
+    return static_cast<uint32_t>(m_threads.size()) + 1;
+  }
+
+  /// Run task(i, thread) for i in [0, task_count) and wait for completion.
+  void parallel_for(uint32_t task_count, const Task& task);
+
+  /// Default worker count: one less than the hardware threads (the caller
+  /// records too), capped to keep per-thread command pools small.
+  [[nodiscard]] static uint32_t default_worker_count();
+
+private:
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  uint64_t m_generation{ 0 };
+  uint32_t m_active{ 0 }; // workers still running the current job
+  bool m_stop{ false };
+
+  const Task* m_task{ nullptr };
+  uint32_t m_task_count{ 0 };
+  std::atomic<uint32_t> m_next_task{ 0 };
+  std::exception_ptr m_error;
+
+  void worker_main(uint32_t thread);
+  void run_tasks(uint32_t thread);
+};
+
+} // namespace sps::vulkan
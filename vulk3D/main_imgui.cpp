@@ -12,6 +12,7 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_vulkan.h>
 
+#include <cstdio>
 #include <filesystem>
 #include <string>
 
@@ -118,6 +119,33 @@ int main(int argc, char* argv[])
       ImGui::SameLine();
       ImGui::TextDisabled("(off = Immediate)");
 
+      bool low_latency = app.low_latency_enabled();
+      if (ImGui::Checkbox("Low latency (Mailbox)", &low_latency))
+      {
+        app.set_low_latency(low_latency);
+      }
+      ImGui::SetItemTooltip("Mailbox present mode and a just-in-time frame start");
+
+      int frames_in_flight = static_cast<int>(app.frames_in_flight());
+      if (ImGui::SliderInt("Frames in flight", &frames_in_flight, 1, 3))
+      {
+        app.set_frames_in_flight(static_cast<uint32_t>(frames_in_flight));
+      }
+      const auto& timings = app.frame_timings();
+      ImGui::Text("CPU wait %.2f ms  GPU busy %.2f ms  GPU idle %.2f ms", timings.cpu_wait_ms,
+        timings.gpu_busy_ms, timings.gpu_idle_ms);
+      const auto& latency = app.input_latency();
+      if (latency.samples > 0)
+      {
+        ImGui::Text("Input latency %.1f ms (avg %.1f ms, %s)", latency.last_ms,
+          latency.average_ms, latency.measured ? "present wait" : "estimated");
+      }
+      if (const auto* culler = app.frustum_culler())
+      {
+        ImGui::Text("Primitives: %u visible, %u culled", culler->visible_count(),
+          culler->culled_count());
+      }
+
       ImGui::Checkbox("Ray Tracing", &app.use_raytracing());
       ImGui::SameLine();
       ImGui::TextDisabled("(R key)");
@@ -379,6 +407,52 @@ int main(int argc, char* argv[])
       }
     }
 
+    if (ImGui::CollapsingHeader("Memory"))
+    {
+      const MemoryStats& stats = app.memory_stats();
+      if (ImGui::BeginTable("mem_categories", 3, ImGuiTableFlags_SizingFixedFit))
+      {
+        for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); i++)
+        {
+          auto category = static_cast<MemoryCategory>(i);
+          MemoryCategoryStats c = stats.category(category);
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::TextUnformatted(to_string(category));
+          ImGui::TableNextColumn();
+          ImGui::Text("%.1f MiB", static_cast<double>(c.bytes) / (1024.0 * 1024.0));
+          ImGui::TableNextColumn();
+          ImGui::TextDisabled("%u allocs", c.allocations);
+        }
+        ImGui::EndTable();
+      }
+      ImGui::Text("Total: %.1f MiB (%u allocations)",
+        static_cast<double>(stats.total_bytes()) / (1024.0 * 1024.0), stats.total_allocations());
+
+      ImGui::Separator();
+      auto heaps = app.memory_budgets();
+      app.memory_stats().check_budgets(heaps);
+      for (const auto& heap : heaps)
+      {
+        float fraction = heap.budget > 0
+          ? static_cast<float>(static_cast<double>(heap.usage) / static_cast<double>(heap.budget))
+          : 0.0f;
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%.0f / %.0f MiB",
+          static_cast<double>(heap.usage) / (1024.0 * 1024.0),
+          static_cast<double>(heap.budget) / (1024.0 * 1024.0));
+        ImGui::Text("Heap %u (%s)", heap.heap_index,
+          (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) ? "device" : "host");
+        if (fraction >= 0.9f)
+          ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
+        ImGui::ProgressBar(fraction, ImVec2(-1.0f, 0.0f), overlay);
+        if (fraction >= 0.9f)
+          ImGui::PopStyleColor();
+      }
+      if (!app.memory_budget_supported())
+        ImGui::TextDisabled("VK_EXT_memory_budget unavailable (app-tracked usage)");
+    }
+
     ImGui::End();
 
     ImGui::Render();
@@ -389,6 +463,8 @@ int main(int argc, char* argv[])
     // Render scene
     app.render();
     app.tick_screenshot_all();
+    app.tick_frames_in_flight_bench();
+    app.tick_mesh_memory_bench();
     app.calculateFrameRate();
   }
 